@@ -25,8 +25,10 @@
 
 #include "../../runner/src/runner_helper.hpp"
 #include "./batch_tensor_buffer.hpp"
+#include "./model_scheduler.hpp"
 #include "vitis/ai/collection_helper.hpp"
 #include "vitis/ai/env_config.hpp"
+#include "vitis/ai/metrics.hpp"
 #include "vitis/ai/weak.hpp"
 #include "xir/graph/graph.hpp"
 
@@ -34,6 +36,10 @@ DEF_ENV_PARAM_2(XLNX_NUM_OF_RUNNER_THREADS, "12", size_t);
 DEF_ENV_PARAM(XLNX_MAX_WAITING_TIME_IN_MS, "5");
 DEF_ENV_PARAM(DEBUG_ASYNC_RUNNER, "0");
 DEF_ENV_PARAM(XLNX_ASYNC_RUNNER_PERF, "0");
+// number of batches which are allowed to run on the device(s) at the
+// same time, shared by all async runners. 0 means the same as
+// XLNX_NUM_OF_RUNNER_THREADS.
+DEF_ENV_PARAM_2(XLNX_NUM_OF_DEVICE_SLOTS, "0", size_t);
 
 namespace {
 
@@ -97,6 +103,7 @@ class AsyncRunnerImpl : public vart::Runner {
     std::vector<vart::TensorBuffer*> input;
     std::vector<vart::TensorBuffer*> output;
     int job_id;
+    std::chrono::steady_clock::time_point submitted;
   };
   struct job_slot_t {
     std::promise<int> promise;
@@ -127,6 +134,17 @@ class AsyncRunnerImpl : public vart::Runner {
   std::unique_ptr<vitis::ai::ErlMsgBox<queue_element_type_t>> queue_;
   std::unique_ptr<vitis::ai::ErlMsgBox<size_t>> runners_idx_q_;
   std::shared_ptr<vitis::ai::ThreadPool> the_pool_;
+  std::shared_ptr<vart::ModelScheduler> the_scheduler_;
+  int model_id_;
+  struct {
+    vitis::ai::Counter* requests;
+    vitis::ai::Gauge* queue_depth;
+    // requests per batch / batch size
+    vitis::ai::Histogram* batch_fill;
+    // from execute_async to the start of the batch
+    vitis::ai::Histogram* wait_time;
+    vitis::ai::Histogram* run_time;
+  } metrics_;
   std::thread my_thread_;
   volatile bool running_;
   std::map<int, std::unique_ptr<job_slot_t>> slots_;
@@ -209,6 +227,41 @@ AsyncRunnerImpl::AsyncRunnerImpl(vart::Runner* (*init_fun)(const xir::Subgraph*,
   }
   the_pool_ = vitis::ai::WeakStore<std::string, vitis::ai::ThreadPool>::create(
       std::string("async_runner"), ENV_PARAM(XLNX_NUM_OF_RUNNER_THREADS));
+  the_scheduler_ =
+      vitis::ai::WeakStore<std::string, vart::ModelScheduler>::create(
+          std::string("async_runner"),
+          ENV_PARAM(XLNX_NUM_OF_DEVICE_SLOTS) != 0u
+              ? ENV_PARAM(XLNX_NUM_OF_DEVICE_SLOTS)
+              : ENV_PARAM(XLNX_NUM_OF_RUNNER_THREADS));
+  // attr "scheduler_weight": share of device time relative to other
+  // models, attr "max_pending_requests": requests beyond this limit
+  // are rejected by execute_async, 0 means unlimited.
+  model_id_ = the_scheduler_->register_model(
+      subgraph->get_name(),
+      attrs->has_attr("scheduler_weight")
+          ? attrs->get_attr<double>("scheduler_weight")
+          : 1.0,
+      attrs->has_attr("max_pending_requests")
+          ? attrs->get_attr<size_t>("max_pending_requests")
+          : 0u);
+  auto& registry = vitis::ai::MetricsRegistry::instance();
+  auto labels =
+      vitis::ai::metrics::labels_t{{"subgraph", subgraph->get_name()}};
+  metrics_.requests = registry.counter("vart_async_runner_requests_total",
+                                       "number of submitted requests", labels);
+  metrics_.queue_depth = registry.gauge(
+      "vart_async_runner_queue_depth",
+      "number of requests waiting for a batch", labels);
+  metrics_.batch_fill = registry.histogram(
+      "vart_async_runner_batch_fill_ratio",
+      "number of requests in a batch divided by the batch size", labels,
+      {0.125, 0.25, 0.375, 0.5, 0.625, 0.75, 0.875, 1.0});
+  metrics_.wait_time = registry.histogram(
+      "vart_async_runner_wait_time_microseconds",
+      "time from submission to the start of the batch", labels);
+  metrics_.run_time = registry.histogram(
+      "vart_async_runner_run_time_microseconds",
+      "time to run one batch on the wrapped runner", labels);
   running_ = true;
   // Q: why there is a thread for an async runner?
   //
@@ -244,6 +297,8 @@ AsyncRunnerImpl::~AsyncRunnerImpl() {
       << " states: " << runners_state_as_string() << " qlen=" << queue_->size()
       << " qcap=" << queue_->capacity()
       << " if #slots is not zero, there might be some resource leak";
+  the_scheduler_->unregister_model(model_id_);
+  the_scheduler_ = nullptr;
   LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER))
       << "AsyncRunnerImpl@" << (void*)this << "  says BYEBYE.";
   the_pool_ = nullptr;  // release the thread pool.
@@ -252,15 +307,24 @@ AsyncRunnerImpl::~AsyncRunnerImpl() {
 std::pair<uint32_t, int> AsyncRunnerImpl::execute_async(
     const std::vector<vart::TensorBuffer*>& input,
     const std::vector<vart::TensorBuffer*>& output) {
-  auto job_id = allocate_job_id();
+  // rejected before admit() and allocate_job_id(), nothing to undo.
   if (!running_) {
     LOG(WARNING) << "runner is shutting down, reject new request";
-    std::make_pair(0xFFFFFFFF, -1);
+    return std::make_pair(0xFFFFFFFF, -1);
+  }
+  if (!the_scheduler_->admit(model_id_)) {
+    LOG_IF(WARNING, ENV_PARAM(DEBUG_ASYNC_RUNNER))
+        << "too many pending requests, reject new request";
+    return std::make_pair(0xFFFFFFFF, -1);
   }
+  auto job_id = allocate_job_id();
   LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER) >= 2)
       << "job id " << job_id << " is allocated for inputs=" << to_string(input)
       << ",outputs=" << to_string(output);
-  queue_->emplace_send(queue_element_type_t{input, output, job_id});
+  queue_->emplace_send(queue_element_type_t{
+      input, output, job_id, std::chrono::steady_clock::now()});
+  metrics_.requests->inc();
+  metrics_.queue_depth->set((double)queue_->size());
   LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER) >= 2)
       << "job id " << job_id << " is submitted. qlen=" << queue_->size()
       << " qcap=" << queue_->capacity();
@@ -419,6 +483,7 @@ void AsyncRunnerImpl::notify_completion(
       slots_[arg->job_id]->promise.set_value(ret);
     }
   }
+  the_scheduler_->retire(model_id_, args.size());
 }
 
 void AsyncRunnerImpl::start_one_runner(
@@ -431,11 +496,21 @@ void AsyncRunnerImpl::start_one_runner(
       << " jobs " << jobs_to_string(args) << " are ready for run.";
 
   runner.state = WAITING;
+  // wait for our turn on the device, it is shared with other models.
+  the_scheduler_->acquire(model_id_);
   the_pool_->async([this, &runner, args = std::move(args)]() mutable {
     LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER) >= 3)
         << " jobs " << jobs_to_string(args) << " are started.";
     runner.state = RUNNING;
+    auto start = std::chrono::steady_clock::now();
+    for (auto& arg : args) {
+      metrics_.wait_time->observe(start - arg->submitted);
+    }
     auto ret = start_one_runner_real(runner.runner.get(), args);
+    auto run_time = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    metrics_.run_time->observe(run_time);
+    the_scheduler_->release(model_id_, run_time);
     LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER) >= 3)
         << " jobs " << jobs_to_string(args) << " are completed.";
     notify_completion(args, ret);
@@ -501,6 +576,8 @@ void AsyncRunnerImpl::thread_main() {
              // quests in the queue.
              (running_ || queue_->size() != 0));
     if (batch_idx > 0u) {
+      metrics_.batch_fill->observe((double)batch_idx / (double)batch_size);
+      metrics_.queue_depth->set((double)queue_->size());
       args.resize(batch_idx);
       start_one_runner(runner, std::move(args));
     } else {
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./model_scheduler.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM(DEBUG_MODEL_SCHEDULER, "0");
+
+namespace vart {
+
+// weight of the newest sample in the moving average of device time.
+static constexpr double EWMA_ALPHA = 0.125;
+
+ModelScheduler::ModelScheduler(size_t num_of_slots)
+    : num_of_slots_{std::max<size_t>(num_of_slots, 1u)},
+      num_of_free_slots_{num_of_slots_},
+      next_model_id_{0},
+      system_vtime_{0.0},
+      total_device_time_us_{0u},
+      models_{},
+      mtx_{},
+      cv_{} {
+  LOG_IF(INFO, ENV_PARAM(DEBUG_MODEL_SCHEDULER))
+      << "@" << (void*)this << " model scheduler created. num_of_slots="
+      << num_of_slots_;
+}
+
+ModelScheduler::~ModelScheduler() {
+  LOG_IF(INFO, ENV_PARAM(DEBUG_MODEL_SCHEDULER))
+      << "@" << (void*)this << " model scheduler destroyed. "
+      << stats_as_string();
+}
+
+int ModelScheduler::register_model(const std::string& name, double weight,
+                                   size_t max_pending) {
+  CHECK_GT(weight, 0.0) << "weight must be positive. model=" << name;
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto model_id = next_model_id_++;
+  auto& model = models_[model_id];
+  model.name = name;
+  model.weight = weight;
+  model.max_pending = max_pending;
+  model.vtime = system_vtime_;
+  model.avg_device_time_us = 0.0;
+  model.num_of_waiting = 0u;
+  model.num_of_running = 0u;
+  model.num_of_pending = 0u;
+  model.num_of_admitted = 0u;
+  model.num_of_rejected = 0u;
+  model.num_of_batches = 0u;
+  model.total_device_time_us = 0u;
+  model.total_waiting_time_us = 0u;
+  LOG_IF(INFO, ENV_PARAM(DEBUG_MODEL_SCHEDULER))
+      << "model " << model_id << " registered. name=" << name
+      << " weight=" << weight << " max_pending=" << max_pending;
+  return model_id;
+}
+
+void ModelScheduler::unregister_model(int model_id) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto& model = find_model(model_id);
+  CHECK_EQ(model.num_of_running, 0u)
+      << "model is still running. name=" << model.name;
+  if (ENV_PARAM(DEBUG_MODEL_SCHEDULER)) {
+    std::ostringstream str;
+    dump_model(str, model);
+    LOG(INFO) << "model " << model_id << " unregistered. " << str.str();
+  }
+  models_.erase(model_id);
+  // removing a model might make another one the smallest vtime.
+  cv_.notify_all();
+}
+
+bool ModelScheduler::admit(int model_id) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto& model = find_model(model_id);
+  if (model.max_pending != 0u && model.num_of_pending >= model.max_pending) {
+    model.num_of_rejected++;
+    LOG_IF(INFO, ENV_PARAM(DEBUG_MODEL_SCHEDULER) >= 2)
+        << "request rejected. model=" << model.name
+        << " pending=" << model.num_of_pending;
+    return false;
+  }
+  model.num_of_pending++;
+  model.num_of_admitted++;
+  return true;
+}
+
+void ModelScheduler::retire(int model_id, size_t n) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto& model = find_model(model_id);
+  CHECK_LE(n, model.num_of_pending) << "model=" << model.name;
+  model.num_of_pending -= n;
+}
+
+void ModelScheduler::acquire(int model_id) {
+  auto start = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(mtx_);
+  auto& model = find_model(model_id);
+  if (model.num_of_waiting == 0u && model.num_of_running == 0u) {
+    // a model which has been idle does not accumulate credits.
+    model.vtime = std::max(model.vtime, system_vtime_);
+  }
+  model.num_of_waiting++;
+  cv_.wait(lock, [this, model_id, &model]() {
+    return num_of_free_slots_ > 0u && is_my_turn(model_id, model);
+  });
+  model.num_of_waiting--;
+  model.num_of_running++;
+  num_of_free_slots_--;
+  system_vtime_ = std::max(system_vtime_, model.vtime);
+  // charge the expected cost now, otherwise the same model would win
+  // all free slots until its first batch completes.
+  model.vtime += model.avg_device_time_us / model.weight;
+  model.total_waiting_time_us +=
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count();
+  LOG_IF(INFO, ENV_PARAM(DEBUG_MODEL_SCHEDULER) >= 3)
+      << "slot granted. model=" << model.name << " vtime=" << model.vtime
+      << " free_slots=" << num_of_free_slots_;
+  // other models might still be eligible for the remaining slots.
+  if (num_of_free_slots_ > 0u) {
+    cv_.notify_all();
+  }
+}
+
+void ModelScheduler::release(int model_id,
+                             std::chrono::microseconds device_time) {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto& model = find_model(model_id);
+    CHECK_GT(model.num_of_running, 0u) << "model=" << model.name;
+    auto us = (double)device_time.count();
+    // correct the cost charged in acquire with the observed one.
+    model.vtime += (us - model.avg_device_time_us) / model.weight;
+    model.avg_device_time_us =
+        model.num_of_batches == 0u
+            ? us
+            : model.avg_device_time_us +
+                  EWMA_ALPHA * (us - model.avg_device_time_us);
+    model.num_of_running--;
+    model.num_of_batches++;
+    model.total_device_time_us += (uint64_t)device_time.count();
+    total_device_time_us_ += (uint64_t)device_time.count();
+    num_of_free_slots_++;
+  }
+  cv_.notify_all();
+}
+
+std::string ModelScheduler::stats_as_string() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  std::ostringstream str;
+  str << "slots=" << num_of_slots_ << " free=" << num_of_free_slots_;
+  for (auto& m : models_) {
+    str << "\n\t";
+    dump_model(str, m.second);
+  }
+  return str.str();
+}
+
+ModelScheduler::model_t& ModelScheduler::find_model(int model_id) {
+  auto it = models_.find(model_id);
+  CHECK(it != models_.end()) << "model is not registered. model_id="
+                             << model_id;
+  return it->second;
+}
+
+bool ModelScheduler::is_my_turn(int model_id, const model_t& model) const {
+  for (auto& m : models_) {
+    if (m.first == model_id || m.second.num_of_waiting == 0u) {
+      continue;
+    }
+    // ties are broken by registration order.
+    if (m.second.vtime < model.vtime ||
+        (m.second.vtime == model.vtime && m.first < model_id)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ModelScheduler::dump_model(std::ostream& str, const model_t& model) const {
+  auto share = total_device_time_us_ == 0u
+                   ? 0.0
+                   : 100.0 * (double)model.total_device_time_us /
+                         (double)total_device_time_us_;
+  auto avg_waiting_time_us =
+      model.num_of_batches == 0u
+          ? 0u
+          : model.total_waiting_time_us / model.num_of_batches;
+  str << model.name << ": weight=" << model.weight        //
+      << " admitted=" << model.num_of_admitted            //
+      << " rejected=" << model.num_of_rejected            //
+      << " batches=" << model.num_of_batches              //
+      << " device_time=" << model.total_device_time_us    //
+      << "us share=" << std::fixed << std::setprecision(1) << share << "%"
+      << " avg_run=" << (uint64_t)model.avg_device_time_us << "us"
+      << " avg_wait=" << avg_waiting_time_us << "us";
+}
+
+}  // namespace vart
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace vart {
+
+// A process wide arbiter shared by all async runners.
+//
+// All AsyncRunnerImpl instances in one process share the same thread
+// pool and the same DPU cores. Without an arbiter, each of them
+// dispatches batches greedily and a model with a long latency or a
+// heavy load starves the others.
+//
+// The scheduler owns a fixed number of device slots. A runner must
+// acquire a slot before it dispatches a batch and release it with the
+// observed run duration afterwards. Slots are granted by start-time
+// fair queuing: every model carries a virtual time which advances by
+// device_time / weight, and the waiting model with the smallest
+// virtual time is served first. Because the real cost is only known
+// at release time, the expected cost (a moving average of the observed
+// durations) is charged at acquire time and corrected at release time.
+//
+// Admission control is done with per model pending limits: a request
+// is rejected instead of queued when the model already has
+// `max_pending` requests in flight. Zero means unlimited.
+class ModelScheduler {
+ public:
+  explicit ModelScheduler(size_t num_of_slots);
+  ModelScheduler(const ModelScheduler& other) = delete;
+  ModelScheduler& operator=(const ModelScheduler& rhs) = delete;
+  ~ModelScheduler();
+
+ public:
+  int register_model(const std::string& name, double weight,
+                     size_t max_pending);
+  void unregister_model(int model_id);
+
+  // admission control, return false if the request is rejected.
+  bool admit(int model_id);
+  // `n` admitted requests are completed.
+  void retire(int model_id, size_t n);
+
+  // block until a device slot is granted to the model.
+  void acquire(int model_id);
+  void release(int model_id, std::chrono::microseconds device_time);
+
+  size_t get_num_of_slots() const { return num_of_slots_; }
+  std::string stats_as_string();
+
+ private:
+  struct model_t {
+    std::string name;
+    double weight;
+    size_t max_pending;
+    // virtual time, in microseconds of device time divided by weight.
+    double vtime;
+    // moving average of the observed device time per batch.
+    double avg_device_time_us;
+    size_t num_of_waiting;
+    size_t num_of_running;
+    size_t num_of_pending;
+    // statistics
+    uint64_t num_of_admitted;
+    uint64_t num_of_rejected;
+    uint64_t num_of_batches;
+    uint64_t total_device_time_us;
+    uint64_t total_waiting_time_us;
+  };
+
+ private:
+  model_t& find_model(int model_id);
+  bool is_my_turn(int model_id, const model_t& model) const;
+  void dump_model(std::ostream& str, const model_t& model) const;
+
+ private:
+  const size_t num_of_slots_;
+  size_t num_of_free_slots_;
+  int next_model_id_;
+  // virtual time of the most recent grant, a model becoming active
+  // again starts from here so that idle periods do not earn credits.
+  double system_vtime_;
+  uint64_t total_device_time_us_;
+  std::map<int, model_t> models_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+};
+
+}  // namespace vart
@@ -0,0 +1,382 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// An interception runner which serves repeated inputs from a result
+// cache and merges identical requests in flight into one execution.
+//
+//   attrs->set_attr<std::string>("interception", "libvart-cache-runner.so");
+//
+// attrs:
+//   "result_cache_capacity": max number of cached results, shared by
+//       all runners of the same subgraph. 0 disables the cache but
+//       keeps coalescing. default XLNX_RESULT_CACHE_CAPACITY.
+//   "result_cache_coalesce": merge identical requests in flight,
+//       default true.
+#include <glog/logging.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <xir/graph/subgraph.hpp>
+
+#include "../../runner/src/runner_helper.hpp"
+#include "./result_cache.hpp"
+#include "./xxhash64.hpp"
+#include "vart/runner_ext.hpp"
+#include "vitis/ai/collection_helper.hpp"
+#include "vitis/ai/env_config.hpp"
+#include "vitis/ai/weak.hpp"
+
+DEF_ENV_PARAM(DEBUG_RESULT_CACHE, "0");
+DEF_ENV_PARAM_2(XLNX_RESULT_CACHE_CAPACITY, "64", size_t);
+// compare the inputs byte by byte on a hit, so that a hash collision
+// never returns a wrong result.
+DEF_ENV_PARAM(XLNX_RESULT_CACHE_VERIFY, "1");
+// print the statistics when the runner is destroyed.
+DEF_ENV_PARAM(XLNX_RESULT_CACHE_REPORT, "0");
+
+namespace {
+using namespace vart::cache;
+using init_function_t = vart::Runner* (*)(const xir::Subgraph*, xir::Attrs*);
+
+class CacheRunner : public vart::RunnerExt {
+ public:
+  CacheRunner(init_function_t f, const xir::Subgraph* subgraph,
+              xir::Attrs* attrs);
+  CacheRunner(const CacheRunner& other) = delete;
+  CacheRunner& operator=(const CacheRunner& rhs) = delete;
+  virtual ~CacheRunner();
+
+ public:
+  virtual std::pair<uint32_t, int> execute_async(
+      const std::vector<vart::TensorBuffer*>& input,
+      const std::vector<vart::TensorBuffer*>& output) override;
+  virtual int wait(int jobid, int timeout) override;
+  virtual std::vector<const xir::Tensor*> get_input_tensors() override;
+  virtual std::vector<const xir::Tensor*> get_output_tensors() override;
+  virtual std::vector<vart::TensorBuffer*> get_inputs() override;
+  virtual std::vector<vart::TensorBuffer*> get_outputs() override;
+  virtual int set_run_attrs(std::unique_ptr<xir::Attrs>& attrs) override {
+    auto r = dynamic_cast<vart::RunnerExt*>(runner_.get());
+    return r ? r->set_run_attrs(attrs) : 0;
+  }
+
+ private:
+  // one execution of the wrapped runner, shared by all identical
+  // requests submitted while it is running.
+  struct inflight_t {
+    // false if the buffers cannot be hashed, i.e. a plain pass through.
+    bool cacheable = true;
+    uint64_t key = 0u;
+    // the inputs of the request which triggers the execution, they stay
+    // untouched until it is waited for.
+    views_t inputs;
+    std::pair<uint32_t, int> job;
+    // buffers of the request which triggers the execution.
+    std::vector<vart::TensorBuffer*> outputs;
+    std::chrono::steady_clock::time_point start;
+    // the first waiter waits for the wrapped runner, others wait on
+    // `mtx`.
+    std::mutex mtx;
+    std::atomic<bool> done{false};
+    int ret = 0;
+    std::shared_ptr<const cache_entry_t> result;
+  };
+  struct job_t {
+    // nullptr if served from the cache.
+    std::shared_ptr<inflight_t> inflight;
+    // non-empty if the outputs must be copied from the result.
+    std::vector<vart::TensorBuffer*> outputs;
+  };
+
+  bool is_cacheable(const std::vector<vart::TensorBuffer*>& buffers) const;
+  uint64_t hash(const std::vector<vart::TensorBuffer*>& input,
+                views_t& views) const;
+  int finish(inflight_t* inflight, int timeout);
+  uint32_t add_job(job_t&& job);
+
+ private:
+  std::unique_ptr<vart::Runner> runner_;
+  std::shared_ptr<ResultCache> cache_;
+  const bool coalesce_;
+  std::vector<std::unique_ptr<vart::TensorBuffer>> inputs_;
+  std::vector<std::unique_ptr<vart::TensorBuffer>> outputs_;
+  std::mutex mtx_;
+  std::map<uint64_t, std::shared_ptr<inflight_t>> inflights_;
+  std::map<uint32_t, job_t> jobs_;
+  uint32_t next_job_id_;
+};
+
+static std::shared_ptr<ResultCache> get_result_cache(
+    const xir::Subgraph* subgraph, xir::Attrs* attrs) {
+  static std::mutex mtx;
+  std::lock_guard<std::mutex> lock(mtx);
+  auto capacity = attrs && attrs->has_attr("result_cache_capacity")
+                      ? attrs->get_attr<size_t>("result_cache_capacity")
+                      : ENV_PARAM(XLNX_RESULT_CACHE_CAPACITY);
+  return vitis::ai::WeakStore<const xir::Subgraph*, ResultCache>::create(
+      subgraph, capacity, ENV_PARAM(XLNX_RESULT_CACHE_VERIFY) != 0);
+}
+
+static std::vector<char> to_blob(vart::TensorBuffer* b) {
+  auto data = b->data(vart::get_index_zeros(b->get_tensor()));
+  auto p = (const char*)data.first;
+  return std::vector<char>(p, p + b->get_tensor()->get_data_size());
+}
+
+static blobs_t to_blobs(const views_t& views) {
+  auto ret = blobs_t();
+  ret.reserve(views.size());
+  for (auto& v : views) {
+    ret.emplace_back(v.first, v.first + v.second);
+  }
+  return ret;
+}
+
+static void from_blob(const std::vector<char>& blob, vart::TensorBuffer* b) {
+  auto data = b->data(vart::get_index_zeros(b->get_tensor()));
+  memcpy((void*)data.first, blob.data(), blob.size());
+}
+
+CacheRunner::CacheRunner(init_function_t f, const xir::Subgraph* subgraph,
+                         xir::Attrs* attrs)
+    : runner_{f(subgraph, attrs)},
+      cache_{get_result_cache(subgraph, attrs)},
+      coalesce_{attrs && attrs->has_attr("result_cache_coalesce")
+                    ? attrs->get_attr<bool>("result_cache_coalesce")
+                    : true},
+      inputs_{},
+      outputs_{},
+      mtx_{},
+      inflights_{},
+      jobs_{},
+      next_job_id_{0u} {
+  if (dynamic_cast<vart::RunnerExt*>(runner_.get()) == nullptr) {
+    inputs_ = vart::alloc_cpu_flat_tensor_buffers(runner_->get_input_tensors());
+    outputs_ =
+        vart::alloc_cpu_flat_tensor_buffers(runner_->get_output_tensors());
+  }
+  LOG_IF(INFO, ENV_PARAM(DEBUG_RESULT_CACHE))
+      << "cache runner created for " << subgraph->get_name()
+      << " coalesce=" << coalesce_;
+}
+
+CacheRunner::~CacheRunner() {
+  LOG_IF(INFO, ENV_PARAM(DEBUG_RESULT_CACHE) ||
+                   ENV_PARAM(XLNX_RESULT_CACHE_REPORT))
+      << "result cache: " << cache_->stats_as_string();
+}
+
+// only plain host buffers which hold the whole tensor contiguously can
+// be hashed and copied.
+bool CacheRunner::is_cacheable(
+    const std::vector<vart::TensorBuffer*>& buffers) const {
+  for (auto b : buffers) {
+    if (b->get_location() != vart::TensorBuffer::location_t::HOST_VIRT) {
+      return false;
+    }
+    auto data = b->data(vart::get_index_zeros(b->get_tensor()));
+    if (data.first == 0u ||
+        data.second < (size_t)b->get_tensor()->get_data_size()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// the inputs are hashed in place, they are only copied when a result
+// is cached and the cache verifies hits.
+uint64_t CacheRunner::hash(const std::vector<vart::TensorBuffer*>& input,
+                           views_t& views) const {
+  auto start = std::chrono::steady_clock::now();
+  auto h = (uint64_t)0u;
+  auto bytes = (uint64_t)0u;
+  views.reserve(input.size());
+  for (auto b : input) {
+    auto data = b->data(vart::get_index_zeros(b->get_tensor()));
+    auto size = (size_t)b->get_tensor()->get_data_size();
+    h = XXHash64::hash((const void*)data.first, size, h);
+    views.emplace_back((const char*)data.first, size);
+    bytes += size;
+  }
+  cache_->count_hash((uint64_t)std::chrono::duration_cast<
+                         std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - start)
+                         .count(),
+                     bytes);
+  return h;
+}
+
+uint32_t CacheRunner::add_job(job_t&& job) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto id = next_job_id_++;
+  jobs_.emplace(id, std::move(job));
+  return id;
+}
+
+std::pair<uint32_t, int> CacheRunner::execute_async(
+    const std::vector<vart::TensorBuffer*>& input,
+    const std::vector<vart::TensorBuffer*>& output) {
+  cache_->count_request();
+  if (!is_cacheable(input) || !is_cacheable(output)) {
+    cache_->count_miss();
+    auto job = job_t();
+    job.inflight = std::make_shared<inflight_t>();
+    job.inflight->cacheable = false;
+    job.inflight->start = std::chrono::steady_clock::now();
+    job.inflight->job = runner_->execute_async(input, output);
+    if (job.inflight->job.second != 0) {
+      return job.inflight->job;
+    }
+    return std::make_pair(add_job(std::move(job)), 0);
+  }
+  auto views = views_t();
+  auto key = hash(input, views);
+  auto entry = cache_->lookup(key, views);
+  if (entry != nullptr) {
+    for (auto i = 0u; i < output.size(); ++i) {
+      from_blob(entry->outputs[i], output[i]);
+    }
+    cache_->count_hit(entry->device_time);
+    LOG_IF(INFO, ENV_PARAM(DEBUG_RESULT_CACHE) >= 2)
+        << "hit. key=" << std::hex << key;
+    return std::make_pair(add_job(job_t()), 0);
+  }
+  std::unique_lock<std::mutex> lock(mtx_);
+  auto it = coalesce_ ? inflights_.find(key) : inflights_.end();
+  if (it != inflights_.end() && same_bytes(it->second->inputs, views)) {
+    auto job = job_t{it->second, output};
+    lock.unlock();
+    LOG_IF(INFO, ENV_PARAM(DEBUG_RESULT_CACHE) >= 2)
+        << "coalesced. key=" << std::hex << key;
+    return std::make_pair(add_job(std::move(job)), 0);
+  }
+  auto inflight = std::make_shared<inflight_t>();
+  inflight->key = key;
+  inflight->inputs = std::move(views);
+  inflight->outputs = output;
+  inflight->start = std::chrono::steady_clock::now();
+  inflight->job = runner_->execute_async(input, output);
+  if (inflight->job.second != 0) {
+    return inflight->job;
+  }
+  if (coalesce_) {
+    inflights_[key] = inflight;
+  }
+  lock.unlock();
+  cache_->count_miss();
+  return std::make_pair(add_job(job_t{inflight, {}}), 0);
+}
+
+int CacheRunner::finish(inflight_t* inflight, int timeout) {
+  std::lock_guard<std::mutex> lock(inflight->mtx);
+  if (inflight->done) {
+    return inflight->ret;
+  }
+  auto ret = runner_->wait((int)inflight->job.first, timeout);
+  if (ret != 0 && timeout != -1) {
+    // not finished yet, the next wait tries again.
+    return ret;
+  }
+  inflight->ret = ret;
+  inflight->done = true;
+  if (!inflight->cacheable) {
+    return ret;
+  }
+  auto entry = std::make_shared<cache_entry_t>();
+  if (ret == 0) {
+    entry->key = inflight->key;
+    entry->device_time =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - inflight->start);
+    for (auto b : inflight->outputs) {
+      entry->outputs.emplace_back(to_blob(b));
+    }
+    if (cache_->verify()) {
+      entry->inputs = to_blobs(inflight->inputs);
+    }
+    inflight->result = entry;
+  }
+  // publish the result before retiring the request, so that no
+  // identical request misses both.
+  std::lock_guard<std::mutex> lock_for_inflights(mtx_);
+  if (ret == 0) {
+    cache_->insert(entry);
+  }
+  auto it = inflights_.find(inflight->key);
+  if (it != inflights_.end() && it->second.get() == inflight) {
+    inflights_.erase(it);
+  }
+  return ret;
+}
+
+int CacheRunner::wait(int jobid, int timeout) {
+  job_t* job = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = jobs_.find((uint32_t)jobid);
+    if (it == jobs_.end()) {
+      return -1;
+    }
+    job = &it->second;
+  }
+  auto ret = 0;
+  if (job->inflight != nullptr) {
+    ret = finish(job->inflight.get(), timeout);
+    if (ret != 0 && timeout != -1 && !job->inflight->done) {
+      return ret;
+    }
+    if (ret == 0 && !job->outputs.empty()) {
+      auto& result = job->inflight->result;
+      for (auto i = 0u; i < job->outputs.size(); ++i) {
+        from_blob(result->outputs[i], job->outputs[i]);
+      }
+      cache_->count_coalesced(result->device_time);
+    }
+  }
+  std::lock_guard<std::mutex> lock(mtx_);
+  jobs_.erase((uint32_t)jobid);
+  return ret;
+}
+
+std::vector<const xir::Tensor*> CacheRunner::get_input_tensors() {
+  return runner_->get_input_tensors();
+}
+
+std::vector<const xir::Tensor*> CacheRunner::get_output_tensors() {
+  return runner_->get_output_tensors();
+}
+
+std::vector<vart::TensorBuffer*> CacheRunner::get_inputs() {
+  auto r = dynamic_cast<vart::RunnerExt*>(runner_.get());
+  return r ? r->get_inputs() : vitis::ai::vector_unique_ptr_get(inputs_);
+}
+
+std::vector<vart::TensorBuffer*> CacheRunner::get_outputs() {
+  auto r = dynamic_cast<vart::RunnerExt*>(runner_.get());
+  return r ? r->get_outputs() : vitis::ai::vector_unique_ptr_get(outputs_);
+}
+
+}  // namespace
+
+extern "C" vart::Runner* create_runner_with_attrs(init_function_t f,
+                                                  const xir::Subgraph* subgraph,
+                                                  xir::Attrs* attrs) {
+  return new CacheRunner(f, subgraph, attrs);
+}
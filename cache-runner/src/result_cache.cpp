@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "./result_cache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace vart {
+namespace cache {
+
+views_t to_views(const blobs_t& blobs) {
+  auto ret = views_t();
+  ret.reserve(blobs.size());
+  for (auto& b : blobs) {
+    ret.emplace_back(b.data(), b.size());
+  }
+  return ret;
+}
+
+bool same_bytes(const views_t& a, const views_t& b) {
+  return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                    [](const views_t::value_type& x,
+                       const views_t::value_type& y) {
+                      return x.second == y.second &&
+                             memcmp(x.first, y.first, x.second) == 0;
+                    });
+}
+
+ResultCache::ResultCache(size_t capacity, bool verify)
+    : capacity_{capacity}, verify_{verify} {}
+
+std::shared_ptr<const cache_entry_t> ResultCache::lookup(
+    uint64_t key, const views_t& inputs) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return nullptr;
+  }
+  auto entry = *it->second;
+  if (verify_ && !same_bytes(to_views(entry->inputs), inputs)) {
+    stats_.num_of_collisions++;
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return entry;
+}
+
+void ResultCache::insert(std::shared_ptr<const cache_entry_t> entry) {
+  if (capacity_ == 0u) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = index_.find(entry->key);
+  if (it != index_.end()) {
+    lru_.erase(it->second);
+    index_.erase(it);
+  }
+  lru_.push_front(std::move(entry));
+  index_[lru_.front()->key] = lru_.begin();
+  while (lru_.size() > capacity_) {
+    index_.erase(lru_.back()->key);
+    lru_.pop_back();
+    stats_.num_of_evictions++;
+  }
+}
+
+void ResultCache::count_hit(std::chrono::microseconds saved) {
+  stats_.num_of_hits++;
+  stats_.saved_device_time_us += (uint64_t)saved.count();
+}
+
+void ResultCache::count_coalesced(std::chrono::microseconds saved) {
+  stats_.num_of_coalesced++;
+  stats_.saved_device_time_us += (uint64_t)saved.count();
+}
+
+void ResultCache::count_hash(uint64_t ns, uint64_t bytes) {
+  stats_.hash_time_ns += ns;
+  stats_.hashed_bytes += bytes;
+}
+
+cache_stats_t ResultCache::get_stats() const {
+  auto ret = cache_stats_t();
+  ret.num_of_requests = stats_.num_of_requests;
+  ret.num_of_hits = stats_.num_of_hits;
+  ret.num_of_coalesced = stats_.num_of_coalesced;
+  ret.num_of_misses = stats_.num_of_misses;
+  ret.num_of_collisions = stats_.num_of_collisions;
+  ret.num_of_evictions = stats_.num_of_evictions;
+  ret.hash_time_ns = stats_.hash_time_ns;
+  ret.hashed_bytes = stats_.hashed_bytes;
+  ret.saved_device_time_us = stats_.saved_device_time_us;
+  return ret;
+}
+
+std::string ResultCache::stats_as_string() const {
+  auto s = get_stats();
+  auto requests = std::max<uint64_t>(s.num_of_requests, 1u);
+  std::ostringstream str;
+  str << std::fixed << std::setprecision(2)  //
+      << "requests=" << s.num_of_requests    //
+      << " hits=" << s.num_of_hits           //
+      << " coalesced=" << s.num_of_coalesced  //
+      << " misses=" << s.num_of_misses       //
+      << " hit_rate="
+      << 100.0 * (s.num_of_hits + s.num_of_coalesced) / requests << "%"
+      << " collisions=" << s.num_of_collisions   //
+      << " evictions=" << s.num_of_evictions     //
+      << " hash_time=" << s.hash_time_ns / 1000u << "us"
+      << " (" << (double)s.hash_time_ns / requests / 1000.0 << "us/request, "
+      << (s.hash_time_ns == 0u ? 0.0
+                               : (double)s.hashed_bytes / s.hash_time_ns)
+      << "GB/s)"
+      << " saved_device_time=" << s.saved_device_time_us << "us";
+  return str.str();
+}
+
+}  // namespace cache
+}  // namespace vart
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vart {
+namespace cache {
+
+// raw bytes of all input or output tensors of one request.
+using blobs_t = std::vector<std::vector<char>>;
+// the same bytes, where they are, e.g. in the tensor buffers of a request.
+using views_t = std::vector<std::pair<const char*, size_t>>;
+
+views_t to_views(const blobs_t& blobs);
+bool same_bytes(const views_t& a, const views_t& b);
+
+struct cache_entry_t {
+  uint64_t key;
+  // empty unless the cache verifies hits.
+  blobs_t inputs;
+  blobs_t outputs;
+  // how long the wrapped runner took to produce the outputs.
+  std::chrono::microseconds device_time;
+};
+
+struct cache_stats_t {
+  uint64_t num_of_requests;
+  uint64_t num_of_hits;
+  uint64_t num_of_coalesced;
+  uint64_t num_of_misses;
+  // hash collisions, i.e. the key matches but the inputs do not.
+  uint64_t num_of_collisions;
+  uint64_t num_of_evictions;
+  uint64_t hash_time_ns;
+  uint64_t hashed_bytes;
+  uint64_t saved_device_time_us;
+};
+
+// A bounded LRU map from the hash of the inputs to the outputs. It is
+// shared by all cache runners of the same subgraph.
+class ResultCache {
+ public:
+  explicit ResultCache(size_t capacity, bool verify);
+  ResultCache(const ResultCache& other) = delete;
+  ResultCache& operator=(const ResultCache& rhs) = delete;
+
+ public:
+  // return nullptr if not found. When `verify` is on, the stored inputs
+  // are compared with `inputs` so that a hash collision is a miss.
+  std::shared_ptr<const cache_entry_t> lookup(uint64_t key,
+                                              const views_t& inputs);
+  void insert(std::shared_ptr<const cache_entry_t> entry);
+  bool verify() const { return verify_; }
+
+  void count_request() { stats_.num_of_requests++; }
+  void count_hit(std::chrono::microseconds saved);
+  void count_coalesced(std::chrono::microseconds saved);
+  void count_miss() { stats_.num_of_misses++; }
+  void count_hash(uint64_t ns, uint64_t bytes);
+
+  cache_stats_t get_stats() const;
+  std::string stats_as_string() const;
+
+ private:
+  using lru_t = std::list<std::shared_ptr<const cache_entry_t>>;
+  const size_t capacity_;
+  const bool verify_;
+  mutable std::mutex mtx_;
+  // most recently used first.
+  lru_t lru_;
+  std::unordered_map<uint64_t, lru_t::iterator> index_;
+  struct {
+    std::atomic<uint64_t> num_of_requests{0};
+    std::atomic<uint64_t> num_of_hits{0};
+    std::atomic<uint64_t> num_of_coalesced{0};
+    std::atomic<uint64_t> num_of_misses{0};
+    std::atomic<uint64_t> num_of_collisions{0};
+    std::atomic<uint64_t> num_of_evictions{0};
+    std::atomic<uint64_t> hash_time_ns{0};
+    std::atomic<uint64_t> hashed_bytes{0};
+    std::atomic<uint64_t> saved_device_time_us{0};
+  } stats_;
+};
+
+}  // namespace cache
+}  // namespace vart
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+// A small implementation of the XXH64 algorithm. It produces the same
+// digest as the reference implementation, processes 32 bytes per round
+// in four independent lanes, and needs no dependency.
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace vart {
+namespace cache {
+
+class XXHash64 {
+ public:
+  static uint64_t hash(const void* data, size_t size, uint64_t seed = 0u) {
+    auto p = (const unsigned char*)data;
+    auto end = p + size;
+    uint64_t h = 0u;
+    if (size >= 32u) {
+      uint64_t v1 = seed + PRIME1 + PRIME2;
+      uint64_t v2 = seed + PRIME2;
+      uint64_t v3 = seed;
+      uint64_t v4 = seed - PRIME1;
+      auto limit = end - 32;
+      do {
+        v1 = round(v1, read64(p));
+        v2 = round(v2, read64(p + 8));
+        v3 = round(v3, read64(p + 16));
+        v4 = round(v4, read64(p + 24));
+        p += 32;
+      } while (p <= limit);
+      h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+      h = merge_round(h, v1);
+      h = merge_round(h, v2);
+      h = merge_round(h, v3);
+      h = merge_round(h, v4);
+    } else {
+      h = seed + PRIME5;
+    }
+    h += (uint64_t)size;
+    for (; p + 8 <= end; p += 8) {
+      h ^= round(0u, read64(p));
+      h = rotl(h, 27) * PRIME1 + PRIME4;
+    }
+    if (p + 4 <= end) {
+      h ^= (uint64_t)read32(p) * PRIME1;
+      h = rotl(h, 23) * PRIME2 + PRIME3;
+      p += 4;
+    }
+    for (; p < end; ++p) {
+      h ^= (*p) * PRIME5;
+      h = rotl(h, 11) * PRIME1;
+    }
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    return h;
+  }
+
+ private:
+  static constexpr uint64_t PRIME1 = 11400714785074694791ULL;
+  static constexpr uint64_t PRIME2 = 14029467366897019727ULL;
+  static constexpr uint64_t PRIME3 = 1609587929392839161ULL;
+  static constexpr uint64_t PRIME4 = 9650029242287828579ULL;
+  static constexpr uint64_t PRIME5 = 2870177450012600261ULL;
+
+  static uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+  static uint64_t read64(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+  static uint32_t read32(const unsigned char* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+  static uint64_t round(uint64_t acc, uint64_t input) {
+    acc += input * PRIME2;
+    acc = rotl(acc, 31);
+    return acc * PRIME1;
+  }
+  static uint64_t merge_round(uint64_t acc, uint64_t val) {
+    acc ^= round(0u, val);
+    return acc * PRIME1 + PRIME4;
+  }
+};
+
+}  // namespace cache
+}  // namespace vart
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// run the first DPU subgraph of an xmodel with and without the result
+// cache. NUM_OF_FRAMES frames cycle through NUM_OF_PATTERNS distinct
+// inputs, NUM_OF_INFLIGHT frames are submitted before waiting, so that
+// identical frames in flight are coalesced. Outputs must be identical.
+//
+// usage: env MODE=ref test_cache_runner <xmodel>
+
+#include <glog/logging.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <xir/graph/graph.hpp>
+
+#include "../../runner/src/runner_helper.hpp"
+#include "vart/runner.hpp"
+#include "vitis/ai/collection_helper.hpp"
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM(NUM_OF_FRAMES, "64");
+DEF_ENV_PARAM(NUM_OF_PATTERNS, "4");
+DEF_ENV_PARAM(NUM_OF_INFLIGHT, "4");
+DEF_ENV_PARAM_2(MODE, "ref", std::string);
+using namespace std;
+
+using buffers_t = vector<unique_ptr<vart::TensorBuffer>>;
+
+static void fill_inputs(buffers_t& inputs, int pattern) {
+  for (auto& b : inputs) {
+    auto size = b->get_tensor()->get_data_size();
+    auto data = (char*)b->data(vart::get_index_zeros(b->get_tensor())).first;
+    for (decltype(size) i = 0; i < size; ++i) {
+      data[i] = (char)((i * 7 + pattern * 13) & 0x3f);
+    }
+  }
+}
+
+static vector<buffers_t> run(const xir::Subgraph* subgraph, bool cached) {
+  auto attrs = xir::Attrs::create();
+  attrs->set_attr<std::string>("mode", ENV_PARAM(MODE));
+  if (cached) {
+    attrs->set_attr<std::string>("interception", "libvart-cache-runner.so");
+  }
+  auto runner = vart::Runner::create_runner_with_attrs(subgraph, attrs.get());
+  auto num_of_frames = (size_t)ENV_PARAM(NUM_OF_FRAMES);
+  auto num_of_inflight = (size_t)ENV_PARAM(NUM_OF_INFLIGHT);
+  auto inputs = vector<buffers_t>(num_of_frames);
+  auto outputs = vector<buffers_t>(num_of_frames);
+  for (auto i = 0u; i < num_of_frames; ++i) {
+    inputs[i] =
+        vart::alloc_cpu_flat_tensor_buffers(runner->get_input_tensors());
+    outputs[i] =
+        vart::alloc_cpu_flat_tensor_buffers(runner->get_output_tensors());
+    // consecutive frames share a pattern, so that they are in flight
+    // together.
+    fill_inputs(inputs[i],
+                (int)((i / num_of_inflight) % ENV_PARAM(NUM_OF_PATTERNS)));
+  }
+  auto jobs = vector<int>(num_of_frames);
+  auto start = chrono::steady_clock::now();
+  for (auto i = 0u; i < num_of_frames; i += num_of_inflight) {
+    auto end = std::min(num_of_frames, i + num_of_inflight);
+    for (auto j = i; j < end; ++j) {
+      auto job =
+          runner->execute_async(vitis::ai::vector_unique_ptr_get(inputs[j]),
+                                vitis::ai::vector_unique_ptr_get(outputs[j]));
+      CHECK_EQ(job.second, 0) << "cannot submit frame " << j;
+      jobs[j] = (int)job.first;
+    }
+    for (auto j = i; j < end; ++j) {
+      CHECK_EQ(runner->wait(jobs[j], -1), 0);
+    }
+  }
+  auto us = chrono::duration_cast<chrono::microseconds>(
+                chrono::steady_clock::now() - start)
+                .count();
+  cout << (cached ? "cached" : "plain") << ": " << num_of_frames
+       << " frames in " << us << "us, fps=" << fixed << setprecision(2)
+       << num_of_frames * 1e6 / us << endl;
+  return outputs;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout << "usage: " << argv[0] << " <xmodel>" << endl;
+    return 1;
+  }
+  // the cache runner prints hit rate, hash cost and saved device time
+  // when it is destroyed.
+  setenv("XLNX_RESULT_CACHE_REPORT", "1", 0);
+  auto graph = xir::Graph::deserialize(argv[1]);
+  const xir::Subgraph* subgraph = nullptr;
+  for (auto s : graph->get_root_subgraph()->children_topological_sort()) {
+    if (s->has_attr("device") && s->get_attr<std::string>("device") == "DPU") {
+      subgraph = s;
+      break;
+    }
+  }
+  CHECK(subgraph != nullptr) << "cannot find a DPU subgraph in " << argv[1];
+  auto plain = run(subgraph, false);
+  auto cached = run(subgraph, true);
+  auto ok = true;
+  for (auto i = 0u; i < plain.size(); ++i) {
+    for (auto j = 0u; j < plain[i].size(); ++j) {
+      auto size = plain[i][j]->get_tensor()->get_data_size();
+      auto a =
+          plain[i][j]->data(vart::get_index_zeros(plain[i][j]->get_tensor()));
+      auto b = cached[i][j]->data(
+          vart::get_index_zeros(cached[i][j]->get_tensor()));
+      if (memcmp((void*)a.first, (void*)b.first, size) != 0) {
+        LOG(ERROR) << "output mismatch. frame=" << i
+                   << " tensor=" << plain[i][j]->get_tensor()->get_name();
+        ok = false;
+      }
+    }
+  }
+  cout << (ok ? "PASS" : "FAIL") << endl;
+  return ok ? 0 : 1;
+}
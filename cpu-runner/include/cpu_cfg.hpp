@@ -49,6 +49,9 @@ enum class CPURunMode : int {
   NORMAL_THREAD = 1,
   GEMM = 2,
   GEMM_THREAD = 3,
+  // GEMM_THREAD, and ops which do not depend on each other run at the
+  // same time, see OPSchedule
+  GRAPH_THREAD = 4,
   PRINT_PARAM = 10,
   CHECK_PARAM = 11,
   WORKLOAD = 12,
@@ -84,7 +87,10 @@ class CPUCfg {
 
   string get_xmodel_run_mode_str() const;
   XModelRunMode get_xmodel_run_mode() const { return xmodel_run_mode_; }
+  // GRAPH_THREAD reads as GEMM_THREAD here, op kernels do not care how
+  // ops are scheduled, see get_graph_thread()
   CPURunMode get_cpu_run_mode() const { return cpu_run_mode_; }
+  bool get_graph_thread() const { return graph_thread_; }
 
   bool get_save_bin() const { return save_bin_; }
   bool get_save_txt() const { return save_txt_; }
@@ -98,7 +104,7 @@ class CPUCfg {
   void set_input_random_seed(uint64_t input_random_seed) { input_random_seed_ = input_random_seed; }
 
   void set_xmodel_run_mode(const string& xmodel_run_mode_str);
-  void set_cpu_run_mode(CPURunMode cpu_run_mode) { cpu_run_mode_ = cpu_run_mode; }
+  void set_cpu_run_mode(CPURunMode cpu_run_mode);
   void set_cpu_run_mode(int cpu_run_mode);
 
   void set_save_bin(bool save_bin) { save_bin_ = save_bin; }
@@ -127,6 +133,7 @@ class CPUCfg {
 
   XModelRunMode xmodel_run_mode_{vart::cpu::XModelRunMode::CPU};
   CPURunMode cpu_run_mode_;
+  bool graph_thread_;
 
   bool save_bin_;
   bool save_txt_;
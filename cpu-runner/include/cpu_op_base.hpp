@@ -60,8 +60,28 @@ class CPUOPBase {
   virtual void read() {}
   virtual void save();
 
+  // called once when the runner is created, after the const ops ran, to
+  // do work which is the same in every run, e.g. packing weights
+  virtual void prepare() {}
+
   virtual uint64_t get_workload() { return 0; }
 
+  // A pointwise op may be fused into the op which writes its input, see
+  // CPURunner::fuse_ops(). That op then writes the output of the fused
+  // op instead of its own, and calls run_fused() on every part of it as
+  // soon as the part is computed, so the fused op does not make another
+  // pass over memory and is not run itself.
+  //
+  // whether output element i only depends on input element i
+  virtual bool is_pointwise() const { return false; }
+  // this op over elements [begin, end) of `data`, in place
+  virtual void run_pointwise(void* data, int64_t begin, int64_t end) {}
+  // whether run() calls run_fused() on all of the output
+  virtual bool can_fuse_pointwise() const { return false; }
+
+  void fuse(CPUOPBase* op);
+  CPUOPBase* get_fused_into() const { return fused_into_; }
+
   // useful routines to get op basic information
  public:
   const xir::Subgraph* get_xir_subg() const { return xir_subg_; }
@@ -75,6 +95,11 @@ class CPUOPBase {
   string get_output_tensor_name() const { return output_tensor_->get_name(); }
   string get_data_type() const { return get_data_type_str(output_tensor_); }
 
+ protected:
+  // the fused ops over elements [begin, end) of the output
+  void run_fused(void* data, int64_t begin, int64_t end);
+  bool has_fused() const { return !fused_ops_.empty(); }
+
  protected:
   const xir::Subgraph* xir_subg_{nullptr};
   const xir::Op* xir_op_{nullptr};
@@ -90,6 +115,9 @@ class CPUOPBase {
   string round_mode_;
 
   uint64_t ops_{0};
+
+  std::vector<CPUOPBase*> fused_ops_;
+  CPUOPBase* fused_into_{nullptr};
 };
 
 // Returns a value of type T by reinterpretting the representation of the input
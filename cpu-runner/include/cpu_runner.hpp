@@ -43,6 +43,8 @@ class CPURunner : public RunnerExt {
 
  public:
   void create_ops_and_tbs();
+  void fuse_ops();
+  void prepare_ops();
   virtual std::pair<uint32_t, int>  // pair<jodid, status>
   execute_async(
       const std::vector<TensorBuffer*>& sbug_input_tbs,
@@ -66,6 +66,7 @@ class CPUTensorBuffer : public TensorBuffer {
   virtual std::pair<uint64_t, size_t> data(
       const std::vector<std::int32_t> index = {}) override final;
 
+  // use memory owned by someone else, the internal buffer is freed
   void set_data_ptr(void* ptr);
   void copy_data_in(char* in);
   void copy_data_out(char* out);
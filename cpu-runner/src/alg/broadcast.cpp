@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "broadcast.hpp"
+
+#include <glog/logging.h>
+
+#include <vitis/ai/env_config.hpp>
+
+DEF_ENV_PARAM(DEBUG_CPU_RUNNER_ELTWISE, "0");
+
+namespace vart {
+namespace cpu {
+
+int64_t Broadcast::input_num(size_t i) const {
+  int64_t n = 1;
+  for (auto d = 0u; d < dims.size(); ++d) {
+    if (strides[i][d] != 0) {
+      n *= dims[d];
+    }
+  }
+  return n;
+}
+
+int64_t Broadcast::input_pos(size_t i, int64_t pos) const {
+  int64_t in_pos = 0;
+  for (auto d = dims.size(); d-- > 0u;) {
+    in_pos += (pos % dims[d]) * strides[i][d];
+    pos /= dims[d];
+  }
+  return in_pos;
+}
+
+Broadcast make_broadcast(const std::vector<int>& out,
+                         const std::vector<std::vector<int>>& in) {
+  Broadcast bc;
+  auto ni = in.size();
+  auto nd = out.size();
+  // dim d of input i, aligned at the innermost dim
+  auto in_dim = [&](size_t i, size_t d) {
+    auto offset = nd - in[i].size();
+    return d < offset ? 1 : in[i][d - offset];
+  };
+  for (auto i = 0u; i < ni; ++i) {
+    CHECK_LE(in[i].size(), nd) << "input " << i << " has more dims";
+    for (auto d = 0u; d < nd; ++d) {
+      CHECK(in_dim(i, d) == out[d] || in_dim(i, d) == 1)
+          << "input " << i << " dim " << d << " is " << in_dim(i, d)
+          << ", it does not broadcast to " << out[d];
+    }
+  }
+
+  // merge from the innermost dim, a dim joins the previous one if every
+  // input broadcasts along both or along neither
+  std::vector<std::vector<bool>> full(ni);
+  for (auto d = nd; d-- > 0u;) {
+    if (out[d] == 1) {
+      continue;
+    }
+    auto merge = !bc.dims.empty();
+    for (auto i = 0u; i < ni && merge; ++i) {
+      merge = full[i].back() == (in_dim(i, d) != 1);
+    }
+    if (merge) {
+      bc.dims.back() *= out[d];
+    } else {
+      bc.dims.push_back(out[d]);
+      for (auto i = 0u; i < ni; ++i) {
+        full[i].push_back(in_dim(i, d) != 1);
+      }
+    }
+  }
+  if (bc.dims.empty()) {
+    bc.dims.push_back(1);
+    for (auto i = 0u; i < ni; ++i) {
+      full[i].push_back(false);
+    }
+  }
+  std::reverse(bc.dims.begin(), bc.dims.end());
+  bc.num = 1;
+  for (auto dim : bc.dims) {
+    bc.num *= dim;
+  }
+
+  auto nm = bc.dims.size();
+  bc.strides.assign(ni, std::vector<int64_t>(nm, 0));
+  for (auto i = 0u; i < ni; ++i) {
+    std::reverse(full[i].begin(), full[i].end());
+    int64_t stride = 1;
+    auto num_of_full = 0u;
+    for (auto d = nm; d-- > 0u;) {
+      if (full[i][d]) {
+        bc.strides[i][d] = stride;
+        stride *= bc.dims[d];
+        num_of_full++;
+      }
+    }
+    auto kind = Broadcast::GENERAL;
+    if (num_of_full == nm) {
+      kind = Broadcast::SAME;
+    } else if (num_of_full == 0u) {
+      kind = Broadcast::SCALAR;
+    } else if (num_of_full == 1u) {
+      kind = full[i][nm - 1] ? Broadcast::ROW : Broadcast::CHANNEL;
+    }
+    bc.kinds.push_back(kind);
+  }
+  return bc;
+}
+
+const char* get_broadcast_kind_name(Broadcast::Kind kind) {
+  switch (kind) {
+    case Broadcast::SAME:
+      return "same";
+    case Broadcast::SCALAR:
+      return "scalar";
+    case Broadcast::ROW:
+      return "row";
+    case Broadcast::CHANNEL:
+      return "channel";
+    default:
+      return "general";
+  }
+}
+
+ElementwiseProfile::ElementwiseProfile(const std::string& name,
+                                       const Broadcast& bc,
+                                       const std::vector<size_t>& elem_sizes)
+    : enabled_(ENV_PARAM(DEBUG_CPU_RUNNER_ELTWISE)), bc_(bc) {
+  if (!enabled_) {
+    return;
+  }
+  name_ = name;
+  auto i = 0u;
+  for (auto size : elem_sizes) {
+    bytes_ += size * (i < bc.kinds.size() ? bc.input_num(i) : bc.num);
+    i++;
+  }
+  start_ = std::chrono::steady_clock::now();
+}
+
+ElementwiseProfile::~ElementwiseProfile() {
+  if (!enabled_) {
+    return;
+  }
+  auto us = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start_)
+                .count();
+  std::string kinds;
+  for (auto kind : bc_.kinds) {
+    kinds += kinds.empty() ? "" : ",";
+    kinds += get_broadcast_kind_name(kind);
+  }
+  LOG(INFO) << "eltwise " << name_ << " " << bc_.num << " elements in "
+            << bc_.dims.size() << " loops (" << kinds << "), " << bytes_
+            << " bytes, " << us << "us, " << bytes_ / us / 1e3 << " GB/s";
+}
+
+}  // namespace cpu
+}  // namespace vart
@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "thread_pool.hpp"
+
+namespace vart {
+namespace cpu {
+
+// Loops of an elementwise op whose inputs broadcast to its output.
+//
+// Inputs are aligned with the output at the innermost dim, missing outer
+// dims are 1, and every other dim is either the one of the output or 1.
+// Dims which are 1 in the output are dropped, and neighbouring dims are
+// merged if every input broadcasts along both or along neither of them,
+// so [N, H, W, C] + [1, 1, 1, C] runs as [N * H * W, C] + [1, C], and two
+// inputs of the same shape as one dim.
+struct Broadcast {
+  // how an input maps to the merged dims
+  enum Kind {
+    SAME,     // the shape of the output
+    SCALAR,   // one value
+    ROW,      // one row of the innermost dim, e.g. a bias of NHWC
+    CHANNEL,  // one value per index of an outer dim, e.g. a bias of NCHW
+    GENERAL,
+  };
+
+  // merged dims of the output, at least one
+  std::vector<int64_t> dims;
+  // strides[i][d] of input i along dims[d], 0 where it broadcasts, so the
+  // innermost one is 0 or 1
+  std::vector<std::vector<int64_t>> strides;
+  std::vector<Kind> kinds;
+  int64_t num = 0;
+
+  // number of elements of input i
+  int64_t input_num(size_t i) const;
+  // position in input i of output element `pos`
+  int64_t input_pos(size_t i, int64_t pos) const;
+};
+
+Broadcast make_broadcast(const std::vector<int>& out,
+                         const std::vector<std::vector<int>>& in);
+const char* get_broadcast_kind_name(Broadcast::Kind kind);
+
+// call f(pos, in_pos, in_step, len) for the runs along the innermost dim
+// which cover output elements [begin, end): output pos + j, j < len, is
+// computed from input i at in_pos[i] + j * in_step[i], the steps are 0 or
+// 1.
+template <typename F>
+void for_each_run(const Broadcast& bc, int64_t begin, int64_t end, F&& f) {
+  if (begin >= end) {
+    return;
+  }
+  auto nd = bc.dims.size();
+  auto ni = bc.strides.size();
+  std::vector<int64_t> coord(nd), in_pos(ni, 0), in_step(ni);
+  auto rem = begin;
+  for (auto d = nd; d-- > 0u;) {
+    coord[d] = rem % bc.dims[d];
+    rem /= bc.dims[d];
+  }
+  for (auto i = 0u; i < ni; ++i) {
+    for (auto d = 0u; d < nd; ++d) {
+      in_pos[i] += coord[d] * bc.strides[i][d];
+    }
+    in_step[i] = bc.strides[i][nd - 1];
+  }
+
+  auto inner = bc.dims[nd - 1];
+  for (auto pos = begin;;) {
+    auto len = std::min(inner - coord[nd - 1], end - pos);
+    f(pos, in_pos.data(), in_step.data(), len);
+    pos += len;
+    if (pos >= end) {
+      break;
+    }
+    // to the start of the next row
+    for (auto i = 0u; i < ni; ++i) {
+      in_pos[i] -= coord[nd - 1] * in_step[i];
+    }
+    coord[nd - 1] = 0;
+    for (auto d = nd - 1; d-- > 0u;) {
+      for (auto i = 0u; i < ni; ++i) {
+        in_pos[i] += bc.strides[i][d];
+      }
+      if (++coord[d] < bc.dims[d]) {
+        break;
+      }
+      for (auto i = 0u; i < ni; ++i) {
+        in_pos[i] -= bc.dims[d] * bc.strides[i][d];
+      }
+      coord[d] = 0;
+    }
+  }
+}
+
+// c = op(a, b) for output elements [begin, end) of a two input broadcast.
+// The inner loops have unit or zero strides, so the compiler vectorizes
+// them.
+template <typename TA, typename TB, typename TC, typename Op>
+void broadcast_binary(const Broadcast& bc, const TA* a, const TB* b, TC* c,
+                      int64_t begin, int64_t end, Op op) {
+  for_each_run(bc, begin, end,
+               [&](int64_t pos, const int64_t* in_pos, const int64_t* in_step,
+                   int64_t len) {
+                 auto* pc = c + pos;
+                 const auto* pa = a + in_pos[0];
+                 const auto* pb = b + in_pos[1];
+                 if (in_step[0] != 0 && in_step[1] != 0) {
+                   for (int64_t j = 0; j < len; ++j) {
+                     pc[j] = op(pa[j], pb[j]);
+                   }
+                 } else if (in_step[0] != 0) {
+                   auto vb = *pb;
+                   for (int64_t j = 0; j < len; ++j) {
+                     pc[j] = op(pa[j], vb);
+                   }
+                 } else if (in_step[1] != 0) {
+                   auto va = *pa;
+                   for (int64_t j = 0; j < len; ++j) {
+                     pc[j] = op(va, pb[j]);
+                   }
+                 } else {
+                   std::fill_n(pc, len, static_cast<TC>(op(*pa, *pb)));
+                 }
+               });
+}
+
+// out[j] = op(out[j], in[j * step]) for j < len, step is 0 or 1, to fold
+// one more input of a run into the output.
+template <typename TO, typename TI, typename Op>
+inline void accumulate_run(TO* out, const TI* in, int64_t step, int64_t len,
+                           Op op) {
+  if (step != 0) {
+    for (int64_t j = 0; j < len; ++j) {
+      out[j] = op(out[j], in[j]);
+    }
+  } else {
+    auto v = *in;
+    for (int64_t j = 0; j < len; ++j) {
+      out[j] = op(out[j], v);
+    }
+  }
+}
+
+// elements per thread below which waking more threads costs more than the
+// memory bandwidth they add
+constexpr int64_t ELEMENTWISE_GRAIN = 32 * 1024;
+
+// call f(begin, end) for chunks of [0, n) on the ThreadPool, with fewer
+// threads for small n, and on the calling thread only if n is below
+// ELEMENTWISE_GRAIN.
+template <typename F>
+void parallel_for_elementwise(int64_t n, F&& f) {
+  auto max_threads = n / ELEMENTWISE_GRAIN;
+  if (max_threads <= 1) {
+    f(int64_t(0), n);
+    return;
+  }
+  ThreadPool::instance().parallel_for(
+      0, n, [&f](int64_t begin, int64_t end) { f(begin, end); },
+      Schedule::STATIC, 1, (size_t)max_threads);
+}
+
+// Rounding of fix_shift(): half up, as DPURound() does, or half to even,
+// as STDRound(), Py3Round() and DPURound() with env ORT_ROUNDING_MODE or
+// ORT_ROUNDING_MODE_EVEN do.
+enum class FixRound {
+  HALF_UP,
+  HALF_EVEN,
+};
+
+// t / 2^shift rounded to an integer and saturated to [lo, hi], shift >= 0.
+// The same as round_normal() of the value as a double, without branches,
+// so that loops of it vectorize.
+template <FixRound R, typename Acc>
+inline Acc fix_shift(Acc t, int shift, Acc lo, Acc hi) {
+  const Acc one = 1;
+  auto half = (one << shift) >> 1;
+  Acc q;
+  if (R == FixRound::HALF_UP) {
+    q = (t + half) >> shift;
+  } else {
+    q = t >> shift;
+    auto r = t & ((one << shift) - one);
+    q += Acc(r > half) | (Acc(r == half) & Acc(half != 0) & (q & one));
+  }
+  return std::min(std::max(q, lo), hi);
+}
+
+// Logs the bandwidth of an elementwise op over the life of the object, if
+// env DEBUG_CPU_RUNNER_ELTWISE=1: the bytes of every input once, given
+// the size of an element of each input and then of the output, over the
+// time. Memory bound ops should get close to what the memory delivers.
+class ElementwiseProfile {
+ public:
+  ElementwiseProfile(const std::string& name, const Broadcast& bc,
+                     const std::vector<size_t>& elem_sizes);
+  ~ElementwiseProfile();
+  ElementwiseProfile(const ElementwiseProfile&) = delete;
+  ElementwiseProfile& operator=(const ElementwiseProfile&) = delete;
+
+ private:
+  bool enabled_;
+  std::string name_;
+  const Broadcast& bc_;
+  size_t bytes_{0u};
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace cpu
+}  // namespace vart
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "cpu_base_inc.hpp"
+#include "thread_pool.hpp"
 
 namespace vart {
 namespace cpu {
@@ -54,41 +55,31 @@ class Conv2Gemm {
 
   template <typename T>
   void transform_thread(const T* src, T* dst) {
-    vector<std::future<void>> fut(THREAD_NUM);
+    parallel_for(THREAD_NUM, [this, src, dst](uint32_t i) {
+      auto BASE_POS = i * THREAD_WORKLOAD;
+      auto FMAP_SIZE = fmap_dst_.num() / fmap_w_.c;
+      for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+        int pos = BASE_POS + j;
+        if (pos >= FMAP_SIZE) break;
 
-    for (auto i = 0U; i < THREAD_NUM; i++) {
-      fut[i] = std::async(
-          std::launch::async,
-          [this, src, dst](decltype(i) i) {
-            auto BASE_POS = i * THREAD_WORKLOAD;
-            auto FMAP_SIZE = fmap_dst_.num() / fmap_w_.c;
-            for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-              int pos = BASE_POS + j;
-              if (pos >= FMAP_SIZE) break;
+        int32_t group_iter = (pos / (fmap_src_.n * (fmap_dst_.ncod() / fmap_w_.c)));
+        int32_t batch_iter = (pos / (fmap_dst_.ncod() / fmap_w_.c)) % fmap_src_.n;
+        int32_t ho_iter    = (pos / (fmap_dst_.hcod() / fmap_w_.c)) % fmap_dst_.h;
+        int32_t wo_iter    = (pos / (fmap_dst_.wcod() / fmap_w_.c)) % fmap_dst_.w;
+        int32_t do_iter    = (pos / (fmap_dst_.dcod() / fmap_w_.c)) % fmap_dst_.d;
+        int32_t kh_iter    = (pos / (fmap_w_.w * fmap_w_.d)) % fmap_w_.h;
+        int32_t kw_iter    = (pos / (fmap_w_.d)) % fmap_w_.w;
+        int32_t kd_iter = pos % fmap_w_.d;
 
-              int32_t group_iter = (pos / (fmap_src_.n * (fmap_dst_.ncod() / fmap_w_.c)));
-              int32_t batch_iter = (pos / (fmap_dst_.ncod() / fmap_w_.c)) % fmap_src_.n;
-              int32_t ho_iter    = (pos / (fmap_dst_.hcod() / fmap_w_.c)) % fmap_dst_.h;
-              int32_t wo_iter    = (pos / (fmap_dst_.wcod() / fmap_w_.c)) % fmap_dst_.w;
-              int32_t do_iter    = (pos / (fmap_dst_.dcod() / fmap_w_.c)) % fmap_dst_.d;
-              int32_t kh_iter    = (pos / (fmap_w_.w * fmap_w_.d)) % fmap_w_.h;
-              int32_t kw_iter    = (pos / (fmap_w_.d)) % fmap_w_.w;
-              int32_t kd_iter = pos % fmap_w_.d;
-
-              auto* src_addr = src + batch_iter * fmap_src_.ncod() +
-                               (ho_iter * stride_.h + kh_iter) * fmap_src_.hcod() +
-                               (wo_iter * stride_.w + kw_iter) * fmap_src_.wcod() +
-                               (do_iter * stride_.d + kd_iter) * fmap_src_.dcod() +
-                               group_iter * fmap_w_.c;
-              auto* dst_addr = dst + pos * fmap_w_.c;
-              std::copy_n(src_addr, fmap_w_.c, dst_addr);
-            }
-          },
-          i);
-    }
-    for (auto i = 0U; i < THREAD_NUM; i++) {
-      fut[i].wait();
-    }
+        auto* src_addr = src + batch_iter * fmap_src_.ncod() +
+                         (ho_iter * stride_.h + kh_iter) * fmap_src_.hcod() +
+                         (wo_iter * stride_.w + kw_iter) * fmap_src_.wcod() +
+                         (do_iter * stride_.d + kd_iter) * fmap_src_.dcod() +
+                         group_iter * fmap_w_.c;
+        auto* dst_addr = dst + pos * fmap_w_.c;
+        std::copy_n(src_addr, fmap_w_.c, dst_addr);
+      }
+    });
   }
 
  private:
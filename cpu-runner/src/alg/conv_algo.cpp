@@ -0,0 +1,421 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "conv_algo.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vitis/ai/env_config.hpp>
+
+#include "thread_pool.hpp"
+
+#if defined(__GNUC__) && !defined(__clang__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define CONV_ALGO_X86 1
+#else
+#define CONV_ALGO_X86 0
+#endif
+
+DEF_ENV_PARAM(DEBUG_CPU_RUNNER_CONV_ALGO, "0");
+DEF_ENV_PARAM_2(XLNX_CPU_RUNNER_CONV_ALGO, "", std::string);
+
+namespace vart {
+namespace cpu {
+
+namespace {
+
+// multiply adds per thread below which waking another one does not pay
+constexpr int64_t CONV_GRAIN = 1024 * 1024;
+// bytes of im2col rows, or of transformed Winograd tiles and their
+// products, a thread works on at a time
+constexpr int64_t IM2COL_BYTES = 256 * 1024;
+constexpr int64_t WINOGRAD_BYTES = 1024 * 1024;
+// output width from which DIRECT beats IM2COL for kernels larger than 1x1
+constexpr int64_t DIRECT_MIN_OW = 16;
+
+// the transforms of Lavin and Gray, "Fast Algorithms for Convolutional
+// Neural Networks", with the interpolation points 0, 1, -1, 2, -2
+template <int M>
+struct Winograd;
+
+template <>
+struct Winograd<2> {
+  static constexpr float BT[4][4] = {
+      {1, 0, -1, 0},
+      {0, 1, 1, 0},
+      {0, -1, 1, 0},
+      {0, 1, 0, -1},
+  };
+  static constexpr double G[4][3] = {
+      {1, 0, 0},
+      {0.5, 0.5, 0.5},
+      {0.5, -0.5, 0.5},
+      {0, 0, 1},
+  };
+  static constexpr float AT[2][4] = {
+      {1, 1, 1, 0},
+      {0, 1, -1, -1},
+  };
+};
+
+template <>
+struct Winograd<4> {
+  static constexpr float BT[6][6] = {
+      {4, 0, -5, 0, 1, 0},  {0, -4, -4, 1, 1, 0}, {0, 4, -4, -1, 1, 0},
+      {0, -2, -1, 2, 1, 0}, {0, 2, -1, -2, 1, 0}, {0, 4, 0, -5, 0, 1},
+  };
+  static constexpr double G[6][3] = {
+      {1.0 / 4, 0, 0},
+      {-1.0 / 6, -1.0 / 6, -1.0 / 6},
+      {-1.0 / 6, 1.0 / 6, -1.0 / 6},
+      {1.0 / 24, 1.0 / 12, 1.0 / 6},
+      {1.0 / 24, -1.0 / 12, 1.0 / 6},
+      {0, 0, 1},
+  };
+  static constexpr float AT[4][6] = {
+      {1, 1, 1, 1, 1, 0},
+      {0, 1, -1, 2, -2, 0},
+      {0, 1, 1, 4, 4, 0},
+      {0, 1, -1, 8, -8, 1},
+  };
+};
+
+namespace base {
+#include "conv_algo_kernel.inc"
+}  // namespace base
+
+#if CONV_ALGO_X86
+// no "fma", and built with -ffp-contract=off, so that DIRECT stays bit
+// exact with conv_one()
+#pragma GCC push_options
+#pragma GCC target("avx2")
+namespace avx2 {
+#include "conv_algo_kernel.inc"
+}  // namespace avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+namespace avx512 {
+#include "conv_algo_kernel.inc"
+}  // namespace avx512
+#pragma GCC pop_options
+#endif
+
+using direct_rows_t = void (*)(const ConvShape&, const float*, const float*,
+                               float*, int64_t, int64_t, int64_t);
+using winograd_input_t = void (*)(const ConvShape&, const float*,
+                                  const float*, int64_t, float*, int64_t);
+using winograd_output_t = void (*)(const ConvShape&, const float*, int64_t,
+                                   int64_t, float*);
+
+// output channels of a DIRECT register tile
+int64_t direct_ob(GemmIsa isa) {
+  if (isa >= GemmIsa::AVX512) {
+    return 32;
+  }
+  if (isa >= GemmIsa::AVX2) {
+    return 16;
+  }
+  return 8;
+}
+
+direct_rows_t get_direct_rows(GemmIsa isa) {
+#if CONV_ALGO_X86
+  if (isa >= GemmIsa::AVX512) {
+    return avx512::direct_rows<6, 32>;
+  }
+  if (isa >= GemmIsa::AVX2) {
+    return avx2::direct_rows<6, 16>;
+  }
+#endif
+  return base::direct_rows<4, 8>;
+}
+
+template <int M>
+winograd_input_t get_winograd_input(GemmIsa isa) {
+#if CONV_ALGO_X86
+  if (isa >= GemmIsa::AVX512) {
+    return avx512::winograd_input<M>;
+  }
+  if (isa >= GemmIsa::AVX2) {
+    return avx2::winograd_input<M>;
+  }
+#endif
+  return base::winograd_input<M>;
+}
+
+template <int M>
+winograd_output_t get_winograd_output(GemmIsa isa) {
+#if CONV_ALGO_X86
+  if (isa >= GemmIsa::AVX512) {
+    return avx512::winograd_output<M>;
+  }
+  if (isa >= GemmIsa::AVX2) {
+    return avx2::winograd_output<M>;
+  }
+#endif
+  return base::winograd_output<M>;
+}
+
+int64_t conv_macs(const ConvShape& s) {
+  return s.n * s.oh * s.ow * s.oc * s.kh * s.kw * s.ic;
+}
+
+// call f(begin, end) for chunks of [0, num) tasks, on the ThreadPool if
+// `parallel` and the conv is large enough
+template <typename F>
+void for_tasks(const ConvShape& s, int64_t num, bool parallel, F&& f) {
+  auto max_threads = parallel ? conv_macs(s) / CONV_GRAIN : 0;
+  if (max_threads <= 1 || num <= 1) {
+    f(int64_t(0), num);
+    return;
+  }
+  ThreadPool::instance().parallel_for(
+      0, num, [&f](int64_t begin, int64_t end) { f(begin, end); },
+      Schedule::STATIC, 1, (size_t)max_threads);
+}
+
+void conv_im2col(const ConvShape& s, const ConvWeights& w, const float* in,
+                 float* out, bool parallel) {
+  auto rows = s.n * s.oh * s.ow;
+  if (s.kh == 1 && s.kw == 1 && s.sh == 1 && s.sw == 1 && s.ih == s.oh &&
+      s.iw == s.ow) {
+    gemm(in, w.gemm[0], out, rows, parallel);
+    return;
+  }
+  auto k = s.kh * s.kw * s.ic;
+  auto block = std::max<int64_t>(1, IM2COL_BYTES / (k * sizeof(float)));
+  auto num_of_blocks = (rows + block - 1) / block;
+  for_tasks(s, num_of_blocks, parallel, [&](int64_t begin, int64_t end) {
+    std::vector<float> a(block * k);
+    for (auto b = begin; b < end; ++b) {
+      auto r0 = b * block;
+      auto nr = std::min(block, rows - r0);
+      for (int64_t r = 0; r < nr; ++r) {
+        auto pixel = r0 + r;
+        auto x = pixel % s.ow, y = pixel / s.ow % s.oh;
+        auto n = pixel / (s.ow * s.oh);
+        // kw pixels of a row of the window are contiguous
+        for (int64_t i = 0; i < s.kh; ++i) {
+          std::memcpy(
+              a.data() + r * k + i * s.kw * s.ic,
+              in + ((n * s.ih + y * s.sh + i) * s.iw + x * s.sw) * s.ic,
+              s.kw * s.ic * sizeof(float));
+        }
+      }
+      gemm(a.data(), w.gemm[0], out + r0 * s.oc, nr, false);
+    }
+  });
+}
+
+void conv_direct(const ConvShape& s, const ConvWeights& w, const float* in,
+                 float* out, bool parallel) {
+  auto rows_of = get_direct_rows(w.isa);
+  auto rows = s.n * s.oh;
+  auto num_of_blocks = (s.oc + w.ob - 1) / w.ob;
+  // task t is row t % rows of block t / rows, so that a thread keeps to
+  // the weights of a block
+  for_tasks(s, num_of_blocks * rows, parallel,
+            [&](int64_t begin, int64_t end) {
+              while (begin < end) {
+                auto blk = begin / rows;
+                auto r_end = std::min(end, (blk + 1) * rows);
+                rows_of(s, in, w.direct.data(), out, blk, begin % rows,
+                        (r_end - 1) % rows + 1);
+                begin = r_end;
+              }
+            });
+}
+
+template <int M>
+void conv_winograd(const ConvShape& s, const ConvWeights& w, const float* in,
+                   float* out, bool parallel) {
+  constexpr int A = M + 2;
+  auto input = get_winograd_input<M>(w.isa);
+  auto output = get_winograd_output<M>(w.isa);
+  auto tiles = s.n * ((s.oh + M - 1) / M) * ((s.ow + M - 1) / M);
+  // tiles transformed at a time, and gemm()'d once per tile element
+  auto block = std::clamp<int64_t>(
+      WINOGRAD_BYTES / (A * A * (s.ic + s.oc) * sizeof(float)), 6, 96);
+  auto num_of_blocks = (tiles + block - 1) / block;
+  std::vector<float> zeros(s.ic, 0.0f);
+  for_tasks(s, num_of_blocks, parallel, [&](int64_t begin, int64_t end) {
+    auto ldv = block * s.ic, ldm = block * s.oc;
+    std::vector<float> v(A * A * ldv), m(A * A * ldm);
+    for (auto b = begin; b < end; ++b) {
+      auto t0 = b * block;
+      auto nt = std::min(block, tiles - t0);
+      for (int64_t t = 0; t < nt; ++t) {
+        input(s, in, zeros.data(), t0 + t, v.data() + t * s.ic, ldv);
+      }
+      for (auto xi = 0; xi < A * A; ++xi) {
+        gemm(v.data() + xi * ldv, w.gemm[xi], m.data() + xi * ldm, nt,
+             false);
+      }
+      for (int64_t t = 0; t < nt; ++t) {
+        output(s, m.data() + t * s.oc, ldm, t0 + t, out);
+      }
+    }
+  });
+}
+
+template <int M>
+void pack_winograd(const ConvShape& s, const float* weights,
+                   ConvWeights* w) {
+  using W = Winograd<M>;
+  constexpr int A = M + 2;
+  // u[xi] is [ic, oc], G g G^T of the 3x3 weights g of (oc, ic)
+  std::vector<std::vector<float>> u(A * A,
+                                    std::vector<float>(s.ic * s.oc));
+  for (int64_t o = 0; o < s.oc; ++o) {
+    for (int64_t c = 0; c < s.ic; ++c) {
+      double g[3][3], gt[A][3];
+      for (auto i = 0; i < 3; ++i) {
+        for (auto j = 0; j < 3; ++j) {
+          g[i][j] = weights[((o * 3 + i) * 3 + j) * s.ic + c];
+        }
+      }
+      for (auto r = 0; r < A; ++r) {
+        for (auto j = 0; j < 3; ++j) {
+          gt[r][j] = W::G[r][0] * g[0][j] + W::G[r][1] * g[1][j] +
+                     W::G[r][2] * g[2][j];
+        }
+      }
+      for (auto r = 0; r < A; ++r) {
+        for (auto q = 0; q < A; ++q) {
+          u[r * A + q][c * s.oc + o] =
+              (float)(gt[r][0] * W::G[q][0] + gt[r][1] * W::G[q][1] +
+                      gt[r][2] * W::G[q][2]);
+        }
+      }
+    }
+  }
+  for (const auto& ux : u) {
+    w->gemm.push_back(pack_gemm_b(ux.data(), s.oc, s.ic, s.oc, 1));
+  }
+}
+
+ConvAlgo env_conv_algo(const ConvShape& s, ConvAlgo selected) {
+  const auto& name = ENV_PARAM(XLNX_CPU_RUNNER_CONV_ALGO);
+  if (name.empty()) {
+    return selected;
+  }
+  for (auto i = 0; i <= (int)ConvAlgo::WINOGRAD_4X4; ++i) {
+    if (name == get_conv_algo_name((ConvAlgo)i)) {
+      return conv_algo_supports(s, (ConvAlgo)i) ? (ConvAlgo)i : selected;
+    }
+  }
+  LOG(WARNING) << "unknown XLNX_CPU_RUNNER_CONV_ALGO " << name;
+  return selected;
+}
+
+}  // namespace
+
+const char* get_conv_algo_name(ConvAlgo algo) {
+  switch (algo) {
+    case ConvAlgo::IM2COL:
+      return "im2col";
+    case ConvAlgo::DIRECT:
+      return "direct";
+    case ConvAlgo::WINOGRAD_2X2:
+      return "winograd_2x2";
+    case ConvAlgo::WINOGRAD_4X4:
+      return "winograd_4x4";
+  }
+  return "unknown";
+}
+
+bool conv_algo_supports(const ConvShape& s, ConvAlgo algo) {
+  if (algo == ConvAlgo::WINOGRAD_2X2 || algo == ConvAlgo::WINOGRAD_4X4) {
+    return s.kh == 3 && s.kw == 3 && s.sh == 1 && s.sw == 1;
+  }
+  return true;
+}
+
+ConvAlgo select_conv_algo(const ConvShape& s) {
+  // im2col copies every input pixel kh * kw times, DIRECT loads a
+  // kh * kw * ic tile of weights per output row instead, which only the
+  // pixels of that row use. On narrow maps, e.g. the 14x14 and 7x7 3x3
+  // convs of ResNet-50, the weights cost more than the copy. 1x1 kernels
+  // copy ic floats per pixel at most, nothing if unpadded stride 1.
+  // Winograd is only used when the env asks for it, it changes the
+  // results and is not faster than DIRECT on every machine.
+  auto algo = s.kh * s.kw > 1 && s.ow >= DIRECT_MIN_OW ? ConvAlgo::DIRECT
+                                                       : ConvAlgo::IM2COL;
+  algo = env_conv_algo(s, algo);
+  LOG_IF(INFO, ENV_PARAM(DEBUG_CPU_RUNNER_CONV_ALGO))
+      << "conv " << s.ih << "x" << s.iw << "x" << s.ic << " -> " << s.oh
+      << "x" << s.ow << "x" << s.oc << " kernel " << s.kh << "x" << s.kw
+      << " stride " << s.sh << "x" << s.sw << ": " << get_conv_algo_name(algo);
+  return algo;
+}
+
+ConvWeights pack_conv_weights(const ConvShape& s, ConvAlgo algo,
+                              const float* weights) {
+  ConvWeights w{algo, get_gemm_isa(), 0, {}, {}};
+  switch (algo) {
+    case ConvAlgo::IM2COL: {
+      auto k = s.kh * s.kw * s.ic;
+      w.gemm.push_back(pack_gemm_b(weights, s.oc, k, 1, k));
+      break;
+    }
+    case ConvAlgo::DIRECT: {
+      w.ob = direct_ob(w.isa);
+      auto taps = s.kh * s.kw * s.ic;
+      auto num_of_blocks = (s.oc + w.ob - 1) / w.ob;
+      w.direct.assign(num_of_blocks * taps * w.ob, 0.0f);
+      for (int64_t o = 0; o < s.oc; ++o) {
+        for (int64_t t = 0; t < taps; ++t) {
+          w.direct[(o / w.ob * taps + t) * w.ob + o % w.ob] =
+              weights[o * taps + t];
+        }
+      }
+      break;
+    }
+    case ConvAlgo::WINOGRAD_2X2:
+      pack_winograd<2>(s, weights, &w);
+      break;
+    case ConvAlgo::WINOGRAD_4X4:
+      pack_winograd<4>(s, weights, &w);
+      break;
+  }
+  return w;
+}
+
+void conv_float(const ConvShape& s, const ConvWeights& w, const float* in,
+                float* out, bool parallel) {
+  switch (w.algo) {
+    case ConvAlgo::IM2COL:
+      conv_im2col(s, w, in, out, parallel);
+      break;
+    case ConvAlgo::DIRECT:
+      conv_direct(s, w, in, out, parallel);
+      break;
+    case ConvAlgo::WINOGRAD_2X2:
+      conv_winograd<2>(s, w, in, out, parallel);
+      break;
+    case ConvAlgo::WINOGRAD_4X4:
+      conv_winograd<4>(s, w, in, out, parallel);
+      break;
+  }
+}
+
+}  // namespace cpu
+}  // namespace vart
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "gemm.hpp"
+
+namespace vart {
+namespace cpu {
+
+// A float conv with group 1 of an NHWC input which is already padded, as
+// ConvBase reads it, by weights [oc, kh, kw, ic].
+struct ConvShape {
+  // padded input
+  int64_t n;
+  int64_t ih;
+  int64_t iw;
+  int64_t ic;
+  int64_t oh;
+  int64_t ow;
+  int64_t oc;
+  int64_t kh;
+  int64_t kw;
+  int64_t sh;
+  int64_t sw;
+};
+
+// How conv_float() computes the conv.
+enum class ConvAlgo {
+  // gemm() of the weights and im2col rows of the input, a block of rows
+  // at a time, or of the input itself for an unpadded 1x1 stride 1 conv
+  IM2COL,
+  // register tiles of output pixels and channels summed straight from the
+  // input, no im2col copy
+  DIRECT,
+  // Winograd F(2x2, 3x3) and F(4x4, 3x3), 3x3 stride 1 only: 2.25 and 4
+  // times fewer multiplies than the others, as (m + 2)^2 gemm()s of
+  // transformed input tiles and weights
+  WINOGRAD_2X2,
+  WINOGRAD_4X4,
+};
+
+const char* get_conv_algo_name(ConvAlgo algo);
+bool conv_algo_supports(const ConvShape& s, ConvAlgo algo);
+
+// DIRECT, or IM2COL for 1x1 kernels and outputs less than 16 pixels
+// wide, or the one named by env XLNX_CPU_RUNNER_CONV_ALGO (im2col,
+// direct, winograd_2x2 or winograd_4x4) if it supports the shape.
+//
+// IM2COL and DIRECT are bit exact with the loops of ConvBase::conv_one(),
+// every output sums its products in kh, kw, ic order starting from 0.
+// Winograd is not, its error grows with the tile size, so it is never
+// picked unless the env asks for it.
+ConvAlgo select_conv_algo(const ConvShape& s);
+
+// weights of a conv in the layout of its algorithm
+struct ConvWeights {
+  ConvAlgo algo;
+  GemmIsa isa;
+  // DIRECT: [oc / ob, kh, kw, ic, ob], oc padded with 0 to a multiple of
+  // ob, the channels of a register tile
+  int64_t ob = 0;
+  std::vector<float> direct;
+  // IM2COL: the weights, Winograd: one per element of a transformed tile
+  std::vector<GemmPackedB> gemm;
+};
+
+ConvWeights pack_conv_weights(const ConvShape& s, ConvAlgo algo,
+                              const float* weights);
+
+// out [n, oh, ow, oc] = the conv of `in` by the weights, split among
+// ThreadPool threads if `parallel`
+void conv_float(const ConvShape& s, const ConvWeights& w, const float* in,
+                float* out, bool parallel);
+
+}  // namespace cpu
+}  // namespace vart
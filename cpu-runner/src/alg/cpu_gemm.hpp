@@ -20,6 +20,8 @@
 // #include <immintrin.h>
 #include "cpu_std_inc.hpp"
 #include "cpu_types.hpp"
+#include "gemm.hpp"
+#include "thread_pool.hpp"
 
 namespace vart {
 namespace cpu {
@@ -246,6 +248,13 @@ parallel; auto left = K % parallel; auto pad = 0; if(left != 0) { ngroups += 1;
 // A dimention: [X, K]
 // B dimention: [Y, K]
 // C dimention: [X, Y]
+// float and int32 go to the packed SIMD gemm(), with the same results.
+template <typename T, typename D>
+constexpr bool use_simd_gemm() {
+  return std::is_same<T, D>::value &&
+         (std::is_same<T, float>::value || std::is_same<T, int32_t>::value);
+}
+
 template <typename T>
 void matmul(const T* A, const T* B, T* C, int64_t X, int64_t Y, int64_t K) {
   matmul<T, T>(A, B, C, X, Y, K);
@@ -253,6 +262,10 @@ void matmul(const T* A, const T* B, T* C, int64_t X, int64_t Y, int64_t K) {
 
 template <typename T, typename D>
 void matmul(const T* A, const D* B, T* C, int64_t X, int64_t Y, int64_t K) {
+  if constexpr (use_simd_gemm<T, D>()) {
+    gemm(A, B, C, X, Y, K, 1, K, false);
+    return;
+  }
   for (auto x = 0; x < X; x++) {
     for (auto y = 0; y < Y; y++) {
       const auto* addrA = A + x * K;
@@ -272,37 +285,28 @@ void matmul_thread(const T* A, const T* B, T* C, int64_t X, int64_t Y, int64_t K
 
 template <typename T, typename D>
 void matmul_thread(const T* A, const D* B, T* C, int64_t X, int64_t Y, int64_t K) {
+  if constexpr (use_simd_gemm<T, D>()) {
+    gemm(A, B, C, X, Y, K, 1, K);
+    return;
+  }
   int THREAD_NUM = CPU_NUM;
   int64_t SIZE = X * Y;
   int64_t THREAD_WORKLOAD = ceil((float)SIZE / THREAD_NUM);
 
-  vector<std::future<int>> fut(THREAD_NUM);
-
-  for (auto i = 0; i < THREAD_NUM; i++) {
-    fut[i] =
-        std::async(std::launch::async,
-                   [A, B, C, X, Y, K, SIZE, THREAD_WORKLOAD](decltype(i) i) {
-                     int64_t BASE_POS = i * THREAD_WORKLOAD;
-                     for (auto j = 0; j < THREAD_WORKLOAD; j++) {
-                       int64_t pos = BASE_POS + j;
-                       if (pos >= SIZE) break;
-
-                       int64_t x = pos / Y;
-                       int64_t y = pos % Y;
-                       auto* addrA = A + x * K;
-                       auto* addrB = B + y * K;
-                       auto* addrC = C + pos;
-                       inner_product(addrA, addrB, addrC, K);
-                     }
-
-                     return 0;
-                   },
-                   i);
-  }
-
-  for (auto i = 0; i < THREAD_NUM; i++) {
-    fut[i].wait();
-  }
+  parallel_for(THREAD_NUM, [A, B, C, Y, K, SIZE, THREAD_WORKLOAD](int i) {
+    int64_t BASE_POS = i * THREAD_WORKLOAD;
+    for (auto j = 0; j < THREAD_WORKLOAD; j++) {
+      int64_t pos = BASE_POS + j;
+      if (pos >= SIZE) break;
+
+      int64_t x = pos / Y;
+      int64_t y = pos % Y;
+      auto* addrA = A + x * K;
+      auto* addrB = B + y * K;
+      auto* addrC = C + pos;
+      inner_product(addrA, addrB, addrC, K);
+    }
+  });
 }
 
 }  // namespace cpu
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "depthwise.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+
+#include "gemm.hpp"
+#include "thread_pool.hpp"
+
+#if defined(__GNUC__) && !defined(__clang__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define DEPTHWISE_X86 1
+#else
+#define DEPTHWISE_X86 0
+#endif
+
+namespace vart {
+namespace cpu {
+
+namespace {
+
+// multiply adds per thread below which waking another one does not pay
+constexpr int64_t DEPTHWISE_GRAIN = 256 * 1024;
+
+namespace base {
+#include "depthwise_kernel.inc"
+}  // namespace base
+
+#if DEPTHWISE_X86
+// no "fma" and, as gemm.cpp, built with -ffp-contract=off: a fused
+// multiply add rounds once, and float results would differ from
+// dwconv_one()
+#pragma GCC push_options
+#pragma GCC target("avx2")
+namespace avx2 {
+#include "depthwise_kernel.inc"
+}  // namespace avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw")
+namespace avx512 {
+#include "depthwise_kernel.inc"
+}  // namespace avx512
+#pragma GCC pop_options
+#endif
+
+template <typename DType, typename WType>
+base::rows_t<DType, WType> get_rows(const Depthwise& d) {
+#if DEPTHWISE_X86
+  // other types are rare, they keep the baseline build
+  if constexpr (std::is_same<DType, WType>::value &&
+                (std::is_same<DType, float>::value ||
+                 std::is_same<DType, int32_t>::value)) {
+    auto isa = get_gemm_isa();
+    if (isa >= GemmIsa::AVX512) {
+      return avx512::get_rows<DType, WType>(d);
+    }
+    if (isa >= GemmIsa::AVX2) {
+      return avx2::get_rows<DType, WType>(d);
+    }
+  }
+#endif
+  return base::get_rows<DType, WType>(d);
+}
+
+}  // namespace
+
+template <typename DType, typename WType>
+void depthwise(const Depthwise& d, const DType* in, const WType* weights,
+               DType* out, bool parallel) {
+  auto rows = get_rows<DType, WType>(d);
+  auto num_of_rows = d.n * d.oh;
+  auto max_threads = parallel ? num_of_rows * d.ow * d.c * d.kh * d.kw /
+                                    DEPTHWISE_GRAIN
+                              : 0;
+  if (max_threads <= 1) {
+    rows(d, in, weights, out, 0, num_of_rows);
+    return;
+  }
+  ThreadPool::instance().parallel_for(
+      0, num_of_rows,
+      [&](int64_t begin, int64_t end) {
+        rows(d, in, weights, out, begin, end);
+      },
+      Schedule::STATIC, 1, (size_t)max_threads);
+}
+
+template void depthwise(const Depthwise&, const float*, const float*, float*,
+                        bool);
+template void depthwise(const Depthwise&, const float*, const double*, float*,
+                        bool);
+template void depthwise(const Depthwise&, const float*, const int32_t*,
+                        float*, bool);
+template void depthwise(const Depthwise&, const double*, const float*,
+                        double*, bool);
+template void depthwise(const Depthwise&, const double*, const double*,
+                        double*, bool);
+template void depthwise(const Depthwise&, const double*, const int32_t*,
+                        double*, bool);
+template void depthwise(const Depthwise&, const int32_t*, const float*,
+                        int32_t*, bool);
+template void depthwise(const Depthwise&, const int32_t*, const double*,
+                        int32_t*, bool);
+template void depthwise(const Depthwise&, const int32_t*, const int32_t*,
+                        int32_t*, bool);
+
+}  // namespace cpu
+}  // namespace vart
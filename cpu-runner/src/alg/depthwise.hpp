@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace vart {
+namespace cpu {
+
+// A depthwise conv with a channel multiplier of 1 on an NHWC input which
+// is already padded, as DWConvBase reads it. Output pixel (n, y, x)
+// channel c is the sum of in[n][y * sh + i][x * sw + j][c] * w[i][j][c]
+// over i, then j, starting from 0, the order of DWConvBase::dwconv_one(),
+// so float results are bit exact with it.
+struct Depthwise {
+  // padded input
+  int64_t n;
+  int64_t ih;
+  int64_t iw;
+  int64_t c;
+  int64_t oh;
+  int64_t ow;
+  int64_t kh;
+  int64_t kw;
+  int64_t sh;
+  int64_t sw;
+};
+
+// out = the depthwise conv of `in` by `weights` [kh, kw, c]. The loops
+// run along the channels, which the compiler vectorizes, and are
+// specialized for 3x3 and 5x5 kernels with strides 1 and 2. float and
+// int32 have AVX2 and AVX-512 builds, the gemm() ISA caps which one.
+// Output rows are split among ThreadPool threads if `parallel`.
+template <typename DType, typename WType>
+void depthwise(const Depthwise& d, const DType* in, const WType* weights,
+               DType* out, bool parallel);
+
+}  // namespace cpu
+}  // namespace vart
@@ -0,0 +1,618 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gemm.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <vitis/ai/env_config.hpp>
+
+#include "cpu_helper.hpp"
+#include "thread_pool.hpp"
+
+#if defined(__GNUC__) && !defined(__clang__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define GEMM_X86 1
+#include <immintrin.h>
+#else
+#define GEMM_X86 0
+#endif
+
+DEF_ENV_PARAM(DEBUG_CPU_RUNNER_GEMM, "0");
+DEF_ENV_PARAM_2(XLNX_CPU_RUNNER_GEMM_ISA, "", std::string);
+
+namespace vart {
+namespace cpu {
+
+namespace {
+
+// rows of a micro tile, the columns depend on the vector width
+constexpr int MR = 6;
+// k of packed panels, in units of the kernel (pairs for int16)
+constexpr int64_t KC = 256;
+// rows and column panels of C per task
+constexpr int64_t MC = 16 * MR;
+constexpr int64_t NCP = 8;
+
+template <typename T>
+inline void copy_tile(const T* src, int64_t lds, T* dst, int64_t ldd, int mr,
+                      int nr) {
+  for (auto r = 0; r < mr; ++r) {
+    std::memcpy(dst + r * ldd, src + r * lds, nr * sizeof(T));
+  }
+}
+
+template <typename TA, typename TB, typename TC>
+using kernel_t = void (*)(int64_t, const TA*, const TB*, TC*, int64_t, int,
+                          int, bool);
+
+struct kernels_t {
+  int nr;
+  kernel_t<float, float, float> f32;
+  kernel_t<int32_t, int32_t, int32_t> s32;
+  kernel_t<int32_t, int16_t, int32_t> s16;
+  kernel_t<int32_t, int32_t, float> s32f;
+};
+
+namespace scalar {
+constexpr int W = 1;
+using vf = float;
+using vi = int32_t;
+inline vf f_zero() { return 0.0f; }
+inline vf f_load(const float* p) { return *p; }
+inline void f_store(float* p, vf v) { *p = v; }
+inline vf f_set1(float v) { return v; }
+inline vf f_add(vf a, vf b) { return a + b; }
+inline vf f_mul(vf a, vf b) { return a * b; }
+inline vi i_zero() { return 0; }
+inline vi i_load(const int32_t* p) { return *p; }
+inline void i_store(int32_t* p, vi v) { *p = v; }
+inline vi i_set1(int32_t v) { return v; }
+inline vi i_add(vi a, vi b) { return a + b; }
+inline vi i_mullo(vi a, vi b) { return a * b; }
+inline vi i_madd16(vi acc, vi a, vi b) {
+  return acc + (int32_t)(int16_t)a * (int16_t)b + (a >> 16) * (b >> 16);
+}
+inline vf i_to_f(vi v) { return (float)v; }
+#include "gemm_kernel.inc"
+const kernels_t kernels = {NR, kernel_f32, kernel_s32, kernel_s16,
+                           kernel_s32f};
+}  // namespace scalar
+
+#if GEMM_X86
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+namespace sse4 {
+constexpr int W = 4;
+using vf = __m128;
+using vi = __m128i;
+inline vf f_zero() { return _mm_setzero_ps(); }
+inline vf f_load(const float* p) { return _mm_loadu_ps(p); }
+inline void f_store(float* p, vf v) { _mm_storeu_ps(p, v); }
+inline vf f_set1(float v) { return _mm_set1_ps(v); }
+inline vf f_add(vf a, vf b) { return _mm_add_ps(a, b); }
+inline vf f_mul(vf a, vf b) { return _mm_mul_ps(a, b); }
+inline vi i_zero() { return _mm_setzero_si128(); }
+inline vi i_load(const int32_t* p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+inline void i_store(int32_t* p, vi v) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+}
+inline vi i_set1(int32_t v) { return _mm_set1_epi32(v); }
+inline vi i_add(vi a, vi b) { return _mm_add_epi32(a, b); }
+inline vi i_mullo(vi a, vi b) { return _mm_mullo_epi32(a, b); }
+inline vi i_madd16(vi acc, vi a, vi b) {
+  return _mm_add_epi32(acc, _mm_madd_epi16(a, b));
+}
+inline vf i_to_f(vi v) { return _mm_cvtepi32_ps(v); }
+#include "gemm_kernel.inc"
+const kernels_t kernels = {NR, kernel_f32, kernel_s32, kernel_s16,
+                           kernel_s32f};
+}  // namespace sse4
+#pragma GCC pop_options
+
+// no "fma": a fused multiply add rounds once, and the float results
+// would no longer match the loops in cpu_gemm.hpp
+#pragma GCC push_options
+#pragma GCC target("avx2")
+namespace avx2 {
+constexpr int W = 8;
+using vf = __m256;
+using vi = __m256i;
+inline vf f_zero() { return _mm256_setzero_ps(); }
+inline vf f_load(const float* p) { return _mm256_loadu_ps(p); }
+inline void f_store(float* p, vf v) { _mm256_storeu_ps(p, v); }
+inline vf f_set1(float v) { return _mm256_set1_ps(v); }
+inline vf f_add(vf a, vf b) { return _mm256_add_ps(a, b); }
+inline vf f_mul(vf a, vf b) { return _mm256_mul_ps(a, b); }
+inline vi i_zero() { return _mm256_setzero_si256(); }
+inline vi i_load(const int32_t* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+inline void i_store(int32_t* p, vi v) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+}
+inline vi i_set1(int32_t v) { return _mm256_set1_epi32(v); }
+inline vi i_add(vi a, vi b) { return _mm256_add_epi32(a, b); }
+inline vi i_mullo(vi a, vi b) { return _mm256_mullo_epi32(a, b); }
+inline vi i_madd16(vi acc, vi a, vi b) {
+  return _mm256_add_epi32(acc, _mm256_madd_epi16(a, b));
+}
+inline vf i_to_f(vi v) { return _mm256_cvtepi32_ps(v); }
+#include "gemm_kernel.inc"
+const kernels_t kernels = {NR, kernel_f32, kernel_s32, kernel_s16,
+                           kernel_s32f};
+}  // namespace avx2
+#pragma GCC pop_options
+
+// _mm512_cvtepi32_ps trips -Wmaybe-uninitialized of gcc 12, hence maskz
+#define GEMM_AVX512_OPS                                                      \
+  using vf = __m512;                                                         \
+  using vi = __m512i;                                                        \
+  inline vf f_zero() { return _mm512_setzero_ps(); }                         \
+  inline vf f_load(const float* p) { return _mm512_loadu_ps(p); }            \
+  inline void f_store(float* p, vf v) { _mm512_storeu_ps(p, v); }            \
+  inline vf f_set1(float v) { return _mm512_set1_ps(v); }                    \
+  inline vf f_add(vf a, vf b) { return _mm512_add_ps(a, b); }                \
+  inline vf f_mul(vf a, vf b) { return _mm512_mul_ps(a, b); }                \
+  inline vi i_zero() { return _mm512_setzero_si512(); }                      \
+  inline vi i_load(const int32_t* p) { return _mm512_loadu_si512(p); }       \
+  inline void i_store(int32_t* p, vi v) { _mm512_storeu_si512(p, v); }       \
+  inline vi i_set1(int32_t v) { return _mm512_set1_epi32(v); }               \
+  inline vi i_add(vi a, vi b) { return _mm512_add_epi32(a, b); }             \
+  inline vi i_mullo(vi a, vi b) { return _mm512_mullo_epi32(a, b); }         \
+  inline vf i_to_f(vi v) { return _mm512_maskz_cvtepi32_ps(0xffff, v); }
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw")
+namespace avx512 {
+constexpr int W = 16;
+GEMM_AVX512_OPS
+inline vi i_madd16(vi acc, vi a, vi b) {
+  return _mm512_add_epi32(acc, _mm512_madd_epi16(a, b));
+}
+#include "gemm_kernel.inc"
+const kernels_t kernels = {NR, kernel_f32, kernel_s32, kernel_s16,
+                           kernel_s32f};
+}  // namespace avx512
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx512vnni")
+namespace avx512_vnni {
+constexpr int W = 16;
+GEMM_AVX512_OPS
+inline vi i_madd16(vi acc, vi a, vi b) { return _mm512_dpwssd_epi32(acc, a, b); }
+#include "gemm_kernel.inc"
+const kernels_t kernels = {NR, kernel_f32, kernel_s32, kernel_s16,
+                           kernel_s32f};
+}  // namespace avx512_vnni
+#pragma GCC pop_options
+
+#undef GEMM_AVX512_OPS
+#endif
+
+GemmIsa detect_gemm_isa() {
+#if GEMM_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+    return __builtin_cpu_supports("avx512vnni") ? GemmIsa::AVX512_VNNI
+                                                : GemmIsa::AVX512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return GemmIsa::AVX2;
+  }
+  if (__builtin_cpu_supports("sse4.1")) {
+    return GemmIsa::SSE4;
+  }
+#endif
+  return GemmIsa::SCALAR;
+}
+
+GemmIsa env_gemm_isa(GemmIsa supported) {
+  const auto& name = ENV_PARAM(XLNX_CPU_RUNNER_GEMM_ISA);
+  for (auto i = 0; i <= (int)GemmIsa::AVX512_VNNI; ++i) {
+    if (name == get_gemm_isa_name((GemmIsa)i)) {
+      return std::min(supported, (GemmIsa)i);
+    }
+  }
+  LOG_IF(WARNING, !name.empty())
+      << "unknown XLNX_CPU_RUNNER_GEMM_ISA " << name << ", use "
+      << get_gemm_isa_name(supported);
+  return supported;
+}
+
+std::atomic<int> isa_cap{(int)GemmIsa::AVX512_VNNI};
+
+const kernels_t& get_kernels(GemmIsa isa) {
+  switch (isa) {
+#if GEMM_X86
+    case GemmIsa::AVX512_VNNI:
+      return avx512_vnni::kernels;
+    case GemmIsa::AVX512:
+      return avx512::kernels;
+    case GemmIsa::AVX2:
+      return avx2::kernels;
+    case GemmIsa::SSE4:
+      return sse4::kernels;
+#endif
+    default:
+      return scalar::kernels;
+  }
+}
+
+template <typename T>
+std::vector<T>& packed_a_buffer() {
+  thread_local std::vector<T> buf;
+  return buf;
+}
+
+template <typename T>
+bool fits_int16(const T* p, int64_t rows, int64_t cols, int64_t row_stride,
+                int64_t col_stride) {
+  // walk in memory order
+  if (row_stride < col_stride) {
+    std::swap(rows, cols);
+    std::swap(row_stride, col_stride);
+  }
+  for (auto r = 0; r < rows; ++r) {
+    for (auto c = 0; c < cols; ++c) {
+      auto v = p[r * row_stride + c * col_stride];
+      if (v < -32767 || v > 32767) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// call f(panel, k, j, element (k, n) of B) for all of B, n is
+// panel * nr + j. If B is [N, K], rows are read in blocks of k, so that
+// the rows of a panel, which may map to the same cache set, are not all
+// touched for every k.
+template <typename T, typename F>
+void walk_b(const T* B, int64_t N, int64_t K, int64_t b_k_stride,
+            int64_t b_n_stride, int nr, F f) {
+  constexpr int64_t KB = 64;
+  auto num_of_panels = (N + nr - 1) / nr;
+  for (auto p = 0; p < num_of_panels; ++p) {
+    auto n0 = p * nr;
+    auto cols = std::min<int64_t>(nr, N - n0);
+    if (b_k_stride < b_n_stride) {
+      for (auto k0 = 0; k0 < K; k0 += KB) {
+        auto k1 = std::min<int64_t>(K, k0 + KB);
+        for (auto j = 0; j < cols; ++j) {
+          const auto* src = B + (n0 + j) * b_n_stride;
+          for (auto k = k0; k < k1; ++k) {
+            f(p, k, j, src[k * b_k_stride]);
+          }
+        }
+      }
+    } else {
+      for (auto k = 0; k < K; ++k) {
+        for (auto j = 0; j < cols; ++j) {
+          f(p, k, j, B[k * b_k_stride + (n0 + j) * b_n_stride]);
+        }
+      }
+    }
+  }
+}
+
+// B as [panel][K][nr], zero padded
+template <typename T>
+std::vector<T> pack_b(const T* B, int64_t N, int64_t K, int64_t b_k_stride,
+                      int64_t b_n_stride, int nr) {
+  auto num_of_panels = (N + nr - 1) / nr;
+  std::vector<T> packed(num_of_panels * K * nr, T(0));
+  auto* dst = packed.data();
+  walk_b(B, N, K, b_k_stride, b_n_stride, nr,
+         [=](int64_t p, int64_t k, int64_t j, T v) {
+           dst[(p * K + k) * nr + j] = v;
+         });
+  return packed;
+}
+
+// B as [panel][K / 2][nr][2] int16, zero padded
+std::vector<int16_t> pack_b16(const int32_t* B, int64_t N, int64_t K,
+                              int64_t b_k_stride, int64_t b_n_stride, int nr) {
+  auto num_of_panels = (N + nr - 1) / nr;
+  auto K2 = (K + 1) / 2;
+  std::vector<int16_t> packed(num_of_panels * K2 * nr * 2, 0);
+  auto* dst = packed.data();
+  walk_b(B, N, K, b_k_stride, b_n_stride, nr,
+         [=](int64_t p, int64_t k, int64_t j, int32_t v) {
+           dst[((p * K2 + k / 2) * nr + j) * 2 + k % 2] = (int16_t)v;
+         });
+  return packed;
+}
+
+// rows [m0, m0 + rows) and k units [k0, k0 + kc) of A as [panel][kc][MR]
+template <typename T>
+void pack_a(const T* A, int64_t K, int64_t m0, int64_t rows, int64_t k0,
+            int64_t kc, T* dst) {
+  for (auto r0 = 0; r0 < rows; r0 += MR) {
+    auto mr = std::min<int64_t>(MR, rows - r0);
+    for (auto k = 0; k < kc; ++k) {
+      auto* src = A + (m0 + r0) * K + k0 + k;
+      for (auto r = 0; r < mr; ++r) {
+        dst[k * MR + r] = src[r * K];
+      }
+      for (auto r = mr; r < MR; ++r) {
+        dst[k * MR + r] = T(0);
+      }
+    }
+    dst += kc * MR;
+  }
+}
+
+// as pack_a, but k units are pairs of int16 in one int32
+void pack_a16(const int32_t* A, int64_t K, int64_t m0, int64_t rows,
+              int64_t k0, int64_t kc, int32_t* dst) {
+  for (auto r0 = 0; r0 < rows; r0 += MR) {
+    auto mr = std::min<int64_t>(MR, rows - r0);
+    for (auto k = 0; k < kc; ++k) {
+      auto k_lo = (k0 + k) * 2;
+      for (auto r = 0; r < MR; ++r) {
+        uint32_t pair = 0u;
+        if (r < mr) {
+          const auto* src = A + (m0 + r0 + r) * K;
+          pair = (uint16_t)src[k_lo];
+          if (k_lo + 1 < K) {
+            pair |= (uint32_t)(uint16_t)src[k_lo + 1] << 16;
+          }
+        }
+        dst[k * MR + r] = (int32_t)pair;
+      }
+    }
+    dst += kc * MR;
+  }
+}
+
+// C = A * packed B, K_units is K, or K / 2 rounded up for int16 pairs
+template <typename TA, typename TB, typename TC, typename PackA>
+void run_tiles(kernel_t<TA, TB, TC> kernel, int nr, int pack, const TA* A,
+               const TB* packed_b, TC* C, int64_t M, int64_t N, int64_t K,
+               int64_t K_units, bool parallel, PackA pack_a_fn) {
+  auto num_of_panels = (N + nr - 1) / nr;
+  auto threads = parallel ? std::min<int64_t>(
+                                CPU_NUM, ThreadPool::instance().num_of_threads())
+                          : 1;
+  auto num_of_nb = (num_of_panels + NCP - 1) / NCP;
+  auto mc = MC;
+  // split M finer if there are not enough tasks for the threads
+  if (((M + mc - 1) / mc) * num_of_nb < threads) {
+    auto num_of_mb = (threads + num_of_nb - 1) / num_of_nb;
+    mc = std::max<int64_t>(MR, ((M + num_of_mb - 1) / num_of_mb + MR - 1) /
+                                   MR * MR);
+  }
+  auto num_of_mb = (M + mc - 1) / mc;
+  auto b_panel_size = K_units * nr * pack;
+
+  auto run_task = [&](int64_t task) {
+    auto m0 = task / num_of_nb * mc;
+    auto rows = std::min<int64_t>(mc, M - m0);
+    auto p0 = task % num_of_nb * NCP;
+    auto p1 = std::min<int64_t>(num_of_panels, p0 + NCP);
+    auto num_of_mp = (rows + MR - 1) / MR;
+    auto& pa = packed_a_buffer<TA>();
+    pa.resize(num_of_mp * MR * std::min<int64_t>(KC, K_units));
+    for (auto k0 = 0; k0 < K_units; k0 += KC) {
+      auto kc = std::min<int64_t>(KC, K_units - k0);
+      pack_a_fn(A, K, m0, rows, k0, kc, pa.data());
+      for (auto p = p0; p < p1; ++p) {
+        const auto* pb = packed_b + p * b_panel_size + k0 * nr * pack;
+        auto cols = (int)std::min<int64_t>(nr, N - p * nr);
+        for (auto mp = 0; mp < num_of_mp; ++mp) {
+          auto mr = (int)std::min<int64_t>(MR, rows - mp * MR);
+          kernel(kc, pa.data() + mp * kc * MR, pb,
+                 C + (m0 + mp * MR) * N + p * nr, N, mr, cols, k0 > 0);
+        }
+      }
+    }
+  };
+  ThreadPool::instance().parallel_for(
+      0, num_of_mb * num_of_nb,
+      [&](int64_t begin, int64_t end) {
+        for (auto t = begin; t < end; ++t) {
+          run_task(t);
+        }
+      },
+      Schedule::DYNAMIC, 1, threads);
+}
+
+// A with fewer rows than this is multiplied by an unpacked B directly,
+// packing B would take as long as the product itself
+constexpr int64_t MIN_M_TO_PACK = 4;
+
+template <typename TA, typename TC>
+void small_gemm(const TA* A, const TA* B, TC* C, int64_t M, int64_t N,
+                int64_t K, int64_t b_k_stride, int64_t b_n_stride) {
+  for (auto m = 0; m < M; ++m) {
+    for (auto n = 0; n < N; ++n) {
+      const auto* b = B + n * b_n_stride;
+      TC acc = 0;
+      for (auto k = 0; k < K; ++k) {
+        acc += A[m * K + k] * b[k * b_k_stride];
+      }
+      C[m * N + n] = acc;
+    }
+  }
+}
+
+template <typename TC>
+bool trivial_gemm(TC* C, int64_t M, int64_t N, int64_t K) {
+  if (M <= 0 || N <= 0) {
+    return true;
+  }
+  if (K <= 0) {
+    std::fill_n(C, M * N, TC(0));
+    return true;
+  }
+  return false;
+}
+
+void log_gemm(const char* type, GemmIsa isa, int64_t M, int64_t N,
+              int64_t K) {
+  LOG_IF(INFO, ENV_PARAM(DEBUG_CPU_RUNNER_GEMM))
+      << "gemm " << type << " " << M << "x" << N << "x" << K << " on "
+      << get_gemm_isa_name(isa);
+}
+
+}  // namespace
+
+GemmIsa get_gemm_isa() {
+  static const auto isa = env_gemm_isa(detect_gemm_isa());
+  return std::min(isa, (GemmIsa)isa_cap.load());
+}
+
+void set_gemm_isa(GemmIsa isa) { isa_cap = (int)isa; }
+
+const char* get_gemm_isa_name(GemmIsa isa) {
+  switch (isa) {
+    case GemmIsa::SCALAR:
+      return "scalar";
+    case GemmIsa::SSE4:
+      return "sse4";
+    case GemmIsa::AVX2:
+      return "avx2";
+    case GemmIsa::AVX512:
+      return "avx512";
+    case GemmIsa::AVX512_VNNI:
+      return "avx512_vnni";
+  }
+  return "unknown";
+}
+
+GemmPackedB pack_gemm_b(const float* B, int64_t N, int64_t K,
+                        int64_t b_k_stride, int64_t b_n_stride) {
+  GemmPackedB packed{get_gemm_isa(), N, K, {}, {}, {}};
+  packed.f32 = pack_b(B, N, K, b_k_stride, b_n_stride,
+                      get_kernels(packed.isa).nr);
+  return packed;
+}
+
+GemmPackedB pack_gemm_b(const int32_t* B, int64_t N, int64_t K,
+                        int64_t b_k_stride, int64_t b_n_stride) {
+  GemmPackedB packed{get_gemm_isa(), N, K, {}, {}, {}};
+  auto nr = get_kernels(packed.isa).nr;
+  packed.s32 = pack_b(B, N, K, b_k_stride, b_n_stride, nr);
+  if (packed.isa != GemmIsa::SCALAR &&
+      fits_int16(B, K, N, b_k_stride, b_n_stride)) {
+    packed.s16 = pack_b16(B, N, K, b_k_stride, b_n_stride, nr);
+  }
+  return packed;
+}
+
+void gemm(const float* A, const GemmPackedB& B, float* C, int64_t M,
+          bool parallel) {
+  if (trivial_gemm(C, M, B.N, B.K)) {
+    return;
+  }
+  CHECK(!B.f32.empty()) << "B is not packed as float";
+  const auto& k = get_kernels(B.isa);
+  log_gemm("f32", B.isa, M, B.N, B.K);
+  run_tiles(k.f32, k.nr, 1, A, B.f32.data(), C, M, B.N, B.K, B.K, parallel,
+            pack_a<float>);
+}
+
+void gemm(const int32_t* A, const GemmPackedB& B, int32_t* C, int64_t M,
+          bool parallel) {
+  if (trivial_gemm(C, M, B.N, B.K)) {
+    return;
+  }
+  const auto& k = get_kernels(B.isa);
+  if (!B.s16.empty() && fits_int16(A, M, B.K, B.K, 1)) {
+    log_gemm("s16", B.isa, M, B.N, B.K);
+    run_tiles(k.s16, k.nr, 2, A, B.s16.data(), C, M, B.N, B.K, (B.K + 1) / 2,
+              parallel, pack_a16);
+    return;
+  }
+  CHECK(!B.s32.empty()) << "B is not packed as int32";
+  log_gemm("s32", B.isa, M, B.N, B.K);
+  run_tiles(k.s32, k.nr, 1, A, B.s32.data(), C, M, B.N, B.K, B.K, parallel,
+            pack_a<int32_t>);
+}
+
+void gemm(const int32_t* A, const GemmPackedB& B, float* C, int64_t M,
+          bool parallel) {
+  if (trivial_gemm(C, M, B.N, B.K)) {
+    return;
+  }
+  CHECK(!B.s32.empty()) << "B is not packed as int32";
+  const auto& k = get_kernels(B.isa);
+  log_gemm("s32f", B.isa, M, B.N, B.K);
+  run_tiles(k.s32f, k.nr, 1, A, B.s32.data(), C, M, B.N, B.K, B.K, parallel,
+            pack_a<int32_t>);
+}
+
+void gemm(const float* A, const float* B, float* C, int64_t M, int64_t N,
+          int64_t K, int64_t b_k_stride, int64_t b_n_stride, bool parallel) {
+  if (trivial_gemm(C, M, N, K)) {
+    return;
+  }
+  if (M < MIN_M_TO_PACK) {
+    small_gemm(A, B, C, M, N, K, b_k_stride, b_n_stride);
+    return;
+  }
+  gemm(A, pack_gemm_b(B, N, K, b_k_stride, b_n_stride), C, M, parallel);
+}
+
+void gemm(const int32_t* A, const int32_t* B, int32_t* C, int64_t M,
+          int64_t N, int64_t K, int64_t b_k_stride, int64_t b_n_stride,
+          bool parallel) {
+  if (trivial_gemm(C, M, N, K)) {
+    return;
+  }
+  if (M < MIN_M_TO_PACK) {
+    small_gemm(A, B, C, M, N, K, b_k_stride, b_n_stride);
+    return;
+  }
+  // pack only the panels which will be used
+  GemmPackedB packed{get_gemm_isa(), N, K, {}, {}, {}};
+  auto nr = get_kernels(packed.isa).nr;
+  if (packed.isa != GemmIsa::SCALAR && fits_int16(A, M, K, K, 1) &&
+      fits_int16(B, K, N, b_k_stride, b_n_stride)) {
+    packed.s16 = pack_b16(B, N, K, b_k_stride, b_n_stride, nr);
+  } else {
+    packed.s32 = pack_b(B, N, K, b_k_stride, b_n_stride, nr);
+  }
+  gemm(A, packed, C, M, parallel);
+}
+
+void gemm(const int32_t* A, const int32_t* B, float* C, int64_t M, int64_t N,
+          int64_t K, int64_t b_k_stride, int64_t b_n_stride, bool parallel) {
+  if (trivial_gemm(C, M, N, K)) {
+    return;
+  }
+  if (M < MIN_M_TO_PACK) {
+    small_gemm(A, B, C, M, N, K, b_k_stride, b_n_stride);
+    return;
+  }
+  GemmPackedB packed{get_gemm_isa(), N, K, {}, {}, {}};
+  packed.s32 = pack_b(B, N, K, b_k_stride, b_n_stride,
+                      get_kernels(packed.isa).nr);
+  gemm(A, packed, C, M, parallel);
+}
+
+}  // namespace cpu
+}  // namespace vart
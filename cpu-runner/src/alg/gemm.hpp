@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace vart {
+namespace cpu {
+
+// Instruction set of the gemm() micro kernels, the best one the cpu
+// supports, or a lower one if env XLNX_CPU_RUNNER_GEMM_ISA is set to
+// scalar, sse4, avx2, avx512 or avx512_vnni.
+enum class GemmIsa {
+  SCALAR,
+  SSE4,
+  AVX2,
+  AVX512,
+  AVX512_VNNI,
+};
+
+GemmIsa get_gemm_isa();
+// cap the instruction set at `isa`, for tests and benchmarks
+void set_gemm_isa(GemmIsa isa);
+const char* get_gemm_isa_name(GemmIsa isa);
+
+// C = A * B, A is [M, K] and C is [M, N], both row major, element
+// (k, n) of B is at B[k * b_k_stride + n * b_n_stride], i.e. B is
+// [K, N] with strides (N, 1), or [N, K] like conv weights with strides
+// (1, K).
+//
+// B is packed into panels of columns, A into panels of rows, and a
+// register blocked micro kernel computes one tile of C from them. Tiles
+// are split among ThreadPool threads if `parallel`.
+//
+// Every element of C adds up its products in k order starting from 0,
+// the same as the loops in cpu_gemm.hpp, so float results are bit exact
+// with them, not only the integer ones.
+void gemm(const float* A, const float* B, float* C, int64_t M, int64_t N,
+          int64_t K, int64_t b_k_stride, int64_t b_n_stride,
+          bool parallel = true);
+
+// int32 results. If all values fit int16, which is the case for fix
+// data, pairs of products are summed by one pmaddwd, or vpdpwssd with
+// VNNI, instead of two multiplies.
+void gemm(const int32_t* A, const int32_t* B, int32_t* C, int64_t M,
+          int64_t N, int64_t K, int64_t b_k_stride, int64_t b_n_stride,
+          bool parallel = true);
+
+// int32 products accumulated in float, as matmul-fix does.
+void gemm(const int32_t* A, const int32_t* B, float* C, int64_t M, int64_t N,
+          int64_t K, int64_t b_k_stride, int64_t b_n_stride,
+          bool parallel = true);
+
+// B of gemm() packed ahead of time, for weights which every run reuses.
+// The panels are laid out for the instruction set of the time it is
+// packed, and gemm() keeps using that one.
+struct GemmPackedB {
+  GemmIsa isa;
+  int64_t N;
+  int64_t K;
+  std::vector<float> f32;
+  std::vector<int32_t> s32;
+  // only if all values fit int16
+  std::vector<int16_t> s16;
+};
+
+GemmPackedB pack_gemm_b(const float* B, int64_t N, int64_t K,
+                        int64_t b_k_stride, int64_t b_n_stride);
+GemmPackedB pack_gemm_b(const int32_t* B, int64_t N, int64_t K,
+                        int64_t b_k_stride, int64_t b_n_stride);
+
+// the same as gemm() above, with B packed by pack_gemm_b()
+void gemm(const float* A, const GemmPackedB& B, float* C, int64_t M,
+          bool parallel = true);
+void gemm(const int32_t* A, const GemmPackedB& B, int32_t* C, int64_t M,
+          bool parallel = true);
+void gemm(const int32_t* A, const GemmPackedB& B, float* C, int64_t M,
+          bool parallel = true);
+
+}  // namespace cpu
+}  // namespace vart
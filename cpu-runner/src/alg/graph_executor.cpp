@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph_executor.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <utility>
+
+namespace vart {
+namespace cpu {
+
+std::vector<uint64_t> critical_path(
+    const std::vector<std::vector<size_t>>& deps,
+    const std::vector<uint64_t>& cost) {
+  auto n = deps.size();
+  std::vector<uint64_t> ret(n, 0u);
+  // walk backwards, every consumer of i is after i.
+  for (auto i = n; i-- > 0u;) {
+    // +1 so that zero cost nodes still count as a step on the path
+    ret[i] += cost[i] + 1u;
+    for (auto d : deps[i]) {
+      ret[d] = std::max(ret[d], ret[i]);
+    }
+  }
+  return ret;
+}
+
+void run_graph(const std::vector<std::vector<size_t>>& deps,
+               const std::vector<uint64_t>& cost,
+               const std::function<void(size_t)>& run_node,
+               size_t num_of_workers) {
+  auto n = deps.size();
+  CHECK_EQ(cost.size(), n);
+  if (n == 0u) {
+    return;
+  }
+
+  std::vector<std::vector<size_t>> consumers(n);
+  auto pending = std::unique_ptr<std::atomic<size_t>[]>(
+      new std::atomic<size_t>[n]);
+  for (auto i = 0u; i < n; ++i) {
+    pending[i].store(deps[i].size(), std::memory_order_relaxed);
+    for (auto d : deps[i]) {
+      CHECK_LT(d, i) << "nodes are not topologically sorted";
+      consumers[d].push_back(i);
+    }
+  }
+  auto priority = critical_path(deps, cost);
+
+  // (priority, -index), ties go to the earlier node as in serial order
+  using item_t = std::pair<uint64_t, int64_t>;
+  std::priority_queue<item_t> ready;
+  std::mutex mtx;
+  std::condition_variable cv;
+  size_t num_of_done = 0u;
+  std::exception_ptr error;
+
+  for (auto i = 0u; i < n; ++i) {
+    if (deps[i].empty()) {
+      ready.emplace(priority[i], -(int64_t)i);
+    }
+  }
+
+  auto worker = [&]() {
+    std::unique_lock<std::mutex> lock(mtx);
+    for (;;) {
+      cv.wait(lock,
+              [&] { return !ready.empty() || num_of_done == n || error; });
+      if (num_of_done == n || error) {
+        return;
+      }
+      auto i = (size_t)(-ready.top().second);
+      ready.pop();
+      lock.unlock();
+
+      std::exception_ptr e;
+      try {
+        run_node(i);
+      } catch (...) {
+        e = std::current_exception();
+      }
+
+      auto num_of_ready = 0u;
+      lock.lock();
+      if (e) {
+        if (!error) {
+          error = e;
+        }
+        cv.notify_all();
+        return;
+      }
+      for (auto c : consumers[i]) {
+        if (pending[c].fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+          ready.emplace(priority[c], -(int64_t)c);
+          num_of_ready++;
+        }
+      }
+      num_of_done++;
+      if (num_of_done == n) {
+        cv.notify_all();
+        return;
+      }
+      // this thread takes one of them itself
+      for (auto k = 1u; k < num_of_ready; ++k) {
+        cv.notify_one();
+      }
+    }
+  };
+
+  num_of_workers = std::max<size_t>(1u, std::min(num_of_workers, n));
+  std::vector<std::thread> threads;
+  threads.reserve(num_of_workers - 1u);
+  for (auto k = 1u; k < num_of_workers; ++k) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : threads) {
+    t.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace cpu
+}  // namespace vart
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace vart {
+namespace cpu {
+
+// Run the nodes of a DAG, node i only after all nodes in deps[i] are
+// done. Nodes must be topologically sorted, i.e. deps[i] < i.
+//
+// Every node has a counter of unfinished dependencies, a node whose
+// counter drops to zero goes to a ready queue which `num_of_workers`
+// threads, the calling thread included, take nodes from. The ready
+// node on the longest remaining path, weighted by cost[i], goes first,
+// so that long branches of inception blocks or detection heads start
+// early and do not finish last alone.
+//
+// Nodes run on dedicated threads, not on ThreadPool workers, so that
+// parallel_for inside a node still gets the whole pool.
+//
+// It returns when all nodes are done, or when a node throws, then the
+// first exception is rethrown after the running nodes finish.
+void run_graph(const std::vector<std::vector<size_t>>& deps,
+               const std::vector<uint64_t>& cost,
+               const std::function<void(size_t)>& run_node,
+               size_t num_of_workers);
+
+// length of the longest path from each node to a sink, weighted by cost
+std::vector<uint64_t> critical_path(
+    const std::vector<std::vector<size_t>>& deps,
+    const std::vector<uint64_t>& cost);
+
+// deps of a serial order in which the same node may appear more than
+// once, e.g. a const op that CPURunner puts in front of every op reading
+// it. Every node is kept at its first appearance only, which comes
+// before all its consumers, and `nodes` gets its position in `order`.
+// `inputs(key)` returns the keys a node waits for, keys which are not in
+// `order` are ready from the start.
+template <typename Key, typename Inputs>
+std::vector<std::vector<size_t>> dedup_deps(const std::vector<Key>& order,
+                                            Inputs inputs,
+                                            std::vector<size_t>* nodes) {
+  std::unordered_map<Key, size_t> index;
+  nodes->clear();
+  for (auto i = 0u; i < order.size(); ++i) {
+    if (index.emplace(order[i], nodes->size()).second) {
+      nodes->push_back(i);
+    }
+  }
+  std::vector<std::vector<size_t>> deps(nodes->size());
+  for (auto i = 0u; i < nodes->size(); ++i) {
+    for (const auto& input : inputs(order[(*nodes)[i]])) {
+      auto it = index.find(input);
+      if (it != index.end() && it->second != i) {
+        deps[i].push_back(it->second);
+      }
+    }
+  }
+  return deps;
+}
+
+}  // namespace cpu
+}  // namespace vart
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "memory_plan.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace vart {
+namespace cpu {
+
+static size_t align_up(size_t size, size_t alignment) {
+  return (size + alignment - 1u) / alignment * alignment;
+}
+
+std::vector<size_t> plan_offsets(const std::vector<mem_block_t>& blocks,
+                                 size_t alignment, size_t* arena_size) {
+  auto n = blocks.size();
+  std::vector<size_t> offsets(n, 0u);
+  std::vector<size_t> order(n);
+  std::iota(order.begin(), order.end(), 0u);
+  // larger first, ties by first use, so that the result is stable
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return blocks[a].size > blocks[b].size;
+  });
+
+  size_t total = 0u;
+  std::vector<size_t> placed;
+  placed.reserve(n);
+  // (offset, end) of placed blocks alive together with the current one
+  std::vector<std::pair<size_t, size_t>> live;
+  for (auto i : order) {
+    const auto& b = blocks[i];
+    auto size = align_up(b.size, alignment);
+
+    live.clear();
+    for (auto p : placed) {
+      if (blocks[p].first <= b.last && b.first <= blocks[p].last) {
+        live.emplace_back(offsets[p], offsets[p] + align_up(blocks[p].size,
+                                                            alignment));
+      }
+    }
+    std::sort(live.begin(), live.end());
+
+    auto best = std::numeric_limits<size_t>::max();
+    auto best_gap = std::numeric_limits<size_t>::max();
+    size_t prev_end = 0u;
+    for (const auto& l : live) {
+      if (l.first > prev_end) {
+        auto gap = l.first - prev_end;
+        if (gap >= size && gap < best_gap) {
+          best = prev_end;
+          best_gap = gap;
+        }
+      }
+      prev_end = std::max(prev_end, l.second);
+    }
+    offsets[i] = best != std::numeric_limits<size_t>::max() ? best : prev_end;
+    total = std::max(total, offsets[i] + size);
+    placed.push_back(i);
+  }
+
+  if (arena_size != nullptr) {
+    *arena_size = total;
+  }
+  return offsets;
+}
+
+}  // namespace cpu
+}  // namespace vart
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace vart {
+namespace cpu {
+
+// A buffer which is written by op `first` and last read by op `last`,
+// ops are numbered in the order they run.
+struct mem_block_t {
+  size_t size;
+  size_t first;
+  size_t last;
+};
+
+// Assign every block an offset in one arena, so that blocks which are
+// alive at the same time, i.e. their [first, last] overlap, do not
+// overlap in memory. Offsets are multiples of `alignment`.
+//
+// Blocks are placed from the largest to the smallest, each one into the
+// smallest gap between already placed blocks alive at the same time
+// which fits it, or after all of them if none fits.
+//
+// It returns the offsets, and the size of the arena in `arena_size`.
+std::vector<size_t> plan_offsets(const std::vector<mem_block_t>& blocks,
+                                 size_t alignment, size_t* arena_size);
+
+}  // namespace cpu
+}  // namespace vart
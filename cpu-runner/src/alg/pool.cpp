@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pool.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+#include "gemm.hpp"
+#include "reduce.hpp"
+#include "thread_pool.hpp"
+
+#if defined(__GNUC__) && !defined(__clang__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define POOL_X86 1
+#else
+#define POOL_X86 0
+#endif
+
+namespace vart {
+namespace cpu {
+
+namespace {
+
+// input elements read per thread below which waking another one does not
+// pay
+constexpr int64_t POOL_GRAIN = 256 * 1024;
+
+namespace base {
+#include "pool_kernel.inc"
+}  // namespace base
+
+#if POOL_X86
+#pragma GCC push_options
+#pragma GCC target("avx2")
+namespace avx2 {
+#include "pool_kernel.inc"
+}  // namespace avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw")
+namespace avx512 {
+#include "pool_kernel.inc"
+}  // namespace avx512
+#pragma GCC pop_options
+#endif
+
+template <bool MAX, typename T>
+base::rows_t<T> get_rows() {
+#if POOL_X86
+  auto isa = get_gemm_isa();
+  if (isa >= GemmIsa::AVX512) {
+    return avx512::rows<MAX, T>;
+  }
+  if (isa >= GemmIsa::AVX2) {
+    return avx2::rows<MAX, T>;
+  }
+#endif
+  return base::rows<MAX, T>;
+}
+
+template <bool MAX, typename T>
+void pool(const Pool& p, const T* in, T* out, bool parallel) {
+  const T init = MAX ? std::numeric_limits<T>::lowest() : T(0);
+  if (p.oh == 1 && p.ow == 1 && p.kh >= p.ih && p.kw >= p.iw) {
+    reduce_3d(MAX ? ReduceOp::MAX : ReduceOp::SUM, in, out, p.n,
+              p.ih * p.iw, p.c, parallel, &init);
+    return;
+  }
+  auto rows = get_rows<MAX, T>();
+  auto num_of_rows = p.n * p.oh;
+  auto max_threads = parallel ? num_of_rows * p.ow * p.c * p.kh * p.kw /
+                                    POOL_GRAIN
+                              : 0;
+  if (max_threads <= 1) {
+    rows(p, in, out, 0, num_of_rows);
+    return;
+  }
+  ThreadPool::instance().parallel_for(
+      0, num_of_rows,
+      [&](int64_t begin, int64_t end) { rows(p, in, out, begin, end); },
+      Schedule::STATIC, 1, (size_t)max_threads);
+}
+
+}  // namespace
+
+template <typename T>
+void max_pool(const Pool& p, const T* in, T* out, bool parallel) {
+  pool<true>(p, in, out, parallel);
+}
+
+template <typename T>
+void sum_pool(const Pool& p, const T* in, T* out, bool parallel) {
+  pool<false>(p, in, out, parallel);
+}
+
+template void max_pool(const Pool&, const int32_t*, int32_t*, bool);
+template void max_pool(const Pool&, const float*, float*, bool);
+template void max_pool(const Pool&, const double*, double*, bool);
+template void sum_pool(const Pool&, const int32_t*, int32_t*, bool);
+template void sum_pool(const Pool&, const float*, float*, bool);
+template void sum_pool(const Pool&, const double*, double*, bool);
+
+}  // namespace cpu
+}  // namespace vart
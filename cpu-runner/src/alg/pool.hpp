@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace vart {
+namespace cpu {
+
+// A max or sum pooling of an NHWC input which is already padded, as
+// PoolBase reads it. Output pixel (n, y, x) channel c folds
+// in[n][y * sh + i][x * sw + j][c] over i, then j, into the lowest value
+// or 0, skipping the taps past the input as MaxPool and AvgPool do, so
+// float results are bit exact with them.
+struct Pool {
+  // padded input
+  int64_t n;
+  int64_t ih;
+  int64_t iw;
+  int64_t c;
+  int64_t oh;
+  int64_t ow;
+  int64_t kh;
+  int64_t kw;
+  int64_t sh;
+  int64_t sw;
+};
+
+// The loops run along the channels, a block of them at a time whose
+// results stay in registers while the taps are folded in. A window over
+// the whole input is a reduce_3d() of [n, ih * iw, c]. Output rows are
+// split among ThreadPool threads if `parallel`.
+template <typename T>
+void max_pool(const Pool& p, const T* in, T* out, bool parallel);
+template <typename T>
+void sum_pool(const Pool& p, const T* in, T* out, bool parallel);
+
+}  // namespace cpu
+}  // namespace vart
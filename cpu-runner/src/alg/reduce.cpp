@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "reduce.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <type_traits>
+
+#include "gemm.hpp"
+#include "thread_pool.hpp"
+
+#if defined(__GNUC__) && !defined(__clang__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define REDUCE_X86 1
+#else
+#define REDUCE_X86 0
+#endif
+
+namespace vart {
+namespace cpu {
+
+namespace {
+
+// input elements per thread below which waking another one does not pay
+constexpr int64_t REDUCE_GRAIN = 64 * 1024;
+
+// inner elements folded at once
+constexpr int64_t REDUCE_BLOCK = 64;
+
+enum class PassKind {
+  // units are blocks of `chunk` inner elements of an outer row
+  VERTICAL,
+  // units are outer rows
+  FOLDED,
+  CHAINS,
+};
+
+struct Pass {
+  int64_t outer;
+  int64_t reduced;
+  int64_t inner;
+  PassKind kind;
+  int64_t chunk;
+};
+
+namespace base {
+#include "reduce_kernel.inc"
+}  // namespace base
+
+#if REDUCE_X86
+#pragma GCC push_options
+#pragma GCC target("avx2")
+namespace avx2 {
+#include "reduce_kernel.inc"
+}  // namespace avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw")
+namespace avx512 {
+#include "reduce_kernel.inc"
+}  // namespace avx512
+#pragma GCC pop_options
+#endif
+
+template <typename T>
+base::pass_t<T> get_pass(ReduceOp op, PassKind kind) {
+#if REDUCE_X86
+  auto isa = get_gemm_isa();
+  if (isa >= GemmIsa::AVX512) {
+    return avx512::get_pass<T>(op, kind);
+  }
+  if (isa >= GemmIsa::AVX2) {
+    return avx2::get_pass<T>(op, kind);
+  }
+#endif
+  return base::get_pass<T>(op, kind);
+}
+
+// the result of the fold does not depend on its order
+template <typename T>
+bool order_free(ReduceOp op) {
+  return std::is_integral<T>::value || op == ReduceOp::MAX ||
+         op == ReduceOp::MIN;
+}
+
+template <typename T>
+Pass make_pass(ReduceOp op, int64_t outer, int64_t reduced, int64_t inner,
+               int64_t max_threads) {
+  Pass p{outer, reduced, inner, PassKind::VERTICAL, inner};
+  if (inner <= REDUCE_BLOCK / 2 && order_free<T>(op) && reduced >= 16) {
+    p.kind = PassKind::FOLDED;
+  } else if (inner == 1) {
+    p.kind = PassKind::CHAINS;
+  } else if (max_threads > outer) {
+    // too few rows to go around, split them into blocks of whole vectors
+    auto parts = (max_threads + outer - 1) / outer;
+    auto chunk = (inner + parts - 1) / parts;
+    p.chunk = std::max(REDUCE_BLOCK, (chunk + REDUCE_BLOCK - 1) /
+                                         REDUCE_BLOCK * REDUCE_BLOCK);
+  }
+  return p;
+}
+
+}  // namespace
+
+template <typename T>
+void reduce_3d(ReduceOp op, const T* in, T* out, int64_t outer,
+               int64_t reduced, int64_t inner, bool parallel, const T* init) {
+  if (outer == 0 || inner == 0) {
+    return;
+  }
+  if (reduced == 0) {
+    // nothing to fold, only pooling windows past the input get here
+    std::fill_n(out, outer * inner, init ? *init : T(0));
+    return;
+  }
+  auto max_threads =
+      parallel ? outer * reduced * inner / REDUCE_GRAIN : int64_t(0);
+  auto p = make_pass<T>(op, outer, reduced, inner, max_threads);
+  auto units = p.kind == PassKind::VERTICAL
+                   ? outer * ((inner + p.chunk - 1) / p.chunk)
+                   : outer;
+  auto kernel = get_pass<T>(op, p.kind);
+  if (max_threads <= 1 || units <= 1) {
+    kernel(p, in, out, init, 0, units);
+    return;
+  }
+  ThreadPool::instance().parallel_for(
+      0, units,
+      [&](int64_t begin, int64_t end) {
+        kernel(p, in, out, init, begin, end);
+      },
+      Schedule::STATIC, 1, (size_t)max_threads);
+}
+
+template <typename T>
+void reduce_axes(ReduceOp op, const std::vector<int>& dims,
+                 const std::vector<int>& axes, const T* in, T* out,
+                 bool parallel) {
+  std::vector<int64_t> shape(dims.begin(), dims.end());
+  std::vector<bool> reduced(dims.size(), false);
+  for (auto a : axes) {
+    reduced[a] = true;
+  }
+  // the passes, as dims of the shape at the time of each
+  std::vector<int> order;
+  // float max and min are order free within a pass, but across passes the
+  // NaN a pass starts from decides whether it is the result
+  if (std::is_integral<T>::value) {
+    // drop dims of 1 and merge neighbours of the same kind, then take the
+    // largest reduced dim first, it shrinks what the others read the most
+    std::vector<int64_t> merged;
+    std::vector<bool> merged_reduced;
+    for (auto d = 0u; d < shape.size(); ++d) {
+      if (shape[d] == 1) {
+        continue;
+      }
+      if (!merged.empty() && merged_reduced.back() == reduced[d]) {
+        merged.back() *= shape[d];
+      } else {
+        merged.push_back(shape[d]);
+        merged_reduced.push_back(reduced[d]);
+      }
+    }
+    shape = merged;
+    for (auto d = 0u; d < shape.size(); ++d) {
+      if (merged_reduced[d]) {
+        order.push_back(d);
+      }
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](int a, int b) { return shape[a] > shape[b]; });
+  } else {
+    for (auto a : axes) {
+      // dims of 1 and axes given twice are no-ops
+      if (shape[a] != 1) {
+        order.push_back(a);
+      }
+    }
+  }
+  auto num = std::accumulate(shape.begin(), shape.end(), int64_t(1),
+                             std::multiplies<int64_t>());
+  if (order.empty()) {
+    std::copy_n(in, num, out);
+    return;
+  }
+  std::vector<T> buf[2];
+  const T* src = in;
+  for (auto i = 0u; i < order.size(); ++i) {
+    auto a = order[i];
+    auto outer = std::accumulate(shape.begin(), shape.begin() + a,
+                                 int64_t(1), std::multiplies<int64_t>());
+    auto inner = std::accumulate(shape.begin() + a + 1, shape.end(),
+                                 int64_t(1), std::multiplies<int64_t>());
+    T* dst = out;
+    if (i + 1 < order.size()) {
+      buf[i % 2].resize(outer * inner);
+      dst = buf[i % 2].data();
+    }
+    reduce_3d(op, src, dst, outer, shape[a], inner, parallel);
+    shape[a] = 1;
+    src = dst;
+  }
+}
+
+template void reduce_3d(ReduceOp, const int32_t*, int32_t*, int64_t, int64_t,
+                        int64_t, bool, const int32_t*);
+template void reduce_3d(ReduceOp, const float*, float*, int64_t, int64_t,
+                        int64_t, bool, const float*);
+template void reduce_3d(ReduceOp, const double*, double*, int64_t, int64_t,
+                        int64_t, bool, const double*);
+template void reduce_axes(ReduceOp, const std::vector<int>&,
+                          const std::vector<int>&, const int32_t*, int32_t*,
+                          bool);
+template void reduce_axes(ReduceOp, const std::vector<int>&,
+                          const std::vector<int>&, const float*, float*,
+                          bool);
+template void reduce_axes(ReduceOp, const std::vector<int>&,
+                          const std::vector<int>&, const double*, double*,
+                          bool);
+
+}  // namespace cpu
+}  // namespace vart
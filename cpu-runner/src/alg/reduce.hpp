@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace vart {
+namespace cpu {
+
+enum class ReduceOp {
+  MAX,
+  MIN,
+  SUM,
+  PROD,
+};
+
+// out[o][i] = in[o][0][i] op in[o][1][i] op ... op in[o][reduced - 1][i]
+// for an input [outer, reduced, inner], folded from left to right as the
+// reduce ops did it in place, or from *init if it is not null, as the
+// pooling ops do. max and min are those of std::max() and std::min().
+//
+// The folds run along `inner` where it is wide enough, which the compiler
+// vectorizes. Otherwise integer folds and max and min, which give the
+// same result in any order, are folded over lanes of a vector that are
+// combined at the end, and float sums and products fold several outer
+// rows at a time to stay in order. float, double and int32 have AVX2 and
+// AVX-512 builds, the gemm() ISA caps which one. Outer rows, or blocks of
+// inner elements if there are few rows, are split among ThreadPool
+// threads if `parallel`.
+template <typename T>
+void reduce_3d(ReduceOp op, const T* in, T* out, int64_t outer,
+               int64_t reduced, int64_t inner, bool parallel,
+               const T* init = nullptr);
+
+// out = `in` of shape `dims` reduced along `axes`, with dims of 1 in
+// place of the reduced ones. The axes are reduced one after the other in
+// the order given, as ReduceBase did, each as a reduce_3d() of the kept
+// dims before and after it, into a compact buffer for the next one, so
+// float results are bit exact with it. Integers, whose folds do not
+// depend on the order, merge adjacent reduced dims and adjacent kept
+// dims first, NHWC reduced along H and W is a single [N, H * W, C] pass.
+template <typename T>
+void reduce_axes(ReduceOp op, const std::vector<int>& dims,
+                 const std::vector<int>& axes, const T* in, T* out,
+                 bool parallel);
+
+}  // namespace cpu
+}  // namespace vart
@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "requantize.hpp"
+
+#include <algorithm>
+#include <functional>
+
+#include "gemm.hpp"
+#include "thread_pool.hpp"
+
+#if defined(__GNUC__) && !defined(__clang__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define REQUANTIZE_X86 1
+#include <immintrin.h>
+#else
+#define REQUANTIZE_X86 0
+#endif
+
+namespace vart {
+namespace cpu {
+
+namespace {
+
+// elements per thread below which waking another one does not pay
+constexpr int64_t REQUANTIZE_GRAIN = 32 * 1024;
+
+// round_even() without branches
+inline int32_t round_even_clamp(int64_t y, int shift, int32_t lo, int32_t hi) {
+  auto half = int64_t(1) << (shift - 1);
+  auto frac = y & (2 * half - 1);
+  auto q = static_cast<int32_t>(y >> shift);
+  auto up = frac > half || (frac == half && (q & 1));
+  q = static_cast<int32_t>(static_cast<uint32_t>(q) + up);
+  return std::min(std::max(q, lo), hi);
+}
+
+inline int32_t requantize_one(const Requantize& q, int64_t row_add,
+                              int32_t acc, int64_t c) {
+  auto y = q.mul * acc + q.add[c] + row_add;
+  if (q.relu) {
+    y = std::max(y, int64_t(0));
+  }
+  return round_even_clamp(y + q.post, q.shift, q.lo, q.hi);
+}
+
+using row_kernel_t = void (*)(const Requantize&, int64_t, const int32_t*,
+                              int32_t*, int64_t);
+
+void row_scalar(const Requantize& q, int64_t row_add, const int32_t* acc,
+                int32_t* out, int64_t n) {
+  for (auto c = 0; c < n; ++c) {
+    out[c] = requantize_one(q, row_add, acc[c], c);
+  }
+}
+
+#if REQUANTIZE_X86
+#pragma GCC push_options
+#pragma GCC target("avx2")
+namespace avx2 {
+
+// 4 int64 lanes up to the rounding, there is no arithmetic shift of
+// int64 lanes in AVX2, so the sign is flipped around a logical one
+inline __m256i quantize4(const Requantize& q, __m256i acc, const int64_t* add,
+                         __m256i mul, __m256i row_add, __m256i post,
+                         __m128i shift, __m256i half, __m256i frac_mask) {
+  auto zero = _mm256_setzero_si256();
+  auto y = _mm256_add_epi64(
+      _mm256_mul_epi32(acc, mul),
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(add)));
+  y = _mm256_add_epi64(y, row_add);
+  if (q.relu) {
+    y = _mm256_andnot_si256(_mm256_cmpgt_epi64(zero, y), y);
+  }
+  y = _mm256_add_epi64(y, post);
+  auto sign = _mm256_cmpgt_epi64(zero, y);
+  auto r = _mm256_xor_si256(
+      _mm256_srl_epi64(_mm256_xor_si256(y, sign), shift), sign);
+  auto frac = _mm256_and_si256(y, frac_mask);
+  auto odd = _mm256_slli_epi64(r, 63);
+  auto up = _mm256_or_si256(
+      _mm256_cmpgt_epi64(frac, half),
+      _mm256_and_si256(_mm256_cmpeq_epi64(frac, half),
+                       _mm256_cmpgt_epi64(zero, odd)));
+  // up is -1 where rounding up, only the low 32 bits of r are kept
+  return _mm256_sub_epi64(r, up);
+}
+
+void row_kernel(const Requantize& q, int64_t row_add, const int32_t* acc,
+                int32_t* out, int64_t n) {
+  auto mul = _mm256_set1_epi64x(q.mul);
+  auto row = _mm256_set1_epi64x(row_add);
+  auto post = _mm256_set1_epi64x(q.post);
+  auto shift = _mm_cvtsi32_si128(q.shift);
+  auto half = _mm256_set1_epi64x(int64_t(1) << (q.shift - 1));
+  auto frac_mask = _mm256_set1_epi64x((int64_t(1) << q.shift) - 1);
+  auto lo = _mm256_set1_epi32(q.lo);
+  auto hi = _mm256_set1_epi32(q.hi);
+  // low 32 bits of each int64 lane into the low 128 bits
+  auto low_halves = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+  int64_t c = 0;
+  for (; c + 8 <= n; c += 8) {
+    auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + c));
+    auto r0 = quantize4(q, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(a)),
+                        q.add + c, mul, row, post, shift, half, frac_mask);
+    auto r1 =
+        quantize4(q, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(a, 1)),
+                  q.add + c + 4, mul, row, post, shift, half, frac_mask);
+    r0 = _mm256_permutevar8x32_epi32(r0, low_halves);
+    r1 = _mm256_permutevar8x32_epi32(r1, low_halves);
+    auto r = _mm256_permute2x128_si256(r0, r1, 0x20);
+    r = _mm256_min_epi32(_mm256_max_epi32(r, lo), hi);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + c), r);
+  }
+  for (; c < n; ++c) {
+    out[c] = requantize_one(q, row_add, acc[c], c);
+  }
+}
+
+}  // namespace avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+namespace avx512 {
+
+// _mm512_cvtepi32_epi64 and friends trip -Wmaybe-uninitialized of gcc 12,
+// hence the maskz forms
+inline __m256i quantize8(const Requantize& q, const int32_t* acc,
+                         const int64_t* add, __m512i mul, __m512i row_add,
+                         __m512i post, __m128i shift, __m512i half,
+                         __m512i frac_mask) {
+  auto one = _mm512_set1_epi64(1);
+  auto a = _mm512_maskz_cvtepi32_epi64(
+      0xff, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc)));
+  auto y = _mm512_add_epi64(_mm512_maskz_mul_epi32(0xff, a, mul),
+                            _mm512_loadu_si512(add));
+  y = _mm512_add_epi64(y, row_add);
+  if (q.relu) {
+    y = _mm512_maskz_max_epi64(0xff, y, _mm512_setzero_si512());
+  }
+  y = _mm512_add_epi64(y, post);
+  auto r = _mm512_maskz_sra_epi64(0xff, y, shift);
+  auto frac = _mm512_and_si512(y, frac_mask);
+  auto up = _mm512_cmpgt_epi64_mask(frac, half) |
+            (_mm512_cmpeq_epi64_mask(frac, half) &
+             _mm512_test_epi64_mask(r, one));
+  r = _mm512_mask_add_epi64(r, up, r, one);
+  return _mm512_maskz_cvtepi64_epi32(0xff, r);
+}
+
+void row_kernel(const Requantize& q, int64_t row_add, const int32_t* acc,
+                int32_t* out, int64_t n) {
+  auto mul = _mm512_set1_epi64(q.mul);
+  auto row = _mm512_set1_epi64(row_add);
+  auto post = _mm512_set1_epi64(q.post);
+  auto shift = _mm_cvtsi32_si128(q.shift);
+  auto half = _mm512_set1_epi64(int64_t(1) << (q.shift - 1));
+  auto frac_mask = _mm512_set1_epi64((int64_t(1) << q.shift) - 1);
+  auto lo = _mm256_set1_epi32(q.lo);
+  auto hi = _mm256_set1_epi32(q.hi);
+  int64_t c = 0;
+  for (; c + 8 <= n; c += 8) {
+    auto r = quantize8(q, acc + c, q.add + c, mul, row, post, shift, half,
+                       frac_mask);
+    r = _mm256_min_epi32(_mm256_max_epi32(r, lo), hi);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + c), r);
+  }
+  for (; c < n; ++c) {
+    out[c] = requantize_one(q, row_add, acc[c], c);
+  }
+}
+
+}  // namespace avx512
+#pragma GCC pop_options
+#endif
+
+row_kernel_t get_row_kernel(const Requantize& q) {
+  if (q.mul < INT32_MIN || q.mul > INT32_MAX) {
+    return row_scalar;
+  }
+#if REQUANTIZE_X86
+  auto isa = get_gemm_isa();
+  if (isa >= GemmIsa::AVX512) {
+    return avx512::row_kernel;
+  }
+  if (isa >= GemmIsa::AVX2) {
+    return avx2::row_kernel;
+  }
+#endif
+  return row_scalar;
+}
+
+}  // namespace
+
+void requantize(const Requantize& q, const int32_t* acc, int64_t lda,
+                int32_t* out, int64_t ldo, int64_t rows, int64_t channels,
+                bool parallel) {
+  auto kernel = get_row_kernel(q);
+  auto run = [&](int64_t begin, int64_t end) {
+    for (auto r = begin; r < end; ++r) {
+      kernel(q, q.row_add ? q.row_add[r] : 0, acc + r * lda, out + r * ldo,
+             channels);
+    }
+  };
+  auto max_threads = parallel ? rows * channels / REQUANTIZE_GRAIN : 0;
+  if (max_threads <= 1) {
+    run(0, rows);
+    return;
+  }
+  ThreadPool::instance().parallel_for(0, rows, run, Schedule::STATIC, 1,
+                                      (size_t)max_threads);
+}
+
+}  // namespace cpu
+}  // namespace vart
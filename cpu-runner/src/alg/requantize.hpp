@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace vart {
+namespace cpu {
+
+// Fixed point requantization of int32 accumulators, as the qlinear ops do
+// it. Element c of row r becomes, in int64,
+//
+//   y = mul * acc[r][c] + add[c] + row_add[r]
+//   y = max(y, 0) if relu
+//   out[r][c] = clamp(round_half_even((y + post) / 2^shift), lo, hi)
+//
+// The rounding is that of round_even() in q_linear_conv2d.cpp, including
+// the truncation of the shifted value to int32 before it is clamped.
+struct Requantize {
+  int64_t mul = 1;
+  // one per channel
+  const int64_t* add = nullptr;
+  // one per row, none if null
+  const int64_t* row_add = nullptr;
+  bool relu = false;
+  int64_t post = 0;
+  // at least 1
+  int shift = 1;
+  int32_t lo = INT32_MIN;
+  int32_t hi = INT32_MAX;
+};
+
+// rows x channels elements, row r of acc at acc + r * lda and of out at
+// out + r * ldo, out may be acc. AVX2 and AVX-512 kernels, the gemm() ISA
+// caps which one, if mul fits int32, rows are split among ThreadPool
+// threads if `parallel` and there are enough of them.
+void requantize(const Requantize& q, const int32_t* acc, int64_t lda,
+                int32_t* out, int64_t ldo, int64_t rows, int64_t channels,
+                bool parallel = true);
+
+}  // namespace cpu
+}  // namespace vart
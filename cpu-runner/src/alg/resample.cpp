@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "resample.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+#include "gemm.hpp"
+#include "thread_pool.hpp"
+
+#if defined(__GNUC__) && !defined(__clang__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define RESAMPLE_X86 1
+#else
+#define RESAMPLE_X86 0
+#endif
+
+namespace vart {
+namespace cpu {
+
+namespace {
+
+// output elements per thread below which waking another one does not pay
+constexpr int64_t RESAMPLE_GRAIN = 64 * 1024;
+
+namespace base {
+#include "resample_kernel.inc"
+}  // namespace base
+
+#if RESAMPLE_X86
+#pragma GCC push_options
+#pragma GCC target("avx2")
+namespace avx2 {
+#include "resample_kernel.inc"
+}  // namespace avx2
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw")
+namespace avx512 {
+#include "resample_kernel.inc"
+}  // namespace avx512
+#pragma GCC pop_options
+#endif
+
+template <typename T, typename U>
+base::nearest_t<T, U> get_nearest() {
+#if RESAMPLE_X86
+  auto isa = get_gemm_isa();
+  if (isa >= GemmIsa::AVX512) {
+    return avx512::nearest<T, U>;
+  }
+  if (isa >= GemmIsa::AVX2) {
+    return avx2::nearest<T, U>;
+  }
+#endif
+  return base::nearest<T, U>;
+}
+
+template <typename T>
+base::bilinear_t<T> get_bilinear() {
+#if RESAMPLE_X86
+  auto isa = get_gemm_isa();
+  if (isa >= GemmIsa::AVX512) {
+    return avx512::bilinear<T>;
+  }
+  if (isa >= GemmIsa::AVX2) {
+    return avx2::bilinear<T>;
+  }
+#endif
+  return base::bilinear<T>;
+}
+
+template <typename T, bool HALF_EVEN>
+base::bilinear_fix_t<T> get_bilinear_fix() {
+#if RESAMPLE_X86
+  auto isa = get_gemm_isa();
+  if (isa >= GemmIsa::AVX512) {
+    return avx512::bilinear_fix<T, HALF_EVEN>;
+  }
+  if (isa >= GemmIsa::AVX2) {
+    return avx2::bilinear_fix<T, HALF_EVEN>;
+  }
+#endif
+  return base::bilinear_fix<T, HALF_EVEN>;
+}
+
+void for_rows(const Resample& r, bool parallel,
+              const std::function<void(int64_t, int64_t)>& rows) {
+  auto num_of_rows = r.n * r.oh;
+  auto max_threads =
+      parallel ? num_of_rows * r.ow * r.c / RESAMPLE_GRAIN : 0;
+  if (max_threads <= 1) {
+    rows(0, num_of_rows);
+    return;
+  }
+  ThreadPool::instance().parallel_for(0, num_of_rows, rows, Schedule::STATIC,
+                                      1, (size_t)max_threads);
+}
+
+}  // namespace
+
+template <typename T, typename U>
+void resample_nearest(const Resample& r, const T* in, U* out, bool parallel) {
+  auto rows = get_nearest<T, U>();
+  for_rows(r, parallel,
+           [&](int64_t begin, int64_t end) { rows(r, in, out, begin, end); });
+}
+
+template <typename T>
+void resample_bilinear(const Resample& r, const T* in, float* out,
+                       bool parallel) {
+  auto rows = get_bilinear<T>();
+  for_rows(r, parallel,
+           [&](int64_t begin, int64_t end) { rows(r, in, out, begin, end); });
+}
+
+template <typename T>
+void resample_bilinear_fix(const Resample& r, const ResampleFix& f,
+                           const T* in, T* out, bool parallel) {
+  auto rows = f.half_even ? get_bilinear_fix<T, true>()
+                          : get_bilinear_fix<T, false>();
+  for_rows(r, parallel, [&](int64_t begin, int64_t end) {
+    rows(r, f, in, out, begin, end);
+  });
+}
+
+template void resample_nearest(const Resample&, const int32_t*, int32_t*,
+                               bool);
+template void resample_nearest(const Resample&, const float*, float*, bool);
+template void resample_nearest(const Resample&, const double*, double*,
+                               bool);
+template void resample_nearest(const Resample&, const int32_t*, float*, bool);
+template void resample_nearest(const Resample&, const double*, float*, bool);
+template void resample_bilinear(const Resample&, const int32_t*, float*,
+                                bool);
+template void resample_bilinear(const Resample&, const float*, float*, bool);
+template void resample_bilinear(const Resample&, const double*, float*,
+                                bool);
+template void resample_bilinear_fix(const Resample&, const ResampleFix&,
+                                    const int32_t*, int32_t*, bool);
+template void resample_bilinear_fix(const Resample&, const ResampleFix&,
+                                    const float*, float*, bool);
+template void resample_bilinear_fix(const Resample&, const ResampleFix&,
+                                    const double*, double*, bool);
+
+}  // namespace cpu
+}  // namespace vart
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace vart {
+namespace cpu {
+
+// Where the output rows or columns of a resize read from. Output index i
+// reads source indices lower[i] and upper[i], weighted by lerp[i] in
+// float, or by weight_lower[i] and weight_upper[i] in fixed point.
+// Nearest only uses lower. The op fills these with its own coordinate
+// formulas, once.
+struct ResampleAxis {
+  std::vector<int64_t> lower;
+  std::vector<int64_t> upper;
+  std::vector<float> lerp;
+  std::vector<int32_t> weight_lower;
+  std::vector<int32_t> weight_upper;
+};
+
+// A 2-D resize of an NHWC input.
+struct Resample {
+  int64_t n;
+  int64_t ih;
+  int64_t iw;
+  int64_t c;
+  int64_t oh;
+  int64_t ow;
+  ResampleAxis ys;
+  ResampleAxis xs;
+};
+
+// How the fixed point bilinear rounds, as round_normal() would: the
+// vertical sums are divided by 2^shift_v into int16, then the horizontal
+// ones by 2^shift_h into the output type. Ties go to the even integer or
+// up.
+struct ResampleFix {
+  int shift_v;
+  int shift_h;
+  bool half_even;
+};
+
+// All of these run along the channels of an output row and split the
+// rows among ThreadPool threads if `parallel`.
+
+// out pixel (n, y, x) = in pixel (n, ys.lower[y], xs.lower[x])
+template <typename T, typename U>
+void resample_nearest(const Resample& r, const T* in, U* out, bool parallel);
+
+// top = tl + (tr - tl) * xs.lerp, bottom likewise, and
+// out = top + (bottom - top) * ys.lerp, in float as the Resize op does.
+// The horizontal pass is computed once per input row.
+template <typename T>
+void resample_bilinear(const Resample& r, const T* in, float* out,
+                       bool parallel);
+
+// left = round(tl * ys.weight_lower + bl * ys.weight_upper) and right
+// likewise, both int16, then out = round(left * xs.weight_lower + right *
+// xs.weight_upper), with the inputs truncated to int as the
+// ResizeBilinearFix op does. Float outputs are not rounded.
+template <typename T>
+void resample_bilinear_fix(const Resample& r, const ResampleFix& f,
+                           const T* in, T* out, bool parallel);
+
+}  // namespace cpu
+}  // namespace vart
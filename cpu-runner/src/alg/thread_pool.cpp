@@ -0,0 +1,259 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "thread_pool.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vitis/ai/env_config.hpp>
+
+#include "cpu_helper.hpp"
+
+DEF_ENV_PARAM(XLNX_CPU_RUNNER_AFFINITY, "0");
+// 0 means one per cpu in the affinity mask.
+DEF_ENV_PARAM(XLNX_CPU_RUNNER_NUM_OF_THREADS, "0");
+DEF_ENV_PARAM(DEBUG_CPU_RUNNER_THREAD_POOL, "0");
+
+namespace vart {
+namespace cpu {
+
+struct ThreadPool::job_t {
+  const std::function<void(int64_t, int64_t)>* f;
+  int64_t begin;
+  int64_t end;
+  int64_t chunk;
+  int64_t num_of_chunks;
+  size_t max_helpers;
+  std::atomic<int64_t> next{0};
+  std::atomic<int64_t> done{0};
+  std::atomic<size_t> num_of_helpers{0u};
+  std::mutex mtx;
+  std::condition_variable cv;
+  bool finished{false};
+  std::exception_ptr error;
+};
+
+// true on the workers, nested parallel_for runs serially on them.
+static thread_local bool tl_is_worker = false;
+
+#ifdef __linux__
+// "0-3,8-11" => {0, 1, 2, 3, 8, 9, 10, 11}
+static std::vector<int> parse_cpu_list(const std::string& s) {
+  auto ret = std::vector<int>();
+  std::stringstream str(s);
+  std::string item;
+  while (std::getline(str, item, ',')) {
+    auto pos = item.find('-');
+    auto first = std::stoi(item.substr(0, pos));
+    auto last =
+        pos == std::string::npos ? first : std::stoi(item.substr(pos + 1));
+    for (auto cpu = first; cpu <= last; ++cpu) {
+      ret.push_back(cpu);
+    }
+  }
+  return ret;
+}
+
+// the cpus which the process may run on, ordered by NUMA node.
+static std::vector<int> get_allowed_cpus() {
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  auto ret = std::vector<int>();
+  if (sched_getaffinity(0, sizeof(mask), &mask) != 0) {
+    return ret;
+  }
+  auto node_of_cpu = std::map<int, int>();
+  for (auto node = 0;; ++node) {
+    std::ifstream f("/sys/devices/system/node/node" + std::to_string(node) +
+                    "/cpulist");
+    std::string list;
+    if (!f || !std::getline(f, list)) {
+      break;
+    }
+    for (auto cpu : parse_cpu_list(list)) {
+      node_of_cpu[cpu] = node;
+    }
+  }
+  for (auto cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &mask)) {
+      ret.push_back(cpu);
+    }
+  }
+  std::stable_sort(ret.begin(), ret.end(), [&node_of_cpu](int a, int b) {
+    return node_of_cpu[a] < node_of_cpu[b];
+  });
+  return ret;
+}
+#endif
+
+ThreadPool& ThreadPool::instance() {
+  static ThreadPool pool;
+  return pool;
+}
+
+ThreadPool::ThreadPool() : stop_(false) {
+  auto num_of_cpus = (size_t)std::max(1u, std::thread::hardware_concurrency());
+#ifdef __linux__
+  auto cpus = get_allowed_cpus();
+  if (!cpus.empty()) {
+    num_of_cpus = cpus.size();
+  }
+#endif
+  if (ENV_PARAM(XLNX_CPU_RUNNER_NUM_OF_THREADS) > 0) {
+    num_of_cpus = (size_t)ENV_PARAM(XLNX_CPU_RUNNER_NUM_OF_THREADS);
+  }
+  for (auto i = 0u; i + 1u < num_of_cpus; ++i) {
+    workers_.emplace_back([this]() { worker_main(); });
+#ifdef __linux__
+    // the calling thread usually runs on the first cpu.
+    if (ENV_PARAM(XLNX_CPU_RUNNER_AFFINITY) && i + 1u < cpus.size()) {
+      cpu_set_t mask;
+      CPU_ZERO(&mask);
+      CPU_SET(cpus[i + 1u], &mask);
+      pthread_setaffinity_np(workers_.back().native_handle(), sizeof(mask),
+                             &mask);
+    }
+#endif
+  }
+  LOG_IF(INFO, ENV_PARAM(DEBUG_CPU_RUNNER_THREAD_POOL))
+      << "cpu runner thread pool started. num_of_workers=" << workers_.size();
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& w : workers_) {
+    w.join();
+  }
+}
+
+bool ThreadPool::run_chunks(job_t* job) {
+  auto ret = false;
+  while (true) {
+    auto idx = job->next.fetch_add(1);
+    if (idx >= job->num_of_chunks) {
+      break;
+    }
+    ret = true;
+    auto begin = job->begin + idx * job->chunk;
+    auto end = std::min(begin + job->chunk, job->end);
+    try {
+      (*job->f)(begin, end);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(job->mtx);
+      if (!job->error) {
+        job->error = std::current_exception();
+      }
+    }
+    if (job->done.fetch_add(1) + 1 == job->num_of_chunks) {
+      std::lock_guard<std::mutex> lock(job->mtx);
+      job->finished = true;
+      job->cv.notify_all();
+    }
+  }
+  return ret;
+}
+
+void ThreadPool::worker_main() {
+  tl_is_worker = true;
+  while (true) {
+    std::shared_ptr<job_t> job;
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+      if (stop_) {
+        return;
+      }
+      job = jobs_.front();
+      // a job leaves the queue once it has all the helpers it may have,
+      // or nothing is left to take.
+      auto helpers = ++job->num_of_helpers;
+      if (helpers >= job->max_helpers ||
+          job->next.load() >= job->num_of_chunks) {
+        jobs_.pop_front();
+      }
+    }
+    run_chunks(job.get());
+  }
+}
+
+void ThreadPool::parallel_for(int64_t begin, int64_t end,
+                              const std::function<void(int64_t, int64_t)>& f,
+                              Schedule schedule, int64_t grain,
+                              size_t max_threads) {
+  if (begin >= end) {
+    return;
+  }
+  auto n = end - begin;
+  if (max_threads == 0u) {
+    max_threads = (size_t)std::max(1l, CPU_NUM);
+  }
+  auto num_of_threads = std::min(max_threads, this->num_of_threads());
+  auto chunk = schedule == Schedule::STATIC
+                   ? (n + (int64_t)num_of_threads - 1) / (int64_t)num_of_threads
+                   : std::max<int64_t>(grain, 1);
+  auto num_of_chunks = (n + chunk - 1) / chunk;
+  if (tl_is_worker || num_of_threads <= 1u || num_of_chunks <= 1) {
+    f(begin, end);
+    return;
+  }
+  auto job = std::make_shared<job_t>();
+  job->f = &f;
+  job->begin = begin;
+  job->end = end;
+  job->chunk = chunk;
+  job->num_of_chunks = num_of_chunks;
+  job->max_helpers =
+      std::min<size_t>(num_of_threads - 1u, (size_t)num_of_chunks - 1u);
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    jobs_.push_back(job);
+  }
+  for (auto i = 0u; i < job->max_helpers; ++i) {
+    cv_.notify_one();
+  }
+  run_chunks(job.get());
+  {
+    std::unique_lock<std::mutex> lock(job->mtx);
+    job->cv.wait(lock, [&job]() { return job->finished; });
+  }
+  {
+    // it is still queued if no worker was free to help.
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = std::find(jobs_.begin(), jobs_.end(), job);
+    if (it != jobs_.end()) {
+      jobs_.erase(it);
+    }
+  }
+  if (job->error) {
+    std::rethrow_exception(job->error);
+  }
+}
+
+}  // namespace cpu
+}  // namespace vart
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vart {
+namespace cpu {
+
+// How parallel_for splits [begin, end) into chunks.
+//   STATIC:  one contiguous chunk per thread, for even workloads.
+//   DYNAMIC: chunks of `grain` iterations, taken by whichever thread is
+//            free, for uneven workloads.
+enum class Schedule {
+  STATIC,
+  DYNAMIC,
+};
+
+// A process-wide pool of persistent worker threads, so that op kernels
+// do not create and join threads on every invocation.
+//
+// Workers are created once, one per cpu in the affinity mask of the
+// process minus one, because the calling thread always takes part, or
+// env XLNX_CPU_RUNNER_NUM_OF_THREADS minus one if it is set. If
+// env XLNX_CPU_RUNNER_AFFINITY=1, every worker is pinned to one cpu,
+// and the cpus are ordered by NUMA node, so that consecutive chunks run
+// on the same node.
+//
+// parallel_for may be called from several threads at the same time,
+// e.g. by several runners, their jobs share the workers. A nested call
+// from a worker runs serially on that worker.
+class ThreadPool {
+ public:
+  static ThreadPool& instance();
+  ~ThreadPool();
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+ public:
+  // workers plus the calling thread
+  size_t num_of_threads() const { return workers_.size() + 1u; }
+
+  // call f(chunk_begin, chunk_end) for disjoint chunks which cover
+  // [begin, end), by at most `max_threads` threads, 0 means all. It
+  // returns when all chunks are done, the first exception thrown by f
+  // is rethrown.
+  void parallel_for(int64_t begin, int64_t end,
+                    const std::function<void(int64_t, int64_t)>& f,
+                    Schedule schedule = Schedule::STATIC, int64_t grain = 1,
+                    size_t max_threads = 0u);
+
+ private:
+  struct job_t;
+  ThreadPool();
+  void worker_main();
+  // run chunks of `job` until none is left, true if it did any.
+  static bool run_chunks(job_t* job);
+
+ private:
+  std::vector<std::thread> workers_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::deque<std::shared_ptr<job_t>> jobs_;
+  bool stop_;
+};
+
+// call f(i) for i in [0, n), one chunk per thread; n is usually
+// THREAD_NUM and f processes the i-th THREAD_WORKLOAD, e.g.
+//
+//   parallel_for(THREAD_NUM, [this](int64_t i) { ... });
+template <typename F>
+void parallel_for(int64_t n, F&& f) {
+  ThreadPool::instance().parallel_for(
+      0, n, [&f](int64_t begin, int64_t end) {
+        for (auto i = begin; i < end; ++i) {
+          f(i);
+        }
+      });
+}
+
+// call f(begin, end) for chunks of [0, n), see ThreadPool::parallel_for
+template <typename F>
+void parallel_for_range(int64_t n, F&& f, Schedule schedule,
+                        int64_t grain = 1) {
+  ThreadPool::instance().parallel_for(
+      0, n, [&f](int64_t begin, int64_t end) { f(begin, end); }, schedule,
+      grain);
+}
+
+}  // namespace cpu
+}  // namespace vart
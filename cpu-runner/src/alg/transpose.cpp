@@ -0,0 +1,612 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "transpose.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vitis/ai/env_config.hpp>
+
+#include "broadcast.hpp"
+#include "thread_pool.hpp"
+
+#if defined(__GNUC__) && !defined(__clang__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define TRANSPOSE_X86 1
+#include <immintrin.h>
+#else
+#define TRANSPOSE_X86 0
+#endif
+
+DEF_ENV_PARAM(DEBUG_CPU_RUNNER_TRANSPOSE, "0");
+
+namespace vart {
+namespace cpu {
+
+// smallest tile dim, and most positions after it, of a transpose in tiles
+constexpr int64_t MIN_TILE_DIM = 8;
+constexpr int64_t MAX_TILE_ROWS = 64 * 1024;
+
+Transpose make_transpose(const std::vector<int>& out_dims,
+                         const std::vector<int64_t>& in_strides,
+                         int64_t offset) {
+  CHECK_EQ(out_dims.size(), in_strides.size());
+  Transpose t;
+  t.offset = offset;
+  t.num = 1;
+  for (auto d = 0u; d < out_dims.size(); ++d) {
+    t.num *= out_dims[d];
+    if (out_dims[d] == 1) {
+      continue;
+    }
+    if (!t.dims.empty() && t.strides.back() == in_strides[d] * out_dims[d]) {
+      t.dims.back() *= out_dims[d];
+      t.strides.back() = in_strides[d];
+    } else {
+      t.dims.push_back(out_dims[d]);
+      t.strides.push_back(in_strides[d]);
+    }
+  }
+  if (t.dims.empty()) {
+    t.dims.push_back(1);
+    t.strides.push_back(1);
+  }
+  // tiles need a few elements along the tile dim, and a table of the
+  // positions after it of reasonable size
+  auto nd = (int)t.dims.size();
+  if (t.strides[nd - 1] != 1) {
+    int64_t rows = 1;
+    for (auto d = nd; d-- > 0 && rows <= MAX_TILE_ROWS;) {
+      if (t.strides[d] == 1) {
+        t.tile_dim = t.dims[d] >= MIN_TILE_DIM ? d : -1;
+        break;
+      }
+      rows *= t.dims[d];
+    }
+  }
+  if (t.tile_dim >= 0) {
+    t.tile_rows.push_back(0);
+    for (auto d = t.tile_dim + 1; d < nd; ++d) {
+      std::vector<int64_t> rows;
+      for (auto off : t.tile_rows) {
+        for (auto x = 0; x < t.dims[d]; ++x) {
+          rows.push_back(off + x * t.strides[d]);
+        }
+      }
+      t.tile_rows.swap(rows);
+    }
+  }
+
+  if (ENV_PARAM(DEBUG_CPU_RUNNER_TRANSPOSE)) {
+    std::string dims, strides;
+    for (auto d = 0; d < nd; ++d) {
+      dims += (d ? "," : "") + std::to_string(t.dims[d]);
+      strides += (d ? "," : "") + std::to_string(t.strides[d]);
+    }
+    LOG(INFO) << "transpose " << t.num << " elements as [" << dims
+              << "] from strides [" << strides << "], "
+              << (t.tile_dim >= 0 ? "tiles of dim " +
+                                        std::to_string(t.tile_dim)
+                                  : t.strides[nd - 1] == 1 ? std::string("rows")
+                                                           : std::string(
+                                                                 "gather"));
+  }
+  return t;
+}
+
+static std::vector<int64_t> dense_strides(const std::vector<int>& shape) {
+  std::vector<int64_t> strides(shape.size());
+  int64_t stride = 1;
+  for (auto d = shape.size(); d-- > 0u;) {
+    strides[d] = stride;
+    stride *= shape[d];
+  }
+  return strides;
+}
+
+Transpose make_permute(const std::vector<int>& in_shape,
+                       const std::vector<int>& order) {
+  CHECK_EQ(in_shape.size(), order.size());
+  auto in_strides = dense_strides(in_shape);
+  std::vector<int> dims;
+  std::vector<int64_t> strides;
+  for (auto d : order) {
+    dims.push_back(in_shape[d]);
+    strides.push_back(in_strides[d]);
+  }
+  return make_transpose(dims, strides);
+}
+
+Transpose make_pixel_shuffle(const std::vector<int>& in_shape, int scale,
+                             bool upscale) {
+  CHECK_EQ(in_shape.size(), 4u);
+  auto n = in_shape[0], h = in_shape[1], w = in_shape[2], c = in_shape[3];
+  int64_t s = scale;
+  if (upscale) {
+    // out[b][y * s + i][x * s + j][k] = in[b][y][x][k * s * s + i * s + j]
+    auto oc = c / scale / scale;
+    return make_transpose({n, h, scale, w, scale, oc},
+                          {(int64_t)h * w * c, (int64_t)w * c, s, c, 1, s * s});
+  }
+  // out[b][y][x][k * s * s + i * s + j] = in[b][y * s + i][x * s + j][k]
+  return make_transpose(
+      {n, h / scale, w / scale, c, scale, scale},
+      {(int64_t)h * w * c, s * w * c, s * c, 1, (int64_t)w * c, c});
+}
+
+Transpose make_channel_shuffle(const std::vector<int>& shape, int group) {
+  CHECK(!shape.empty());
+  auto c = shape.back();
+  CHECK_EQ(c % group, 0) << "channels " << c << ", group " << group;
+  auto pixels = 1;
+  for (auto d = 0u; d + 1u < shape.size(); ++d) {
+    pixels *= shape[d];
+  }
+  return make_transpose({pixels, c / group, group}, {c, 1, c / group});
+}
+
+Transpose make_strided_slice(const std::vector<int>& in_shape,
+                             const std::vector<int>& begin,
+                             const std::vector<int>& end,
+                             const std::vector<int>& strides,
+                             std::vector<int>* out_shape) {
+  CHECK_EQ(begin.size(), in_shape.size());
+  CHECK_EQ(end.size(), in_shape.size());
+  CHECK_EQ(strides.size(), in_shape.size());
+  // output element x is input element begin + x * strides
+  auto in_strides = dense_strides(in_shape);
+  out_shape->resize(in_shape.size());
+  int64_t offset = 0;
+  for (auto d = 0u; d < in_shape.size(); ++d) {
+    // ceil((end - begin) / stride), none if end is on the wrong side
+    auto s = strides[d];
+    auto n = end[d] - begin[d] + s - (s > 0 ? 1 : -1);
+    (*out_shape)[d] = std::max(0, n / s);
+    offset += in_strides[d] * begin[d];
+    in_strides[d] *= strides[d];
+  }
+  return make_transpose(*out_shape, in_strides, offset);
+}
+
+bool make_reorg(const std::vector<int>& in_shape, int scale, bool reverse,
+                Transpose* t) {
+  CHECK_EQ(in_shape.size(), 4u);
+  auto h = in_shape[1], w = in_shape[2], c = in_shape[3];
+  int64_t s = scale;
+  // rows are swapped within units of s * s rows: row u * s * s + i * s + j
+  // and u * s * s + j * s + i trade places, and s * s pixels are packed
+  // into the channels of one, or unpacked if reverse
+  if (!reverse) {
+    if (h % (scale * scale) != 0 || w % scale != 0) return false;
+    // out[u * s + j][x][(i * s + k) * c + m]
+    //   = in[u * s * s + i * s + j][x * s + k][m]
+    *t = make_transpose({h / scale / scale, scale, w / scale, scale, scale, c},
+                        {s * s * w * c, (int64_t)w * c, s * c, s * w * c, c, 1});
+    return true;
+  }
+  if (h % scale != 0 || c % (scale * scale) != 0) return false;
+  // out[u * s * s + i * s + j][x * s + k][m]
+  //   = in[u * s + j][x][(i * s + k) * oc + m]
+  auto oc = c / scale / scale;
+  *t = make_transpose({h / scale, scale, scale, w, scale, oc},
+                      {s * w * c, s * oc, (int64_t)w * c, c, oc, 1});
+  return true;
+}
+
+namespace {
+
+// dst[j] = src[j * step] for j < len. The steps of a shuffle by 2 are
+// spelled out, the compiler turns those into vector loads and shuffles.
+template <typename U>
+inline void gather_row(const U* src, int64_t step, U* dst, int64_t len) {
+  switch (step) {
+    case 2:
+      for (int64_t j = 0; j < len; ++j) dst[j] = src[j * 2];
+      break;
+    case 4:
+      for (int64_t j = 0; j < len; ++j) dst[j] = src[j * 4];
+      break;
+    default:
+      for (int64_t j = 0; j < len; ++j) dst[j] = src[j * step];
+  }
+}
+
+// output elements [begin, end) row by row along the innermost dim, rows
+// contiguous in the input are one memcpy. Rows of a few elements are
+// copied a plane of the two innermost dims at a time instead, so that
+// the loop overhead is not paid every few elements.
+template <typename U>
+void copy_rows(const Transpose& t, const U* in, U* out, int64_t begin,
+               int64_t end) {
+  if (begin >= end) {
+    return;
+  }
+  auto nd = t.dims.size();
+  auto inner = t.dims[nd - 1];
+  auto step = t.strides[nd - 1];
+  auto planar = nd >= 2u && inner < MIN_TILE_DIM;
+  // the dims from `run_dim` on are one run
+  auto run_dim = planar ? nd - 2u : nd - 1u;
+  auto rows = planar ? t.dims[nd - 2] : 1;
+  auto row_step = planar ? t.strides[nd - 2] : 0;
+  auto run = rows * inner;
+
+  std::vector<int64_t> coord(run_dim);
+  auto rem = begin / run;
+  auto in_pos = t.offset;
+  for (auto d = run_dim; d-- > 0u;) {
+    coord[d] = rem % t.dims[d];
+    rem /= t.dims[d];
+    in_pos += coord[d] * t.strides[d];
+  }
+  auto r0 = begin % run;
+  for (auto pos = begin;;) {
+    auto len = std::min(run - r0, end - pos);
+    const auto* src = in + in_pos;
+    auto* dst = out + pos;
+    if (!planar && step == 1) {
+      std::memcpy(dst, src + r0, len * sizeof(U));
+    } else if (!planar) {
+      gather_row(src + r0 * step, step, dst, len);
+    } else if (len == run) {
+      for (int64_t i = 0; i < rows; ++i) {
+        for (int64_t j = 0; j < inner; ++j) {
+          dst[i * inner + j] = src[i * row_step + j * step];
+        }
+      }
+    } else {
+      auto i = r0 / inner, j = r0 % inner;
+      for (int64_t k = 0; k < len; ++k) {
+        dst[k] = src[i * row_step + j * step];
+        if (++j == inner) {
+          j = 0;
+          ++i;
+        }
+      }
+    }
+    pos += len;
+    if (pos >= end) {
+      break;
+    }
+    r0 = 0;
+    for (auto d = run_dim; d-- > 0u;) {
+      in_pos += t.strides[d];
+      if (++coord[d] < t.dims[d]) {
+        break;
+      }
+      in_pos -= t.dims[d] * t.strides[d];
+      coord[d] = 0;
+    }
+  }
+}
+
+// dst[c * ds + r] = src[off[r] + c] for r < rows and c < cols, those not
+// covered by the M x M tiles of `kernel` one by one
+template <int M, typename U, typename K>
+void transpose_in_tiles(const U* src, const int64_t* off, U* dst, int64_t ds,
+                        int64_t rows, int64_t cols, K kernel) {
+  auto rows_m = M > 1 ? rows / M * M : 0;
+  auto cols_m = M > 1 ? cols / M * M : 0;
+  for (int64_t r = 0; r < rows_m; r += M) {
+    for (int64_t c = 0; c < cols_m; c += M) {
+      kernel(src + c, off + r, dst + c * ds + r, ds);
+    }
+  }
+  for (auto c = cols_m; c < cols; ++c) {
+    for (int64_t r = 0; r < rows_m; ++r) {
+      dst[c * ds + r] = src[off[r] + c];
+    }
+  }
+  for (auto r = rows_m; r < rows; ++r) {
+    const auto* row = src + off[r];
+    for (int64_t c = 0; c < cols; ++c) {
+      dst[c * ds + r] = row[c];
+    }
+  }
+}
+
+#if TRANSPOSE_X86
+#pragma GCC push_options
+#pragma GCC target("sse2")
+void transpose4x4_sse(const uint32_t* src, const int64_t* off, uint32_t* dst,
+                      int64_t ds) {
+  auto* s = reinterpret_cast<const float*>(src);
+  auto* d = reinterpret_cast<float*>(dst);
+  auto r0 = _mm_loadu_ps(s + off[0]);
+  auto r1 = _mm_loadu_ps(s + off[1]);
+  auto r2 = _mm_loadu_ps(s + off[2]);
+  auto r3 = _mm_loadu_ps(s + off[3]);
+  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+  _mm_storeu_ps(d, r0);
+  _mm_storeu_ps(d + ds, r1);
+  _mm_storeu_ps(d + 2 * ds, r2);
+  _mm_storeu_ps(d + 3 * ds, r3);
+}
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx")
+void transpose8x8_avx(const uint32_t* src, const int64_t* off, uint32_t* dst,
+                      int64_t ds) {
+  auto* s = reinterpret_cast<const float*>(src);
+  auto* d = reinterpret_cast<float*>(dst);
+  __m256 r[8], t[8];
+  for (auto i = 0; i < 8; ++i) {
+    r[i] = _mm256_loadu_ps(s + off[i]);
+  }
+  // pairs of rows interleaved, then pairs of pairs, then the 128 bit
+  // halves of rows i and i + 4
+  for (auto i = 0; i < 8; i += 2) {
+    t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+    t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+  }
+  for (auto i = 0; i < 8; i += 4) {
+    r[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+    r[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+    r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+    r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+  }
+  for (auto i = 0; i < 4; ++i) {
+    _mm256_storeu_ps(d + i * ds, _mm256_permute2f128_ps(r[i], r[i + 4], 0x20));
+    _mm256_storeu_ps(d + (i + 4) * ds,
+                     _mm256_permute2f128_ps(r[i], r[i + 4], 0x31));
+  }
+}
+
+void transpose4x4_avx(const uint64_t* src, const int64_t* off, uint64_t* dst,
+                      int64_t ds) {
+  auto* s = reinterpret_cast<const double*>(src);
+  auto* d = reinterpret_cast<double*>(dst);
+  auto r0 = _mm256_loadu_pd(s + off[0]);
+  auto r1 = _mm256_loadu_pd(s + off[1]);
+  auto r2 = _mm256_loadu_pd(s + off[2]);
+  auto r3 = _mm256_loadu_pd(s + off[3]);
+  auto t0 = _mm256_unpacklo_pd(r0, r1);
+  auto t1 = _mm256_unpackhi_pd(r0, r1);
+  auto t2 = _mm256_unpacklo_pd(r2, r3);
+  auto t3 = _mm256_unpackhi_pd(r2, r3);
+  _mm256_storeu_pd(d, _mm256_permute2f128_pd(t0, t2, 0x20));
+  _mm256_storeu_pd(d + ds, _mm256_permute2f128_pd(t1, t3, 0x20));
+  _mm256_storeu_pd(d + 2 * ds, _mm256_permute2f128_pd(t0, t2, 0x31));
+  _mm256_storeu_pd(d + 3 * ds, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+#pragma GCC pop_options
+
+bool has_avx() {
+  static const bool avx = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx") != 0;
+  }();
+  return avx;
+}
+#endif
+
+template <typename U>
+void no_kernel(const U*, const int64_t*, U*, int64_t) {}
+
+template <typename U>
+void transpose_block(const U* src, const int64_t* off, U* dst, int64_t ds,
+                     int64_t rows, int64_t cols) {
+  transpose_in_tiles<1>(src, off, dst, ds, rows, cols, no_kernel<U>);
+}
+
+void transpose_block(const uint32_t* src, const int64_t* off, uint32_t* dst,
+                     int64_t ds, int64_t rows, int64_t cols) {
+#if TRANSPOSE_X86
+  if (has_avx()) {
+    transpose_in_tiles<8>(src, off, dst, ds, rows, cols, transpose8x8_avx);
+  } else {
+    transpose_in_tiles<4>(src, off, dst, ds, rows, cols, transpose4x4_sse);
+  }
+#else
+  transpose_in_tiles<1>(src, off, dst, ds, rows, cols, no_kernel<uint32_t>);
+#endif
+}
+
+void transpose_block(const uint64_t* src, const int64_t* off, uint64_t* dst,
+                     int64_t ds, int64_t rows, int64_t cols) {
+#if TRANSPOSE_X86
+  if (has_avx()) {
+    transpose_in_tiles<4>(src, off, dst, ds, rows, cols, transpose4x4_avx);
+    return;
+  }
+#endif
+  transpose_in_tiles<1>(src, off, dst, ds, rows, cols, no_kernel<uint64_t>);
+}
+
+// dst[c * R + r] = src[off[r] + c], R rows interleaved, which the compiler
+// vectorizes with shuffles for a constant R
+template <int R, typename U>
+void interleave_rows(const U* src, const int64_t* off, U* dst, int64_t cols) {
+  const U* rows[R];
+  for (auto r = 0; r < R; ++r) {
+    rows[r] = src + off[r];
+  }
+  for (int64_t c = 0; c < cols; ++c) {
+    for (auto r = 0; r < R; ++r) {
+      dst[c * R + r] = rows[r][c];
+    }
+  }
+}
+
+// side of a cache block, the input and output blocks of 4 byte elements
+// take 4KB each
+constexpr int64_t BLOCK = 32;
+
+// a task is one block of the tile dim at one index of the dims before it,
+// for all of tile_rows in blocks of BLOCK. The block of the tile dim is
+// longer if there are only a few rows, so that a task is not too small.
+int64_t tile_dim_block(const Transpose& t) {
+  auto rows = (int64_t)t.tile_rows.size();
+  return std::max(BLOCK, BLOCK * BLOCK / rows / BLOCK * BLOCK);
+}
+
+int64_t blocks_of_tile_dim(const Transpose& t) {
+  auto block = tile_dim_block(t);
+  return (t.dims[t.tile_dim] + block - 1) / block;
+}
+
+int64_t num_of_tile_tasks(const Transpose& t) {
+  auto rows = (int64_t)t.tile_rows.size();
+  return t.num / t.dims[t.tile_dim] / rows * blocks_of_tile_dim(t);
+}
+
+template <typename U>
+void copy_tiles(const Transpose& t, const U* in, U* out, int64_t task_begin,
+                int64_t task_end) {
+  if (task_begin >= task_end) {
+    return;
+  }
+  auto e = t.tile_dim;
+  auto rows = (int64_t)t.tile_rows.size();
+  auto blocks = blocks_of_tile_dim(t);
+  auto size = tile_dim_block(t);
+  // index of the dims before the tile dim, kept up to date rather than
+  // divided out for every task
+  std::vector<int64_t> coord(e);
+  auto outer = task_begin / blocks;
+  auto rem = outer;
+  auto in_pos = t.offset;
+  for (auto d = e; d-- > 0;) {
+    coord[d] = rem % t.dims[d];
+    rem /= t.dims[d];
+    in_pos += coord[d] * t.strides[d];
+  }
+  auto block = task_begin % blocks;
+  for (auto task = task_begin; task < task_end; ++task) {
+    auto a0 = block * size;
+    auto a1 = std::min(t.dims[e], a0 + size);
+    const auto* src = in + in_pos + a0;
+    auto* dst = out + outer * t.dims[e] * rows + a0 * rows;
+    if (rows == 2) {
+      interleave_rows<2>(src, t.tile_rows.data(), dst, a1 - a0);
+    } else if (rows == 4) {
+      interleave_rows<4>(src, t.tile_rows.data(), dst, a1 - a0);
+    } else {
+      for (int64_t b0 = 0; b0 < rows; b0 += BLOCK) {
+        auto b1 = std::min(rows, b0 + BLOCK);
+        transpose_block(src, t.tile_rows.data() + b0, dst + b0, rows, b1 - b0,
+                        a1 - a0);
+      }
+    }
+    if (++block < blocks) {
+      continue;
+    }
+    block = 0;
+    ++outer;
+    for (auto d = e; d-- > 0;) {
+      in_pos += t.strides[d];
+      if (++coord[d] < t.dims[d]) {
+        break;
+      }
+      in_pos -= t.dims[d] * t.strides[d];
+      coord[d] = 0;
+    }
+  }
+}
+
+template <typename U>
+void transpose_typed(const Transpose& t, const U* in, U* out, bool parallel) {
+  if (t.num == 0) {
+    return;
+  }
+  auto max_threads = parallel ? t.num / ELEMENTWISE_GRAIN : 0;
+  if (t.tile_dim < 0) {
+    if (max_threads <= 1) {
+      copy_rows(t, in, out, 0, t.num);
+    } else {
+      parallel_for_elementwise(t.num, [&](int64_t begin, int64_t end) {
+        copy_rows(t, in, out, begin, end);
+      });
+    }
+    return;
+  }
+  auto tasks = num_of_tile_tasks(t);
+  max_threads = std::min(max_threads, tasks);
+  if (max_threads <= 1) {
+    copy_tiles(t, in, out, 0, tasks);
+    return;
+  }
+  ThreadPool::instance().parallel_for(
+      0, tasks,
+      [&](int64_t begin, int64_t end) { copy_tiles(t, in, out, begin, end); },
+      Schedule::STATIC, 1, (size_t)max_threads);
+}
+
+// elements of another size one memcpy each
+void transpose_any(const Transpose& t, const char* in, char* out,
+                   size_t elem_size, int64_t begin, int64_t end) {
+  for (auto pos = begin; pos < end; ++pos) {
+    auto in_pos = t.offset;
+    auto rem = pos;
+    for (auto d = t.dims.size(); d-- > 0u;) {
+      in_pos += rem % t.dims[d] * t.strides[d];
+      rem /= t.dims[d];
+    }
+    std::memcpy(out + pos * elem_size, in + in_pos * elem_size, elem_size);
+  }
+}
+
+template <typename U>
+const U* as(const void* p) {
+  return reinterpret_cast<const U*>(p);
+}
+template <typename U>
+U* as(void* p) {
+  return reinterpret_cast<U*>(p);
+}
+
+}  // namespace
+
+void transpose_bytes(const Transpose& t, const void* in, void* out,
+                     size_t elem_size, bool parallel) {
+  switch (elem_size) {
+    case 1:
+      return transpose_typed(t, as<uint8_t>(in), as<uint8_t>(out), parallel);
+    case 2:
+      return transpose_typed(t, as<uint16_t>(in), as<uint16_t>(out), parallel);
+    case 4:
+      return transpose_typed(t, as<uint32_t>(in), as<uint32_t>(out), parallel);
+    case 8:
+      return transpose_typed(t, as<uint64_t>(in), as<uint64_t>(out), parallel);
+    default:
+      return transpose_any(t, as<char>(in), as<char>(out), elem_size, 0,
+                           t.num);
+  }
+}
+
+void transpose_bytes(const Transpose& t, const void* in, void* out,
+                     size_t elem_size, int64_t begin, int64_t end) {
+  switch (elem_size) {
+    case 1:
+      return copy_rows(t, as<uint8_t>(in), as<uint8_t>(out), begin, end);
+    case 2:
+      return copy_rows(t, as<uint16_t>(in), as<uint16_t>(out), begin, end);
+    case 4:
+      return copy_rows(t, as<uint32_t>(in), as<uint32_t>(out), begin, end);
+    case 8:
+      return copy_rows(t, as<uint64_t>(in), as<uint64_t>(out), begin, end);
+    default:
+      return transpose_any(t, as<char>(in), as<char>(out), elem_size, begin,
+                           end);
+  }
+}
+
+}  // namespace cpu
+}  // namespace vart
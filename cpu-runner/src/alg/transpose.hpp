@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace vart {
+namespace cpu {
+
+// A dense output gathered from a strided view of the input: output
+// element at coordinate x is input element offset + sum(x[d] * strides[d]).
+// Permutes, shuffles and slices of a dense tensor are all of this kind.
+//
+// Output dims of 1 are dropped, and a dim is merged into the one before
+// it if the input is contiguous across both, so NCHW to NHWC runs as
+// [N, H * W, C] from strides [C * H * W, 1, H * W].
+struct Transpose {
+  // merged dims of the output, at least one
+  std::vector<int64_t> dims;
+  // stride of the input along dims[d], may be negative
+  std::vector<int64_t> strides;
+  int64_t offset = 0;
+  int64_t num = 0;
+  // dim other than the innermost one along which the input is
+  // contiguous, if the innermost one is not, else -1. The output is then
+  // [tile dim, positions after it] at each index of the dims before it,
+  // which is copied in cache blocks by 2-D transposes of the input at
+  // `tile_rows`, the offset of each position after the tile dim.
+  int tile_dim = -1;
+  std::vector<int64_t> tile_rows;
+};
+
+Transpose make_transpose(const std::vector<int>& out_dims,
+                         const std::vector<int64_t>& in_strides,
+                         int64_t offset = 0);
+
+// output dim d is input dim order[d]
+Transpose make_permute(const std::vector<int>& in_shape,
+                       const std::vector<int>& order);
+// pixel-shuffle of an NHWC input, depth to space if upscale, else space to
+// depth, with the channel order of the pixel-shuffle op
+Transpose make_pixel_shuffle(const std::vector<int>& in_shape, int scale,
+                             bool upscale);
+// each pixel's channels [group, C / group] as [C / group, group]
+Transpose make_channel_shuffle(const std::vector<int>& shape, int group);
+// a strided slice of a dense input, with begin, end and strides per dim
+// as xir::validate_strided_slice() resolves them: begin is in the input,
+// end is one past the last element, -1 for a negative stride which runs
+// down to 0. `out_shape` gets the dims of the output.
+Transpose make_strided_slice(const std::vector<int>& in_shape,
+                             const std::vector<int>& begin,
+                             const std::vector<int>& end,
+                             const std::vector<int>& strides,
+                             std::vector<int>* out_shape);
+// the reorg op on an [1, H, W, C] input, false if H or W are not
+// multiples of what the op reorders at once
+bool make_reorg(const std::vector<int>& in_shape, int scale, bool reverse,
+                Transpose* t);
+
+void transpose_bytes(const Transpose& t, const void* in, void* out,
+                     size_t elem_size, bool parallel);
+void transpose_bytes(const Transpose& t, const void* in, void* out,
+                     size_t elem_size, int64_t begin, int64_t end);
+
+// out = the elements of `in` given by `t`, split among ThreadPool threads
+// if `parallel` and it is large enough
+template <typename T>
+void transpose(const Transpose& t, const T* in, T* out, bool parallel) {
+  static_assert(std::is_trivially_copyable<T>::value, "");
+  transpose_bytes(t, in, out, sizeof(T), parallel);
+}
+
+// output elements [begin, end) only, row by row without cache blocks
+template <typename T>
+void transpose(const Transpose& t, const T* in, T* out, int64_t begin,
+               int64_t end) {
+  static_assert(std::is_trivially_copyable<T>::value, "");
+  transpose_bytes(t, in, out, sizeof(T), begin, end);
+}
+
+}  // namespace cpu
+}  // namespace vart
@@ -17,6 +17,11 @@
 #include "load_cfg.hpp"
 #include "cpu_cfg.hpp"
 
+#include <vitis/ai/env_config.hpp>
+
+// run_mode 4 without a config file, e.g. when loaded as a runner
+DEF_ENV_PARAM(XLNX_CPU_RUNNER_GRAPH_THREAD, "0");
+
 namespace vart {
 namespace cpu {
 
@@ -24,6 +29,7 @@ namespace cpu {
 CPUCfg::CPUCfg(const string& config_fname)
     : config_fname_(config_fname),
       cpu_run_mode_(CPURunMode::GEMM_THREAD),
+      graph_thread_(ENV_PARAM(XLNX_CPU_RUNNER_GRAPH_THREAD) != 0),
       save_bin_(true),
       save_txt_(false),
       save_weights_fmt_(WeightsFmt::OC_KH_KW_IC),
@@ -70,7 +76,13 @@ void CPUCfg::set_xmodel_run_mode(const string& xmodel_run_mode_str) {
   }
 }
 
+void CPUCfg::set_cpu_run_mode(CPURunMode cpu_run_mode) {
+  graph_thread_ = cpu_run_mode == CPURunMode::GRAPH_THREAD;
+  cpu_run_mode_ = graph_thread_ ? CPURunMode::GEMM_THREAD : cpu_run_mode;
+}
+
 void CPUCfg::set_cpu_run_mode(int cpu_run_mode) {
+  graph_thread_ = false;
   if (cpu_run_mode == 0) {
     cpu_run_mode_ = CPURunMode::NORMAL;
   } else if (cpu_run_mode == 1) {
@@ -79,6 +91,8 @@ void CPUCfg::set_cpu_run_mode(int cpu_run_mode) {
     cpu_run_mode_ = CPURunMode::GEMM;
   } else if (cpu_run_mode == 3) {
     cpu_run_mode_ = CPURunMode::GEMM_THREAD;
+  } else if (cpu_run_mode == 4) {
+    set_cpu_run_mode(CPURunMode::GRAPH_THREAD);
   } else if (cpu_run_mode == 10) {
     cpu_run_mode_ = CPURunMode::PRINT_PARAM;
   } else if (cpu_run_mode == 11) {
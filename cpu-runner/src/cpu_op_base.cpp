@@ -129,6 +129,22 @@ void CPUOPBase::save() {
   }
 }
 
+void CPUOPBase::fuse(CPUOPBase* op) {
+  CHECK(op->is_pointwise()) << op->get_name() << " is not pointwise";
+  CHECK(op->fused_into_ == nullptr) << op->get_name() << " is fused already";
+  fused_ops_.push_back(op);
+  op->fused_into_ = this;
+  // the fused op computes in place on the output, which is now its
+  // output
+  output_ = op->output_;
+}
+
+void CPUOPBase::run_fused(void* data, int64_t begin, int64_t end) {
+  for (auto* op : fused_ops_) {
+    op->run_pointwise(data, begin, end);
+  }
+}
+
 string CPUOPBase::get_input_list() const {
   string s;
   auto v = vec_input_ops(xir_op_->get_input_ops());
@@ -17,6 +17,9 @@
 
 #include "cpu_runner.hpp"
 
+#include <set>
+#include <vitis/ai/env_config.hpp>
+
 #include "check_param_visitor.hpp"
 #include "cpu_op_base.hpp"
 #include "cpu_reg_func.hpp"
@@ -31,9 +34,17 @@
 #include "vitis/ai/plugin.hpp"
 #include "workload_visitor.hpp"
 
+DEF_ENV_PARAM(XLNX_CPU_RUNNER_FUSION, "1");
+DEF_ENV_PARAM(DEBUG_CPU_RUNNER_FUSION, "0");
+
 namespace vart {
 namespace cpu {
 
+static bool is_float32(const xir::Op* op) {
+  auto data_type = op->get_output_tensor()->get_data_type();
+  return data_type.type == xir::DataType::FLOAT && data_type.bit_width == 32;
+}
+
 CPURunner::CPURunner(const xir::Subgraph* subgraph, const xir::Attrs* attrs)
     : subg_(subgraph), g_(subg_->get_graph()) {
   if (VART_DEBUG) {
@@ -298,6 +309,89 @@ void CPURunner::create_ops_and_tbs() {
         subg_, xir_op, inputs, output);
     cpu_ops_.push_back(cpu_op);
   }
+
+  std::vector<const xir::Op*> run_order;
+  for (auto* cpu_op : cpu_ops_) {
+    run_order.push_back(cpu_op->get_xir_op());
+  }
+  CPUTBFactory::Instance().plan_memory(subg_, run_order);
+  fuse_ops();
+  prepare_ops();
+}
+
+void CPURunner::fuse_ops() {
+  // fused ops have no output of their own to dump, and other modes visit
+  // every op on its own
+  auto cpu_run_mode = CPU_RUN_MODE;
+  if (!ENV_PARAM(XLNX_CPU_RUNNER_FUSION) || VART_DEBUG ||
+      CPUCfg::Instance().debug() || !run_from_tensors_.empty() ||
+      !assign_tensors_.empty() ||
+      (cpu_run_mode != CPURunMode::NORMAL &&
+       cpu_run_mode != CPURunMode::NORMAL_THREAD &&
+       cpu_run_mode != CPURunMode::GEMM &&
+       cpu_run_mode != CPURunMode::GEMM_THREAD))
+    return;
+
+  std::unordered_map<const xir::Op*, CPUOPBase*> ops;
+  for (auto* cpu_op : cpu_ops_) {
+    ops[cpu_op->get_xir_op()] = cpu_op;
+  }
+  auto output_ops = get_output_ops(subg_);
+  std::set<const xir::Op*> outputs(output_ops.begin(), output_ops.end());
+
+  // ops are in topological order, so in a chain of pointwise ops the
+  // first one is fused before the next one is looked at
+  auto num_of_fused = 0U;
+  for (auto* cpu_op : cpu_ops_) {
+    if (!cpu_op->is_pointwise()) continue;
+    const auto* xir_op = cpu_op->get_xir_op();
+    auto input_ops = vec_input_ops(xir_op->get_input_ops());
+    if (input_ops.size() != 1U) continue;
+    auto it = ops.find(input_ops[0]);
+    if (it == ops.end()) continue;
+    auto* writer = it->second->get_fused_into() != nullptr
+                       ? it->second->get_fused_into()
+                       : it->second;
+
+    // nothing else may read the input, it is overwritten in place
+    if (!writer->can_fuse_pointwise() ||
+        input_ops[0]->get_fanout_ops().size() != 1U ||
+        outputs.count(input_ops[0]) != 0U || !is_float32(input_ops[0]) ||
+        !is_float32(xir_op) ||
+        input_ops[0]->get_output_tensor()->get_element_num() !=
+            xir_op->get_output_tensor()->get_element_num() ||
+        !CPUTBFactory::Instance().can_write_ahead(xir_op,
+                                                  writer->get_xir_op()))
+      continue;
+
+    writer->fuse(cpu_op);
+    num_of_fused++;
+    LOG_IF(INFO, ENV_PARAM(DEBUG_CPU_RUNNER_FUSION))
+        << "fused " << cpu_op->get_type() << " " << cpu_op->get_name()
+        << " into " << writer->get_type() << " " << writer->get_name();
+  }
+
+  LOG_IF(INFO, ENV_PARAM(DEBUG_CPU_RUNNER_FUSION))
+      << subg_->get_name() << ": " << num_of_fused << " of "
+      << cpu_ops_.size() << " ops fused, " << num_of_fused
+      << " passes over memory saved per run";
+}
+
+void CPURunner::prepare_ops() {
+  // weights assigned from outside may differ from run to run
+  if (!run_from_tensors_.empty() || !assign_tensors_.empty()) return;
+
+  // const ops run in order, ahead of the ops which read them, so their
+  // outputs are filled and still alive, see plan_memory()
+  for (auto* cpu_op : cpu_ops_) {
+    const auto op_type = cpu_op->get_type();
+    if (op_type == "const" || op_type == "const-fix") {
+      cpu_op->read();
+      cpu_op->run();
+    } else {
+      cpu_op->prepare();
+    }
+  }
 }
 
 string CPURunner::get_name() const { return subg_->get_name(); }
@@ -17,9 +17,56 @@
 
 #include "cpu_tb_factory.hpp"
 
+#include <set>
+#include <unordered_set>
+#include <vitis/ai/env_config.hpp>
+
+#include "memory_plan.hpp"
+#include "vart/xir_helper.hpp"
+
+DEF_ENV_PARAM(XLNX_CPU_RUNNER_MEMORY_PLAN, "1");
+DEF_ENV_PARAM(DEBUG_CPU_RUNNER_MEMORY_PLAN, "0");
+
 namespace vart {
 namespace cpu {
 
+// output element i only depends on input element i, and the kernel
+// still works if input and output are the same buffer
+static bool can_run_in_place(const xir::Op* op) {
+  static const std::set<string> types = {
+      "relu", "relu6", "leaky-relu", "neg",
+      "exp",  "sigmoid", "tanh",    "hard-sigmoid"};
+  return types.count(op->get_type()) != 0;
+}
+
+// output is the input with another shape, it may take the memory of the
+// input whoever else reads the input, as long as nobody writes either
+static bool is_view(const xir::Op* op) {
+  static const std::set<string> types = {"reshape", "reshape-fix",
+                                         "qlinear-reshape", "flatten",
+                                         "squeeze"};
+  return types.count(op->get_type()) != 0;
+}
+
+// the inputs of a concat along `axis` are one after another in its
+// output if all dims before `axis` are 1
+static bool is_contiguous_concat(const xir::Op* op) {
+  if (op->get_type() != "concat") return false;
+  auto shape = op->get_output_tensor()->get_shape();
+  auto axis = op->get_attr<int>("axis");
+  if (axis < 0) axis += (int)shape.size();
+  for (auto d = 0; d < axis; d++) {
+    if (shape[d] != 1) return false;
+  }
+  return true;
+}
+
+static bool same_layout(const xir::Tensor* a, const xir::Tensor* b) {
+  return a->get_data_type().type == b->get_data_type().type &&
+         a->get_data_type().bit_width == b->get_data_type().bit_width &&
+         a->get_element_num() == b->get_element_num();
+}
+
 CPUTBPtr_t CPUTBFactory::create_or_get(const xir::Op* op) {
   std::lock_guard<std::recursive_mutex> lock(mtx_);
 
@@ -49,5 +96,221 @@ CPUTBPtr_t CPUTBFactory::create_or_get(const xir::Op* op) {
   return lookup_ptr;
 }
 
+void CPUTBFactory::plan_memory(const xir::Subgraph* subg,
+                               const std::vector<const xir::Op*>& ops) {
+  std::lock_guard<std::recursive_mutex> lock(mtx_);
+  if (!ENV_PARAM(XLNX_CPU_RUNNER_MEMORY_PLAN) || VART_DEBUG ||
+      arenas_.find(subg) != arenas_.end()) {
+    return;
+  }
+
+  std::unordered_map<const xir::Op*, size_t> index;
+  for (auto i = 0U; i < ops.size(); i++) {
+    index[ops[i]] = i;
+  }
+  std::unordered_set<const xir::Op*> pinned;
+  for (auto* op : get_input_ops(subg)) pinned.insert(op);
+  for (auto* op : get_output_ops(subg)) pinned.insert(op);
+
+  // one block per group of outputs which share memory, i.e. an output
+  // and the outputs computed in place on it or viewing it. The block of
+  // an input of a concat may also be put into the block of the concat,
+  // at `sub_offset`, then `parent` is the block of the concat, and the
+  // input is written in its place in the output right away.
+  std::vector<int> group(ops.size(), -1);
+  std::vector<mem_block_t> blocks;
+  std::vector<std::vector<size_t>> users;
+  std::vector<std::vector<size_t>> writers;
+  std::vector<std::vector<CPUTensorBuffer*>> members;
+  std::vector<int> parent;
+  std::vector<size_t> sub_offset;
+  size_t naive_size = 0U;
+  size_t copy_size = 0U;
+  auto num_of_tensors = 0U;
+  auto num_of_in_place = 0U;
+  auto num_of_views = 0U;
+  auto num_of_concat_inputs = 0U;
+  for (auto i = 0U; i < ops.size(); i++) {
+    const auto* op = ops[i];
+    auto* tb = get_by_op(op);
+    if (tb == nullptr || pinned.count(op) != 0) continue;
+
+    auto last = (size_t)i;
+    auto read_outside = false;
+    std::vector<size_t> readers;
+    for (const auto* fanout_op : op->get_fanout_ops()) {
+      auto it = index.find(fanout_op);
+      if (it == index.end() || it->second < i) {
+        read_outside = true;
+        break;
+      }
+      readers.push_back(it->second);
+      last = std::max(last, it->second);
+    }
+    if (read_outside) continue;
+
+    // blocks inside a concat output take neither, it is written as soon
+    // as the inputs of the concat are
+    auto g = -1;
+    if (is_view(op)) {
+      auto input_ops = op->get_input_ops("input");
+      auto it = input_ops.size() == 1U ? index.find(input_ops[0]) : index.end();
+      if (it != index.end() && group[it->second] >= 0 &&
+          parent[group[it->second]] < 0 &&
+          same_layout(input_ops[0]->get_output_tensor(),
+                      op->get_output_tensor())) {
+        g = group[it->second];
+        blocks[g].size = std::max<size_t>(blocks[g].size, tb->get_data_size());
+        blocks[g].last = std::max(blocks[g].last, last);
+        copy_size += 2U * tb->get_data_size();
+        num_of_views++;
+      }
+    } else if (can_run_in_place(op)) {
+      auto input_ops = vec_input_ops(op->get_input_ops());
+      auto it = input_ops.size() == 1U ? index.find(input_ops[0]) : index.end();
+      if (it != index.end() && group[it->second] >= 0 &&
+          parent[group[it->second]] < 0 &&
+          blocks[group[it->second]].last == i &&
+          same_layout(input_ops[0]->get_output_tensor(),
+                      op->get_output_tensor())) {
+        g = group[it->second];
+        // the other readers of the input must be done before it is
+        // overwritten
+        auto& deps = reuse_deps_[op];
+        for (auto u : users[g]) {
+          deps.push_back(ops[u]);
+        }
+        blocks[g].size = std::max<size_t>(blocks[g].size, tb->get_data_size());
+        blocks[g].last = last;
+        num_of_in_place++;
+      }
+    }
+    if (g < 0) {
+      g = (int)blocks.size();
+      blocks.push_back(mem_block_t{tb->get_data_size(), i, last});
+      users.emplace_back();
+      writers.emplace_back();
+      members.emplace_back();
+      parent.push_back(-1);
+      sub_offset.push_back(0U);
+    }
+    group[i] = g;
+    users[g].push_back(i);
+    users[g].insert(users[g].end(), readers.begin(), readers.end());
+    writers[g].push_back(i);
+    members[g].push_back(tb);
+    naive_size += tb->get_data_size();
+    num_of_tensors++;
+
+    if (is_contiguous_concat(op) && blocks[g].first == i) {
+      // each input block in its place, if it holds just that input and
+      // is not inside another concat, or in this one twice
+      size_t offset = 0U;
+      for (const auto* input_op : op->get_input_ops("input")) {
+        const auto* tensor = input_op->get_output_tensor();
+        auto size = get_by_op(input_op)->get_data_size();
+        auto it = index.find(input_op);
+        auto k = it != index.end() ? group[it->second] : -1;
+        if (k >= 0 && k != g && parent[k] < 0 && blocks[k].size == size &&
+            tensor->get_data_type().type ==
+                op->get_output_tensor()->get_data_type().type &&
+            tensor->get_data_type().bit_width ==
+                op->get_output_tensor()->get_data_type().bit_width) {
+          parent[k] = g;
+          sub_offset[k] = offset;
+          blocks[g].first = std::min(blocks[g].first, blocks[k].first);
+          blocks[g].last = std::max(blocks[g].last, blocks[k].last);
+          users[g].insert(users[g].end(), users[k].begin(), users[k].end());
+          writers[g].insert(writers[g].end(), writers[k].begin(),
+                            writers[k].end());
+          copy_size += 2U * size;
+          num_of_concat_inputs++;
+        }
+        offset += size;
+      }
+    }
+  }
+  if (blocks.empty()) return;
+  for (auto i = 0U; i < ops.size(); i++) {
+    if (group[i] >= 0) blocks_[ops[i]] = {subg, group[i]};
+  }
+
+  // only the outermost blocks are placed, the others are inside them
+  std::vector<size_t> roots;
+  std::vector<mem_block_t> root_blocks;
+  std::vector<size_t> root_of(blocks.size());
+  for (auto g = 0U; g < blocks.size(); g++) {
+    if (parent[g] >= 0) continue;
+    root_of[g] = roots.size();
+    roots.push_back(g);
+    root_blocks.push_back(blocks[g]);
+  }
+  size_t arena_size = 0U;
+  auto root_offsets = plan_offsets(root_blocks, ALIGN_SIZE, &arena_size);
+  // a block is inside its parent, which may be inside another concat
+  std::vector<size_t> offsets(blocks.size());
+  for (auto g = 0U; g < blocks.size(); g++) {
+    auto r = (int)g;
+    auto offset = (size_t)0U;
+    for (; parent[r] >= 0; r = parent[r]) {
+      offset += sub_offset[r];
+    }
+    offsets[g] = root_offsets[root_of[r]] + offset;
+  }
+
+  auto& arena = arenas_[subg];
+  arena.resize(arena_size + ALIGN_SIZE);
+  auto space = arena.size();
+  void* p = arena.data();
+  std::align(ALIGN_SIZE, arena_size, p, space);
+  auto* base = reinterpret_cast<char*>(p);
+  for (auto g = 0U; g < blocks.size(); g++) {
+    for (auto* tb : members[g]) {
+      tb->set_data_ptr(base + offsets[g]);
+    }
+  }
+
+  // a block which takes the memory of an earlier one is written only
+  // after every op which used the earlier one is done
+  for (auto a : roots) {
+    for (auto b : roots) {
+      if (blocks[a].last >= blocks[b].first) continue;
+      auto a_end = offsets[a] + blocks[a].size;
+      auto b_end = offsets[b] + blocks[b].size;
+      if (offsets[a] < b_end && offsets[b] < a_end) {
+        for (auto w : writers[b]) {
+          auto& deps = reuse_deps_[ops[w]];
+          for (auto u : users[a]) {
+            deps.push_back(ops[u]);
+          }
+        }
+      }
+    }
+  }
+
+  LOG_IF(INFO, ENV_PARAM(DEBUG_CPU_RUNNER_MEMORY_PLAN))
+      << subg->get_name() << ": " << naive_size << " bytes of "
+      << num_of_tensors << " tensors planned into " << arena_size
+      << " bytes, " << num_of_in_place << " in place, " << num_of_views
+      << " views, " << num_of_concat_inputs
+      << " concat inputs written in place, " << copy_size
+      << " bytes of copies saved per run";
+}
+
+std::vector<const xir::Op*> CPUTBFactory::get_reuse_deps(const xir::Op* op) {
+  std::lock_guard<std::recursive_mutex> lock(mtx_);
+  auto it = reuse_deps_.find(op);
+  if (it == reuse_deps_.end()) return {};
+  return it->second;
+}
+
+bool CPUTBFactory::can_write_ahead(const xir::Op* op, const xir::Op* writer) {
+  std::lock_guard<std::recursive_mutex> lock(mtx_);
+  auto it = blocks_.find(op);
+  if (it == blocks_.end()) return true;
+  auto writer_it = blocks_.find(writer);
+  return writer_it != blocks_.end() && writer_it->second == it->second;
+}
+
 }  // namespace cpu
 }  // namespace vart
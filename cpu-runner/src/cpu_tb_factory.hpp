@@ -48,6 +48,33 @@ class CPUTBFactory {
     return nullptr;
   }
 
+  // Let the outputs of `ops`, which run in this order, share one arena
+  // instead of a buffer each: an output is alive from the op which
+  // writes it to the last op which reads it, and outputs which are not
+  // alive at the same time may take the same memory, see plan_offsets().
+  // The output of an elementwise op may also take the memory of its
+  // input if it is the last reader, the output of a reshape, flatten or
+  // squeeze is the memory of its input, and the inputs of a concat which
+  // are one after another in its output are written in their place, so
+  // none of these copy.
+  //
+  // Subgraph inputs and outputs, and tensors read outside of `ops`, keep
+  // their own buffer. Nothing is planned in debug mode, so that every
+  // op's output can still be dumped, or if env
+  // XLNX_CPU_RUNNER_MEMORY_PLAN=0. A subgraph is planned once.
+  void plan_memory(const xir::Subgraph* subg,
+                   const std::vector<const xir::Op*>& ops);
+
+  // ops which must finish before `op` runs, because `op` writes memory
+  // which they use. They run before `op` in the planned order anyway,
+  // only schedules which reorder ops need this.
+  std::vector<const xir::Op*> get_reuse_deps(const xir::Op* op);
+
+  // whether `writer` may already write the output of `op` when it runs,
+  // i.e. the output has memory of its own, or plan_memory() gave it the
+  // memory of the output of `writer` and it is computed in place there
+  bool can_write_ahead(const xir::Op* op, const xir::Op* writer);
+
  private:
   // using mutex to make sure this class is thread-safe,
   // and in create_or_get func, it will call other routines,
@@ -61,6 +88,14 @@ class CPUTBFactory {
   std::unordered_map<const xir::Op*, CPUTensorBuffer*> op_map_;
   // key: tensor, value is tbs_ related element's raw pointer
   std::unordered_map<const xir::Tensor*, CPUTensorBuffer*> tensor_map_;
+
+  // key: subgraph, value is its planned arena
+  std::unordered_map<const xir::Subgraph*, vector<char>> arenas_;
+  std::unordered_map<const xir::Op*, std::vector<const xir::Op*>>
+      reuse_deps_;
+  // key: planned op, value is the block of memory its output is in
+  std::unordered_map<const xir::Op*, std::pair<const xir::Subgraph*, int>>
+      blocks_;
 };
 
 }  // namespace cpu
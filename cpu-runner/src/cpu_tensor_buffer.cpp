@@ -92,6 +92,7 @@ void CPUTensorBuffer::set_data_ptr(void* ptr) {
   UNI_LOG_CHECK(ptr != nullptr, VART_NULL_PTR);
   use_internal_buf_ = false;
   data_ptr_ = (char*)ptr;
+  vector<char>().swap(internal_data_buf_);
 }
 
 std::vector<int32_t> CPUTensorBuffer::get_stride(const xir::Tensor* tensor,
@@ -17,6 +17,8 @@
 
 #include "avg_pool.hpp"
 
+#include "thread_pool.hpp"
+
 namespace vart {
 namespace cpu {
 
@@ -60,79 +62,9 @@ void AvgPool<DType>::print_param() {
 
 template <typename DType>
 void AvgPool<DType>::acc_pool() {
-  if (CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
-      CPU_RUN_MODE == CPURunMode::GEMM_THREAD) {
-    acc_pool_thread();
-  } else {
-    acc_pool_normal();
-  }
-}
-
-template <typename DType>
-void AvgPool<DType>::acc_pool_normal() {
-  for (auto n = 0; n < fmap_o_.n; n++) {
-    for (auto h = 0; h < fmap_o_.h; h++) {
-      for (auto w = 0; w < fmap_o_.w; w++) {
-        acc_pool_one(n, h, w);
-      }
-    }
-  }
-}
-
-template <typename DType>
-void AvgPool<DType>::acc_pool_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(std::launch::async,
-                            [this](decltype(i) i) {
-                              auto BASE_POS = i * THREAD_WORKLOAD;
-                              for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                auto pos = BASE_POS + j;
-                                if (pos % fmap_o_.c != 0) continue;
-                                if (pos >= FMAP_SIZE) break;
-
-                                auto fmap = fmap_o_.pos2coord(pos);
-                                acc_pool_one(fmap.n, fmap.h, fmap.w);
-                              }
-
-                              return 0;
-                            },
-                            i);
-  }
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
-}
-
-template <typename DType>
-void AvgPool<DType>::acc_pool_one(int idx_dst_n, int idx_dst_h, int idx_dst_w) {
-  // init result value
-  int idx_src_n = idx_dst_n;
-  int idx_src_h = idx_dst_h * stride_.h;
-  int idx_src_w = idx_dst_w * stride_.w;
-
-  auto dst_base = idx_dst_n * fmap_o_.ncod() + idx_dst_h * fmap_o_.hcod() +
-                  idx_dst_w * fmap_o_.wcod();
-  std::fill_n(data_out_ptr_ + dst_base, fmap_o_.c, static_cast<DType>(0));
-
-  // accumulate one pool kernel
-  for (auto h = 0; h < kernel_.h; h++) {
-    for (auto w = 0; w < kernel_.w; w++) {
-      // be in special_pad range, not handle
-      if (idx_src_h + h >= fmap_i_.h || idx_src_w + w >= fmap_i_.w) continue;
-
-      auto src_base = idx_src_n * fmap_i_.ncod() +
-                      (idx_src_h + h) * fmap_i_.hcod() +
-                      (idx_src_w + w) * fmap_i_.wcod();
-
-      for (auto c = 0; c < fmap_o_.c; c++) {
-        data_out_ptr_[dst_base + c] += data_in_ptr_[src_base + c];
-      }
-    }
-  }
+  vart::cpu::sum_pool(this->pool_shape(), data_in_ptr_, data_out_ptr_,
+                      CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
+                          CPU_RUN_MODE == CPURunMode::GEMM_THREAD);
 }
 
 template <typename DType>
@@ -165,30 +97,17 @@ void AvgPool<DType>::avg_pool_normal() {
 
 template <typename DType>
 void AvgPool<DType>::avg_pool_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(std::launch::async,
-                            [this](decltype(i) i) {
-                              auto BASE_POS = i * THREAD_WORKLOAD;
-                              for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                auto pos = BASE_POS + j;
-                                if (pos % fmap_o_.c != 0) continue;
-                                if (pos >= FMAP_SIZE) break;
-
-                                auto fmap = fmap_o_.pos2coord(pos);
-                                avg_pool_one(fmap.n, fmap.h, fmap.w);
-                              }
-
-                              return 0;
-                            },
-                            i);
-  }
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+  parallel_for(THREAD_NUM, [this](uint32_t i) {
+    auto BASE_POS = i * THREAD_WORKLOAD;
+    for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+      auto pos = BASE_POS + j;
+      if (pos % fmap_o_.c != 0) continue;
+      if (pos >= FMAP_SIZE) break;
+
+      auto fmap = fmap_o_.pos2coord(pos);
+      avg_pool_one(fmap.n, fmap.h, fmap.w);
+    }
+  });
 }
 
 template <typename DType>
@@ -36,9 +36,6 @@ public:
 protected:
 
   void acc_pool();
-  void acc_pool_normal();
-  void acc_pool_thread();
-  inline void acc_pool_one(int idx_dst_n, int idx_dst_h, int idx_dst_w);
 
   void avg_pool();
   void avg_pool_normal();
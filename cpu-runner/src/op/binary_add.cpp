@@ -18,6 +18,7 @@
 #include "binary_add.hpp"
 
 #include "align_buf_mgr.hpp"
+#include "thread_pool.hpp"
 
 namespace vart {
 namespace cpu {
@@ -30,6 +31,11 @@ Add<DType>::Add(const xir::Subgraph* subg, const xir::Op* op, IMapTBs_t inputs,
   GET_INPUT_ANY_DIM_FMAPS(fmap_i_, input);
   GET_OUTPUT_ANY_DIM_FMAP(fmap_o_);
   align_dim();
+  vector<vector<int>> in_dims;
+  for (const auto& map_i : fmap_i_) {
+    in_dims.push_back(map_i.vdims());
+  }
+  loops_ = make_broadcast(fmap_o_.vdims(), in_dims);
 
   auto input_ops = xir_op_->get_input_ops("input");
   shift = std::all_of(input_ops.begin(), input_ops.end(), [=](auto input_op) {
@@ -107,53 +113,45 @@ void Add<DType>::read() {
 template <typename DType>
 void Add<DType>::add_normal() {
   add(0, fmap_o_.num());
+  run_fused(data_out_ptr_, 0, fmap_o_.num());
 }
 
 template <typename DType>
 void Add<DType>::add_thread() {
-  vector<std::future<void>> fut(THREAD_NUM);
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; ++thread_id) {
-    auto start_index = thread_id * THREAD_WORKLOAD;
-    auto FMAP_SIZE = fmap_o_.num();
-    auto end_index =
-        std::min<uint32_t>(FMAP_SIZE, start_index + THREAD_WORKLOAD);
-    fut[thread_id] = std::async(
-        std::launch::async,
-        [this](decltype(start_index) start_index,
-               decltype(end_index) end_index) { add(start_index, end_index); },
-        start_index, end_index);
-  }
-
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; thread_id++) {
-    fut[thread_id].wait();
-  }
+  parallel_for_elementwise(fmap_o_.num(),
+                           [this](int64_t start_index, int64_t end_index) {
+                             add(start_index, end_index);
+                             run_fused(data_out_ptr_, start_index, end_index);
+                           });
 }
 
 template <typename DType>
 void Add<DType>::add(std::uint32_t start_index, std::uint32_t end_index) {
-  for (auto i = start_index; i < end_index; ++i) {
-    for (auto j = 0U; j < fmap_i_.size(); j++) {
-      auto coord = fmap_o_.pos2coord(i);
-      for (auto k = 0U; k < coord.size(); k++) {
-        if (fmap_i_[j][k] == 1) {
-          coord[k] = 0;
+  for_each_run(
+      loops_, start_index, end_index,
+      [&](int64_t pos, const int64_t* in_pos, const int64_t* in_step,
+          int64_t len) {
+        for (auto j = 0U; j < fmap_i_.size(); j++) {
+          const auto* in = data_in_ptr_[j] + in_pos[j];
+          if (shift) {
+            auto scale = pow(2, shift_factor_[j]);
+            accumulate_run(data_out_ptr_ + pos, in, in_step[j], len,
+                           [scale](DType o, DType x) {
+                             return o + floor(x * scale) / scale;
+                           });
+          } else {
+            accumulate_run(data_out_ptr_ + pos, in, in_step[j], len,
+                           [](DType o, DType x) { return o + x; });
+          }
         }
-      }
-      auto pos = fmap_i_[j].coord2pos(coord);
-      if (shift) {
-        data_out_ptr_[i] +=
-            floor(data_in_ptr_[j][pos] * pow(2, shift_factor_[j])) /
-            pow(2, shift_factor_[j]);
-      } else {
-        data_out_ptr_[i] += data_in_ptr_[j][pos];
-      }
-    }
-  }
+      });
 }
 
 template <typename DType>
 void Add<DType>::run() {
   read();
+  ElementwiseProfile profile(get_name(), loops_,
+                             vector<size_t>(fmap_i_.size() + 1, sizeof(DType)));
   if (CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
       CPU_RUN_MODE == CPURunMode::GEMM_THREAD) {
     add_thread();
@@ -195,15 +193,17 @@ AddFix<DType>::AddFix(const xir::Subgraph* subg, const xir::Op* op,
 
 template <typename DType>
 void AddFix<DType>::add(std::uint32_t start_index, std::uint32_t end_index) {
+  vector<int64_t> pos(fmap_i_.size());
   for (auto i = start_index; i < end_index; i++) {
     float tmp = 0;
-    for (auto j = 0U; j < fmap_i_.size(); j++) {
-      auto coord = fmap_o_.pos2coord(i);
-      for (auto k = 0U; k < coord.size(); k++) {
-        if (fmap_i_[j][k] == 1) coord[k] = 0;
+    if (i == start_index || (i % loops_.dims.back()) == 0) {
+      for (auto j = 0U; j < fmap_i_.size(); j++) {
+        pos[j] = loops_.input_pos(j, i);
       }
-      auto pos = fmap_i_[j].coord2pos(coord);
-      tmp += data_in_ptr_[j][pos] / pow(2.0, shift_read_[j] - 2);
+    }
+    for (auto j = 0U; j < fmap_i_.size(); j++) {
+      tmp += data_in_ptr_[j][pos[j]] / pow(2.0, shift_read_[j] - 2);
+      pos[j] += loops_.strides[j].back();
     }
     tmp /= pow(2.0, shift_write_ + 2);
     if (act_type_ == "RELU") {
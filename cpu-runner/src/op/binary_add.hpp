@@ -34,6 +34,10 @@ class Add : public CPUOPBase {
   virtual void print_param() override;
   virtual void read() override final;
   virtual void run() override;
+  // add_normal() and add_thread() run the fused ops
+  virtual bool can_fuse_pointwise() const override {
+    return std::is_floating_point<DType>::value;
+  }
   virtual void add_normal();
   virtual void add_thread();
   virtual void add(std::uint32_t start_index, std::uint32_t end_index);
@@ -41,6 +45,7 @@ class Add : public CPUOPBase {
  protected:
   vector<Dimension> fmap_i_;
   Dimension fmap_o_;
+  Broadcast loops_;
 
   // i/o buffer
   vector<DType*> data_in_ptr_;
@@ -67,6 +72,7 @@ class AddFix : public Add<DType> {
  protected:
   using Add<DType>::fmap_i_;
   using Add<DType>::fmap_o_;
+  using Add<DType>::loops_;
   using Add<DType>::data_in_ptr_;
   using Add<DType>::data_out_ptr_;
 
@@ -17,6 +17,8 @@
 
 #include "binary_base.hpp"
 
+#include "thread_pool.hpp"
+
 namespace vart {
 namespace cpu {
 
@@ -49,10 +51,15 @@ BinaryBase<DTypeIn0, DTypeIn1, DTypeOut>::BinaryBase(const xir::Subgraph* subg,
   no_broadcast_ = std::all_of(
       fmap_i_.begin(), fmap_i_.end(),
       [this](const Dimension map_iter) { return fmap_o_ == map_iter; });
+  broadcast_ = make_broadcast(
+      fmap_o_.vdims(), {fmap_i_[0].vdims(), fmap_i_.back().vdims()});
 }
 
 template <typename DTypeIn0, typename DTypeIn1, typename DTypeOut>
 void BinaryBase<DTypeIn0, DTypeIn1, DTypeOut>::run() {
+  ElementwiseProfile profile(
+      get_name(), broadcast_,
+      {sizeof(DTypeIn0), sizeof(DTypeIn1), sizeof(DTypeOut)});
   if (CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
       CPU_RUN_MODE == CPURunMode::GEMM_THREAD) {
     calculate_thread();
@@ -64,27 +71,16 @@ void BinaryBase<DTypeIn0, DTypeIn1, DTypeOut>::run() {
 template <typename DTypeIn0, typename DTypeIn1, typename DTypeOut>
 void BinaryBase<DTypeIn0, DTypeIn1, DTypeOut>::calculate_normal() {
   calculate(0, fmap_o_.num(), no_broadcast_);
+  run_fused(data_out_ptr_, 0, fmap_o_.num());
 }
 
 template <typename DTypeIn0, typename DTypeIn1, typename DTypeOut>
 void BinaryBase<DTypeIn0, DTypeIn1, DTypeOut>::calculate_thread() {
-  vector<std::future<void>> fut(THREAD_NUM);
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; ++thread_id) {
-    auto start_index = thread_id * THREAD_WORKLOAD;
-    auto FMAP_SIZE = fmap_o_.num();
-    auto end_index =
-        std::min<uint32_t>(FMAP_SIZE, start_index + THREAD_WORKLOAD);
-    fut[thread_id] = std::async(
-        std::launch::async,
-        [this](decltype(start_index) start_index, decltype(end_index) end_index,
-               decltype(no_broadcast_) no_broadcast_) {
-          calculate(start_index, end_index, no_broadcast_);
-        },
-        start_index, end_index, no_broadcast_);
-  }
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; thread_id++) {
-    fut[thread_id].wait();
-  }
+  parallel_for_elementwise(
+      fmap_o_.num(), [this](int64_t start_index, int64_t end_index) {
+        calculate(start_index, end_index, no_broadcast_);
+        run_fused(data_out_ptr_, start_index, end_index);
+      });
 }
 
 template <typename DTypeIn0, typename DTypeIn1, typename DTypeOut>
@@ -94,6 +90,10 @@ void BinaryBase<DTypeIn0, DTypeIn1, DTypeOut>::print_param() {
   fmap_i_[1].print_param("fmap_i1");
   fmap_o_.print_param("fmap_o");
   UNI_LOG_DEBUG_INFO << "broadcast = " << !no_broadcast_;
+  UNI_LOG_DEBUG_INFO << "loops = " << broadcast_.dims.size() << ", input "
+                     << get_broadcast_kind_name(broadcast_.kinds[0])
+                     << ", input "
+                     << get_broadcast_kind_name(broadcast_.kinds[1]);
 
   if (CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
       CPU_RUN_MODE == CPURunMode::GEMM_THREAD) {
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "broadcast.hpp"
 #include "cpu_op_base.hpp"
 
 namespace vart {
@@ -45,6 +46,10 @@ class BinaryBase : public CPUOPBase {
 
   virtual void run() override final;
 
+  virtual bool can_fuse_pointwise() const override final {
+    return std::is_floating_point<DTypeOut>::value;
+  }
+
   virtual void print_param() override;
   virtual void check_param() override final;
 
@@ -57,6 +62,12 @@ class BinaryBase : public CPUOPBase {
   void calculate_thread();
   virtual void calculate(std::uint32_t start_index, std::uint32_t end_index,
                          bool no_broadcast) {}
+  // data_out = op(data_ina, data_inb) for outputs [start_index, end_index)
+  template <typename Op>
+  void binary(std::uint32_t start_index, std::uint32_t end_index, Op op) {
+    broadcast_binary(broadcast_, data_ina_ptr_, data_inb_ptr_, data_out_ptr_,
+                     start_index, end_index, op);
+  }
 
  protected:
   vector<Dimension> fmap_i_;
@@ -64,6 +75,7 @@ class BinaryBase : public CPUOPBase {
 
   int binary_type_{Unknown};
   bool no_broadcast_ = false;
+  Broadcast broadcast_;
 
   // i/o buffer
   DTypeIn0* data_ina_ptr_{nullptr};
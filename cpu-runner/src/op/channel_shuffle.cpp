@@ -29,6 +29,7 @@ ChannelShuffle<DType>::ChannelShuffle(const xir::Subgraph* subg, const xir::Op*
   output_shape_ = op->get_output_tensor()->get_shape();
   //upscale_ = xir_op_->get_attr<bool>("upscale");
   group_ = xir_op_->get_attr<int>("group");
+  transpose_ = make_channel_shuffle(input_shape_, group_);
 
   print_param();
 }
@@ -62,21 +63,9 @@ uint64_t ChannelShuffle<DType>::get_workload() {
 
 template <typename DType>
 void ChannelShuffle<DType>::shuffle() {
-  
-  int idx = 0;
-  for (auto b = 0; b < output_shape_[0]; b++)
-    for (auto h = 0; h < output_shape_[1]; h++)
-      for (auto w = 0; w < output_shape_[2]; w++)
-        for (auto c = 0; c < output_shape_[3]; c++) {
-          auto each_tile = output_shape_[3] / group_;
-          auto i_index =
-              b * input_shape_[1] * input_shape_[2] * input_shape_[3] +
-              h * input_shape_[2] * input_shape_[3] +
-              w * input_shape_[3] + c;
-          idx = (i_index % each_tile) * group_ + std::floor(i_index / each_tile);
-          data_out_[idx] = data_in_[i_index];
-        }
-  
+  transpose(transpose_, data_in_, data_out_,
+            CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
+                CPU_RUN_MODE == CPURunMode::GEMM_THREAD);
 }
 
 INSTANTIATE_TPCLASS(ChannelShuffle);
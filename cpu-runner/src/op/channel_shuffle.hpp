@@ -18,6 +18,7 @@
 #pragma once
 
 #include "cpu_op_base.hpp"
+#include "transpose.hpp"
 
 namespace vart {
 namespace cpu {
@@ -45,6 +46,7 @@ class ChannelShuffle : public CPUOPBase {
   std::vector<int> input_shape_;
   std::vector<int> output_shape_;
   int group_;
+  Transpose transpose_;
 
   DType* data_in_{nullptr};
   DType* data_out_{nullptr};
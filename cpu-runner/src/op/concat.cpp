@@ -17,6 +17,8 @@
 
 #include "concat.hpp"
 
+#include "thread_pool.hpp"
+
 namespace vart {
 namespace cpu {
 
@@ -109,34 +111,29 @@ void Concat<DType>::read() {
 
 template <typename DType>
 void Concat<DType>::concat_thread() {
-  THREAD_NUM = input_num_;
-  vector<std::future<int>> fut(THREAD_NUM);
+  auto offsets = vector<int>(input_num_, 0);
+  for (auto id = 1; id < input_num_; id++) {
+    offsets[id] = offsets[id - 1] + fmap_i_[id - 1][axis_];
+  }
 
-  auto acc = 0;
-  for (auto id = 0; id < input_num_; id++) {
-    fut[id] = std::async(
-        std::launch::async,
-        [this](decltype(id) id, decltype(acc) acc) {
+  // inputs differ in size, free threads take them one by one.
+  parallel_for_range(
+      input_num_,
+      [this, &offsets](int64_t begin, int64_t end) {
+        for (auto id = begin; id < end; id++) {
           auto inner_num = fmap_i_[id][axis_] * fmap_i_[id].cod(axis_);
           auto outer_num = fmap_i_[id].num() / inner_num;
           for (auto o = 0; o < outer_num; o++) {
             auto src_addr = o * inner_num;
             auto coord = fmap_i_[id].pos2coord(src_addr);
-            coord[axis_] += acc;
+            coord[axis_] += offsets[id];
             auto dst_addr = fmap_o_.coord2pos(coord);
+            if (&data_in_[id][src_addr] == &data_out_[dst_addr]) continue;
             copy_n(&data_in_[id][src_addr], inner_num, &data_out_[dst_addr]);
           }
-
-          return 0;
-        },
-        id, acc);
-
-    acc += fmap_i_[id][axis_];
-  }
-
-  for (auto i = 0; i < THREAD_NUM; i++) {
-    fut[i].wait();
-  }
+        }
+      },
+      Schedule::DYNAMIC);
 }
 
 template <typename DType>
@@ -151,6 +148,8 @@ void Concat<DType>::concat_normal() {
       coord[axis_] += acc;
       auto dst_addr = fmap_o_.coord2pos(coord);
 
+      // the memory plan may have had the input written in its place
+      if (&data_in_[id][src_addr] == &data_out_[dst_addr]) continue;
       copy_n(&data_in_[id][src_addr], inner_num, &data_out_[dst_addr]);
     }
 
@@ -17,6 +17,8 @@
 
 #include "concat_fix.hpp"
 
+#include "thread_pool.hpp"
+
 namespace vart {
 namespace cpu {
 
@@ -85,40 +87,35 @@ void ConcatFix<DType>::read() {
 
 template <typename DType>
 void ConcatFix<DType>::concat_thread() {
-  auto THREAD_NUM = input_num_;
-  vector<std::future<int>> fut(THREAD_NUM);
+  auto offsets = vector<int>(input_num_, 0);
+  for (auto id = 1; id < input_num_; id++) {
+    offsets[id] = offsets[id - 1] + fmap_i_[id - 1][axis_];
+  }
 
-  auto acc = 0;
-  for (auto id = 0; id < input_num_; id++) {
-    fut[id] = std::async(
-        std::launch::async,
-        [this](decltype(id) id, decltype(acc) acc) {
+  // inputs differ in size, free threads take them one by one.
+  parallel_for_range(
+      input_num_,
+      [this, &offsets](int64_t begin, int64_t end) {
+        for (auto id = begin; id < end; id++) {
           auto inner_num = fmap_i_[id][axis_] * fmap_i_[id].cod(axis_);
           auto outer_num = fmap_i_[id].num() / inner_num;
           for (auto o = 0; o < outer_num; o++) {
             auto src_addr = o * inner_num;
             auto coord = fmap_i_[id].pos2coord(src_addr);
-            coord[axis_] += acc;
+            coord[axis_] += offsets[id];
             auto dst_addr = fmap_o_.coord2pos(coord);
             auto factor = pow(2, shift_read[id]);
             for (auto i = 0; i < inner_num; i++) {
-              auto data_in =
-                  round_normal<DType>(CPUOPBase::round_mode_,(double)(data_in_[id][src_addr + i]) * factor,
-                                  CPUOPBase::data_min_, CPUOPBase::data_max_);
+              auto data_in = round_normal<DType>(
+                  CPUOPBase::round_mode_,
+                  (double)(data_in_[id][src_addr + i]) * factor,
+                  CPUOPBase::data_min_, CPUOPBase::data_max_);
               data_out_[dst_addr + i] = data_in;
             }
           }
-
-          return 0;
-        },
-        id, acc);
-
-    acc += fmap_i_[id][axis_];
-  }
-
-  for (auto i = 0; i < THREAD_NUM; i++) {
-    fut[i].wait();
-  }
+        }
+      },
+      Schedule::DYNAMIC);
 }
 
 template <typename DType>
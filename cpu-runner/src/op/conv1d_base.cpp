@@ -21,6 +21,7 @@
 #include "conv_2_gemm.hpp"
 #include "cpu_gemm.hpp"
 #include "fast_pad.hpp"
+#include "thread_pool.hpp"
 
 namespace vart {
 namespace cpu {
@@ -231,31 +232,17 @@ void Conv1dBase<DType, WType>::conv_normal() {
 
 template <typename DType, typename WType>
 void Conv1dBase<DType, WType>::conv_normal_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(
-        std::launch::async,
-        [this](decltype(i) i) {
-          auto BASE_POS = i * THREAD_WORKLOAD;
-          auto FMAP_SIZE = fmap_o_.num();
-          for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-            int pos = BASE_POS + j;
-            if (pos >= FMAP_SIZE) break;
-
-            auto fmap = fmap_o_.pos2coord(pos);
-            conv_one(fmap.n, fmap.h, fmap.w, fmap.c);
-          }
-
-          return 0;
-        },
-        i);
-  }
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+  parallel_for(THREAD_NUM, [this](uint32_t i) {
+    auto BASE_POS = i * THREAD_WORKLOAD;
+    auto FMAP_SIZE = fmap_o_.num();
+    for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+      int pos = BASE_POS + j;
+      if (pos >= FMAP_SIZE) break;
+
+      auto fmap = fmap_o_.pos2coord(pos);
+      conv_one(fmap.n, fmap.h, fmap.w, fmap.c);
+    }
+  });
 }
 
 template <typename DType, typename WType>
@@ -296,39 +283,25 @@ void Conv1dBase<DType, WType>::conv_gemm_thread() {
 #endif
 
 #if 1
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(
-        std::launch::async,
-        [this](decltype(i) i) {
-          auto BASE_POS = i * THREAD_WORKLOAD;
-          auto FMAP_SIZE = fmap_o_.num();
-          for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-            int pos = BASE_POS + j;
-            if (pos >= FMAP_SIZE) break;
-
-            auto fmap = fmap_o_.pos2coord(pos);
-
-            auto* tmp_ptr_i = data_in_ptr_ + fmap.n * fmap_i_.ncod() +
-                              fmap.h * stride_.h * fmap_i_.hcod() +
-                              fmap.w * stride_.w * fmap_i_.wcod();
-            auto* tmp_ptr_w = weights_ptr_ + fmap.c * fmap_w_.ncod();
-
-            inner_product_with_kernel_stride<DType, WType>(
-                tmp_ptr_i, tmp_ptr_w, &data_out_ptr_[pos], fmap_i_, fmap_w_,
-                kernel_);
-          }
-
-          return 0;
-        },
-        i);
-  }
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+  parallel_for(THREAD_NUM, [this](uint32_t i) {
+    auto BASE_POS = i * THREAD_WORKLOAD;
+    auto FMAP_SIZE = fmap_o_.num();
+    for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+      int pos = BASE_POS + j;
+      if (pos >= FMAP_SIZE) break;
+
+      auto fmap = fmap_o_.pos2coord(pos);
+
+      auto* tmp_ptr_i = data_in_ptr_ + fmap.n * fmap_i_.ncod() +
+                        fmap.h * stride_.h * fmap_i_.hcod() +
+                        fmap.w * stride_.w * fmap_i_.wcod();
+      auto* tmp_ptr_w = weights_ptr_ + fmap.c * fmap_w_.ncod();
+
+      inner_product_with_kernel_stride<DType, WType>(
+          tmp_ptr_i, tmp_ptr_w, &data_out_ptr_[pos], fmap_i_, fmap_w_,
+          kernel_);
+    }
+  });
 #endif
 }
 
@@ -21,6 +21,7 @@
 #include "conv_2_gemm.hpp"
 #include "cpu_gemm.hpp"
 #include "fast_pad.hpp"
+#include "thread_pool.hpp"
 
 using std::begin;
 using std::end;
@@ -207,31 +208,19 @@ void Conv3dBase<DType, WType>::conv_normal() {
 
 template <typename DType, typename WType>
 void Conv3dBase<DType, WType>::conv_normal_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i] = std::async(
-        std::launch::async,
-        [this](decltype(i) i) {
-          auto BASE_POS = i * THREAD_WORKLOAD;
-          auto FMAP_SIZE = fmap_o_.num();
-          for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-            int pos = BASE_POS + j;
-            if (pos >= FMAP_SIZE) break;
-            auto fmap = fmap_o_.pos2coord(pos);
-            if (!if_depthwise_)
-              conv_one(fmap.n, fmap.h, fmap.w, fmap.d, fmap.c);
-            else
-              dwconv_one(fmap.n, fmap.h, fmap.w, fmap.d, fmap.c);
-          }
-          return 0;
-        },
-        i);
-  }
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+  parallel_for(THREAD_NUM, [this](uint32_t i) {
+    auto BASE_POS = i * THREAD_WORKLOAD;
+    auto FMAP_SIZE = fmap_o_.num();
+    for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+      int pos = BASE_POS + j;
+      if (pos >= FMAP_SIZE) break;
+      auto fmap = fmap_o_.pos2coord(pos);
+      if (!if_depthwise_)
+        conv_one(fmap.n, fmap.h, fmap.w, fmap.d, fmap.c);
+      else
+        dwconv_one(fmap.n, fmap.h, fmap.w, fmap.d, fmap.c);
+    }
+  });
 }
 
 template <typename DType, typename WType>
@@ -277,38 +266,25 @@ void Conv3dBase<DType, WType>::conv_gemm_thread() {
 #endif
 
 #if 1
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i] = std::async(
-        std::launch::async,
-        [this](decltype(i) i) {
-          auto BASE_POS = i * THREAD_WORKLOAD;
-          auto FMAP_SIZE = fmap_o_.num();
-          for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-            int pos = BASE_POS + j;
-            if (pos >= FMAP_SIZE) break;
-            auto fmap = fmap_o_.pos2coord(pos);
-
-            auto* tmp_ptr_i = data_in_ptr_ + fmap.n * fmap_pad_i_.ncod() +
-                              fmap.h * stride_.h * fmap_pad_i_.hcod() +
-                              fmap.w * stride_.w * fmap_pad_i_.wcod() +
-                              fmap.d * stride_.d * fmap_pad_i_.dcod();
-            auto* tmp_ptr_w = weights_ptr_ + fmap.c * fmap_dilated_w_.ncod();
-
-            inner_product_with_kernel_stride<DType, WType>(
-                tmp_ptr_i, tmp_ptr_w, &data_out_ptr_[pos], fmap_pad_i_,
-                fmap_dilated_w_, kernel_);
-          }
-
-          return 0;
-        },
-        i);
-  }
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+  parallel_for(THREAD_NUM, [this](uint32_t i) {
+    auto BASE_POS = i * THREAD_WORKLOAD;
+    auto FMAP_SIZE = fmap_o_.num();
+    for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+      int pos = BASE_POS + j;
+      if (pos >= FMAP_SIZE) break;
+      auto fmap = fmap_o_.pos2coord(pos);
+
+      auto* tmp_ptr_i = data_in_ptr_ + fmap.n * fmap_pad_i_.ncod() +
+                        fmap.h * stride_.h * fmap_pad_i_.hcod() +
+                        fmap.w * stride_.w * fmap_pad_i_.wcod() +
+                        fmap.d * stride_.d * fmap_pad_i_.dcod();
+      auto* tmp_ptr_w = weights_ptr_ + fmap.c * fmap_dilated_w_.ncod();
+
+      inner_product_with_kernel_stride<DType, WType>(
+          tmp_ptr_i, tmp_ptr_w, &data_out_ptr_[pos], fmap_pad_i_,
+          fmap_dilated_w_, kernel_);
+    }
+  });
 #endif
 }
 
@@ -17,9 +17,12 @@
 
 #include "conv_base.hpp"
 #include "align_buf_mgr.hpp"
+#include "broadcast.hpp"
 #include "conv_2_gemm.hpp"
 #include "cpu_gemm.hpp"
 #include "fast_pad.hpp"
+#include "thread_pool.hpp"
+#include "weight_cache.hpp"
 
 namespace vart {
 namespace cpu {
@@ -174,6 +177,39 @@ void ConvBase<DType, WType>::read() {
   std::fill_n(data_out_ptr_, fmap_o_.num(), DType(0));
 }
 
+template <typename DType, typename WType>
+void ConvBase<DType, WType>::prepare() {
+  if constexpr (std::is_same<DType, float>::value &&
+                std::is_same<WType, float>::value) {
+    if (use_conv_algo()) {
+      auto* weights_op = xir_op_->get_input_op(ITName[WEIGHTS], 0);
+      if (!WeightCache::cacheable(xir_subg_, weights_op)) {
+        return;
+      }
+      read_weights();
+      auto s = conv_shape();
+      conv_weights_ = WeightCache::Instance().get_conv_weights(
+          weights_op, s, select_conv_algo(s), weights_ptr_);
+      return;
+    }
+  }
+
+  // only conv_gemm_thread() takes packed weights
+  if constexpr (std::is_same<DType, int32_t>::value &&
+                std::is_same<WType, int32_t>::value) {
+    auto* weights_op = xir_op_->get_input_op(ITName[WEIGHTS], 0);
+    if (group_ != 1 || enable_conv_dirty_ ||
+        CPU_RUN_MODE != CPURunMode::GEMM_THREAD ||
+        !WeightCache::cacheable(xir_subg_, weights_op)) {
+      return;
+    }
+    read_weights();
+    auto k = fmap_w_.h * fmap_w_.w * fmap_w_.c;
+    packed_weights_ = WeightCache::Instance().get_gemm_b(
+        weights_op, weights_ptr_, fmap_o_.c, k, 1, k);
+  }
+}
+
 template <typename DType, typename WType>
 uint64_t ConvBase<DType, WType>::get_workload() {
   // not consider batch
@@ -228,7 +264,9 @@ void ConvBase<DType, WType>::read_bias() {
 template <typename DType, typename WType>
 void ConvBase<DType, WType>::conv() {
   if (!enable_conv_dirty_) {
-    if (CPU_RUN_MODE == CPURunMode::NORMAL) {
+    if (use_conv_algo()) {
+      conv_algo();
+    } else if (CPU_RUN_MODE == CPURunMode::NORMAL) {
       conv_normal();
     } else if (CPU_RUN_MODE == CPURunMode::NORMAL_THREAD) {
       conv_normal_thread();
@@ -244,6 +282,39 @@ void ConvBase<DType, WType>::conv() {
   }
 }
 
+template <typename DType, typename WType>
+bool ConvBase<DType, WType>::use_conv_algo() const {
+  return std::is_same<DType, float>::value &&
+         std::is_same<WType, float>::value && group_ == 1 &&
+         !enable_conv_dirty_ &&
+         (CPU_RUN_MODE == CPURunMode::NORMAL ||
+          CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
+          CPU_RUN_MODE == CPURunMode::GEMM);
+}
+
+template <typename DType, typename WType>
+ConvShape ConvBase<DType, WType>::conv_shape() const {
+  return ConvShape{fmap_o_.n, fmap_i_.h, fmap_i_.w, fmap_i_.c,
+                   fmap_o_.h, fmap_o_.w, fmap_o_.c, fmap_w_.h,
+                   fmap_w_.w, stride_.h, stride_.w};
+}
+
+template <typename DType, typename WType>
+void ConvBase<DType, WType>::conv_algo() {
+  if constexpr (std::is_same<DType, float>::value &&
+                std::is_same<WType, float>::value) {
+    auto s = conv_shape();
+    auto parallel = CPU_RUN_MODE == CPURunMode::NORMAL_THREAD;
+    if (conv_weights_) {
+      conv_float(s, *conv_weights_, data_in_ptr_, data_out_ptr_, parallel);
+    } else {
+      // weights computed by the graph, packed on every run
+      conv_float(s, pack_conv_weights(s, select_conv_algo(s), weights_ptr_),
+                 data_in_ptr_, data_out_ptr_, parallel);
+    }
+  }
+}
+
 template <typename DType, typename WType>
 void ConvBase<DType, WType>::conv_dirty() {
   std::vector<DType> cascade0(fmap_o_.num(), 0);
@@ -385,35 +456,21 @@ void ConvBase<DType, WType>::conv_normal() {
 
 template <typename DType, typename WType>
 void ConvBase<DType, WType>::conv_normal_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] =
-        std::async(std::launch::async,
-                   [this](decltype(i) i) {
-                     auto BASE_POS = i * THREAD_WORKLOAD;
-                     auto FMAP_SIZE = fmap_o_.num();
-                     for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                       int pos = BASE_POS + j;
-                       if (pos >= FMAP_SIZE) break;
-                       auto fmap = fmap_o_.pos2coord(pos);
-                       if (group_ == 1) {
-                         conv_one(data_in_ptr_, weights_ptr_, data_out_ptr_,
-                                  fmap.n, fmap.h, fmap.w, fmap.c, 0, fmap_i_.c);
-                       } else {
-                         conv_one_withgroup(fmap.n, fmap.h, fmap.w, fmap.c);
-                       }
-                     }
-
-                     return 0;
-                   },
-                   i);
-  }
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+  parallel_for(THREAD_NUM, [this](uint32_t i) {
+    auto BASE_POS = i * THREAD_WORKLOAD;
+    auto FMAP_SIZE = fmap_o_.num();
+    for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+      int pos = BASE_POS + j;
+      if (pos >= FMAP_SIZE) break;
+      auto fmap = fmap_o_.pos2coord(pos);
+      if (group_ == 1) {
+        conv_one(data_in_ptr_, weights_ptr_, data_out_ptr_, fmap.n, fmap.h,
+                 fmap.w, fmap.c, 0, fmap_i_.c);
+      } else {
+        conv_one_withgroup(fmap.n, fmap.h, fmap.w, fmap.c);
+      }
+    }
+  });
 }
 
 template <typename DType, typename WType>
@@ -481,44 +538,56 @@ void ConvBase<DType, WType>::conv_gemm_thread() {
 #endif
 
 #if 1
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(
-        std::launch::async,
-        [this](decltype(i) i) {
-          auto BASE_POS = i * THREAD_WORKLOAD;
-          auto FMAP_SIZE = fmap_o_.num();
-          for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-            int pos = BASE_POS + j;
-            if (pos >= FMAP_SIZE) break;
-
-            auto fmap = fmap_o_.pos2coord(pos);
-
-            auto* tmp_ptr_i = data_in_ptr_ + fmap.n * fmap_i_.ncod() +
-                              fmap.h * stride_.h * fmap_i_.hcod() +
-                              fmap.w * stride_.w * fmap_i_.wcod();
-            auto* tmp_ptr_w = weights_ptr_ + fmap.c * fmap_w_.ncod();
-            if (group_ == 1) {
-              inner_product_with_kernel_stride<DType, WType>(
-                  tmp_ptr_i, tmp_ptr_w, &data_out_ptr_[pos], fmap_i_, fmap_w_,
-                  kernel_);
-            } else {
-              int32_t idx_oc_group = floor(fmap.c * group_ / fmap_o_.c);
-              inner_product_with_kernel_stride<DType, WType>(
-                  tmp_ptr_i + idx_oc_group * fmap_w_.c, tmp_ptr_w,
-                  &data_out_ptr_[pos], fmap_i_, fmap_w_, kernel_);
-            }
-          }
-          return 0;
-        },
-        i);
+  // int32 (conv-fix) goes through im2col and the packed gemm, float keeps
+  // the direct loops, which emulate the rounding of the float conv
+  if constexpr (std::is_same<DType, int32_t>::value &&
+                std::is_same<WType, int32_t>::value) {
+    if (group_ == 1) {
+      auto WEIGHTS_BATCH_SIZE = fmap_w_.h * fmap_w_.w * fmap_w_.c;
+      FMap_t tmp_fmap{fmap_o_.n, fmap_o_.h, fmap_o_.w, WEIGHTS_BATCH_SIZE};
+      DType* tmp_ptr =
+          reinterpret_cast<DType*>(AlignBufMgr::Instance()->allocate(
+              tmp_fmap.num() * sizeof(DType), ALIGN_SIZE));
+      Conv2Gemm(fmap_i_, tmp_fmap, fmap_w_, kernel_, stride_)
+          .transform_thread(data_in_ptr_, tmp_ptr);
+      if (packed_weights_) {
+        gemm(tmp_ptr, *packed_weights_, data_out_ptr_,
+             fmap_o_.n * fmap_o_.h * fmap_o_.w);
+      } else {
+        gemm(tmp_ptr, weights_ptr_, data_out_ptr_,
+             fmap_o_.n * fmap_o_.h * fmap_o_.w, fmap_o_.c, WEIGHTS_BATCH_SIZE,
+             1, WEIGHTS_BATCH_SIZE);
+      }
+      AlignBufMgr::Instance()->release(tmp_ptr);
+      return;
+    }
   }
 
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+  parallel_for(THREAD_NUM, [this](uint32_t i) {
+    auto BASE_POS = i * THREAD_WORKLOAD;
+    auto FMAP_SIZE = fmap_o_.num();
+    for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+      int pos = BASE_POS + j;
+      if (pos >= FMAP_SIZE) break;
+
+      auto fmap = fmap_o_.pos2coord(pos);
+
+      auto* tmp_ptr_i = data_in_ptr_ + fmap.n * fmap_i_.ncod() +
+                        fmap.h * stride_.h * fmap_i_.hcod() +
+                        fmap.w * stride_.w * fmap_i_.wcod();
+      auto* tmp_ptr_w = weights_ptr_ + fmap.c * fmap_w_.ncod();
+      if (group_ == 1) {
+        inner_product_with_kernel_stride<DType, WType>(
+            tmp_ptr_i, tmp_ptr_w, &data_out_ptr_[pos], fmap_i_, fmap_w_,
+            kernel_);
+      } else {
+        int32_t idx_oc_group = floor(fmap.c * group_ / fmap_o_.c);
+        inner_product_with_kernel_stride<DType, WType>(
+            tmp_ptr_i + idx_oc_group * fmap_w_.c, tmp_ptr_w,
+            &data_out_ptr_[pos], fmap_i_, fmap_w_, kernel_);
+      }
+    }
+  });
 #endif
 }
 
@@ -592,14 +661,26 @@ void ConvBase<DType, WType>::conv_one_withgroup(int idx_dst_n, int idx_dst_h,
 
 template <typename DType, typename WType>
 void ConvBase<DType, WType>::bias() {
-  if (!has_bias_) return;
+  if (!has_bias_ && !this->has_fused()) return;
   if (enable_conv_dirty_) return;
 
   // NOTE: special handling for conv-fix
   if (std::is_floating_point<DType>::value) {
-    for (auto i = 0; i < fmap_o_.num(); i++) {
-      auto pos = i % fmap_o_.c;
-      data_out_ptr_[i] += bias_ptr_[pos];
+    // bias and the fused ops in one pass
+    auto f = [this](int64_t begin, int64_t end) {
+      if (has_bias_) {
+        for (auto i = begin; i < end; i++) {
+          auto pos = i % fmap_o_.c;
+          data_out_ptr_[i] += bias_ptr_[pos];
+        }
+      }
+      this->run_fused(data_out_ptr_, begin, end);
+    };
+    if (CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
+        CPU_RUN_MODE == CPURunMode::GEMM_THREAD) {
+      parallel_for_elementwise(fmap_o_.num(), f);
+    } else {
+      f(0, fmap_o_.num());
     }
   } else {
     UNI_LOG_FATAL(VART_EXEC_ERROR)
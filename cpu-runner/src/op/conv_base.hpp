@@ -17,8 +17,10 @@
 
 #pragma once
 
+#include "conv_algo.hpp"
 #include "cpu_op_base.hpp"
 #include "cpu_tensor_utils.hpp"
+#include "gemm.hpp"
 
 namespace vart {
 namespace cpu {
@@ -46,6 +48,7 @@ class ConvBase : public CPUOPBase {
   virtual void check_param() override;
 
   virtual void read() override final;
+  virtual void prepare() override;
 
   virtual uint64_t get_workload() override final;
 
@@ -60,6 +63,11 @@ class ConvBase : public CPUOPBase {
   void conv_gemm();
   void conv_gemm_thread();
   void conv_dirty();
+  // float convs with group 1, unless the run mode emulates the float
+  // rounding of the hardware, go through conv_float()
+  bool use_conv_algo() const;
+  ConvShape conv_shape() const;
+  void conv_algo();
 
   void conv_one(DType* src, WType* wts, DType* dst, int idx_dst_n,
                 int idx_dst_h, int idx_dst_w, int idx_oc, int32_t ic_begin,
@@ -101,6 +109,11 @@ class ConvBase : public CPUOPBase {
   WType* weights_ptr_{nullptr};
   WType* bias_ptr_{nullptr};
   DType* data_out_ptr_{nullptr};
+
+  // weights packed for gemm() by prepare(), shared through WeightCache
+  std::shared_ptr<const GemmPackedB> packed_weights_;
+  // weights packed for conv_float() by prepare()
+  std::shared_ptr<const ConvWeights> conv_weights_;
 };
 
 }  // namespace cpu
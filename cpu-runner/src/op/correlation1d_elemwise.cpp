@@ -16,6 +16,7 @@
  */
 #include "correlation1d_elemwise.hpp"
 #include "align_buf_mgr.hpp"
+#include "thread_pool.hpp"
 
 namespace vart {
 namespace cpu {
@@ -105,23 +106,12 @@ void Correlation1dElemwise<DType>::corr_normal() {
 
 template <typename DType>
 void Correlation1dElemwise<DType>::corr_thread() {
-  vector<std::future<void>> fut(THREAD_NUM);
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; ++thread_id) {
-    auto start_index = thread_id * THREAD_WORKLOAD;
-    auto FMAP_SIZE = fmap_o_.num();
-    auto end_index =
-        std::min<uint32_t>(FMAP_SIZE, start_index + THREAD_WORKLOAD);
-    fut[thread_id] = std::async(std::launch::async,
-                                [this](decltype(start_index) start_index,
-                                       decltype(end_index) end_index) {
-                                  eltwise(start_index, end_index);
-                                },
-                                start_index, end_index);
-  }
-
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; thread_id++) {
-    fut[thread_id].wait();
-  }
+  parallel_for_range(
+      fmap_o_.num(),
+      [this](int64_t start_index, int64_t end_index) {
+        eltwise(start_index, end_index);
+      },
+      Schedule::STATIC);
 }
 
 template <typename DType>
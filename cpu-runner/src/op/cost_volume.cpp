@@ -17,6 +17,8 @@
 
 #include "cost_volume.hpp"
 
+#include "thread_pool.hpp"
+
 namespace vart {
 namespace cpu {
 
@@ -125,23 +127,12 @@ void CostVolume<DType>::cost_volume_normal() {
 
 template <typename DType>
 void CostVolume<DType>::cost_volume_thread() {
-  vector<std::future<void>> fut(THREAD_NUM);
-  auto FMAP_SIZE = fmap_o_.num();
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; ++thread_id) {
-    auto start_index = thread_id * THREAD_WORKLOAD;
-    auto end_index =
-        std::min<uint32_t>(FMAP_SIZE, start_index + THREAD_WORKLOAD);
-    fut[thread_id] = std::async(std::launch::async,
-                                [this](decltype(start_index) start_index,
-                                       decltype(end_index) end_index) {
-                                  cost_volume(start_index, end_index);
-                                },
-                                start_index, end_index);
-  }
-
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; ++thread_id) {
-    fut[thread_id].wait();
-  }
+  parallel_for_range(
+      fmap_o_.num(),
+      [this](int64_t start_index, int64_t end_index) {
+        cost_volume(start_index, end_index);
+      },
+      Schedule::STATIC);
 }
 
 INSTANTIATE_TPCLASS(CostVolume);
@@ -17,6 +17,8 @@
 
 #include "depthwise_fix.hpp"
 
+#include "thread_pool.hpp"
+
 namespace vart {
 namespace cpu {
 
@@ -66,6 +68,16 @@ DepthwiseFix<DType>::DepthwiseFix(const xir::Subgraph* subg, const xir::Op* op,
   broadcast_ =
       std::any_of(fmap_i_.begin(), fmap_i_.end(),
                   [this](const Dimension map_i) { return fmap_o_ != map_i; });
+  vector<vector<int>> in_dims;
+  for (const auto& map_i : fmap_i_) {
+    in_dims.push_back(map_i.vdims());
+  }
+  loops_ = make_broadcast(fmap_o_.vdims(), in_dims);
+
+  for (auto shift : shift_read_) {
+    read_scale_.push_back(pow(2.0, shift));
+  }
+  write_scale_ = pow(2.0, shift_write_);
 
   THREAD_NUM = CPU_NUM;
   THREAD_WORKLOAD = ceil((float)fmap_o_.num() / THREAD_NUM);
@@ -128,14 +140,8 @@ void DepthwiseFix<DType>::read() {
     data_in_[idx] = GET_CPUTB_DType_PTR(DType, cputb);
   }
 
-  // handle output buffer
+  // handle output buffer, every element of it is written by depthwise()
   data_out_ = GET_CPUTB_DType_PTR(DType, output_);
-
-  if ("MUL" == dpt_type_) {
-    std::fill_n(data_out_, 1, fmap_o_.num());
-  } else {
-    std::fill_n(data_out_, 0, fmap_o_.num());
-  }
 }
 
 template <typename DType>
@@ -146,33 +152,34 @@ uint64_t DepthwiseFix<DType>::get_workload() {
 template <typename DType>
 void DepthwiseFix<DType>::depthwise(std::uint32_t start_index,
                                     std::uint32_t end_index) {
-  auto dst_coord = fmap_o_.pos2coord(0);
-  auto src_coord = dst_coord;
-  for (auto pos_iter = start_index; pos_iter < end_index; pos_iter++) {
-    double tmp = (dpt_type_ == "MUL") ? 1 : 0;
-    // dim_t pos;
-    for (auto fp_iter = 0U; fp_iter < fmap_i_.size(); fp_iter++) {
-      auto pos = pos_iter;
-      if (broadcast_) {
-        fmap_o_.pos2coord(pos_iter, dst_coord);
-        for (auto dim_iter = 0U; dim_iter < dst_coord.size(); dim_iter++) {
-          src_coord[dim_iter] =
-              dst_coord[dim_iter] % fmap_i_[fp_iter][dim_iter];
+  auto mul = dpt_type_ == "MUL";
+  auto add = dpt_type_ == "ADD";
+  // a run of the output in double, the inputs folded in one at a time
+  vector<double> tmp;
+  for_each_run(
+      loops_, start_index, end_index,
+      [&](int64_t pos, const int64_t* in_pos, const int64_t* in_step,
+          int64_t len) {
+        tmp.assign(len, mul ? 1.0 : 0.0);
+        for (auto fp_iter = 0; fp_iter < input_num_; fp_iter++) {
+          const auto* in = data_in_[fp_iter] + in_pos[fp_iter];
+          auto step = in_step[fp_iter];
+          if (add) {
+            auto scale = read_scale_[fp_iter];
+            accumulate_run(
+                tmp.data(), in, step, len,
+                [scale](double t, DType x) { return t + x * scale; });
+          } else if (mul) {
+            accumulate_run(tmp.data(), in, step, len,
+                           [](double t, DType x) { return t * x; });
+          }
         }
-        pos = fmap_i_[fp_iter].coord2pos(src_coord);
-      }
-      if (dpt_type_ == "ADD") {
-        tmp += data_in_[fp_iter][pos] * pow(2.0, shift_read_[fp_iter]);
-      } else if (dpt_type_ == "MUL") {
-        tmp *= data_in_[fp_iter][pos];
-      }
-    }
-
-    tmp *= pow(2.0, shift_write_);
-    data_out_[pos_iter] =
-        round_normal<DType>(CPUOPBase::round_mode_, tmp, CPUOPBase::data_min_,
-                            CPUOPBase::data_max_);
-  }
+        for (int64_t j = 0; j < len; ++j) {
+          data_out_[pos + j] = round_normal<DType>(
+              CPUOPBase::round_mode_, tmp[j] * write_scale_,
+              CPUOPBase::data_min_, CPUOPBase::data_max_);
+        }
+      });
 }
 
 template <typename DType>
@@ -182,23 +189,10 @@ void DepthwiseFix<DType>::depthwise_normal() {
 
 template <typename DType>
 void DepthwiseFix<DType>::depthwise_thread() {
-  vector<std::future<void>> fut(THREAD_NUM);
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; ++thread_id) {
-    auto start_index = thread_id * THREAD_WORKLOAD;
-    auto FMAP_SIZE = fmap_o_.num();
-    auto end_index =
-        std::min<uint32_t>(FMAP_SIZE, start_index + THREAD_WORKLOAD);
-    fut[thread_id] = std::async(std::launch::async,
-                                [this](decltype(start_index) start_index,
-                                       decltype(end_index) end_index) {
-                                  depthwise(start_index, end_index);
-                                },
-                                start_index, end_index);
-  }
-
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; thread_id++) {
-    fut[thread_id].wait();
-  }
+  parallel_for_elementwise(fmap_o_.num(),
+                           [this](int64_t start_index, int64_t end_index) {
+                             depthwise(start_index, end_index);
+                           });
 }
 
 INSTANTIATE_TPCLASS(DepthwiseFix);
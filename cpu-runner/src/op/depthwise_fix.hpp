@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "broadcast.hpp"
 #include "cpu_op_base.hpp"
 
 namespace vart {
@@ -58,12 +59,16 @@ class DepthwiseFix : public CPUOPBase {
   std::string dpt_type_;
   int input_num_;
   bool broadcast_ = false;
+  Broadcast loops_;
 
   vector<int> fp_inputs_;
   int fp_output_;
 
   vector<int> shift_read_;
   int shift_write_;
+  // 2^shift_read_ and 2^shift_write_
+  vector<double> read_scale_;
+  double write_scale_;
 
   // caculate buffer
   vector<DType*> data_in_;
@@ -21,6 +21,7 @@
 #include "conv_2_gemm.hpp"
 #include "cpu_gemm.hpp"
 #include "fast_pad.hpp"
+#include "thread_pool.hpp"
 
 namespace vart {
 namespace cpu {
@@ -227,32 +228,20 @@ void DWConv1dBase<DType, WType>::dwconv_normal() {
 
 template <typename DType, typename WType>
 void DWConv1dBase<DType, WType>::dwconv_normal_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for(auto i=0U; i<THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(std::launch::async,
-        [this](decltype(i) i) {
-      auto BASE_POS = i*THREAD_WORKLOAD;
-      auto FMAP_SIZE = fmap_o_.num();
-      for(auto j=0U; j<THREAD_WORKLOAD; j++) {
-        int pos = BASE_POS + j;
-        if(pos >= FMAP_SIZE)
-          break;
-
-        if(pos % fmap_o_.c == 0) {
-          auto fmap = fmap_o_.pos2coord(pos);
-          dwconv_one(fmap.n, fmap.h, fmap.w);
-        }
+  parallel_for(THREAD_NUM, [this](uint32_t i) {
+    auto BASE_POS = i*THREAD_WORKLOAD;
+    auto FMAP_SIZE = fmap_o_.num();
+    for(auto j=0U; j<THREAD_WORKLOAD; j++) {
+      int pos = BASE_POS + j;
+      if(pos >= FMAP_SIZE)
+        break;
+
+      if(pos % fmap_o_.c == 0) {
+        auto fmap = fmap_o_.pos2coord(pos);
+        dwconv_one(fmap.n, fmap.h, fmap.w);
       }
-
-      return 0;
-    }, i);
-  }
-
-  for(auto i=0U; i<THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+    }
+  });
 }
 
 template <typename DType, typename WType>
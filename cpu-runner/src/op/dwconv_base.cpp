@@ -18,9 +18,12 @@
 #include "dwconv_base.hpp"
 
 #include "align_buf_mgr.hpp"
+#include "broadcast.hpp"
 #include "conv_2_gemm.hpp"
 #include "cpu_gemm.hpp"
+#include "depthwise.hpp"
 #include "fast_pad.hpp"
+#include "thread_pool.hpp"
 
 namespace vart {
 namespace cpu {
@@ -203,6 +206,15 @@ void DWConvBase<DType, WType>::read_bias() {
 
 template <typename DType, typename WType>
 void DWConvBase<DType, WType>::dwconv() {
+  // one output channel per input channel, run along the channels
+  if (fmap_w_.n == 1) {
+    Depthwise d{fmap_o_.n, fmap_i_.h, fmap_i_.w, fmap_i_.c, fmap_o_.h,
+                fmap_o_.w, fmap_w_.h, fmap_w_.w, stride_.h, stride_.w};
+    depthwise(d, data_in_ptr_, weights_ptr_, data_out_ptr_,
+              CPU_RUN_MODE != CPURunMode::NORMAL);
+    return;
+  }
+
   if(CPU_RUN_MODE == CPURunMode::NORMAL) {
     dwconv_normal();
   } else {
@@ -223,32 +235,20 @@ void DWConvBase<DType, WType>::dwconv_normal() {
 
 template <typename DType, typename WType>
 void DWConvBase<DType, WType>::dwconv_normal_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for(auto i=0U; i<THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(std::launch::async,
-        [this](decltype(i) i) {
-      auto BASE_POS = i*THREAD_WORKLOAD;
-      auto FMAP_SIZE = fmap_o_.num();
-      for(auto j=0U; j<THREAD_WORKLOAD; j++) {
-        int pos = BASE_POS + j;
-        if(pos >= FMAP_SIZE)
-          break;
-
-        if(pos % fmap_o_.c == 0) {
-          auto fmap = fmap_o_.pos2coord(pos);
-          dwconv_one(fmap.n, fmap.h, fmap.w);
-        }
+  parallel_for(THREAD_NUM, [this](uint32_t i) {
+    auto BASE_POS = i*THREAD_WORKLOAD;
+    auto FMAP_SIZE = fmap_o_.num();
+    for(auto j=0U; j<THREAD_WORKLOAD; j++) {
+      int pos = BASE_POS + j;
+      if(pos >= FMAP_SIZE)
+        break;
+
+      if(pos % fmap_o_.c == 0) {
+        auto fmap = fmap_o_.pos2coord(pos);
+        dwconv_one(fmap.n, fmap.h, fmap.w);
       }
-
-      return 0;
-    }, i);
-  }
-
-  for(auto i=0U; i<THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+    }
+  });
 }
 
 template <typename DType, typename WType>
@@ -289,14 +289,26 @@ void DWConvBase<DType, WType>::dwconv_one(int idx_dst_n, int idx_dst_h,
 
 template <typename DType, typename WType>
 void DWConvBase<DType, WType>::bias() {
-  if(!has_bias_)
+  if(!has_bias_ && !this->has_fused())
     return;
 
   // NOTE: special handling for conv-fix
   if(std::is_floating_point<DType>::value) {
-    for(auto i=0; i<fmap_o_.num(); i++) {
-      auto pos = i % fmap_o_.c;
-      data_out_ptr_[i] += bias_ptr_[pos];
+    // bias and the fused ops in one pass
+    auto f = [this](int64_t begin, int64_t end) {
+      if (has_bias_) {
+        for (auto i = begin; i < end; i++) {
+          auto pos = i % fmap_o_.c;
+          data_out_ptr_[i] += bias_ptr_[pos];
+        }
+      }
+      this->run_fused(data_out_ptr_, begin, end);
+    };
+    if (CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
+        CPU_RUN_MODE == CPURunMode::GEMM_THREAD) {
+      parallel_for_elementwise(fmap_o_.num(), f);
+    } else {
+      f(0, fmap_o_.num());
     }
   } else {
     UNI_LOG_FATAL(VART_EXEC_ERROR)
@@ -17,6 +17,8 @@
 
 #include "eltwise.hpp"
 
+#include "thread_pool.hpp"
+
 namespace vart {
 namespace cpu {
 
@@ -43,6 +45,11 @@ Eltwise<DType>::Eltwise(const xir::Subgraph* subg, const xir::Op* op,
   broadcast_ =
       std::any_of(fmap_i_.begin(), fmap_i_.end(),
                   [this](const Dimension map_i) { return fmap_o_ != map_i; });
+  vector<vector<int>> in_dims;
+  for (const auto& map_i : fmap_i_) {
+    in_dims.push_back(map_i.vdims());
+  }
+  loops_ = make_broadcast(fmap_o_.vdims(), in_dims);
 
   auto input_ops = xir_op_->get_input_ops("input");
   shift = std::all_of(input_ops.begin(), input_ops.end(), [=](auto input_op) {
@@ -84,6 +91,8 @@ void Eltwise<DType>::align_dim() {
 
 template <typename DType>
 void Eltwise<DType>::run() {
+  ElementwiseProfile profile(get_name(), loops_,
+                             vector<size_t>(input_num_ + 1, sizeof(DType)));
   if (CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
       CPU_RUN_MODE == CPURunMode::GEMM_THREAD) {
     eltwise_thread();
@@ -101,6 +110,7 @@ void Eltwise<DType>::print_param() {
 
   UNI_LOG_DEBUG_INFO << "elt_type = " << elt_type_ << endl;
   UNI_LOG_DEBUG_INFO << "broadcast = " << broadcast_ << endl;
+  UNI_LOG_DEBUG_INFO << "loops = " << loops_.dims.size() << endl;
   if (CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
       CPU_RUN_MODE == CPURunMode::GEMM_THREAD) {
     UNI_LOG_DEBUG_INFO << "THREAD_NUM = " << THREAD_NUM << endl;
@@ -140,9 +150,9 @@ void Eltwise<DType>::read() {
   data_out_ = GET_CPUTB_DType_PTR(DType, output_);
 
   if ("MUL" == elt_type_) {
-    std::fill_n(data_out_, 1, fmap_o_.num());
+    std::fill_n(data_out_, fmap_o_.num(), DType(1));
   } else {
-    std::fill_n(data_out_, 0, fmap_o_.num());
+    std::fill_n(data_out_, fmap_o_.num(), DType(0));
   }
 }
 
@@ -154,64 +164,51 @@ uint64_t Eltwise<DType>::get_workload() {
 template <typename DType>
 void Eltwise<DType>::eltwise(std::uint32_t start_index,
                              std::uint32_t end_index) {
-  auto dst_coord = fmap_o_.pos2coord(0);
-  auto src_coord = dst_coord;
-  for (auto pos_iter = start_index; pos_iter < end_index; ++pos_iter) {
-    for (auto input_iter = 0; input_iter < input_num_; input_iter++) {
-      auto pos = pos_iter;
-      if (broadcast_) {
-        fmap_o_.pos2coord(pos_iter, dst_coord);
-        for (auto dim_iter = 0U; dim_iter < src_coord.size(); dim_iter++) {
-          src_coord[dim_iter] =
-              dst_coord[dim_iter] % fmap_i_[input_iter][dim_iter];
-        }
-        pos = fmap_i_[input_iter].coord2pos(src_coord);
-      }
-      if ("MUL" == elt_type_) {
-        if (shift) {
-          data_out_[pos_iter] *= floor(data_in_[input_iter][pos] *
-                                       pow(2, shift_factor_[input_iter])) /
-                                 pow(2, shift_factor_[input_iter]);
-        } else {
-          data_out_[pos_iter] *= data_in_[input_iter][pos];
-        }
-      } else if ("ADD" == elt_type_) {
-        if (shift) {
-          data_out_[pos_iter] += floor(data_in_[input_iter][pos] *
-                                       pow(2, shift_factor_[input_iter])) /
-                                 pow(2, shift_factor_[input_iter]);
-        } else {
-          data_out_[pos_iter] += data_in_[input_iter][pos];
-        }
-      }
-    }
+  auto mul = "MUL" == elt_type_;
+  if (!mul && "ADD" != elt_type_) {
+    return;
   }
+  for_each_run(
+      loops_, start_index, end_index,
+      [&](int64_t pos, const int64_t* in_pos, const int64_t* in_step,
+          int64_t len) {
+        for (auto input_iter = 0; input_iter < input_num_; input_iter++) {
+          const auto* in = data_in_[input_iter] + in_pos[input_iter];
+          auto step = in_step[input_iter];
+          if (shift) {
+            auto scale = pow(2, shift_factor_[input_iter]);
+            auto fix = [scale](DType x) { return floor(x * scale) / scale; };
+            if (mul) {
+              accumulate_run(data_out_ + pos, in, step, len,
+                             [&](DType o, DType x) { return o * fix(x); });
+            } else {
+              accumulate_run(data_out_ + pos, in, step, len,
+                             [&](DType o, DType x) { return o + fix(x); });
+            }
+          } else if (mul) {
+            accumulate_run(data_out_ + pos, in, step, len,
+                           [](DType o, DType x) { return o * x; });
+          } else {
+            accumulate_run(data_out_ + pos, in, step, len,
+                           [](DType o, DType x) { return o + x; });
+          }
+        }
+      });
 }
 
 template <typename DType>
 void Eltwise<DType>::eltwise_normal() {
   eltwise(0, fmap_o_.num());
+  run_fused(data_out_, 0, fmap_o_.num());
 }
 
 template <typename DType>
 void Eltwise<DType>::eltwise_thread() {
-  vector<std::future<void>> fut(THREAD_NUM);
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; ++thread_id) {
-    auto start_index = thread_id * THREAD_WORKLOAD;
-    auto FMAP_SIZE = fmap_o_.num();
-    auto end_index =
-        std::min<uint32_t>(FMAP_SIZE, start_index + THREAD_WORKLOAD);
-    fut[thread_id] = std::async(std::launch::async,
-                                [this](decltype(start_index) start_index,
-                                       decltype(end_index) end_index) {
-                                  eltwise(start_index, end_index);
-                                },
-                                start_index, end_index);
-  }
-
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; thread_id++) {
-    fut[thread_id].wait();
-  }
+  parallel_for_elementwise(fmap_o_.num(),
+                           [this](int64_t start_index, int64_t end_index) {
+                             eltwise(start_index, end_index);
+                             run_fused(data_out_, start_index, end_index);
+                           });
 }
 
 INSTANTIATE_TPCLASS(Eltwise);
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "broadcast.hpp"
 #include "cpu_op_base.hpp"
 
 namespace vart {
@@ -38,6 +39,11 @@ class Eltwise : public CPUOPBase {
 
   virtual void run() override;
 
+  // eltwise_normal() and eltwise_thread() run the fused ops
+  virtual bool can_fuse_pointwise() const override {
+    return std::is_floating_point<DType>::value;
+  }
+
   virtual void print_param() override;
   virtual void check_param() override;
 
@@ -56,6 +62,7 @@ class Eltwise : public CPUOPBase {
   std::string elt_type_;
   int input_num_;
   bool broadcast_;
+  Broadcast loops_;
 
   // caculate buffer
   vector<DType*> data_in_;
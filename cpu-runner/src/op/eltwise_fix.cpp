@@ -16,6 +16,7 @@
  */
 
 #include "eltwise_fix.hpp"
+
 #include <array>
 
 namespace vart {
@@ -129,6 +130,38 @@ T DPURoundEven(double data, T data_min = std::numeric_limits<T>::lowest(),
   return rlt;
 }
 
+// out = round(op(a * mul[0] >> rs[0], b * mul[1] >> rs[1]) / 2^shift),
+// see EltwiseFix::fused_t
+template <typename Acc, FixRound R, typename T>
+void fix_binary(const std::string& op, const Broadcast& bc, const T* a,
+                const T* b, T* c, int64_t begin, int64_t end,
+                const std::int64_t* mul, const int* rs, int shift,
+                std::int32_t lo, std::int32_t hi) {
+  auto ma = Acc(mul[0]);
+  auto mb = Acc(mul[1]);
+  auto ra = rs[0];
+  auto rb = rs[1];
+  auto l = Acc(lo);
+  auto h = Acc(hi);
+  auto run = [&](auto f) {
+    broadcast_binary(bc, a, b, c, begin, end, [=](T x, T y) {
+      return static_cast<T>(
+          fix_shift<R>(f(Acc(x) * ma >> ra, Acc(y) * mb >> rb), shift, l, h));
+    });
+  };
+  if (op == "ADD") {
+    run([](Acc u, Acc v) { return u + v; });
+  } else if (op == "SUB") {
+    run([](Acc u, Acc v) { return u - v; });
+  } else if (op == "MUL") {
+    run([](Acc u, Acc v) { return u * v; });
+  } else if (op == "MAX") {
+    run([](Acc u, Acc v) { return std::max(u, v); });
+  } else if (op == "MIN") {
+    run([](Acc u, Acc v) { return std::min(u, v); });
+  }
+}
+
 int8_t gelu_lut(int8_t x) {
   // Generated from PyTorch. Ref:
   // https://gist.gitenterprise.xilinx.com/ZIJIANGY/691ec391e0fb9a3726057dc6308cdd96
@@ -320,6 +353,7 @@ EltwiseFix<DType>::EltwiseFix(const xir::Subgraph* subg, const xir::Op* op,
       shift_write_ = fp_min - hsigmoid_in_;
     }
   }
+  init_fused();
 }
 
 template <typename DType>
@@ -354,10 +388,13 @@ void EltwiseFix<DType>::print_param() {
   if (nonlinear_type_ == 3) {
     UNI_LOG_DEBUG_INFO << "leakyrelu_alpha: " << prelu_alpha_ << endl;
   }
+  UNI_LOG_DEBUG_INFO << "fused = " << !fused_.op.empty() << endl;
 }
 
 template <typename DType>
 void EltwiseFix<DType>::run() {
+  ElementwiseProfile profile(CPUOPBase::get_name(), loops_,
+                             vector<size_t>(input_num_ + 1, sizeof(DType)));
   if (elt_type_ == "L2NORM") {
     calculate_pow();
   }
@@ -412,26 +449,85 @@ void EltwiseFix<DType>::calculate_pow() {
 
 template <typename DType>
 uint32_t EltwiseFix<DType>::broadcast_pos(uint32_t pos_iter, int input_iter) {
-  auto get_sub_coord = [](coord_t coord, int start) {
-    return coord_t(coord.begin() + start, coord.end());
-  };
-  auto pos = pos_iter;
-  auto dst_coord = fmap_o_.pos2coord(0);
-  auto src_coord = dst_coord;
-  if (broadcast_) {
-    fmap_o_.pos2coord(pos_iter, dst_coord);
-    int delta = 0;
-    for (auto dim_iter = 0U; dim_iter < dst_coord.size(); dim_iter++) {
-      if (fmap_i_[input_iter].ndims() < int(dst_coord.size())) {
-        delta = dst_coord.size() - fmap_i_[input_iter].ndims();
-      }
-      if (int(dim_iter) >= delta)
-        src_coord[dim_iter] =
-            dst_coord[dim_iter] % fmap_i_[input_iter][dim_iter - delta];
+  return broadcast_ ? loops_.input_pos(input_iter, pos_iter) : pos_iter;
+}
+
+template <typename DType>
+void EltwiseFix<DType>::init_fused() {
+  auto is_op = elt_type_ == "ADD" || elt_type_ == "SUB" ||
+               elt_type_ == "MUL" || elt_type_ == "MAX" || elt_type_ == "MIN";
+  auto is_nonlinear = nonlinear_type_ == NONLINEAR_NONE ||
+                      nonlinear_type_ == NONLINEAR_RELU ||
+                      nonlinear_type_ == NONLINEAR_RELU6;
+  if (!std::is_integral<DType>::value || input_num_ != 2 || !is_op ||
+      !is_nonlinear) {
+    return;
+  }
+  if (output_round_ == "DPU_ROUND") {
+    fused_.round =
+        (ENV_PARAM(ORT_ROUNDING_MODE) || ENV_PARAM(ORT_ROUNDING_MODE_EVEN))
+            ? FixRound::HALF_EVEN
+            : FixRound::HALF_UP;
+  } else if (output_round_ == "STD_ROUND" || output_round_ == "PY3_ROUND") {
+    fused_.round = FixRound::HALF_EVEN;
+  } else {
+    return;
+  }
+
+  // eltwise() scales inputs by 2^(7 - shift_read), or 4 / 2^shift_read
+  // for mul, and takes the floor, which is a shift for integers
+  auto mul = elt_type_ == "MUL";
+  double magnitude[2];
+  for (auto i = 0; i < 2; i++) {
+    auto e = (mul ? 2 : 7) - shift_read_[i];
+    if (e > 30 || e < -30) {
+      return;
     }
-    pos = fmap_i_[input_iter].coord2pos(get_sub_coord(src_coord, delta));
+    fused_.mul[i] = std::int64_t(1) << std::max(e, 0);
+    fused_.rs[i] = std::max(-e, 0);
+    auto bit_width = CPUOPBase::xir_op_->get_input_tensor("input", i)
+                         ->get_data_type()
+                         .bit_width;
+    magnitude[i] = std::ldexp(1.0, bit_width + std::max(e, 0));
+  }
+  fused_.shift = shift_write_ + (mul ? 4 : 7);
+  if (fused_.shift < 0 || fused_.shift > 60) {
+    return;
+  }
+  auto bound = (mul ? magnitude[0] * magnitude[1]
+                    : magnitude[0] + magnitude[1]) +
+               std::ldexp(1.0, fused_.shift);
+  if (bound >= std::ldexp(1.0, 62)) {
+    return;
+  }
+  fused_.acc64 = bound >= std::ldexp(1.0, 31);
+
+  fused_.lo = CPUOPBase::data_min_;
+  fused_.hi = CPUOPBase::data_max_;
+  if (nonlinear_type_ != NONLINEAR_NONE) {
+    fused_.lo = std::max(fused_.lo, 0);
+  }
+  if (nonlinear_type_ == NONLINEAR_RELU6 && fp_output_ <= 4) {
+    fused_.hi = std::min(fused_.hi, 6 << 4);
+  }
+  fused_.op = elt_type_;
+}
+
+template <typename DType>
+void EltwiseFix<DType>::eltwise_fused(std::uint32_t start_index,
+                                      std::uint32_t end_index) {
+  if constexpr (std::is_integral<DType>::value) {
+    auto* a = data_in_[0];
+    auto* b = data_in_[1];
+    auto half_up = fused_.round == FixRound::HALF_UP;
+    auto f = fused_.acc64
+                 ? (half_up ? fix_binary<int64_t, FixRound::HALF_UP, DType>
+                            : fix_binary<int64_t, FixRound::HALF_EVEN, DType>)
+                 : (half_up ? fix_binary<int32_t, FixRound::HALF_UP, DType>
+                            : fix_binary<int32_t, FixRound::HALF_EVEN, DType>);
+    f(fused_.op, loops_, a, b, data_out_, start_index, end_index, fused_.mul,
+      fused_.rs, fused_.shift, fused_.lo, fused_.hi);
   }
-  return pos;
 }
 
 template <typename DType>
@@ -445,6 +541,10 @@ void EltwiseFix<DType>::eltwise(std::uint32_t start_index,
   //   }
   //   fclose(fp_add);
   // }
+  if (!fused_.op.empty()) {
+    eltwise_fused(start_index, end_index);
+    return;
+  }
   auto dst_coord = fmap_o_.pos2coord(0);
   auto src_coord = dst_coord;
   for (auto pos_iter = start_index; pos_iter < end_index; pos_iter++) {
@@ -48,8 +48,27 @@ class EltwiseFix : public Eltwise<DType> {
 
  private:
   uint32_t broadcast_pos(uint32_t, int);
+  void init_fused();
+  void eltwise_fused(std::uint32_t start_index, std::uint32_t end_index);
   EltwiseNonlinearType nonlinear_type_;
 
+  // add, sub, mul, max or min of two inputs with no nonlinear, relu or
+  // relu6, in integers instead of doubles:
+  //   out = round(op(in0 * mul[0] >> rs[0], in1 * mul[1] >> rs[1]) / 2^shift)
+  // saturated to [lo, hi]. `op` is empty if eltwise() computes it per
+  // element, `acc64` if int32 may overflow.
+  struct fused_t {
+    std::string op;
+    bool acc64{false};
+    FixRound round{FixRound::HALF_UP};
+    std::int64_t mul[2]{1, 1};
+    int rs[2]{0, 0};
+    int shift{0};
+    std::int32_t lo{0};
+    std::int32_t hi{0};
+  };
+  fused_t fused_;
+
   vector<int> fp_inputs_;
   int fp_output_;
   std::string output_round_;
@@ -76,6 +95,7 @@ class EltwiseFix : public Eltwise<DType> {
   std::vector<int32_t> axis_;
 
   using Eltwise<DType>::broadcast_;
+  using Eltwise<DType>::loops_;
   using Eltwise<DType>::fmap_i_;
   using Eltwise<DType>::fmap_o_;
   using Eltwise<DType>::input_num_;
@@ -17,6 +17,8 @@
 
 #include "fix.hpp"
 
+#include "thread_pool.hpp"
+
 namespace vart {
 namespace cpu {
 
@@ -183,49 +185,35 @@ void Fix<DType, FixType>::float2fix_normal() {
 
 template <typename DType, typename FixType>
 void Fix<DType, FixType>::float2fix_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(std::launch::async,
-                            [this](decltype(i) i) {
-                              auto BASE_POS = i * THREAD_WORKLOAD;
-                              if (round_mode_ == "STD_ROUND") {
-                                for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                  auto pos = BASE_POS + j;
-                                  if (pos >= FMAP_SIZE) break;
-
-                                  float2fix_std_round(pos);
-                                }
-                              } else if (round_mode_ == "DPU_ROUND") {
-                                for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                  auto pos = BASE_POS + j;
-                                  if (pos >= FMAP_SIZE) break;
-
-                                  float2fix_dpu_round(pos);
-                                }
-                              } else if (round_mode_ == "PY3_ROUND") {
-                                for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                  auto pos = BASE_POS + j;
-                                  if (pos >= FMAP_SIZE) break;
-
-                                  float2fix_py3_round(pos);
-                                }
-                              } else {
-                                UNI_LOG_ERROR(VART_NOT_SUPPORT)
-                                    << "Not supported round mode "
-                                    << round_mode_ << endl;
-                                abort();
-                              }
-
-                              return 0;
-                            },
-                            i);
-  }
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+  parallel_for(THREAD_NUM, [this](uint32_t i) {
+    auto BASE_POS = i * THREAD_WORKLOAD;
+    if (round_mode_ == "STD_ROUND") {
+      for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+        auto pos = BASE_POS + j;
+        if (pos >= FMAP_SIZE) break;
+
+        float2fix_std_round(pos);
+      }
+    } else if (round_mode_ == "DPU_ROUND") {
+      for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+        auto pos = BASE_POS + j;
+        if (pos >= FMAP_SIZE) break;
+
+        float2fix_dpu_round(pos);
+      }
+    } else if (round_mode_ == "PY3_ROUND") {
+      for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+        auto pos = BASE_POS + j;
+        if (pos >= FMAP_SIZE) break;
+
+        float2fix_py3_round(pos);
+      }
+    } else {
+      UNI_LOG_ERROR(VART_NOT_SUPPORT)
+          << "Not supported round mode " << round_mode_ << endl;
+      abort();
+    }
+  });
 }
 
 template <typename DType, typename FixType>
@@ -251,49 +239,35 @@ void Fix<DType, FixType>::fix2float_normal() {
 
 template <typename DType, typename FixType>
 void Fix<DType, FixType>::fix2float_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(std::launch::async,
-                            [this](decltype(i) i) {
-                              auto BASE_POS = i * THREAD_WORKLOAD;
-                              if (round_mode_ == "STD_ROUND") {
-                                for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                  auto pos = BASE_POS + j;
-                                  if (pos >= FMAP_SIZE) break;
-
-                                  fix2float_std_round(pos);
-                                }
-                              } else if (round_mode_ == "DPU_ROUND") {
-                                for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                  auto pos = BASE_POS + j;
-                                  if (pos >= FMAP_SIZE) break;
-
-                                  fix2float_dpu_round(pos);
-                                }
-                              } else if (round_mode_ == "PY3_ROUND") {
-                                for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                  auto pos = BASE_POS + j;
-                                  if (pos >= FMAP_SIZE) break;
-
-                                  fix2float_py3_round(pos);
-                                }
-                              } else {
-                                UNI_LOG_ERROR(VART_NOT_SUPPORT)
-                                    << "Not supported round mode "
-                                    << round_mode_ << endl;
-                                abort();
-                              }
-
-                              return 0;
-                            },
-                            i);
-  }
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+  parallel_for(THREAD_NUM, [this](uint32_t i) {
+    auto BASE_POS = i * THREAD_WORKLOAD;
+    if (round_mode_ == "STD_ROUND") {
+      for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+        auto pos = BASE_POS + j;
+        if (pos >= FMAP_SIZE) break;
+
+        fix2float_std_round(pos);
+      }
+    } else if (round_mode_ == "DPU_ROUND") {
+      for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+        auto pos = BASE_POS + j;
+        if (pos >= FMAP_SIZE) break;
+
+        fix2float_dpu_round(pos);
+      }
+    } else if (round_mode_ == "PY3_ROUND") {
+      for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+        auto pos = BASE_POS + j;
+        if (pos >= FMAP_SIZE) break;
+
+        fix2float_py3_round(pos);
+      }
+    } else {
+      UNI_LOG_ERROR(VART_NOT_SUPPORT)
+          << "Not supported round mode " << round_mode_ << endl;
+      abort();
+    }
+  });
 }
 
 INSTANTIATE_TPCLASS(Fix);
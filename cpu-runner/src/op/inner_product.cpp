@@ -17,6 +17,9 @@
 
 #include "inner_product.hpp"
 
+#include "gemm.hpp"
+#include "weight_cache.hpp"
+
 namespace vart {
 namespace cpu {
 
@@ -115,6 +118,26 @@ void InnerProduct<DType, TmpDType>::read() {
   rlt_ = GET_CPUTB_DType_PTR(DType, output_);
 }
 
+template <typename DType, typename TmpDType>
+void InnerProduct<DType, TmpDType>::prepare() {
+  if constexpr (std::is_same<DType, float>::value ||
+                std::is_same<DType, int32_t>::value) {
+    auto* weights_op = xir_op_->get_input_op(ITName[WEIGHTS], 0);
+    if (!WeightCache::cacheable(xir_subg_, weights_op)) {
+      return;
+    }
+    int k = 1, w = 1;
+    for (unsigned i = axis_; i < in_shape_.size(); i++)
+      k *= in_shape_[i];
+    for (int i : weights_shape_)
+      w *= i;
+    auto* weights =
+        GET_CPUTB_DType_PTR(DType, inputs_.at(ITName[WEIGHTS]).at(0));
+    packed_weights_ = WeightCache::Instance().get_gemm_b(weights_op, weights,
+                                                         w / k, k, 1, k);
+  }
+}
+
 template <typename DType, typename TmpDType>
 uint64_t InnerProduct<DType, TmpDType>::get_workload() {
   // TODO
@@ -132,13 +155,24 @@ void InnerProduct<DType, TmpDType>::inner_product() {
     w *= i;
   int outter = in / k;
   int oc = w / k;
-  for (auto i = 0; i < outter; i++) {
-    for (auto j = 0; j < oc; j++) {
-      auto addr = i * oc + j;
-      for (auto p = 0; p < k; p++) {
-        auto img_addr = i * k + p;
-        auto weights_addr = j * k + p;
-        rlt_[addr] += img_[img_addr] * weights_[weights_addr];
+  if constexpr (std::is_same<DType, float>::value ||
+                std::is_same<DType, int32_t>::value) {
+    // weights are [oc, k]
+    if (packed_weights_) {
+      gemm(img_, *packed_weights_, rlt_, outter);
+    } else {
+      gemm(img_, weights_, rlt_, outter, oc, k, 1, k);
+    }
+  } else {
+    for (auto i = 0; i < outter; i++) {
+      for (auto j = 0; j < oc; j++) {
+        auto addr = i * oc + j;
+        rlt_[addr] = 0;
+        for (auto p = 0; p < k; p++) {
+          auto img_addr = i * k + p;
+          auto weights_addr = j * k + p;
+          rlt_[addr] += img_[img_addr] * weights_[weights_addr];
+        }
       }
     }
   }
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "cpu_op_base.hpp"
+#include "gemm.hpp"
 
 namespace vart {
 namespace cpu {
@@ -57,6 +58,7 @@ public:
   virtual void check_param() override final;
 
   virtual void read() override final;
+  virtual void prepare() override final;
 
   virtual uint64_t get_workload() override final;
 
@@ -82,6 +84,9 @@ private:
   DType* weights_{nullptr};
   DType* bias_{nullptr};
   DType* rlt_{nullptr};
+
+  // weights packed for gemm() by prepare(), shared through WeightCache
+  std::shared_ptr<const GemmPackedB> packed_weights_;
 };
 
 } // namespace cpu
@@ -52,11 +52,19 @@ void LeakyRelu<DType>::print_param() {
 
 template <typename DType>
 void LeakyRelu<DType>::leaky_relu() {
-  copy_n(data_in_ptr_, fmap_o_.num(), data_out_ptr_);
+  if (data_out_ptr_ != data_in_ptr_) {
+    copy_n(data_in_ptr_, fmap_o_.num(), data_out_ptr_);
+  }
+
+  run_pointwise(data_out_ptr_, 0, fmap_o_.num());
+}
 
-  for (auto i = 0; i < fmap_o_.num(); i++) {
-    if (data_out_ptr_[i] < 0) {
-      data_out_ptr_[i] *= alpha_;
+template <typename DType>
+void LeakyRelu<DType>::run_pointwise(void* data, int64_t begin, int64_t end) {
+  auto* ptr = static_cast<DType*>(data);
+  for (auto i = begin; i < end; i++) {
+    if (ptr[i] < 0) {
+      ptr[i] *= alpha_;
     }
   }
 }
@@ -17,6 +17,9 @@
 
 #include "matmul.hpp"
 
+#include "broadcast.hpp"
+#include "weight_cache.hpp"
+
 namespace vart {
 namespace cpu {
 
@@ -60,6 +63,31 @@ Matmul<DType1, DType2, BType>::Matmul(const xir::Subgraph* subg,
 
 template<typename DType1, typename DType2, typename BType>
 void Matmul<DType1, DType2, BType>::run() {
+  if constexpr (std::is_same<DType1, DType2>::value &&
+                (std::is_same<DType1, float>::value ||
+                 std::is_same<DType1, int32_t>::value)) {
+    gemm_batches(data_out_);
+    if (!has_bias_ && !has_fused()) {
+      return;
+    }
+    // bias and the fused ops in one pass
+    auto f = [this](int64_t begin, int64_t end) {
+      if (has_bias_) {
+        for (auto i = begin; i < end; i++) {
+          data_out_[i] += data_bias_[i % N_];
+        }
+      }
+      run_fused(data_out_, begin, end);
+    };
+    if (CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
+        CPU_RUN_MODE == CPURunMode::GEMM_THREAD) {
+      parallel_for_elementwise(fmap_o_.num(), f);
+    } else {
+      f(0, fmap_o_.num());
+    }
+    return;
+  }
+
   for (auto i = 0; i < fmap_o_.num(); i++) {
     auto coord = fmap_o_.pos2coord(i);
 
@@ -85,6 +113,7 @@ void Matmul<DType1, DType2, BType>::run() {
     if (has_bias_) {
       data_out_[i] += data_bias_[i % N_];
     }
+    run_fused(data_out_, i, i + 1);
   }
 }
 
@@ -134,7 +163,7 @@ void Matmul<DType1, DType2, BType>::read() {
     }
   }
 
-  if (transpose_b_) {
+  if (transpose_b_ && !packed_b_) {
     for (auto i = 0; i < batch_b_; i++) {
       auto size_b = K_ * N_;
       auto* pb = data_inb_ + i * size_b;
@@ -153,6 +182,25 @@ void Matmul<DType1, DType2, BType>::read() {
   data_out_ = GET_CPUTB_DType_PTR(DType1, output_);
 }
 
+template<typename DType1, typename DType2, typename BType>
+void Matmul<DType1, DType2, BType>::prepare() {
+  if constexpr (std::is_same<DType1, DType2>::value &&
+                (std::is_same<DType1, float>::value ||
+                 std::is_same<DType1, int32_t>::value)) {
+    if (!has_wts_ || batch_b_ != 1) {
+      return;
+    }
+    auto* weights_op = xir_op_->get_input_op(ITName[WEIGHT], 0);
+    if (!WeightCache::cacheable(xir_subg_, weights_op)) {
+      return;
+    }
+    // the const data, not transposed yet: [N, K] if transpose_b_
+    auto* b = GET_CPUTB_DType_PTR(DType2, inputs_.at(ITName[WEIGHT]).at(0));
+    packed_b_ = WeightCache::Instance().get_gemm_b(
+        weights_op, b, N_, K_, transpose_b_ ? 1 : N_, transpose_b_ ? K_ : 1);
+  }
+}
+
 template<typename DType1, typename DType2, typename BType>
 uint64_t Matmul<DType1, DType2, BType>::get_workload() {
   // uint64_t mkn = 2 * M_ * K_ * N_;
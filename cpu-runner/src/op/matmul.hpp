@@ -18,6 +18,7 @@
 #pragma once
 
 #include "cpu_op_base.hpp"
+#include "gemm.hpp"
 
 namespace vart {
 namespace cpu {
@@ -41,16 +42,27 @@ public:
 
   virtual void run() override;
 
+  // run() applies the fused ops with the bias
+  virtual bool can_fuse_pointwise() const override {
+    return std::is_floating_point<DType1>::value;
+  }
+
   virtual void print_param() override;
   virtual void check_param() override;
 
   virtual void read() override;
+  virtual void prepare() override;
 
   virtual uint64_t get_workload() override;
 
 protected:
   virtual void calc_param();
 
+  // gemm() for every output matrix into `out`, the matrices of a and b
+  // are picked as in run(), with broadcast
+  template <typename OType>
+  void gemm_batches(OType* out);
+
 protected:
   // ia means input matrix a
   // ib means input matrix b
@@ -84,8 +96,41 @@ protected:
   DType2* data_inb_{nullptr};
   BType* data_bias_{nullptr};
   DType1* data_out_{nullptr};
+
+  // const weights packed for gemm() by prepare(), with transpose_b_
+  // already applied
+  std::shared_ptr<const GemmPackedB> packed_b_;
 };
 
+template <typename DType1, typename DType2, typename BType>
+template <typename OType>
+void Matmul<DType1, DType2, BType>::gemm_batches(OType* out) {
+  auto mat_size = M_ * N_;
+  if (mat_size == 0) {
+    return;
+  }
+  for (auto i = 0; i < fmap_o_.num(); i += mat_size) {
+    auto coord = fmap_o_.pos2coord(i);
+    auto coord_a = coord;
+    auto coord_b = coord;
+    for (auto j = 0; j < fmap_o_.ndims() - 2; j++) {
+      if (fmap_ia_[j] == 1) {
+        coord_a[j] = 0;
+      }
+      if (fmap_ib_[j] == 1) {
+        coord_b[j] = 0;
+      }
+    }
+    if (packed_b_) {
+      gemm(data_ina_ + fmap_ia_.coord2pos(coord_a), *packed_b_, out + i, M_);
+    } else {
+      gemm(data_ina_ + fmap_ia_.coord2pos(coord_a),
+           data_inb_ + fmap_ib_.coord2pos(coord_b), out + i, M_, N_, K_, N_,
+           1);
+    }
+  }
+}
+
 } // namespace cpu
 } // namespace vart
 
@@ -100,6 +100,26 @@ MatmulFix<DType1, DType2, BType>::MatmulFix(const xir::Subgraph* subg, const xir
 template <typename DType1, typename DType2, typename BType>
 void MatmulFix<DType1, DType2, BType>::run() {
   UNI_LOG_DEBUG_INFO << "[CPURunner] Run Matmul-fix..." << std::endl;
+  auto scale = [this](int i, float tmp) {
+    tmp /= 1.0 * pow(2, fp_input_a_ + fp_input_b_);
+    if (this->has_bias_) {
+      tmp += this->data_bias_[i % this->N_] * 1.0 / pow(2, fp_bias_);
+    }
+    tmp = xround(tmp * pow(2, fp_output_), round_mode_);
+    this->data_out_[i] = static_cast<DType1>(tmp);
+  };
+
+  if constexpr (std::is_same<DType1, DType2>::value &&
+                (std::is_same<DType1, float>::value ||
+                 std::is_same<DType1, int32_t>::value)) {
+    std::vector<float> acc(this->fmap_o_.num());
+    this->gemm_batches(acc.data());
+    for (auto i = 0; i < this->fmap_o_.num(); i++) {
+      scale(i, acc[i]);
+    }
+    return;
+  }
+
   for (auto i = 0; i < this->fmap_o_.num(); i++) {
     auto coord = this->fmap_o_.pos2coord(i);
 
@@ -122,12 +142,7 @@ void MatmulFix<DType1, DType2, BType>::run() {
     for (auto j = 0; j < this->K_; j++) {
       tmp += this->data_ina_[pos_a + j] * this->data_inb_[pos_b + j * this->N_];
     }
-    tmp /= 1.0 * pow(2, fp_input_a_ + fp_input_b_);
-    if (this->has_bias_) {
-      tmp += this->data_bias_[i % this->N_] * 1.0 / pow(2, fp_bias_);
-    }
-    tmp = xround(tmp * pow(2, fp_output_), round_mode_);
-    this->data_out_[i] = static_cast<DType1>(tmp);
+    scale(i, tmp);
   }
 }
 
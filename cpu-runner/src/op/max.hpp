@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "broadcast.hpp"
 #include "cpu_op_base.hpp"
 
 namespace vart {
@@ -55,6 +56,7 @@ private:
   Dimension fmap_ia_;
   Dimension fmap_ib_;
   Dimension fmap_o_;
+  Broadcast loops_;
 
   // caculate buffer
   DType* data_ia_{nullptr};
@@ -33,10 +33,6 @@ public:
 
 protected:
   void max_pool();
-  void max_pool_normal();
-  void max_pool_thread();
-
-  void max_pool_one(int idx_dst_n, int idx_dst_h, int idx_dst_w);
 
 protected:
   using PoolBase<DType>::pool_type_;
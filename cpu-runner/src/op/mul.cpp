@@ -50,6 +50,8 @@ Mul<DTypeIn0, DTypeIn1, DTypeOut>::Mul(const xir::Subgraph* subg,
   fmap_o_ = xir_tensor_o->get_shape();
 
   mul_align_dim();
+  loops_ = make_broadcast(fmap_o_.vdims(),
+                          {fmap_ia_.vdims(), fmap_ib_.vdims()});
 
   // print param value, used to debug
   print_param();
@@ -57,24 +59,19 @@ Mul<DTypeIn0, DTypeIn1, DTypeOut>::Mul(const xir::Subgraph* subg,
 
 template <typename DTypeIn0, typename DTypeIn1, typename DTypeOut>
 void Mul<DTypeIn0, DTypeIn1, DTypeOut>::run() {
-  for (auto i = 0; i < fmap_o_.num(); i++) {
-    auto coord = fmap_o_.pos2coord(i);
-
-    auto coord_a = coord;
-    auto coord_b = coord;
-    for (auto j = 0; j < fmap_o_.ndims(); j++) {
-      if (fmap_ia_[j] == 1) {
-        coord_a[j] = 0;
-      }
-
-      if (fmap_ib_[j] == 1) {
-        coord_b[j] = 0;
-      }
-    }
-
-    auto pos_a = fmap_ia_.coord2pos(coord_a);
-    auto pos_b = fmap_ib_.coord2pos(coord_b);
-    data_out_[i] = data_ia_[pos_a] * data_ib_[pos_b];
+  ElementwiseProfile profile(
+      get_name(), loops_,
+      {sizeof(DTypeIn0), sizeof(DTypeIn1), sizeof(DTypeOut)});
+  auto f = [this](int64_t start_index, int64_t end_index) {
+    broadcast_binary(loops_, data_ia_, data_ib_, data_out_, start_index,
+                     end_index,
+                     [](DTypeIn0 a, DTypeIn1 b) -> DTypeOut { return a * b; });
+  };
+  if (CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
+      CPU_RUN_MODE == CPURunMode::GEMM_THREAD) {
+    parallel_for_elementwise(fmap_o_.num(), f);
+  } else {
+    f(0, fmap_o_.num());
   }
 }
 
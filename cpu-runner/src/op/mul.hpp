@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "broadcast.hpp"
 #include "cpu_op_base.hpp"
 
 namespace vart {
@@ -54,6 +55,7 @@ class Mul : public CPUOPBase {
   Dimension fmap_ia_;
   Dimension fmap_ib_;
   Dimension fmap_o_;
+  Broadcast loops_;
 
   // caculate buffer
   DTypeIn0* data_ia_{nullptr};
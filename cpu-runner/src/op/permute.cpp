@@ -26,16 +26,9 @@ Permute<DType>::Permute(const xir::Subgraph* subg, const xir::Op* op,
                         IMapTBs_t inputs, CPUTBPtr_t output)
     : CPUOPBase(subg, op, inputs, output) {
   o_shape_ = op->get_output_tensor()->get_shape();
-  for (unsigned i = 0; i < o_shape_.size(); i++) {
-    o_prod_.push_back(std::accumulate(
-      begin(o_shape_) + i, end(o_shape_), 1, std::multiplies<int>()));
-  }
   i_shape_ = op->get_input_ops("input")[0]->get_output_tensor()->get_shape();
-  for (unsigned i = 0; i < i_shape_.size(); i++) {
-    i_prod_.push_back(std::accumulate(
-      begin(i_shape_) + i, end(i_shape_), 1, std::multiplies<int>()));
-  }
   order_ = xir_op_->get_attr<std::vector<std::int32_t>>("order");
+  transpose_ = make_permute(i_shape_, order_);
 }
 
 template <typename DType>
@@ -53,29 +46,9 @@ void Permute<DType>::read() {
 
 template <typename DType>
 void Permute<DType>::permute() {
-  if (i_shape_.size() == 1) {
-    for (auto i = 0; i < o_prod_[0]; i++) {
-      data_out_ptr_[i] = data_in_ptr_[i];
-    }
-    return;
-  }
-  for (auto i = 0; i < i_prod_[0]; i++) {
-    std::vector<int> dims;
-    dims.push_back(i / i_prod_[1]);
-    int left = i;
-    for (unsigned j = 1; j < i_shape_.size(); j++) {
-      left = left - dims[dims.size() - 1] * i_prod_[dims.size()];
-      if (j == i_shape_.size() - 1)
-        dims.push_back(left % i_prod_[j]);
-      else
-        dims.push_back(left / i_prod_[j + 1]);
-    }
-    int out_addr = dims[order_[dims.size() - 1]];
-    for (unsigned d = 0; d < dims.size() - 1; d++) {
-      out_addr += dims[order_[d]] * o_prod_[d + 1];
-    }
-    data_out_ptr_[out_addr] = data_in_ptr_[i];
-  }
+  transpose(transpose_, data_in_ptr_, data_out_ptr_,
+            CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
+                CPU_RUN_MODE == CPURunMode::GEMM_THREAD);
 }
 
 INSTANTIATE_TPCLASS(Permute);
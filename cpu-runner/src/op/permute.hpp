@@ -18,6 +18,7 @@
 #pragma once
 
 #include "cpu_op_base.hpp"
+#include "transpose.hpp"
 
 namespace vart {
 namespace cpu {
@@ -39,10 +40,9 @@ class Permute : public CPUOPBase {
  private:
   std::vector<std::int32_t> i_shape_;
   std::vector<std::int32_t> o_shape_;
-  std::vector<int> i_prod_;
-  std::vector<int> o_prod_;
 
   vector<std::int32_t> order_;
+  Transpose transpose_;
 
   DType* data_in_ptr_{nullptr};
   DType* data_out_ptr_{nullptr};
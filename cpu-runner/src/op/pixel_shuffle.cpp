@@ -29,6 +29,7 @@ PixelShuffle<DType>::PixelShuffle(const xir::Subgraph* subg, const xir::Op* op,
   output_shape_ = op->get_output_tensor()->get_shape();
   upscale_ = xir_op_->get_attr<bool>("upscale");
   scale_ = xir_op_->get_attr<int>("scale");
+  transpose_ = make_pixel_shuffle(input_shape_, scale_, upscale_);
 
   print_param();
 }
@@ -62,33 +63,9 @@ uint64_t PixelShuffle<DType>::get_workload() {
 
 template <typename DType>
 void PixelShuffle<DType>::shuffle() {
-  if (upscale_) {
-    int idx = 0;
-    for (auto b = 0; b < output_shape_[0]; b++)
-      for (auto h = 0; h < output_shape_[1]; h++)
-        for (auto w = 0; w < output_shape_[2]; w++)
-          for (auto c = 0; c < output_shape_[3]; c++) {
-            auto i_index =
-                b * input_shape_[1] * input_shape_[2] * input_shape_[3] +
-                h / scale_ * input_shape_[2] * input_shape_[3] +
-                w / scale_ * input_shape_[3] + c * scale_ * scale_ +
-                w % scale_ + h % scale_ * scale_;
-            data_out_[idx++] = data_in_[i_index];
-          }
-  } else {
-    int idx = 0;
-    for (auto b = 0; b < input_shape_[0]; b++)
-      for (auto h = 0; h < input_shape_[1]; h++)
-        for (auto w = 0; w < input_shape_[2]; w++)
-          for (auto c = 0; c < input_shape_[3]; c++) {
-            auto i_index =
-                b * output_shape_[1] * output_shape_[2] * output_shape_[3] +
-                h / scale_ * output_shape_[2] * output_shape_[3] +
-                w / scale_ * output_shape_[3] + c * scale_ * scale_ +
-                w % scale_ + h % scale_ * scale_;
-            data_out_[i_index] = data_in_[idx++];
-          }
-  }
+  transpose(transpose_, data_in_, data_out_,
+            CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
+                CPU_RUN_MODE == CPURunMode::GEMM_THREAD);
 }
 
 INSTANTIATE_TPCLASS(PixelShuffle);
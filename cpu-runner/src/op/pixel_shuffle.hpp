@@ -18,6 +18,7 @@
 #pragma once
 
 #include "cpu_op_base.hpp"
+#include "transpose.hpp"
 
 namespace vart {
 namespace cpu {
@@ -46,6 +47,7 @@ class PixelShuffle : public CPUOPBase {
   std::vector<int> output_shape_;
   bool upscale_;
   int scale_;
+  Transpose transpose_;
 
   DType* data_in_{nullptr};
   DType* data_out_{nullptr};
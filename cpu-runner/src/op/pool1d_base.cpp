@@ -18,6 +18,7 @@
 #include "pool1d_base.hpp"
 #include "align_buf_mgr.hpp"
 #include "fast_pad.hpp"
+#include "thread_pool.hpp"
 
 namespace vart {
 namespace cpu {
@@ -235,30 +236,17 @@ void MaxPool1d<DType>::max_pool_normal() {
 
 template <typename DType>
 void MaxPool1d<DType>::max_pool_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(std::launch::async,
-                            [this](decltype(i) i) {
-                              auto BASE_POS = i * THREAD_WORKLOAD;
-                              for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                auto pos = BASE_POS + j;
-                                if (pos % fmap_o_.c != 0) continue;
-                                if (pos >= FMAP_SIZE) break;
-
-                                auto fmap = fmap_o_.pos2coord(pos);
-                                max_pool_one(fmap.n, fmap.h, fmap.w);
-                              }
-
-                              return 0;
-                            },
-                            i);
-  }
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+  parallel_for(THREAD_NUM, [this](uint32_t i) {
+    auto BASE_POS = i * THREAD_WORKLOAD;
+    for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+      auto pos = BASE_POS + j;
+      if (pos % fmap_o_.c != 0) continue;
+      if (pos >= FMAP_SIZE) break;
+
+      auto fmap = fmap_o_.pos2coord(pos);
+      max_pool_one(fmap.n, fmap.h, fmap.w);
+    }
+  });
 }
 
 template <typename DType>
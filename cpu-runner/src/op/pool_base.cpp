@@ -187,6 +187,12 @@ void PoolBase<DType>::read() {
     .transform<DType>(tb_input_ptr, data_in_ptr_, pad_value_);
 }
 
+template <typename DType>
+Pool PoolBase<DType>::pool_shape() const {
+  return Pool{fmap_i_.n, fmap_i_.h, fmap_i_.w, fmap_i_.c, fmap_o_.h,
+              fmap_o_.w, kernel_.h, kernel_.w, stride_.h, stride_.w};
+}
+
 template <typename DType>
 uint64_t PoolBase<DType>::get_workload() {
   // not consider batch
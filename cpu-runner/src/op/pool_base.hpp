@@ -18,6 +18,7 @@
 #pragma once
 
 #include "cpu_op_base.hpp"
+#include "pool.hpp"
 
 namespace vart {
 namespace cpu {
@@ -50,6 +51,10 @@ public:
 
   virtual uint64_t get_workload() override final;
 
+protected:
+  // the shape max_pool() and sum_pool() see data_in_ptr_ as
+  Pool pool_shape() const;
+
 protected:
   int pool_type_;
 
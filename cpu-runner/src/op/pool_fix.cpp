@@ -18,6 +18,7 @@
 #include "pool_fix.hpp"
 
 #include "pair_hash.hpp"
+#include "thread_pool.hpp"
 
 namespace {
 struct ApproximateParam {
@@ -103,6 +104,7 @@ PoolFix<DType>::PoolFix(const xir::Subgraph* subg, const xir::Op* op,
   fp_output_ = xir_tensor_o->get_attr<int>("fix_point");
   shift_pool_ = fp_output_ - fp_input_;
   pow_shift_ = pow(2.0, shift_pool_);
+  avg_coefficient_ = get_avgpool_dpu_coefficient({kernel_.h, kernel_.w});
 }
 
 template <typename DType>
@@ -161,29 +163,16 @@ void PoolFix<DType>::max_pool_fix_normal() {
 
 template <typename DType>
 void PoolFix<DType>::max_pool_fix_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(std::launch::async,
-                            [this](decltype(i) i) {
-                              auto BASE_POS = i * THREAD_WORKLOAD;
-                              for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                auto pos = BASE_POS + j;
-                                if (pos >= FMAP_SIZE) break;
-                                data_out_ptr_[pos] = round_normal<DType>(
-                                    CPUOPBase::round_mode_,
-                                    data_out_ptr_[pos] * pow_shift_,
-                                    CPUOPBase::data_min_, CPUOPBase::data_max_);
-                              }
-                              return 0;
-                            },
-                            i);
-  }
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+  parallel_for(THREAD_NUM, [this](uint32_t i) {
+    auto BASE_POS = i * THREAD_WORKLOAD;
+    for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+      auto pos = BASE_POS + j;
+      if (pos >= FMAP_SIZE) break;
+      data_out_ptr_[pos] = round_normal<DType>(
+          CPUOPBase::round_mode_, data_out_ptr_[pos] * pow_shift_,
+          CPUOPBase::data_min_, CPUOPBase::data_max_);
+    }
+  });
 }
 
 template <typename DType>
@@ -205,36 +194,22 @@ void PoolFix<DType>::avg_pool_fix_normal() {
 
 template <typename DType>
 void PoolFix<DType>::avg_pool_fix_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(std::launch::async,
-                            [this](decltype(i) i) {
-                              auto BASE_POS = i * THREAD_WORKLOAD;
-                              for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                auto pos = BASE_POS + j;
-                                if (pos >= FMAP_SIZE) break;
-
-                                avg_pool_fix_one(pos);
-                              }
-
-                              return 0;
-                            },
-                            i);
-  }
+  parallel_for(THREAD_NUM, [this](uint32_t i) {
+    auto BASE_POS = i * THREAD_WORKLOAD;
+    for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+      auto pos = BASE_POS + j;
+      if (pos >= FMAP_SIZE) break;
 
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+      avg_pool_fix_one(pos);
+    }
+  });
 }
 
 template <typename DType>
 void PoolFix<DType>::avg_pool_fix_one(int i) {
   auto tmp = 0.f;
 
-  tmp = (float)data_out_ptr_[i] *
-        get_avgpool_dpu_coefficient({kernel_.h, kernel_.w});
+  tmp = (float)data_out_ptr_[i] * avg_coefficient_;
 
   data_out_ptr_[i] = round_normal<DType>(CPUOPBase::round_mode_, tmp * pow_shift_, CPUOPBase::data_min_,
                               CPUOPBase::data_max_);
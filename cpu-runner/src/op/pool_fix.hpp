@@ -51,6 +51,8 @@ protected:
   std::string output_round_;
   int shift_pool_;
   float pow_shift_;
+  // get_avgpool_dpu_coefficient() of the kernel
+  float avg_coefficient_;
 
   using PoolBase<DType>::pool_type_;
   using PoolBase<DType>::raw_fmap_i_;
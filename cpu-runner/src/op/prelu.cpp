@@ -32,6 +32,9 @@ PRelu<DType>::PRelu(const xir::Subgraph* subg, const xir::Op* op,
                     IMapTBs_t inputs, CPUTBPtr_t output)
     : ReluBase<DType>(subg, op, inputs, output) {
   GET_INPUT_DIMX_FMAP(fmap_alpha_, weight, 3);
+  // alpha is per channel, the innermost dim
+  loops_ = make_broadcast(fmap_o_.vdims(),
+                          {fmap_i_.vdims(), {(int)fmap_alpha_.num()}});
 }
 
 template <typename DType>
@@ -79,14 +82,18 @@ void PRelu<DType>::read() {
 
 template <typename DType>
 void PRelu<DType>::prelu() {
-  auto N = fmap_alpha_.num();
-
-  copy_n(data_in_ptr_, fmap_o_.num(), data_out_ptr_);
-
-  for (auto i = 0; i < fmap_o_.num(); i++) {
-    if (data_out_ptr_[i] < 0) {
-      data_out_ptr_[i] *= alpha_[i % N];
-    }
+  ElementwiseProfile profile(this->get_name(), loops_,
+                             {sizeof(DType), sizeof(DType), sizeof(DType)});
+  auto f = [this](int64_t start_index, int64_t end_index) {
+    broadcast_binary(loops_, data_in_ptr_, alpha_, data_out_ptr_, start_index,
+                     end_index,
+                     [](DType x, DType a) { return x < 0 ? x * a : x; });
+  };
+  if (CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
+      CPU_RUN_MODE == CPURunMode::GEMM_THREAD) {
+    parallel_for_elementwise(fmap_o_.num(), f);
+  } else {
+    f(0, fmap_o_.num());
   }
 }
 
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "broadcast.hpp"
 #include "relu_base.hpp"
 
 namespace vart {
@@ -49,6 +50,7 @@ private:
 
 private:
   Dimension fmap_alpha_;
+  Broadcast loops_;
 
   DType* alpha_{nullptr};
 
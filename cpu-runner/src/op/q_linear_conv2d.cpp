@@ -21,7 +21,12 @@
 #include <thread>
 #include <vector>
 
+#include "align_buf_mgr.hpp"
+#include "conv_2_gemm.hpp"
 #include "fast_pad.hpp"
+#include "requantize.hpp"
+#include "thread_pool.hpp"
+#include "weight_cache.hpp"
 
 namespace vart {
 namespace cpu {
@@ -60,6 +65,9 @@ int32_t float_to_int32(float value) {
   return result;
 }
 
+int64_t calculate_matmul_shift(const int& a_bit_width, const int& w_bit_width,
+                               int64_t K);
+
 // constructor and deconstructor
 template <typename DType, typename WType>
 QLinearConv2d<DType, WType>::QLinearConv2d(const xir::Subgraph* subg,
@@ -97,7 +105,22 @@ QLinearConv2d<DType, WType>::QLinearConv2d(const xir::Subgraph* subg,
     UNI_LOG_FATAL(VART_NOT_SUPPORT)
         << "Unsupported nonlinear type: " << nonlinear_type_str << ".";
   }
-  tmp_data_out_ = std::vector<int64_t>(fmap_o_.num());
+  auto a_bit_width =
+      xir_op_->get_input_tensor(ITName[ConvBase<DType, WType>::INPUT])
+          ->get_data_type()
+          .bit_width;
+  auto w_bit_width =
+      xir_op_->get_input_tensor(ITName[ConvBase<DType, WType>::WEIGHTS])
+          ->get_data_type()
+          .bit_width;
+  shift_matmul_ = calculate_matmul_shift(a_bit_width, w_bit_width,
+                                         fmap_w_.num() / channel_);
+  use_gemm_ = std::is_same<DType, int32_t>::value &&
+              std::is_same<WType, int32_t>::value && group_ == 1 &&
+              shift_matmul_ == 0;
+  if (!use_gemm_) {
+    tmp_data_out_ = std::vector<int64_t>(fmap_o_.num());
+  }
 
   THREAD_NUM = CPU_NUM;
   THREAD_WORKLOAD = ceil((float)fmap_o_.num() / THREAD_NUM);
@@ -146,7 +169,11 @@ void QLinearConv2d<DType, WType>::run() {
       .transform<DType>(tb_input_ptr, data_in_ptr_, zp_input_);
 
   // calc conv
-  this->qlinearconv2d_conv();
+  if (use_gemm_) {
+    this->qlinearconv2d_gemm();
+  } else {
+    this->qlinearconv2d_conv();
+  }
 
   // do fix
   this->fix();
@@ -155,6 +182,31 @@ void QLinearConv2d<DType, WType>::run() {
   // this->save();
 }
 
+template <typename DType, typename WType>
+void QLinearConv2d<DType, WType>::prepare() {
+  auto* weights_op =
+      xir_op_->get_input_op(ITName[ConvBase<DType, WType>::WEIGHTS], 0);
+  auto* bias_op =
+      has_bias_ ? xir_op_->get_input_op(ITName[ConvBase<DType, WType>::BIAS], 0)
+                : nullptr;
+  if (!WeightCache::cacheable(xir_subg_, weights_op) ||
+      (has_bias_ && !WeightCache::cacheable(xir_subg_, bias_op))) {
+    return;
+  }
+  this->read_weights();
+  this->read_bias();
+  calculate_coeffs();
+  coeffs_ready_ = true;
+  if constexpr (std::is_same<DType, int32_t>::value &&
+                std::is_same<WType, int32_t>::value) {
+    if (use_gemm_) {
+      auto k = fmap_w_.h * fmap_w_.w * fmap_w_.c;
+      packed_weights_ = WeightCache::Instance().get_gemm_b(
+          weights_op, weights_ptr_, fmap_o_.c, k, 1, k);
+    }
+  }
+}
+
 template <typename DType, typename WType>
 std::vector<int32_t> QLinearConv2d<DType, WType>::calculate_ifm() {
   std::vector<int32_t> ifm(fmap_o_.num() / fmap_o_.c, 0);
@@ -217,30 +269,17 @@ int64_t calculate_matmul_shift(const int& a_bit_width, const int& w_bit_width,
 
 template <typename DType, typename WType>
 void QLinearConv2d<DType, WType>::qlinearconv2d_conv() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i] = std::async(
-        std::launch::async,
-        [this](decltype(i) i) {
-          auto BASE_POS = i * THREAD_WORKLOAD;
-          auto FMAP_SIZE = fmap_o_.num();
-          for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-            int pos = BASE_POS + j;
-            if (pos >= FMAP_SIZE) break;
-            auto fmap = fmap_o_.pos2coord(pos);
-            qlinearconv2d_conv_one(data_in_ptr_, weights_ptr_, fmap.n, fmap.h,
-                                   fmap.w, fmap.c, 0, fmap_i_.c);
-          }
-
-          return 0;
-        },
-        i);
-  }
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+  parallel_for(THREAD_NUM, [this](uint32_t i) {
+    auto BASE_POS = i * THREAD_WORKLOAD;
+    auto FMAP_SIZE = fmap_o_.num();
+    for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+      int pos = BASE_POS + j;
+      if (pos >= FMAP_SIZE) break;
+      auto fmap = fmap_o_.pos2coord(pos);
+      qlinearconv2d_conv_one(data_in_ptr_, weights_ptr_, fmap.n, fmap.h,
+                             fmap.w, fmap.c, 0, fmap_i_.c);
+    }
+  });
   // for (auto n = 0; n < fmap_o_.n; n++) {
   //   for (auto h = 0; h < fmap_o_.h; h++) {
   //     for (auto w = 0; w < fmap_o_.w; w++) {
@@ -252,6 +291,52 @@ void QLinearConv2d<DType, WType>::qlinearconv2d_conv() {
   //   }
   // }
 }
+// the same sums as qlinearconv2d_conv(), in int32, which is where fix()
+// takes them from anyway without a matmul shift
+template <typename DType, typename WType>
+void QLinearConv2d<DType, WType>::qlinearconv2d_gemm() {
+  if constexpr (std::is_same<DType, int32_t>::value &&
+                std::is_same<WType, int32_t>::value) {
+    auto M = fmap_o_.n * fmap_o_.h * fmap_o_.w;
+    auto K = fmap_w_.h * fmap_w_.w * fmap_w_.c;
+    // a 1x1 kernel over every pixel reads the padded input as it is
+    auto pointwise = kernel_.h == 1 && kernel_.w == 1 &&
+                     fmap_i_.h == fmap_o_.h && fmap_i_.w == fmap_o_.w;
+    DType* tmp_ptr = data_in_ptr_;
+    if (!pointwise) {
+      FMap_t tmp_fmap{fmap_o_.n, fmap_o_.h, fmap_o_.w, K};
+      tmp_ptr = reinterpret_cast<DType*>(AlignBufMgr::Instance()->allocate(
+          tmp_fmap.num() * sizeof(DType), ALIGN_SIZE));
+      Conv2Gemm(fmap_i_, tmp_fmap, fmap_w_, kernel_, stride_)
+          .transform_thread(data_in_ptr_, tmp_ptr);
+    }
+    if (packed_weights_) {
+      gemm(tmp_ptr, *packed_weights_, data_out_ptr_, M);
+    } else {
+      gemm(tmp_ptr, weights_ptr_, data_out_ptr_, M, fmap_o_.c, K, 1, K);
+    }
+    // the rows of A are the input windows
+    if (zp_weights_ != 0) {
+      ifm_.resize(M);
+      parallel_for_range(
+          M,
+          [&](int64_t begin, int64_t end) {
+            for (auto p = begin; p < end; ++p) {
+              int32_t sum = 0;
+              for (auto k = 0; k < K; ++k) {
+                sum += tmp_ptr[p * K + k];
+              }
+              ifm_[p] = sum;
+            }
+          },
+          Schedule::STATIC);
+    }
+    if (!pointwise) {
+      AlignBufMgr::Instance()->release(tmp_ptr);
+    }
+  }
+}
+
 template <typename DType, typename WType>
 void QLinearConv2d<DType, WType>::qlinearconv2d_conv_one(
     DType* src, WType* wts, int idx_dst_n, int idx_dst_h, int idx_dst_w,
@@ -284,7 +369,7 @@ void QLinearConv2d<DType, WType>::qlinearconv2d_conv_one(
   }
 }
 template <typename DType, typename WType>
-void QLinearConv2d<DType, WType>::fix() {
+void QLinearConv2d<DType, WType>::calculate_coeffs() {
   // xcompiler
   int64_t za = zp_input_;
   int64_t zw = zp_weights_;
@@ -305,16 +390,7 @@ void QLinearConv2d<DType, WType>::fix() {
     cf2 = cf2 >> 1;
     shift_out = shift_out - 1;
   }
-  auto a_bit_width =
-      xir_op_->get_input_tensor(ITName[ConvBase<DType, WType>::INPUT])
-          ->get_data_type()
-          .bit_width;
-  auto w_bit_width =
-      xir_op_->get_input_tensor(ITName[ConvBase<DType, WType>::WEIGHTS])
-          ->get_data_type()
-          .bit_width;
-  auto shift_matmul = calculate_matmul_shift(a_bit_width, w_bit_width, K);
-  cf2 = cf2 << shift_matmul;
+  cf2 = cf2 << shift_matmul_;
 
   // use cf2
   int64_t cf4 = (cf2 * prelu_in_) * pow(2, -prelu_shift_);
@@ -333,31 +409,92 @@ void QLinearConv2d<DType, WType>::fix() {
   UNI_LOG_DEBUG_INFO << "f_cf2 " << f_cf2 << " cf2 " << cf2;
   UNI_LOG_DEBUG_INFO << "cf1 " << cf1;
   UNI_LOG_DEBUG_INFO << "cf0 " << cf0;
-  UNI_LOG_DEBUG_INFO << "shift_matmul " << shift_matmul;
+  UNI_LOG_DEBUG_INFO << "shift_matmul " << shift_matmul_;
   UNI_LOG_DEBUG_INFO << "shift_out " << shift_out;
-  // std::ofstream("int64.bin",
-  // std::ios::binary).write(reinterpret_cast<char*>(tmp_data_out_),
-  // fmap_o_.num() * sizeof(int64_t));
+
+  cf1_ = cf1;
+  cf2_ = cf2;
+  cf4_ = cf4;
+  zo_ = zo;
+  shift_out_ = shift_out;
+  cf0_ = std::move(cf0);
+  cf3_ = std::move(cf3);
+}
+
+template <typename DType, typename WType>
+void QLinearConv2d<DType, WType>::fix() {
+  if (!coeffs_ready_) {
+    calculate_coeffs();
+  }
+  int64_t zw = zp_weights_;
+  auto& ch = channel_;
+  // with zw 0 the input sums are multiplied by 0
+  if (!use_gemm_ && zw != 0) {
+    ifm_ = calculate_ifm();
+  }
+
+  if constexpr (std::is_same<DType, int32_t>::value) {
+    if (!use_gemm_) {
+      for (auto i = 0; i < fmap_o_.num(); i++) {
+        data_out_ptr_[i] = tmp_data_out_[i];
+        if (shift_matmul_) {
+          data_out_ptr_[i] =
+              round_even(tmp_data_out_[i], shift_matmul_, INT32_MAX, INT32_MIN);
+        }
+      }
+    }
+    // the same as the loop below, all pixels of a channel at once
+    if ((nonlinear_type_ == 0 || nonlinear_type_ == 1) && shift_out_ >= 1) {
+      std::vector<int64_t> cf0(ch);
+      for (auto i = 0; i < ch; i++) {
+        cf0[i] = cf0_[i] - zo_;
+      }
+      std::vector<int64_t> cf1_ifm;
+      if (zw != 0) {
+        cf1_ifm.resize(ifm_.size());
+        for (auto p = 0u; p < ifm_.size(); p++) {
+          cf1_ifm[p] = cf1_ * ifm_[p];
+        }
+      }
+      Requantize q;
+      q.mul = cf2_;
+      q.add = cf0.data();
+      q.row_add = cf1_ifm.empty() ? nullptr : cf1_ifm.data();
+      q.relu = nonlinear_type_ == 1;
+      q.post = zo_;
+      q.shift = shift_out_;
+      q.lo = data_min_;
+      q.hi = data_max_;
+      requantize(q, data_out_ptr_, ch, data_out_ptr_, ch, fmap_o_.num() / ch,
+                 ch);
+      return;
+    }
+  }
 
   // kernel
-  auto ifm = calculate_ifm();
   for (auto i = 0; i < fmap_o_.num(); i++) {
-    int32_t tmp_data = tmp_data_out_[i];
-    if (shift_matmul) {
-      tmp_data =
-          round_even(tmp_data_out_[i], shift_matmul, INT32_MAX, INT32_MIN);
+    int32_t tmp_data;
+    if constexpr (std::is_same<DType, int32_t>::value) {
+      tmp_data = data_out_ptr_[i];
+    } else {
+      tmp_data = tmp_data_out_[i];
+      if (shift_matmul_) {
+        tmp_data =
+            round_even(tmp_data_out_[i], shift_matmul_, INT32_MAX, INT32_MIN);
+      }
     }
-    int64_t tmp = cf2 * tmp_data + cf1 * ifm[i / ch] + cf0[i % ch] - zo;
+    int64_t ifm = zw != 0 ? ifm_[i / ch] : 0;
+    int64_t tmp = cf2_ * tmp_data + cf1_ * ifm + cf0_[i % ch] - zo_;
     if (nonlinear_type_ == 1) {
       if (tmp < 0) tmp = 0;
-      tmp = tmp + zo;
+      tmp = tmp + zo_;
     } else if (nonlinear_type_ == 2 || nonlinear_type_ == 3) {
-      int64_t tmp1 = cf4 * (tmp_data - zw * ifm[i / ch]) + cf3[i % ch];
-      tmp = std::max(tmp + zo, tmp1);
+      int64_t tmp1 = cf4_ * (tmp_data - zw * ifm) + cf3_[i % ch];
+      tmp = std::max(tmp + zo_, tmp1);
     } else {
-      tmp = tmp + zo;
+      tmp = tmp + zo_;
     }
-    data_out_ptr_[i] = round_even(tmp, shift_out, data_max_, data_min_);
+    data_out_ptr_[i] = round_even(tmp, shift_out_, data_max_, data_min_);
   }
 }
 
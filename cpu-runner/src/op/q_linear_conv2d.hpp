@@ -32,15 +32,18 @@ class QLinearConv2d : public Conv2d<DType, WType> {
   ~QLinearConv2d() = default;
 
   virtual void run() override final;
+  virtual void prepare() override;
 
   virtual void print_param() override;
   virtual void check_param() override;
 
  private:
   void fix();
+  void calculate_coeffs();
   std::vector<int32_t> calculate_ifm();
 
   void qlinearconv2d_conv();
+  void qlinearconv2d_gemm();
   void qlinearconv2d_conv_one(DType* src, WType* wts, int idx_dst_n,
                               int idx_dst_h, int idx_dst_w, int idx_oc,
                               int32_t ic_begin, int32_t ic_end);
@@ -58,6 +61,25 @@ class QLinearConv2d : public Conv2d<DType, WType> {
   int32_t zp_output_;
   std::vector<int64_t> tmp_data_out_;
 
+  // int32 data with products which sum up to int32 exactly, i.e. without
+  // a matmul shift, runs im2col and the packed gemm() instead of
+  // qlinearconv2d_conv(), the sums are then in data_out_ptr_
+  bool use_gemm_{false};
+  int64_t shift_matmul_{0};
+  // input sums of each output pixel, if zp_weights_ is not 0
+  std::vector<int32_t> ifm_;
+
+  // requantization coefficients, see fix(), computed by prepare() if the
+  // weights and bias are const, else on every run
+  bool coeffs_ready_{false};
+  int64_t cf1_;
+  int64_t cf2_;
+  int64_t cf4_;
+  int64_t zo_;
+  int32_t shift_out_;
+  std::vector<int64_t> cf0_;
+  std::vector<int64_t> cf3_;
+
   double prelu_alpha_{0.1015625};
   int prelu_in_{0};
   int prelu_shift_{0};
@@ -76,7 +98,10 @@ class QLinearConv2d : public Conv2d<DType, WType> {
   using ConvBase<DType, WType>::pad_;
   using ConvBase<DType, WType>::dilation_;
   using ConvBase<DType, WType>::ITName;
+  using ConvBase<DType, WType>::group_;
+  using ConvBase<DType, WType>::packed_weights_;
   using CPUOPBase::inputs_;
+  using CPUOPBase::xir_subg_;
 
   using CPUOPBase::data_max_;
   using CPUOPBase::data_min_;
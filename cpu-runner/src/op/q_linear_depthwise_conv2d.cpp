@@ -19,6 +19,8 @@
 #include <ostream>
 
 #include "fast_pad.hpp"
+#include "requantize.hpp"
+#include "weight_cache.hpp"
 
 namespace vart {
 namespace cpu {
@@ -100,6 +102,24 @@ void QLinearDWConv2d<DType, WType>::run() {
   // // do save, debug...
   // this->save();
 }
+template <typename DType, typename WType>
+void QLinearDWConv2d<DType, WType>::prepare() {
+  auto* weights_op =
+      xir_op_->get_input_op(ITName[DWConvBase<DType, WType>::WEIGHTS], 0);
+  auto* bias_op =
+      has_bias_
+          ? xir_op_->get_input_op(ITName[DWConvBase<DType, WType>::BIAS], 0)
+          : nullptr;
+  if (!WeightCache::cacheable(xir_subg_, weights_op) ||
+      (has_bias_ && !WeightCache::cacheable(xir_subg_, bias_op))) {
+    return;
+  }
+  this->read_weights();
+  this->read_bias();
+  calculate_coeffs();
+  coeffs_ready_ = true;
+}
+
 template <typename DType, typename WType>
 std::vector<int64_t> QLinearDWConv2d<DType, WType>::calculate_cf2(
     std::vector<float> cf_float) {
@@ -183,7 +203,7 @@ std::vector<WType> QLinearDWConv2d<DType, WType>::calculate_wgt() {
 }
 
 template <typename DType, typename WType>
-void QLinearDWConv2d<DType, WType>::fix() {
+void QLinearDWConv2d<DType, WType>::calculate_coeffs() {
   auto f_cf0 = so_ / (sa_ * sw_);
   int64_t cf0 = float_to_int32(f_cf0);
   shift_out_ = get_shift_from_int32_rep(f_cf0);
@@ -206,9 +226,32 @@ void QLinearDWConv2d<DType, WType>::fix() {
   UNI_LOG_DEBUG_INFO << "coeffs0 " << f_cf0 << "\n" << cf0;
   UNI_LOG_DEBUG_INFO << "coeffs2 " << f_cf2 << "\n" << cf2;
   UNI_LOG_DEBUG_INFO << "shift_b_" << shift_b_ << " shift_out_ " << shift_out_;
+  cf0_ = cf0;
+  cf2_ = std::move(cf2);
+}
+
+template <typename DType, typename WType>
+void QLinearDWConv2d<DType, WType>::fix() {
+  if (!coeffs_ready_) {
+    calculate_coeffs();
+  }
+  auto ch = (int64_t)cf2_.size();
+  if constexpr (std::is_same<DType, int32_t>::value) {
+    if (ch == fmap_o_.c && shift_out_ >= 1) {
+      Requantize q;
+      q.mul = cf0_;
+      q.add = cf2_.data();
+      q.shift = shift_out_;
+      q.lo = data_min_;
+      q.hi = data_max_;
+      requantize(q, data_out_ptr_, ch, data_out_ptr_, ch, fmap_o_.num() / ch,
+                 ch);
+      return;
+    }
+  }
   for (auto i = 0; i < fmap_o_.num(); i++) {
     int64_t new_value =
-        cf0 * data_out_ptr_[i] + /*cf1 * ifm[i] +*/ cf2[i % cf2.size()];
+        cf0_ * data_out_ptr_[i] + /*cf1 * ifm[i] +*/ cf2_[i % ch];
     data_out_ptr_[i] = round_even(new_value, shift_out_, data_max_, data_min_);
   }
 }
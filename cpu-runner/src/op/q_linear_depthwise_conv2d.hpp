@@ -32,12 +32,14 @@ class QLinearDWConv2d : public DWConv<DType, WType> {
   ~QLinearDWConv2d() = default;
 
   virtual void run() override final;
+  virtual void prepare() override;
 
   virtual void print_param() override;
   virtual void check_param() override;
 
  private:
   void fix();
+  void calculate_coeffs();
   std::vector<DType> calculate_ifm();
   std::vector<WType> calculate_wgt();
   std::vector<int64_t> calculate_cf2(std::vector<float> cf_float);
@@ -57,7 +59,13 @@ class QLinearDWConv2d : public DWConv<DType, WType> {
 
   int32_t shift_b_;
   int32_t shift_out_;
-  
+
+  // requantization coefficients, see fix(), computed by prepare() if the
+  // weights and bias are const, else on every run
+  bool coeffs_ready_{false};
+  int64_t cf0_;
+  std::vector<int64_t> cf2_;
+
   using DWConvBase<DType, WType>::xir_op_;
   using DWConvBase<DType, WType>::has_bias_;
   using DWConvBase<DType, WType>::fmap_o_;
@@ -71,6 +79,7 @@ class QLinearDWConv2d : public DWConv<DType, WType> {
   using CPUOPBase::data_max_;
   using CPUOPBase::data_min_;
   using CPUOPBase::inputs_;
+  using CPUOPBase::xir_subg_;
   using DWConvBase<DType, WType>::bias_ptr_;
   using DWConvBase<DType, WType>::data_out_ptr_;
   using DWConvBase<DType, WType>::weights_ptr_;
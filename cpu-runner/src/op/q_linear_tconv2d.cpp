@@ -17,6 +17,8 @@
 #include "q_linear_tconv2d.hpp"
 
 #include "fast_pad.hpp"
+#include "requantize.hpp"
+#include "weight_cache.hpp"
 
 namespace vart {
 namespace cpu {
@@ -93,7 +95,25 @@ void QLinearTConv2d<DType, WType>::run() {
 }
 
 template <typename DType, typename WType>
-void QLinearTConv2d<DType, WType>::fix() {
+void QLinearTConv2d<DType, WType>::prepare() {
+  TConv2d<DType, WType>::prepare();
+  auto* weights_op =
+      xir_op_->get_input_op(ITName[TConv2d<DType, WType>::WEIGHTS], 0);
+  auto* bias_op =
+      has_bias_ ? xir_op_->get_input_op(ITName[TConv2d<DType, WType>::BIAS], 0)
+                : nullptr;
+  if (!WeightCache::cacheable(xir_subg_, weights_op) ||
+      (has_bias_ && !WeightCache::cacheable(xir_subg_, bias_op))) {
+    return;
+  }
+  this->read_weights();
+  this->read_bias();
+  calculate_coeffs();
+  coeffs_ready_ = true;
+}
+
+template <typename DType, typename WType>
+void QLinearTConv2d<DType, WType>::calculate_coeffs() {
   auto f_cf1 = so_ / (sa_ * sw_);
   int64_t cf1 = float_to_int32(f_cf1);
   auto shift_out = get_shift_from_int32_rep(f_cf1);
@@ -110,9 +130,33 @@ void QLinearTConv2d<DType, WType>::fix() {
   UNI_LOG_DEBUG_INFO << "f_cf1 " << f_cf1 << " cf1 " << cf1;
   UNI_LOG_DEBUG_INFO << "cf0 " << cf0;
   UNI_LOG_DEBUG_INFO << "shift_out " << shift_out;
+  cf1_ = cf1;
+  shift_out_ = shift_out;
+  cf0_ = std::move(cf0);
+}
+
+template <typename DType, typename WType>
+void QLinearTConv2d<DType, WType>::fix() {
+  if (!coeffs_ready_) {
+    calculate_coeffs();
+  }
+  auto ch = fmap_o_.c;
+  if constexpr (std::is_same<DType, int32_t>::value) {
+    if (shift_out_ >= 1) {
+      Requantize q;
+      q.mul = cf1_;
+      q.add = cf0_.data();
+      q.shift = shift_out_;
+      q.lo = data_min_;
+      q.hi = data_max_;
+      requantize(q, data_out_ptr_, ch, data_out_ptr_, ch, fmap_o_.num() / ch,
+                 ch);
+      return;
+    }
+  }
   for (auto i = 0; i < fmap_o_.num(); i++) {
-    int64_t tmp = cf1 * data_out_ptr_[i] + cf0[i % ch];
-    data_out_ptr_[i] = round_even(tmp, shift_out, data_max_, data_min_);
+    int64_t tmp = cf1_ * data_out_ptr_[i] + cf0_[i % ch];
+    data_out_ptr_[i] = round_even(tmp, shift_out_, data_max_, data_min_);
   }
 }
 
@@ -32,12 +32,14 @@ class QLinearTConv2d : public TConv2d<DType, WType> {
   ~QLinearTConv2d() = default;
 
   virtual void run() override final;
+  virtual void prepare() override;
 
   virtual void print_param() override;
   virtual void check_param() override;
 
  private:
   void fix();
+  void calculate_coeffs();
 
  private:
   float sa_;
@@ -49,6 +51,13 @@ class QLinearTConv2d : public TConv2d<DType, WType> {
   float so_;
   int32_t zo_;
 
+  // requantization coefficients, see fix(), computed by prepare() if the
+  // weights and bias are const, else on every run
+  bool coeffs_ready_{false};
+  int64_t cf1_;
+  int32_t shift_out_;
+  std::vector<int64_t> cf0_;
+
   using TConv2d<DType, WType>::xir_op_;
   using TConv2d<DType, WType>::has_bias_;
   using TConv2d<DType, WType>::fmap_o_;
@@ -62,6 +71,7 @@ class QLinearTConv2d : public TConv2d<DType, WType> {
   using CPUOPBase::data_max_;
   using CPUOPBase::data_min_;
   using CPUOPBase::inputs_;
+  using CPUOPBase::xir_subg_;
   using TConv2d<DType, WType>::bias_ptr_;
   using TConv2d<DType, WType>::data_out_ptr_;
   using TConv2d<DType, WType>::weights_ptr_;
@@ -17,6 +17,9 @@
 
 #include "qlinear_pool.hpp"
 
+#include "requantize.hpp"
+#include "thread_pool.hpp"
+
 namespace vart {
 namespace cpu {
 
@@ -73,6 +76,24 @@ void QlinearPool<DType>::print_param() {
 
 template <typename DType>
 void QlinearPool<DType>::avg_pool_qdq() {
+  if constexpr (std::is_same<DType, int32_t>::value) {
+    if (shift_c0_ >= 1) {
+      std::vector<std::int64_t> add(
+          fmap_o_.c,
+          shift_c0_ > shift_c1_
+              ? static_cast<std::int64_t>(c_1_) << (shift_c0_ - shift_c1_)
+              : static_cast<std::int64_t>(c_1_) >> (shift_c1_ - shift_c0_));
+      Requantize q;
+      q.mul = c_0_;
+      q.add = add.data();
+      q.shift = shift_c0_;
+      q.lo = data_min_;
+      q.hi = data_max_;
+      requantize(q, data_out_ptr_, fmap_o_.c, data_out_ptr_, fmap_o_.c,
+                 fmap_o_.num() / fmap_o_.c, fmap_o_.c);
+      return;
+    }
+  }
   if (CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
       CPU_RUN_MODE == CPURunMode::GEMM_THREAD) {
     avg_pool_qdq_thread();
@@ -90,29 +111,15 @@ void QlinearPool<DType>::avg_pool_qdq_normal() {
 
 template <typename DType>
 void QlinearPool<DType>::avg_pool_qdq_thread() {
-  std::vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(
-        std::launch::async,
-        [this](decltype(i) i) {
-          auto BASE_POS = i * THREAD_WORKLOAD;
-          for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-            auto pos = BASE_POS + j;
-            if (pos >= FMAP_SIZE) break;
-
-            avg_pool_qdq_one(pos);
-          }
-
-          return 0;
-        },
-        i);
-  }
+  parallel_for(THREAD_NUM, [this](uint32_t i) {
+    auto BASE_POS = i * THREAD_WORKLOAD;
+    for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+      auto pos = BASE_POS + j;
+      if (pos >= FMAP_SIZE) break;
 
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+      avg_pool_qdq_one(pos);
+    }
+  });
 }
 
 static int32_t round_even(int64_t n, int shift, int32_t min, int32_t max) {
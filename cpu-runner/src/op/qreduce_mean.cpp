@@ -100,34 +100,13 @@ void QReduceMean<DType>::calculate() {
   // caculate
   // double factor = 1.0;
   // float pow_shift = 1.0;
-  for (auto idx : reduce_dims_) {
-    auto cur_dim = fmap_i_.dim(idx);
-    // factor = factor / cur_dim;
-    // auto factors = qdq_get_mean_dpu_fix_factors(cur_dim);
-    // factor *= (double)(factors.first);
-    // pow_shift *= std::exp2(factors.second);
-    auto cur_cod = fmap_i_.cod(idx);
-    auto n_cur_chunk = fmap_i_.num() / (cur_dim * cur_cod);
-
-    for (auto i = 0; i < n_cur_chunk; i++) {
-      DType* prlt = data_in_ptr_ + i * cur_dim * cur_cod;
-
-      for (auto j = 1; j < cur_dim; j++) {
-        DType* pcur = prlt + j * cur_cod;
-
-        // accumulate
-        for (auto k = 0; k < cur_cod; k++) {
-          prlt[k] += pcur[k];
-        }
-      }
-    }
-  }
+  this->reduce(ReduceOp::SUM);
 
   int32_t c1_shift_pre = ((FP_1 - FP_0) >= 32) ? 0 : (FP_0 - FP_1);
   int64_t c1_int_pre = ((FP_1 - FP_0) >= 32) ? 0 : C_1;
-  for (auto i = 0; i < fmap_i_.num(); i++) {
+  for (auto i = 0; i < fmap_o_.num(); i++) {
     // simulate aie shift-round-saturate
-    int64_t tmp = (double)(static_cast<std::int64_t>(data_in_ptr_[i]) * C_0 +
+    int64_t tmp = (double)(static_cast<std::int64_t>(data_out_ptr_[i]) * C_0 +
                            (c1_int_pre << c1_shift_pre));
     if (FP_0 > 0) {
       // shift
@@ -137,11 +116,11 @@ void QReduceMean<DType>::calculate() {
     }
     // saturate
     if (tmp > CPUOPBase::data_max_) {
-      data_in_ptr_[i] = CPUOPBase::data_max_;
+      data_out_ptr_[i] = CPUOPBase::data_max_;
     } else if (tmp < CPUOPBase::data_min_) {
-      data_in_ptr_[i] = CPUOPBase::data_min_;
+      data_out_ptr_[i] = CPUOPBase::data_min_;
     } else {
-      data_in_ptr_[i] = tmp;
+      data_out_ptr_[i] = tmp;
     }
   }
 }
@@ -152,24 +131,10 @@ void QReduceMean<float>::calculate() {
   for (auto idx : reduce_dims_) {
     auto cur_dim = fmap_i_.dim(idx);
     factor = factor / cur_dim;
-    auto cur_cod = fmap_i_.cod(idx);
-    auto n_cur_chunk = fmap_i_.num() / (cur_dim * cur_cod);
-
-    for (auto i = 0; i < n_cur_chunk; i++) {
-      float* prlt = data_in_ptr_ + i * cur_dim * cur_cod;
-
-      for (auto j = 1; j < cur_dim; j++) {
-        float* pcur = prlt + j * cur_cod;
-
-        // accumulate
-        for (auto k = 0; k < cur_cod; k++) {
-          prlt[k] += pcur[k];
-        }
-      }
-    }
   }
-  for (auto i = 0; i < fmap_i_.num(); i++) {
-    data_in_ptr_[i] *= factor;
+  this->reduce(ReduceOp::SUM);
+  for (auto i = 0; i < fmap_o_.num(); i++) {
+    data_out_ptr_[i] *= factor;
   }
 }
 
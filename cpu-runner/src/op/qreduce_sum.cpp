@@ -62,6 +62,9 @@ QReduceSum<DType>::QReduceSum(const xir::Subgraph* subg, const xir::Op* op,
 
   FP_0 = c0_shift;
   FP_1 = c1_shift;
+
+  // float rounds the sums to bfloat16 after each axis, in place
+  ReduceBase<DType>::in_place_ = std::is_same<DType, float>::value;
 }
 
 template <typename DType>
@@ -82,9 +85,9 @@ void QReduceSum<DType>::calculate() {
 
   int32_t c1_shift_pre = ((FP_1 - FP_0) >= 32) ? 0 : (FP_0 - FP_1);
   int64_t c1_int_pre = ((FP_1 - FP_0) >= 32) ? 0 : C_1;
-  for (auto i = 0; i < fmap_i_.num(); i++) {
+  for (auto i = 0; i < fmap_o_.num(); i++) {
     // simulate aie shift-round-saturate
-    int64_t tmp = (double)(static_cast<std::int64_t>(data_in_ptr_[i]) * C_0 +
+    int64_t tmp = (double)(static_cast<std::int64_t>(data_out_ptr_[i]) * C_0 +
                            (c1_int_pre << c1_shift_pre));
     if (FP_0 > 0) {
       // shift
@@ -94,11 +97,11 @@ void QReduceSum<DType>::calculate() {
     }
     // saturate
     if (tmp > CPUOPBase::data_max_) {
-      data_in_ptr_[i] = CPUOPBase::data_max_;
+      data_out_ptr_[i] = CPUOPBase::data_max_;
     } else if (tmp < CPUOPBase::data_min_) {
-      data_in_ptr_[i] = CPUOPBase::data_min_;
+      data_out_ptr_[i] = CPUOPBase::data_min_;
     } else {
-      data_in_ptr_[i] = tmp;
+      data_out_ptr_[i] = tmp;
     }
   }
 }
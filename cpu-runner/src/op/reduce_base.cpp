@@ -64,6 +64,9 @@ void ReduceBase<DType>::run() {
   // Use this virtual func to dispatch sub-class's
   // calculation implementation routine.
   calculate();
+  if (!in_place_) {
+    return;
+  }
 
   // copy calculation result from data_in_ptr_ into data_out_ptr_
   for (auto pos = 0; pos < fmap_o_.num(); pos++) {
@@ -109,15 +112,23 @@ void ReduceBase<DType>::check_param() {
 template <typename DType>
 void ReduceBase<DType>::read() {
   auto* cputb = inputs_.at(ITName[INPUT]).at(0);
-  auto* origin_in_ptr_ = GET_CPUTB_DType_PTR(DType, cputb);
-  data_in_buf_.resize(fmap_i_.num());
-  data_in_ptr_ = data_in_buf_.data();
-  std::copy_n(origin_in_ptr_, fmap_i_.num(), data_in_ptr_);
+  data_in_ptr_ = GET_CPUTB_DType_PTR(DType, cputb);
+  if (in_place_) {
+    data_in_buf_.assign(data_in_ptr_, data_in_ptr_ + fmap_i_.num());
+    data_in_ptr_ = data_in_buf_.data();
+  }
 
   // handle output buffer
   data_out_ptr_ = GET_CPUTB_DType_PTR(DType, output_);
 }
 
+template <typename DType>
+void ReduceBase<DType>::reduce(ReduceOp op) {
+  reduce_axes(op, fmap_i_.vdims(), reduce_dims_, data_in_ptr_, data_out_ptr_,
+              CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
+                  CPU_RUN_MODE == CPURunMode::GEMM_THREAD);
+}
+
 template <typename DType>
 uint64_t ReduceBase<DType>::get_workload() {
   return 0;
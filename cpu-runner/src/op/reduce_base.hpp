@@ -18,6 +18,7 @@
 #pragma once
 
 #include "cpu_op_base.hpp"
+#include "reduce.hpp"
 
 namespace vart {
 namespace cpu {
@@ -60,6 +61,10 @@ public:
 protected:
   virtual void calculate() {}
 
+  // reduce_axes() of the input into data_out_ptr_, for ops which do not
+  // reduce in place
+  void reduce(ReduceOp op);
+
 protected:
   Dimension fmap_i_;
   Dimension fmap_o_;
@@ -70,6 +75,11 @@ protected:
 
   int reduce_type_{Unknown};
 
+  // calculate() reduces a copy of the input in place, whose results
+  // run() gathers, else it writes data_out_ptr_ and data_in_ptr_ is the
+  // input itself
+  bool in_place_{true};
+
   // i/o buffer
   vector<DType> data_in_buf_;
   DType* data_in_ptr_{nullptr};
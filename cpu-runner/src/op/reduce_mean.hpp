@@ -29,14 +29,17 @@ public:
       IMapTBs_t inputs, CPUTBPtr_t output)
     : ReduceBase<DType>(subg, op, inputs, output) {
     ReduceBase<DType>::reduce_type_ = ReduceBase<DType>::MEAN;
+    ReduceBase<DType>::in_place_ = false;
   }
   virtual ~ReduceMean() = default;
 
 protected:
   virtual void calculate() override;
   using ReduceBase<DType>::fmap_i_;
+  using ReduceBase<DType>::fmap_o_;
   using ReduceBase<DType>::reduce_dims_;
   using ReduceBase<DType>::data_in_ptr_;
+  using ReduceBase<DType>::data_out_ptr_;
 };
 
 } // namespace cpu
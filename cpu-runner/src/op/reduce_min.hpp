@@ -29,6 +29,7 @@ public:
       IMapTBs_t inputs, CPUTBPtr_t output)
     : ReduceBase<DType>(subg, op, inputs, output) {
     ReduceBase<DType>::reduce_type_ = ReduceBase<DType>::MIN;
+    ReduceBase<DType>::in_place_ = false;
   }
   virtual ~ReduceMin() = default;
 
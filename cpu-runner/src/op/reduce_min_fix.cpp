@@ -46,9 +46,9 @@ void ReduceMinFix<DType>::print_param() {
 template <typename DType>
 void ReduceMinFix<DType>::calculate() {
   ReduceMin<DType>::calculate();
-  for (auto i = 0; i < fmap_i_.num(); i++) {
-    data_in_ptr_[i] = round_normal<DType>(
-        CPUOPBase::round_mode_, data_in_ptr_[i] * pow_shift_,
+  for (auto i = 0; i < fmap_o_.num(); i++) {
+    data_out_ptr_[i] = round_normal<DType>(
+        CPUOPBase::round_mode_, data_out_ptr_[i] * pow_shift_,
         CPUOPBase::data_min_, CPUOPBase::data_max_);
   }
 }
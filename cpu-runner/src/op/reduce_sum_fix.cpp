@@ -47,10 +47,10 @@ void ReduceSumFix<DType>::print_param() {
 template <typename DType>
 void ReduceSumFix<DType>::calculate() {
   ReduceSum<DType>::calculate();
-  for (auto i = 0; i < fmap_i_.num(); i++) {
+  for (auto i = 0; i < fmap_o_.num(); i++) {
     auto tmp = 0.f;
-    tmp = (float)data_in_ptr_[i];
-    data_in_ptr_[i] =
+    tmp = (float)data_out_ptr_[i];
+    data_out_ptr_[i] =
         round_normal<DType>(CPUOPBase::round_mode_, tmp * pow_shift_,
                             CPUOPBase::data_min_, CPUOPBase::data_max_);
   }
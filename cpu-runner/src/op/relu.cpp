@@ -44,11 +44,20 @@ void Relu<DType>::run() {
 
 template <typename DType>
 void Relu<DType>::relu() {
-  copy_n(data_in_ptr_, fmap_o_.num(), data_out_ptr_);
+  // in place when plan_memory gives the output the input memory
+  if (data_out_ptr_ != data_in_ptr_) {
+    copy_n(data_in_ptr_, fmap_o_.num(), data_out_ptr_);
+  }
+
+  run_pointwise(data_out_ptr_, 0, fmap_o_.num());
+}
 
-  for (auto i = 0; i < fmap_o_.num(); i++) {
-    if (data_out_ptr_[i] < 0) {
-      data_out_ptr_[i] = 0;
+template <typename DType>
+void Relu<DType>::run_pointwise(void* data, int64_t begin, int64_t end) {
+  auto* ptr = static_cast<DType*>(data);
+  for (auto i = begin; i < end; i++) {
+    if (ptr[i] < 0) {
+      ptr[i] = 0;
     }
   }
 }
@@ -31,6 +31,10 @@ public:
 
   virtual void run() override final;
 
+  virtual bool is_pointwise() const override { return true; }
+  virtual void run_pointwise(void* data, int64_t begin,
+                             int64_t end) override final;
+
 private:
   void relu6();
 
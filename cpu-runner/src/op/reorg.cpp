@@ -37,6 +37,10 @@ Reorg<DType>::Reorg(const xir::Subgraph* subg, const xir::Op* op,
   auto scale_hw = xir_op_->get_attr<int>("scale");
   scale_ = ScaleAttr{scale_hw, scale_hw};
   reverse_ = xir_op_->get_attr<bool>("reverse");
+  use_transpose_ =
+      fmap_i_.n == 1 &&
+      make_reorg({1, (int)fmap_i_.h, (int)fmap_i_.w, (int)fmap_i_.c},
+                 scale_hw, reverse_, &transpose_);
 
   // resize related buffer size
   data_in_tmp_.resize(fmap_i_.n * fmap_i_.h * fmap_i_.w * fmap_i_.c);
@@ -100,7 +104,11 @@ uint64_t Reorg<DType>::get_workload() {
 
 template <typename DType>
 void Reorg<DType>::reorg() {
-  if (reverse_) {
+  if (use_transpose_) {
+    transpose(transpose_, data_in_, data_out_,
+              CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
+                  CPU_RUN_MODE == CPURunMode::GEMM_THREAD);
+  } else if (reverse_) {
     reorg_reverse_yes();
   } else {
     reorg_reverse_no();
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "cpu_op_base.hpp"
+#include "transpose.hpp"
 
 namespace vart {
 namespace cpu {
@@ -59,6 +60,9 @@ protected:
 
   bool reverse_;
   ScaleAttr scale_;
+  // one transpose instead of the two passes, if the shape allows
+  bool use_transpose_;
+  Transpose transpose_;
 
   // buffer
   DType* data_in_;
@@ -96,7 +96,9 @@ uint64_t Reshape<DType>::get_workload() {
 
 template <typename DType>
 void Reshape<DType>::reshape() {
-  // just assign value, nothing to do else
+  // just assign value, nothing to do else, unless the memory plan made
+  // the output a view of the input
+  if (data_out_ == data_in_) return;
   std::copy_n(data_in_, get_vec_mul(fmap_i_), data_out_);
 }
 
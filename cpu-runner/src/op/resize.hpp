@@ -18,6 +18,7 @@
 #pragma once
 
 #include "cpu_op_base.hpp"
+#include "resample.hpp"
 
 namespace vart {
 namespace cpu {
@@ -35,6 +36,10 @@ class Resize : public CPUOPBase {
   virtual void read() override final;
   void resize();
 
+ protected:
+  // the float results, the ones ResizeFix rounds, into dst
+  void resize_f(float* dst);
+
  protected:
   std::string mode_;
   bool align_corners_;
@@ -43,7 +48,11 @@ class Resize : public CPUOPBase {
   FMap_t fmap_i_;
   FMap_t fmap_o_;
 
+  // source rows and columns of the nearest and bilinear modes
+  Resample resample_;
+
   DType* data_in_ptr_{nullptr};
+  // float results before the cast to DType, unused by Resize<float>
   std::vector<float> output_f_;
   DType* data_out_ptr_{nullptr};
 };
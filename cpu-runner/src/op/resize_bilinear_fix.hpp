@@ -51,6 +51,7 @@ class ResizeBilinearFix : public Resize<DType> {
   using Resize<DType>::mode_;
   using Resize<DType>::align_corners_;
   using Resize<DType>::half_pixel_centers_;
+  using Resize<DType>::resample_;
 
   using Resize<DType>::data_in_ptr_;
   using Resize<DType>::data_out_ptr_;
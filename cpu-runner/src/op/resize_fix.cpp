@@ -34,11 +34,12 @@ ResizeFix<DType>::ResizeFix(const xir::Subgraph* subg, const xir::Op* op,
   }else{
       shift_ = 0;
   }
+  this->output_f_.resize(fmap_o_.num());
 }
 
 template <typename DType>
 void ResizeFix<DType>::run() {
-  this->resize();
+  this->resize_f(this->output_f_.data());
   fix();
 }
 
@@ -55,6 +56,24 @@ void ResizeFix<DType>::print_param() {
 template <typename DType>
 void ResizeFix<DType>::fix() {
   double factor = pow(2, shift_);
+  if constexpr (std::is_integral<DType>::value) {
+    // round_normal() with the mode looked up once, not per element
+    DType (*round)(double, DType, DType) = nullptr;
+    if (CPUOPBase::round_mode_ == "STD_ROUND") {
+      round = STDRound<DType>;
+    } else if (CPUOPBase::round_mode_ == "DPU_ROUND") {
+      round = DPURound<DType>;
+    } else if (CPUOPBase::round_mode_ == "PY3_ROUND") {
+      round = Py3Round<DType>;
+    }
+    if (round != nullptr) {
+      for (auto i = 0; i < fmap_o_.num(); i++) {
+        data_out_ptr_[i] = round(this->output_f_[i] * factor,
+                                 CPUOPBase::data_min_, CPUOPBase::data_max_);
+      }
+      return;
+    }
+  }
   for (auto i = 0; i < fmap_o_.num(); i++) {
     data_out_ptr_[i] =
         round_normal<DType>(CPUOPBase::round_mode_, this->output_f_[i] * factor,
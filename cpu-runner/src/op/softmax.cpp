@@ -17,6 +17,8 @@
 
 #include "softmax.hpp"
 
+#include "thread_pool.hpp"
+
 namespace vart {
 namespace cpu {
 
@@ -106,29 +108,18 @@ void Softmax<DType>::softmax_normal() {
 
 template <typename DType>
 void Softmax<DType>::softmax_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(
-        std::launch::async,
-        [this](decltype(i) i) {
-          auto BASE_POS = i * THREAD_WORKLOAD;
-          for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-            auto loop_iter = BASE_POS + j;
-            if (loop_iter >= loop_times_) break;
-            if (axis_stride_ == 1) {
-              softmax_one_contiguous(loop_iter);
-            } else {
-              softmax_one_discrete(loop_iter);
-            }
-          }
-          return 0;
-        },
-        i);
-  }
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+  parallel_for(THREAD_NUM, [this](uint32_t i) {
+    auto BASE_POS = i * THREAD_WORKLOAD;
+    for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
+      auto loop_iter = BASE_POS + j;
+      if (loop_iter >= loop_times_) break;
+      if (axis_stride_ == 1) {
+        softmax_one_contiguous(loop_iter);
+      } else {
+        softmax_one_discrete(loop_iter);
+      }
+    }
+  });
 }
 
 template <typename DType>
@@ -45,6 +45,7 @@ void Squeeze<DType>::read() {
 
 template <typename DType>
 void Squeeze<DType>::squeeze() {
+  if (data_out_ptr_ == data_in_ptr_) return;
   for (auto i = 0; i < num_; i++) data_out_ptr_[i] = data_in_ptr_[i];
 }
 
@@ -17,6 +17,8 @@
 
 #include "strided_slice.hpp"
 
+#include "thread_pool.hpp"
+
 namespace vart {
 namespace cpu {
 
@@ -50,11 +52,7 @@ StridedSlice<DType>::StridedSlice(const xir::Subgraph* subg, const xir::Op* op,
   end_.insert(end_.begin(), 4 - end_.size(), 1);
   strides_.insert(strides_.begin(), 4 - strides_.size(), 1);
   fmap_i_.insert(fmap_i_.begin(), 4 - fmap_i_.size(), 1);
-  fmap_o_.resize(4);
-  for (uint32_t i = 0u; i < 4; i++) {
-    fmap_o_[i] = (end_[i] - begin_[i]) / strides_[i] +
-                 ((end_[i] - begin_[i]) % strides_[i] != 0);
-  }
+  transpose_ = make_strided_slice(fmap_i_, begin_, end_, strides_, &fmap_o_);
   fmap_o_num_ = get_vec_mul(fmap_o_);
   THREAD_NUM = CPU_NUM;
   THREAD_WORKLOAD = ceil((float)(fmap_o_num_) / THREAD_NUM);
@@ -155,42 +153,18 @@ void StridedSlice<DType>::calculate_normal() {
 
 template <typename DType>
 void StridedSlice<DType>::calculate_thread() {
-  vector<std::future<void>> fut(THREAD_NUM);
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; ++thread_id) {
-    auto start_index = thread_id * THREAD_WORKLOAD;
-    auto FMAP_SIZE = fmap_o_num_;
-    auto end_index =
-        std::min<uint32_t>(FMAP_SIZE, start_index + THREAD_WORKLOAD);
-    fut[thread_id] = std::async(
-        std::launch::async,
-        [this](decltype(start_index) start_index,
-               decltype(end_index) end_index) {
-          calculate(start_index, end_index);
-        },
-        start_index, end_index);
-  }
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; thread_id++) {
-    fut[thread_id].wait();
-  }
+  parallel_for_range(
+      fmap_o_num_,
+      [this](int64_t start_index, int64_t end_index) {
+        calculate(start_index, end_index);
+      },
+      Schedule::STATIC);
 }
 
 template <typename DType>
 void StridedSlice<DType>::calculate(std::uint32_t start_index,
                                     std::uint32_t end_index) {
-  for (uint32_t pos_iter = start_index; pos_iter < end_index; pos_iter++) {
-    int32_t dim3_iter = pos_iter % fmap_o_[3];
-    int32_t dim2_iter = (pos_iter / (fmap_o_[3])) % fmap_o_[2];
-    int32_t dim1_iter = (pos_iter / (fmap_o_[3] * fmap_o_[2])) % fmap_o_[1];
-    int32_t dim0_iter = pos_iter / (fmap_o_[3] * fmap_o_[2] * fmap_o_[1]);
-
-    int32_t src_pos =
-        ((dim0_iter * strides_[0]) + begin_[0]) * fmap_i_[1] * fmap_i_[2] *
-            fmap_i_[3] +
-        ((dim1_iter * strides_[1]) + begin_[1]) * fmap_i_[2] * fmap_i_[3] +
-        ((dim2_iter * strides_[2]) + begin_[2]) * fmap_i_[3] +
-        ((dim3_iter * strides_[3]) + begin_[3]);
-    data_out_[pos_iter] = data_in_[src_pos];
-  }
+  transpose(transpose_, data_in_, data_out_, start_index, end_index);
 }
 
 INSTANTIATE_TPCLASS(StridedSlice);
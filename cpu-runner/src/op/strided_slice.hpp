@@ -18,6 +18,7 @@
 #pragma once
 
 #include "cpu_op_base.hpp"
+#include "transpose.hpp"
 
 namespace vart {
 namespace cpu {
@@ -65,6 +66,7 @@ class StridedSlice : public CPUOPBase {
   int ellipsis_mask_ = 0;
   int new_axis_mask_ = 0;
   int shrink_axis_mask_ = 0;
+  Transpose transpose_;
 
   // caculate buffer
   DType* data_in_{nullptr};
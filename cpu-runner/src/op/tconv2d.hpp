@@ -31,6 +31,12 @@ public:
 
   virtual void run() override;
 
+  // bias() runs the fused ops
+  virtual bool can_fuse_pointwise() const override {
+    return std::is_floating_point<DType>::value &&
+           !this->enable_conv_dirty_;
+  }
+
   virtual void check_param() override;
 
 protected:
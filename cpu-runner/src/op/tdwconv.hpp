@@ -31,6 +31,11 @@ public:
 
   virtual void run() override;
 
+  // bias() runs the fused ops
+  virtual bool can_fuse_pointwise() const override {
+    return std::is_floating_point<DType>::value;
+  }
+
   virtual void check_param() override;
 
 protected:
@@ -17,8 +17,17 @@
 
 #pragma once
 
+#include <glog/logging.h>
+
+#include <vitis/ai/env_config.hpp>
+
 #include "cpu_base_inc.hpp"
-#include "op_state.hpp"
+#include "cpu_tb_factory.hpp"
+#include "graph_executor.hpp"
+#include "thread_pool.hpp"
+#include "vart/xir_helper.hpp"
+
+DEF_ENV_PARAM(DEBUG_CPU_RUNNER_SCHEDULE, "0");
 
 namespace vart {
 namespace cpu {
@@ -49,8 +58,12 @@ class OPSchedule {
     } else if (cpu_run_mode == CPURunMode::NORMAL_THREAD ||
                cpu_run_mode == CPURunMode::GEMM ||
                cpu_run_mode == CPURunMode::GEMM_THREAD) {
-      run_normal(std::move(v));
-      //  run_thread(std::move(v));
+      // dump files are written in op order, so debug runs stay serial
+      if (CPUCfg::Instance().get_graph_thread() && !VART_DEBUG) {
+        run_dag(std::move(v));
+      } else {
+        run_normal(std::move(v));
+      }
     } else {
       run_debug(std::move(v));
     }
@@ -77,52 +90,60 @@ class OPSchedule {
     print_summary();
   }
 
-  void run_thread(shared_ptr<CPUOPVisitor> v) {
+  // run an op as soon as all ops it reads from are done, on a fixed
+  // set of threads, see run_graph(). Every op still computes exactly
+  // what it computes in run_normal, so outputs do not change.
+  void run_dag(unique_ptr<CPUOPVisitor> v) {
     // do global initialization in current subg
     CPUOPBase::StaticInit();
 
-    // init op state
+    // CPURunner puts a const in front of every op reading it, all copies
+    // fill the same output, so each xir op runs once, at its first copy.
+    std::vector<const xir::Op*> order;
     for (auto* op : ops_) {
-      op_state_.set_state(op->get_xir_op()->get_name(), OPState::Blocked);
+      order.push_back(op->get_xir_op());
     }
-
-    // every op create a thread to run
-    auto THREAD_NUM = ops_.size();
-    vector<std::future<int>> fut(THREAD_NUM);
-
-    int id = 0;
-    for (auto* op : ops_) {
-      fut[id] = std::async(
-          std::launch::async,
-          [this, v, op](decltype(id) id) {
-            const auto* xir_op = op->get_xir_op();
-            while (!op_state_.get_op_ready(xir_op)) {
-              std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            }
-
-            auto start = time_start();
-
-            op->accept(v.get());
-            op_state_.set_op_ready(xir_op);
-
-            auto ms = time_finish(start, TIME_UNIT_MS);
-            if (VART_DEBUG) {
-              UNI_LOG_DEBUG_INFO << xir_op->get_type() << " " << ms << "ms"
-                                 << endl;
-            }
-
-            return 0;
-          },
-          id);
-
-      id++;
+    std::vector<size_t> nodes;
+    auto deps = dedup_deps(
+        order,
+        [](const xir::Op* xir_op) {
+          // subgraph inputs are not in ops_, they are ready
+          auto input_ops = vec_input_ops(xir_op->get_input_ops());
+          std::vector<const xir::Op*> ret(input_ops.begin(), input_ops.end());
+          // ops whose memory this op reuses, see CPUTBFactory::plan_memory
+          for (const auto* dep_op :
+               CPUTBFactory::Instance().get_reuse_deps(xir_op)) {
+            ret.push_back(dep_op);
+          }
+          return ret;
+        },
+        &nodes);
+    std::vector<uint64_t> cost(nodes.size());
+    for (auto i = 0U; i < nodes.size(); i++) {
+      cost[i] = ops_[nodes[i]]->get_workload();
     }
 
-    for (auto i = 0U; i < THREAD_NUM; i++) {
-      fut[i].wait();
-    }
-    PRINT_DIVIDING_LINE();
-    print_summary();
+    // the ops share ThreadPool for their kernels, more op threads than
+    // pool threads only make them wait for each other.
+    auto num_of_workers =
+        std::min<size_t>(CPU_NUM, ThreadPool::instance().num_of_threads());
+
+    auto start = time_start();
+    std::atomic<uint64_t> op_us{0U};
+    run_graph(
+        deps, cost,
+        [this, &v, &nodes, &op_us](size_t i) {
+          auto op_start = time_start();
+          ops_[nodes[i]]->accept(v.get());
+          op_us += (uint64_t)time_finish(op_start, TIME_UNIT_US);
+        },
+        num_of_workers);
+    auto ms = time_finish(start, TIME_UNIT_MS);
+
+    LOG_IF(INFO, ENV_PARAM(DEBUG_CPU_RUNNER_SCHEDULE))
+        << "ran " << nodes.size() << " ops on " << num_of_workers
+        << " threads in " << ms << "ms, sum of op time "
+        << op_us.load() / 1000. << "ms";
   }
 
   void run_debug(unique_ptr<CPUOPVisitor> v) {
@@ -170,8 +191,6 @@ class OPSchedule {
 
  private:
   std::vector<CPUOPBase*> ops_;
-
-  CPUOPState op_state_;
 };
 
 }  // namespace cpu
@@ -19,6 +19,7 @@
 
 #include "cpu_base_inc.hpp"
 #include "cpu_op_visitor.hpp"
+#include "vitis/ai/metrics.hpp"
 
 class CPUOPBase;
 
@@ -32,6 +33,11 @@ public:
 
 public:
   virtual void run(CPUOPBase *op) {
+    // computed by the op it is fused into
+    if (op->get_fused_into() != nullptr) {
+      return;
+    }
+
     print_overview(op);
     CPUOPBase::subg_ops += op->get_workload();
 
@@ -40,7 +46,11 @@ public:
 
     op->read();
 
-    op->run();
+    {
+      vitis::ai::ScopedTimer timer(
+          get_op_time_histogram(op->get_xir_op()->get_type()));
+      op->run();
+    }
 
     // TODO: use single thread to do following
     op->save();
@@ -52,6 +62,18 @@ public:
   static const VisitorType type = VisitorType::RunVisitor;
 
 private:
+  // registry lookups take a lock, so cache them per thread.
+  static vitis::ai::Histogram *get_op_time_histogram(const string &op_type) {
+    thread_local map<string, vitis::ai::Histogram *> cache;
+    auto &h = cache[op_type];
+    if (h == nullptr) {
+      h = vitis::ai::MetricsRegistry::instance().histogram(
+          "vart_cpu_runner_op_time_microseconds", "time to run one op",
+          {{"op_type", op_type}});
+    }
+    return h;
+  }
+
   void print_overview(CPUOPBase *op) {
     VART_DEBUG_GO_ON();
 
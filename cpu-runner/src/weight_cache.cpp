@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "weight_cache.hpp"
+
+#include <chrono>
+#include <iterator>
+#include <vitis/ai/env_config.hpp>
+
+DEF_ENV_PARAM(XLNX_CPU_RUNNER_WEIGHT_CACHE, "1");
+DEF_ENV_PARAM(DEBUG_CPU_RUNNER_WEIGHT_CACHE, "0");
+
+namespace vart {
+namespace cpu {
+
+// drop the entries whose weights are no longer used by any op
+template <typename Map>
+static void erase_expired(Map& entries) {
+  for (auto it = entries.begin(); it != entries.end();) {
+    it = it->second.expired() ? entries.erase(it) : std::next(it);
+  }
+}
+
+bool WeightCache::cacheable(const xir::Subgraph* subg, const xir::Op* op) {
+  if (!ENV_PARAM(XLNX_CPU_RUNNER_WEIGHT_CACHE) || op == nullptr) {
+    return false;
+  }
+  auto type = op->get_type();
+  return (type == "const" || type == "const-fix") && subg->has_op(op);
+}
+
+std::shared_ptr<const GemmPackedB> WeightCache::get_gemm_b(
+    const xir::Op* op, const float* B, int64_t N, int64_t K,
+    int64_t b_k_stride, int64_t b_n_stride) {
+  return get_or_pack(op, B, N, K, b_k_stride, b_n_stride);
+}
+
+std::shared_ptr<const GemmPackedB> WeightCache::get_gemm_b(
+    const xir::Op* op, const int32_t* B, int64_t N, int64_t K,
+    int64_t b_k_stride, int64_t b_n_stride) {
+  return get_or_pack(op, B, N, K, b_k_stride, b_n_stride);
+}
+
+std::shared_ptr<const ConvWeights> WeightCache::get_conv_weights(
+    const xir::Op* op, const ConvShape& s, ConvAlgo algo,
+    const float* weights) {
+  auto key = std::make_tuple(op, algo, s.oc, s.kh, s.kw, s.ic);
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = conv_weights_.find(key);
+  if (it != conv_weights_.end()) {
+    if (auto packed = it->second.lock()) {
+      return packed;
+    }
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto packed = std::make_shared<const ConvWeights>(
+      pack_conv_weights(s, algo, weights));
+  auto bytes = packed->direct.size() * sizeof(float);
+  for (const auto& b : packed->gemm) {
+    bytes += b.f32.size() * sizeof(float);
+  }
+  LOG_IF(INFO, ENV_PARAM(DEBUG_CPU_RUNNER_WEIGHT_CACHE))
+      << "pack " << op->get_name() << " for " << get_conv_algo_name(algo)
+      << " on " << get_gemm_isa_name(packed->isa) << ", " << bytes
+      << " bytes, "
+      << std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - start)
+             .count()
+      << "us";
+  erase_expired(conv_weights_);
+  conv_weights_[key] = packed;
+  return packed;
+}
+
+template <typename T>
+std::shared_ptr<const GemmPackedB> WeightCache::get_or_pack(
+    const xir::Op* op, const T* B, int64_t N, int64_t K, int64_t b_k_stride,
+    int64_t b_n_stride) {
+  auto key = std::make_tuple(op, std::is_integral<T>::value, N, K, b_k_stride,
+                             b_n_stride);
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto it = gemm_b_.find(key);
+  if (it != gemm_b_.end()) {
+    if (auto packed = it->second.lock()) {
+      return packed;
+    }
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto packed = std::make_shared<const GemmPackedB>(
+      pack_gemm_b(B, N, K, b_k_stride, b_n_stride));
+  auto bytes = packed->f32.size() * sizeof(float) +
+               packed->s32.size() * sizeof(int32_t) +
+               packed->s16.size() * sizeof(int16_t);
+  LOG_IF(INFO, ENV_PARAM(DEBUG_CPU_RUNNER_WEIGHT_CACHE))
+      << "pack " << op->get_name() << " " << K << "x" << N << " for "
+      << get_gemm_isa_name(packed->isa) << ", " << bytes << " bytes, "
+      << std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - start)
+             .count()
+      << "us";
+  erase_expired(gemm_b_);
+  gemm_b_[key] = packed;
+  return packed;
+}
+
+}  // namespace cpu
+}  // namespace vart
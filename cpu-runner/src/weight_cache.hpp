@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#include "conv_algo.hpp"
+#include "cpu_base_inc.hpp"
+#include "gemm.hpp"
+
+namespace vart {
+namespace cpu {
+
+// Weights which are packed once, when the runner is created, instead of
+// being re-read into the kernel's layout on every run. Entries are keyed
+// by the const op which holds the weights and the layout, so that the
+// ops of all runners of a subgraph share them. The cache only holds weak
+// references, an entry goes away with the last op using it, i.e. with
+// the last runner of the subgraph, so that an op of a later graph at the
+// same address never gets the weights of a freed one.
+class WeightCache {
+ private:
+  explicit WeightCache() = default;
+  VART_BIG_THREE_LAW(WeightCache);
+
+ public:
+  static WeightCache& Instance() {
+    static WeightCache cache;
+    return cache;
+  }
+
+  // true if `op` is a const op of `subg`, so its output is ready before
+  // the first run and never changes, and env
+  // XLNX_CPU_RUNNER_WEIGHT_CACHE is not 0
+  static bool cacheable(const xir::Subgraph* subg, const xir::Op* op);
+
+  // `B`, the output of const op `op`, packed by pack_gemm_b() by the
+  // first caller with the same layout
+  std::shared_ptr<const GemmPackedB> get_gemm_b(const xir::Op* op,
+                                                const float* B, int64_t N,
+                                                int64_t K, int64_t b_k_stride,
+                                                int64_t b_n_stride);
+  std::shared_ptr<const GemmPackedB> get_gemm_b(const xir::Op* op,
+                                                const int32_t* B, int64_t N,
+                                                int64_t K, int64_t b_k_stride,
+                                                int64_t b_n_stride);
+  // the weights [oc, kh, kw, ic] of a float conv, the output of const op
+  // `op`, packed by pack_conv_weights() for `algo`
+  std::shared_ptr<const ConvWeights> get_conv_weights(const xir::Op* op,
+                                                      const ConvShape& s,
+                                                      ConvAlgo algo,
+                                                      const float* weights);
+
+ private:
+  template <typename T>
+  std::shared_ptr<const GemmPackedB> get_or_pack(const xir::Op* op,
+                                                 const T* B, int64_t N,
+                                                 int64_t K, int64_t b_k_stride,
+                                                 int64_t b_n_stride);
+
+ private:
+  std::mutex mtx_;
+  // key: weights op, int32 or float, N, K, b_k_stride, b_n_stride
+  std::map<std::tuple<const xir::Op*, bool, int64_t, int64_t, int64_t, int64_t>,
+           std::weak_ptr<const GemmPackedB>>
+      gemm_b_;
+  // key: weights op, algorithm, oc, kh, kw, ic
+  std::map<std::tuple<const xir::Op*, ConvAlgo, int64_t, int64_t, int64_t,
+                      int64_t>,
+           std::weak_ptr<const ConvWeights>>
+      conv_weights_;
+};
+
+}  // namespace cpu
+}  // namespace vart
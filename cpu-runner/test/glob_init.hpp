@@ -163,7 +163,7 @@ private:
   void cmd_helper() {
     cout << argv_[0] << " usage:" << endl
       << "\t-x xmodel run mode(cpu/sim/dpu)" << endl
-      << "\t-c cpu run mode(0/1/2/3)" << endl
+      << "\t-c cpu run mode(0/1/2/3/4)" << endl
       << "\t-m model name" << endl
       << "\t-i input name" << endl
       << "\t-f input random flag" << endl
@@ -171,7 +171,7 @@ private:
       << "\t-v version" << endl
       << "\t-h help" << endl
       << "\t--xmodel_run_mode run mode(cpu/sim/dpu)" << endl
-      << "\t--cpu_run_mode run mode(0/1/2/3)" << endl
+      << "\t--cpu_run_mode run mode(0/1/2/3/4)" << endl
       << "\t--model_name model name" << endl
       << "\t--input_name input name" << endl
       << "\t--random_flag input random flag" << endl
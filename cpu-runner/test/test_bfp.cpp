@@ -0,0 +1,338 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// check LaunchBFPCPUKernel() and LaunchBFPPrimeCPUKernel() against the
+// per value kernels they used to run, for every round mode, bit widths 9
+// to 24 and a range of block and sub-block sizes, with zeros of both
+// signs, subnormals, Inf and NaN among the values, on every instruction
+// set the cpu supports, then compare their throughput per bit width.
+//
+// usage: test_bfp [num_of_values] [num_of_runs]
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "gemm.hpp"
+
+using namespace std;
+using vart::cpu::GemmIsa;
+
+namespace vart {
+namespace cpu {
+void LaunchBFPCPUKernel(const float* input, float* output, int n, int bit_width,
+                        int block_size, int rounding_mode);
+void LaunchBFPPrimeCPUKernel(const float* input, float* output, const int n,
+                             const int bit_width, const int block_size,
+                             const int sub_block_size,
+                             const int sub_block_shift_bits,
+                             const int rounding_mode);
+}  // namespace cpu
+}  // namespace vart
+
+// the kernels of bfp_kernel.cpp
+static uint32_t float_as_uint(float x) {
+  uint32_t uint_x;
+  memcpy(&uint_x, &x, sizeof(float));
+  return uint_x;
+}
+
+static uint32_t exponent(float v) {
+  return (float_as_uint(v) & 0x7f800000) >> 23;
+}
+
+static uint32_t max_exponent(const float* input, int n) {
+  uint32_t max_exp = 0;
+  for (int i = 0; i < n; i++) {
+    max_exp = std::max(max_exp, exponent(input[i]));
+  }
+  return max_exp;
+}
+
+static float dpu_round(float x) {
+  return ((x < 0) && (x - floor(x) == 0.5)) ? std::ceil(x) : std::round(x);
+}
+
+static float py3_round(float x) {
+  float x_floor = std::floor(x);
+  float diff = x - x_floor;
+  if (diff > 0.5)
+    return x_floor + 1;
+  else if (diff == 0.5)
+    return (int)x_floor % 2 == 1 || (int)x_floor % 2 == -1 ? x_floor + 1
+                                                           : x_floor;
+  else
+    return x_floor;
+}
+
+static float round_mode(float x, int rounding_mode) {
+  switch (rounding_mode) {
+    case 0:
+      return std::round(x);
+    case 1:
+      return dpu_round(x);
+    case 2:
+      return py3_round(x);
+  }
+  return 0.f;
+}
+
+static void ref_bfp(const float* input, float* output, int n, int index,
+                    int bit_width, int rounding_mode) {
+  uint32_t shared_exp = 0;
+  for (int i = index; i < n; i++) {
+    uint32_t exp = exponent(input[i]);
+    if (exp == 0xff) {
+      exp = 0;
+    }
+    if (exp > shared_exp) {
+      shared_exp = exp;
+    }
+  }
+  int shared_exp_value = static_cast<int>(shared_exp) - 127;
+  int m_bits = bit_width - 9;
+  float scale = std::pow(2.0, shared_exp_value - (m_bits - 1));
+  for (int i = index; i < n; i++) {
+    if (exponent(input[i]) == shared_exp) {
+      float x = round_mode(input[i] / scale, rounding_mode);
+      if (x >= 128 || x < -128) {
+        shared_exp += 1;
+        shared_exp_value += 1;
+        scale *= 2.0;
+        break;
+      }
+    }
+  }
+  float max_v = std::pow(2.0, shared_exp_value) * (std::pow(2.0, m_bits) - 1);
+  float min_v = -std::pow(2.0, shared_exp_value) * (std::pow(2.0, m_bits));
+  for (int i = index; i < n; i++) {
+    if (exponent(input[i]) == 0xff) {
+      output[i] = input[i];
+    } else {
+      float x = round_mode(input[i] / scale, rounding_mode) * scale;
+      output[i] = std::max(min_v, std::min(x, max_v));
+    }
+  }
+}
+
+static uint32_t round_bits(int sign, uint32_t x, uint32_t num_tail_bits,
+                           uint32_t upper_bound, int rounding_mode) {
+  if (num_tail_bits == 0) return x;
+  if (num_tail_bits > 25) return 0;
+  uint32_t half = 1 << (num_tail_bits - 1);
+  uint32_t tail = x & ((1 << num_tail_bits) - 1);
+  uint32_t ret = x >> num_tail_bits;
+  if (ret == upper_bound) return ret;
+  if (tail < half) return ret;
+  if (tail > half) return ret + 1;
+  switch (rounding_mode) {
+    case 0:
+      return ret + 1;
+    case 1:
+      return sign == -1 ? ret : ret + 1;
+    case 2:
+      return (x >> num_tail_bits) % 2 == 1 ? ret + 1 : ret;
+  }
+  return ret;
+}
+
+static void ref_bfp_prime(const float* input, float* output, int offset,
+                          int bit_width, int block_size, int sub_block_size,
+                          int sub_block_shift_bits, int rounding_mode) {
+  const uint32_t m_float = 23;
+  const uint32_t m_bfp = bit_width - 9;
+  const uint32_t exp_bias = 127;
+  uint32_t shared_exp = max_exponent(input + offset, block_size);
+  for (int i = 0; i < block_size / sub_block_size; i++) {
+    uint32_t max_sub_exp =
+        max_exponent(input + offset + i * sub_block_size, sub_block_size);
+    uint32_t shift;
+    uint32_t shift_upper_bound = (1 << sub_block_shift_bits) - 1;
+    if (shared_exp - max_sub_exp > shift_upper_bound) {
+      shift = shift_upper_bound;
+    } else {
+      shift = shared_exp - max_sub_exp;
+    }
+    for (int j = 0; j < sub_block_size; j++) {
+      auto idx = offset + i * sub_block_size + j;
+      uint32_t input_x = float_as_uint(input[idx]);
+      uint32_t exp = (input_x & 0x7f800000) >> m_float;
+      uint32_t mantissa;
+      if (exp == 0) {
+        mantissa = 0;
+      } else {
+        mantissa = (input_x & 0x7fffff) | (1 << m_float);
+      }
+      uint32_t num_bits_shifting =
+          shared_exp - shift - exp + m_float - m_bfp + 1;
+      int sign = input_x & 0x80000000 ? -1 : 1;
+      mantissa = round_bits(sign, mantissa, num_bits_shifting,
+                            ((1 << (m_bfp + 1)) - 1), rounding_mode);
+      if (shared_exp == 0xff) {
+        uint32_t nan = 0x7fffffff;
+        memcpy(&output[idx], &nan, sizeof(float));
+      } else {
+        output[idx] = sign *
+                      std::pow(2.0, static_cast<int>(shared_exp - exp_bias -
+                                                     shift + 1 - m_bfp)) *
+                      static_cast<int>(mantissa);
+      }
+    }
+  }
+}
+
+static void ref_launch_bfp(const float* input, float* output, int n,
+                           int bit_width, int block_size, int rounding_mode) {
+  for (int index = 0; index < n / block_size; index++) {
+    ref_bfp(input, output, index * block_size + block_size,
+            index * block_size, bit_width, rounding_mode);
+  }
+}
+
+static void ref_launch_bfp_prime(const float* input, float* output, int n,
+                                 int bit_width, int block_size,
+                                 int sub_block_size, int sub_block_shift_bits,
+                                 int rounding_mode) {
+  for (int index = 0; index < n / block_size; index++) {
+    ref_bfp_prime(input, output, index * block_size, bit_width, block_size,
+                  sub_block_size, sub_block_shift_bits, rounding_mode);
+  }
+}
+
+// values whose exponents spread over a few binades, as activations and
+// weights do, with exact ties, zeros, subnormals, Inf and NaN sprinkled in
+static vector<float> random_data(mt19937& gen, int n, bool specials) {
+  vector<float> data(n);
+  uniform_real_distribution<float> mantissa(0.5f, 1.0f);
+  uniform_int_distribution<int> exp(-12, 4), kind(0, 99);
+  for (auto& d : data) {
+    auto k = kind(gen);
+    d = ldexp(mantissa(gen), exp(gen)) * (gen() % 2 ? 1 : -1);
+    if (k < 10) {
+      d = ldexp(round(ldexp(d, 9)) + 0.5f, -9 + exp(gen) % 3);
+    } else if (k < 13) {
+      d = gen() % 2 ? 0.f : -0.f;
+    } else if (k < 15) {
+      d = numeric_limits<float>::denorm_min() * (float)(gen() % 1000);
+    } else if (specials && k == 15) {
+      d = gen() % 2 ? numeric_limits<float>::infinity()
+                    : -numeric_limits<float>::infinity();
+    } else if (specials && k == 16) {
+      d = numeric_limits<float>::quiet_NaN();
+    }
+  }
+  return data;
+}
+
+static bool check(mt19937& gen) {
+  auto block_size = 1 << (gen() % 6);
+  auto n = block_size * (1 + gen() % 40) + gen() % block_size;
+  auto bit_width = 9 + (int)(gen() % 16);
+  auto rounding_mode = (int)(gen() % 3);
+  auto in = random_data(gen, n, gen() % 4 == 0);
+  vector<float> ref(n), out(n);
+  ref_launch_bfp(in.data(), ref.data(), n, bit_width, block_size,
+                 rounding_mode);
+  vart::cpu::LaunchBFPCPUKernel(in.data(), out.data(), n, bit_width,
+                                block_size, rounding_mode);
+  if (memcmp(ref.data(), out.data(), n * sizeof(float)) != 0) {
+    return false;
+  }
+  auto sub_block_size = 1 << (gen() % 4);
+  auto sub_block_shift_bits = (int)(gen() % 4);
+  fill(ref.begin(), ref.end(), 0.f);
+  fill(out.begin(), out.end(), 0.f);
+  ref_launch_bfp_prime(in.data(), ref.data(), n, bit_width, block_size,
+                       sub_block_size, sub_block_shift_bits, rounding_mode);
+  vart::cpu::LaunchBFPPrimeCPUKernel(in.data(), out.data(), n, bit_width,
+                                     block_size, sub_block_size,
+                                     sub_block_shift_bits, rounding_mode);
+  return memcmp(ref.data(), out.data(), n * sizeof(float)) == 0;
+}
+
+static double measure_ms(const function<void()>& f, int num_of_runs) {
+  f();
+  auto start = chrono::steady_clock::now();
+  for (auto r = 0; r < num_of_runs; ++r) {
+    f();
+  }
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - start)
+             .count() /
+         num_of_runs;
+}
+
+int main(int argc, char* argv[]) {
+  auto n = argc >= 2 ? stoi(argv[1]) : 1 << 20;
+  auto num_of_runs = argc >= 3 ? stoi(argv[2]) : 5;
+
+  auto best = vart::cpu::get_gemm_isa();
+  mt19937 gen(123);
+  for (auto i = 0; i <= (int)best; ++i) {
+    vart::cpu::set_gemm_isa((GemmIsa)i);
+    auto ok = true;
+    for (auto t = 0; t < 2000 && ok; ++t) {
+      ok = check(gen);
+    }
+    if (!ok) {
+      cout << "FAIL: " << vart::cpu::get_gemm_isa_name((GemmIsa)i)
+           << " differs from the per value kernels" << endl;
+      return 1;
+    }
+  }
+
+  vart::cpu::set_gemm_isa(best);
+  cout << "isa " << vart::cpu::get_gemm_isa_name(best) << endl;
+  auto in = random_data(gen, n, false);
+  vector<float> out(n);
+  auto mvalues = n / 1e3;
+  for (auto bit_width : {9, 12, 13, 16}) {
+    for (auto mode : {1, 2}) {
+      auto ref_ms = measure_ms(
+          [&] { ref_launch_bfp(in.data(), out.data(), n, bit_width, 8, mode); },
+          num_of_runs);
+      auto ms = measure_ms(
+          [&] {
+            vart::cpu::LaunchBFPCPUKernel(in.data(), out.data(), n, bit_width,
+                                          8, mode);
+          },
+          num_of_runs);
+      auto ref_prime_ms = measure_ms(
+          [&] {
+            ref_launch_bfp_prime(in.data(), out.data(), n, bit_width, 16, 2,
+                                 1, mode);
+          },
+          num_of_runs);
+      auto prime_ms = measure_ms(
+          [&] {
+            vart::cpu::LaunchBFPPrimeCPUKernel(in.data(), out.data(), n,
+                                               bit_width, 16, 2, 1, mode);
+          },
+          num_of_runs);
+      cout << "bfp" << bit_width << (mode == 1 ? " dpu_round" : " py3_round")
+           << " (Mvalues/s): block 8 " << mvalues / ref_ms << " -> "
+           << mvalues / ms << ", prime block 16/2 " << mvalues / ref_prime_ms
+           << " -> " << mvalues / prime_ms << endl;
+    }
+  }
+  cout << "PASS" << endl;
+  return 0;
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// check that the merged loops of make_broadcast() visit the same input
+// elements as per element index arithmetic, and fix_shift() rounds as the
+// round modes of cpu_util.hpp do, then compare the bandwidth of an add
+// for the common broadcast kinds.
+//
+// usage: test_broadcast [N] [H] [W] [C] [num_of_runs]
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "broadcast.hpp"
+
+using namespace std;
+using vart::cpu::Broadcast;
+using vart::cpu::FixRound;
+
+// position in `in` of output element `pos`, the way the ops used to do
+static int64_t naive_pos(const vector<int>& out, const vector<int>& in,
+                         int64_t pos) {
+  auto offset = out.size() - in.size();
+  int64_t in_pos = 0;
+  int64_t in_stride = 1;
+  for (auto d = out.size(); d-- > 0u;) {
+    auto coord = pos % out[d];
+    pos /= out[d];
+    if (d >= offset) {
+      in_pos += (coord % in[d - offset]) * in_stride;
+      in_stride *= in[d - offset];
+    }
+  }
+  return in_pos;
+}
+
+static bool check_loops(mt19937& gen) {
+  auto nd = 1 + gen() % 5;
+  vector<int> out(nd);
+  for (auto& d : out) {
+    d = 1 + gen() % 5;
+  }
+  vector<vector<int>> in(1 + gen() % 3);
+  for (auto& v : in) {
+    v.assign(out.begin() + gen() % nd, out.end());
+    for (auto& d : v) {
+      d = gen() % 2 ? d : 1;
+    }
+  }
+  auto bc = vart::cpu::make_broadcast(out, in);
+  auto ok = true;
+  for (auto i = 0u; i < in.size(); ++i) {
+    for (auto pos = 0; pos < bc.num; ++pos) {
+      ok = ok && bc.input_pos(i, pos) == naive_pos(out, in[i], pos);
+    }
+  }
+  // every split point of the runs
+  for (auto begin = 0; begin < bc.num; ++begin) {
+    int64_t end = begin + gen() % (bc.num - begin + 1);
+    int64_t next = begin;
+    vart::cpu::for_each_run(
+        bc, begin, end,
+        [&](int64_t pos, const int64_t* in_pos, const int64_t* in_step,
+            int64_t len) {
+          ok = ok && pos == next && len > 0;
+          for (auto j = 0; j < len; ++j) {
+            for (auto i = 0u; i < in.size(); ++i) {
+              ok = ok && in_step[i] <= 1 &&
+                   in_pos[i] + j * in_step[i] ==
+                       naive_pos(out, in[i], pos + j);
+            }
+          }
+          next = pos + len;
+        });
+    ok = ok && next == end;
+  }
+  return ok;
+}
+
+static bool check_kinds() {
+  auto kind = [](vector<int> out, vector<int> in) {
+    auto bc = vart::cpu::make_broadcast(out, {out, in});
+    return bc.kinds[1];
+  };
+  auto dims = [](vector<int> out, vector<int> in) {
+    return vart::cpu::make_broadcast(out, {out, in}).dims.size();
+  };
+  return kind({2, 3, 4, 5}, {2, 3, 4, 5}) == Broadcast::SAME &&
+         dims({2, 3, 4, 5}, {2, 3, 4, 5}) == 1u &&
+         kind({2, 3, 4, 5}, {1}) == Broadcast::SCALAR &&
+         kind({2, 3, 4, 5}, {5}) == Broadcast::ROW &&
+         dims({2, 3, 4, 5}, {1, 1, 1, 5}) == 2u &&
+         kind({2, 3, 4, 5}, {3, 1, 1}) == Broadcast::CHANNEL &&
+         dims({2, 3, 4, 5}, {3, 1, 1}) == 3u &&
+         kind({1, 3, 4, 5}, {3, 1, 1}) == Broadcast::CHANNEL &&
+         dims({1, 3, 4, 5}, {3, 1, 1}) == 2u &&
+         kind({2, 3, 4, 5}, {2, 1, 4, 1}) == Broadcast::GENERAL;
+}
+
+// round_normal() of t / 2^shift as a double
+static int64_t ref_round(int64_t t, int shift, FixRound r, int64_t lo,
+                         int64_t hi) {
+  auto v = std::ldexp((double)t, -shift);
+  double q;
+  if (r == FixRound::HALF_UP) {
+    q = (v < 0 && v - floor(v) == 0.5) ? ceil(v) : round(v);
+  } else {
+    q = nearbyint(v);
+  }
+  return (int64_t)std::min(std::max(q, (double)lo), (double)hi);
+}
+
+static bool check_fix_shift(mt19937& gen) {
+  auto ok = true;
+  for (auto n = 0; n < 100000; ++n) {
+    auto shift = (int)(gen() % 12);
+    int32_t t = (int32_t)(gen() % 40001) - 20000;
+    ok = ok && vart::cpu::fix_shift<FixRound::HALF_UP, int32_t>(
+                   t, shift, -128, 127) ==
+                   ref_round(t, shift, FixRound::HALF_UP, -128, 127);
+    ok = ok && vart::cpu::fix_shift<FixRound::HALF_EVEN, int64_t>(
+                   t, shift, -128, 127) ==
+                   ref_round(t, shift, FixRound::HALF_EVEN, -128, 127);
+  }
+  return ok;
+}
+
+static double measure_ms(const function<void()>& f, int num_of_runs) {
+  f();
+  auto start = chrono::steady_clock::now();
+  for (auto r = 0; r < num_of_runs; ++r) {
+    f();
+  }
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - start)
+             .count() /
+         num_of_runs;
+}
+
+int main(int argc, char* argv[]) {
+  auto N = argc >= 2 ? stoi(argv[1]) : 1;
+  auto H = argc >= 3 ? stoi(argv[2]) : 56;
+  auto W = argc >= 4 ? stoi(argv[3]) : 56;
+  auto C = argc >= 5 ? stoi(argv[4]) : 256;
+  auto num_of_runs = argc >= 6 ? stoi(argv[5]) : 10;
+
+  mt19937 gen(123);
+  auto ok = check_kinds() && check_fix_shift(gen);
+  for (auto t = 0; t < 300 && ok; ++t) {
+    ok = check_loops(gen);
+  }
+  if (!ok) {
+    cout << "FAIL: broadcast loops or rounding differ" << endl;
+    return 1;
+  }
+
+  vector<int> out = {N, H, W, C};
+  vector<float> a(N * H * W * C, 1.0f), c(a.size());
+  vector<float> b(a.size(), 2.0f);
+  cout << N << "x" << H << "x" << W << "x" << C << " float add" << endl;
+  for (auto in_b : vector<vector<int>>{out, {1}, {C}, {N, 1, 1, C}}) {
+    auto bc = vart::cpu::make_broadcast(out, {out, in_b});
+    auto bytes = (2 * bc.num + bc.input_num(1)) * sizeof(float);
+    auto naive_ms = measure_ms(
+        [&] {
+          for (auto i = 0; i < bc.num; ++i) {
+            c[i] = a[naive_pos(out, out, i)] + b[naive_pos(out, in_b, i)];
+          }
+        },
+        num_of_runs);
+    auto ms = measure_ms(
+        [&] {
+          vart::cpu::parallel_for_elementwise(
+              bc.num, [&](int64_t begin, int64_t end) {
+                vart::cpu::broadcast_binary(
+                    bc, a.data(), b.data(), c.data(), begin, end,
+                    [](float x, float y) { return x + y; });
+              });
+        },
+        num_of_runs);
+    cout.width(9);
+    cout << left
+         << string(vart::cpu::get_broadcast_kind_name(bc.kinds[1])) + ":"
+         << "index arithmetic " << bytes / naive_ms / 1e6 << " GB/s, "
+         << bc.dims.size() << " loops " << bytes / ms / 1e6 << " GB/s"
+         << endl;
+  }
+  cout << "PASS" << endl;
+  return 0;
+}
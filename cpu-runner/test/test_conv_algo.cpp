@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// check conv_float() against the loops of ConvBase::conv_one(): IM2COL
+// and DIRECT bit exact, Winograd within a tolerance of a double precision
+// conv, on every instruction set the cpu supports, and that the default
+// pick is bit exact, then print a table of the time of each algorithm,
+// and of the one select_conv_algo() picks, on the 3x3 and 1x1 convs of
+// ResNet-50 and VGG-16.
+//
+// usage: test_conv_algo [num_of_runs]
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "conv_algo.hpp"
+
+using namespace std;
+using vart::cpu::ConvAlgo;
+using vart::cpu::ConvShape;
+using vart::cpu::GemmIsa;
+
+// the loops of conv_one() with group 1
+template <typename T>
+static void ref_conv(const ConvShape& s, const float* in, const float* w,
+                     T* out) {
+  for (auto n = 0; n < s.n; n++) {
+    for (auto y = 0; y < s.oh; y++) {
+      for (auto x = 0; x < s.ow; x++) {
+        for (auto o = 0; o < s.oc; o++) {
+          T acc = 0;
+          for (auto h = 0; h < s.kh; ++h) {
+            for (auto k = 0; k < s.kw; ++k) {
+              auto* pi = in + ((n * s.ih + y * s.sh + h) * s.iw + x * s.sw +
+                               k) * s.ic;
+              auto* pw = w + ((o * s.kh + h) * s.kw + k) * s.ic;
+              for (auto c = 0; c < s.ic; ++c) {
+                acc += (T)pi[c] * (T)pw[c];
+              }
+            }
+          }
+          out[((n * s.oh + y) * s.ow + x) * s.oc + o] = acc;
+        }
+      }
+    }
+  }
+}
+
+static ConvShape make_shape(int64_t n, int64_t h, int64_t w, int64_t ic,
+                            int64_t oc, int64_t k, int64_t s) {
+  // padded as ConvBase pads a SAME conv
+  auto oh = (h + s - 1) / s, ow = (w + s - 1) / s;
+  return ConvShape{n, (oh - 1) * s + k, (ow - 1) * s + k, ic, oh, ow, oc, k,
+                   k, s, s};
+}
+
+static vector<float> random_data(mt19937& gen, size_t size) {
+  uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  vector<float> v(size);
+  for (auto& x : v) {
+    x = dist(gen);
+  }
+  return v;
+}
+
+// max |out - ref| over max |ref| allowed for each algorithm, F(4x4, 3x3)
+// multiplies by up to 8 and 5 in its transforms and loses more bits
+static double tolerance(ConvAlgo algo) {
+  switch (algo) {
+    case ConvAlgo::WINOGRAD_2X2:
+      return 1e-5;
+    case ConvAlgo::WINOGRAD_4X4:
+      return 1e-4;
+    default:
+      return 0;
+  }
+}
+
+static bool check(mt19937& gen, const ConvShape& s, ConvAlgo algo) {
+  auto in = random_data(gen, s.n * s.ih * s.iw * s.ic);
+  auto weights = random_data(gen, s.oc * s.kh * s.kw * s.ic);
+  vector<float> ref(s.n * s.oh * s.ow * s.oc), out(ref.size(), -1.0f);
+  auto w = vart::cpu::pack_conv_weights(s, algo, weights.data());
+  vart::cpu::conv_float(s, w, in.data(), out.data(), true);
+  if (tolerance(algo) == 0) {
+    ref_conv(s, in.data(), weights.data(), ref.data());
+    return memcmp(ref.data(), out.data(), ref.size() * sizeof(float)) == 0;
+  }
+  vector<double> exact(ref.size());
+  ref_conv(s, in.data(), weights.data(), exact.data());
+  double max_ref = 0, max_err = 0;
+  for (auto i = 0u; i < exact.size(); ++i) {
+    max_ref = max(max_ref, fabs(exact[i]));
+    max_err = max(max_err, fabs(out[i] - exact[i]));
+  }
+  return max_err <= tolerance(algo) * max_ref;
+}
+
+static double measure_ms(const function<void()>& f, int num_of_runs) {
+  f();
+  auto start = chrono::steady_clock::now();
+  for (auto r = 0; r < num_of_runs; ++r) {
+    f();
+  }
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - start)
+             .count() /
+         num_of_runs;
+}
+
+int main(int argc, char* argv[]) {
+  auto num_of_runs = argc >= 2 ? stoi(argv[1]) : 3;
+
+  const ConvAlgo algos[] = {ConvAlgo::IM2COL, ConvAlgo::DIRECT,
+                            ConvAlgo::WINOGRAD_2X2, ConvAlgo::WINOGRAD_4X4};
+  auto best = vart::cpu::get_gemm_isa();
+  mt19937 gen(123);
+  vector<ConvShape> shapes;
+  for (auto k : {1, 3}) {
+    for (auto s : {1, 2}) {
+      for (auto c : {3, 17, 40}) {
+        shapes.push_back(make_shape(2, 9, 11, c, 2 * c + 5, k, s));
+      }
+    }
+  }
+  shapes.push_back(make_shape(1, 13, 7, 24, 70, 5, 1));
+  shapes.push_back(make_shape(1, 20, 20, 64, 64, 3, 1));
+  shapes.push_back(ConvShape{1, 10, 12, 8, 4, 5, 9, 3, 3, 2, 1});
+  for (auto i = 0; i <= (int)best; ++i) {
+    vart::cpu::set_gemm_isa((GemmIsa)i);
+    for (const auto& s : shapes) {
+      for (auto algo : algos) {
+        if (vart::cpu::conv_algo_supports(s, algo) && !check(gen, s, algo)) {
+          cout << "FAIL: " << vart::cpu::get_conv_algo_name(algo) << " on "
+               << vart::cpu::get_gemm_isa_name((GemmIsa)i) << ", " << s.oh
+               << "x" << s.ow << "x" << s.ic << " -> " << s.oc << " kernel "
+               << s.kh << " stride " << s.sh << endl;
+          return 1;
+        }
+      }
+    }
+  }
+
+  // run modes 0-2 are the reference, only the env may make them inexact
+  if (getenv("XLNX_CPU_RUNNER_CONV_ALGO") == nullptr) {
+    for (const auto& s : shapes) {
+      auto algo = vart::cpu::select_conv_algo(s);
+      if (algo != ConvAlgo::IM2COL && algo != ConvAlgo::DIRECT) {
+        cout << "FAIL: " << vart::cpu::get_conv_algo_name(algo)
+             << " is selected by default" << endl;
+        return 1;
+      }
+    }
+  }
+
+  vart::cpu::set_gemm_isa(best);
+  cout << "isa " << vart::cpu::get_gemm_isa_name(best) << ", ms per conv"
+       << endl;
+  cout << left << setw(22) << "shape" << right << setw(9) << "loops";
+  for (auto algo : algos) {
+    cout << setw(14) << vart::cpu::get_conv_algo_name(algo);
+  }
+  cout << "  selected" << endl;
+  struct Layer {
+    int64_t h, w, ic, oc, k, s;
+  };
+  for (const auto& l : vector<Layer>{{224, 224, 3, 64, 3, 1},
+                                     {224, 224, 64, 64, 3, 1},
+                                     {112, 112, 3, 32, 3, 2},
+                                     {56, 56, 64, 64, 3, 1},
+                                     {56, 56, 64, 256, 1, 1},
+                                     {28, 28, 128, 128, 3, 1},
+                                     {28, 28, 256, 128, 3, 2},
+                                     {14, 14, 256, 256, 3, 1},
+                                     {7, 7, 512, 512, 3, 1},
+                                     {7, 7, 512, 2048, 1, 1}}) {
+    auto s = make_shape(1, l.h, l.w, l.ic, l.oc, l.k, l.s);
+    auto in = random_data(gen, s.n * s.ih * s.iw * s.ic);
+    auto weights = random_data(gen, s.oc * s.kh * s.kw * s.ic);
+    vector<float> out(s.n * s.oh * s.ow * s.oc);
+    auto loops_ms = measure_ms(
+        [&] { ref_conv(s, in.data(), weights.data(), out.data()); }, 1);
+    cout << left << setw(22)
+         << to_string(l.h) + "x" + to_string(l.w) + "x" + to_string(l.ic) +
+                " " + to_string(l.k) + "x" + to_string(l.k) + "/" +
+                to_string(l.s) + " " + to_string(l.oc)
+         << right << fixed << setprecision(2) << setw(9) << loops_ms;
+    for (auto algo : algos) {
+      if (!vart::cpu::conv_algo_supports(s, algo)) {
+        cout << setw(14) << "-";
+        continue;
+      }
+      auto w = vart::cpu::pack_conv_weights(s, algo, weights.data());
+      cout << setw(14)
+           << measure_ms(
+                  [&] {
+                    vart::cpu::conv_float(s, w, in.data(), out.data(), true);
+                  },
+                  num_of_runs);
+    }
+    cout << "  "
+         << vart::cpu::get_conv_algo_name(vart::cpu::select_conv_algo(s))
+         << endl;
+  }
+  cout << "PASS" << endl;
+  return 0;
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// check that gemm() gives bit exact results with the plain loops for
+// every instruction set the cpu supports, with B as it is or packed
+// ahead, then compare their speed, and what packing the weights once
+// saves on the first and on later runs.
+//
+// usage: test_gemm [M] [N] [K] [num_of_runs]
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "gemm.hpp"
+
+using namespace std;
+using vart::cpu::GemmIsa;
+
+// the loops gemm() replaces, B is [N, K] or [K, N]
+template <typename T, typename D>
+static void ref_gemm(const T* A, const T* B, D* C, int64_t M, int64_t N,
+                     int64_t K, int64_t b_k_stride, int64_t b_n_stride) {
+  for (auto m = 0; m < M; ++m) {
+    for (auto n = 0; n < N; ++n) {
+      D acc = 0;
+      for (auto k = 0; k < K; ++k) {
+        acc += A[m * K + k] * B[k * b_k_stride + n * b_n_stride];
+      }
+      C[m * N + n] = acc;
+    }
+  }
+}
+
+template <typename T>
+static vector<T> random_data(mt19937& gen, size_t size, int range) {
+  vector<T> v(size);
+  uniform_int_distribution<int> dist(-range, range);
+  for (auto& x : v) {
+    x = (T)dist(gen);
+    if (is_floating_point<T>::value) {
+      x = x / 7.0f;
+    }
+  }
+  return v;
+}
+
+template <typename T, typename D>
+static bool check(mt19937& gen, int64_t M, int64_t N, int64_t K, bool nk,
+                  int range) {
+  auto A = random_data<T>(gen, M * K, range);
+  auto B = random_data<T>(gen, K * N, range);
+  auto b_k_stride = nk ? 1 : N;
+  auto b_n_stride = nk ? K : 1;
+  vector<D> ref(M * N), out(M * N, D(-1));
+  ref_gemm(A.data(), B.data(), ref.data(), M, N, K, b_k_stride, b_n_stride);
+  vart::cpu::gemm(A.data(), B.data(), out.data(), M, N, K, b_k_stride,
+                  b_n_stride);
+  auto ok = memcmp(ref.data(), out.data(), ref.size() * sizeof(D)) == 0;
+  auto packed = vart::cpu::pack_gemm_b(B.data(), N, K, b_k_stride, b_n_stride);
+  fill(out.begin(), out.end(), D(-1));
+  vart::cpu::gemm(A.data(), packed, out.data(), M);
+  return ok && memcmp(ref.data(), out.data(), ref.size() * sizeof(D)) == 0;
+}
+
+static double measure_ms(const function<void()>& f, int num_of_runs) {
+  f();
+  auto start = chrono::steady_clock::now();
+  for (auto r = 0; r < num_of_runs; ++r) {
+    f();
+  }
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - start)
+             .count() /
+         num_of_runs;
+}
+
+int main(int argc, char* argv[]) {
+  auto M = argc >= 2 ? stol(argv[1]) : 784l;
+  auto N = argc >= 3 ? stol(argv[2]) : 64l;
+  auto K = argc >= 4 ? stol(argv[3]) : 576l;
+  auto num_of_runs = argc >= 5 ? stoi(argv[4]) : 5;
+
+  auto best = vart::cpu::get_gemm_isa();
+  mt19937 gen(123);
+  const vector<vector<int64_t>> shapes = {
+      {1, 1, 1},   {1, 1, 0},     {5, 3, 1},    {7, 33, 5},
+      {13, 17, 19}, {6, 32, 255}, {100, 70, 300}, {97, 129, 517}};
+  for (auto i = 0; i <= (int)best; ++i) {
+    vart::cpu::set_gemm_isa((GemmIsa)i);
+    auto ok = true;
+    for (const auto& s : shapes) {
+      for (auto nk : {true, false}) {
+        ok = ok && check<float, float>(gen, s[0], s[1], s[2], nk, 1000);
+        ok = ok && check<int32_t, int32_t>(gen, s[0], s[1], s[2], nk, 128);
+        ok = ok && check<int32_t, int32_t>(gen, s[0], s[1], s[2], nk, 32767);
+        ok = ok && check<int32_t, int32_t>(gen, s[0], s[1], s[2], nk, 100000);
+        ok = ok && check<int32_t, float>(gen, s[0], s[1], s[2], nk, 128);
+      }
+    }
+    if (!ok) {
+      cout << "FAIL: " << vart::cpu::get_gemm_isa_name((GemmIsa)i)
+           << " differs from the loops" << endl;
+      return 1;
+    }
+  }
+
+  auto fa = random_data<float>(gen, M * K, 1000);
+  auto fb = random_data<float>(gen, K * N, 1000);
+  auto ia = random_data<int32_t>(gen, M * K, 128);
+  auto ib = random_data<int32_t>(gen, K * N, 128);
+  vector<float> fc(M * N);
+  vector<int32_t> ic(M * N);
+  auto gops = [&](double ms) { return 2.0 * M * N * K / ms / 1e6; };
+
+  cout << M << "x" << N << "x" << K << ", B as [N, K]" << endl;
+  auto f_ms = measure_ms(
+      [&] { ref_gemm(fa.data(), fb.data(), fc.data(), M, N, K, 1, K); },
+      num_of_runs);
+  auto i_ms = measure_ms(
+      [&] { ref_gemm(ia.data(), ib.data(), ic.data(), M, N, K, 1, K); },
+      num_of_runs);
+  cout << "loops:       " << gops(f_ms) << " GFLOPS, " << gops(i_ms)
+       << " GOPS" << endl;
+  for (auto i = 0; i <= (int)best; ++i) {
+    vart::cpu::set_gemm_isa((GemmIsa)i);
+    f_ms = measure_ms(
+        [&] {
+          vart::cpu::gemm(fa.data(), fb.data(), fc.data(), M, N, K, 1, K);
+        },
+        num_of_runs);
+    i_ms = measure_ms(
+        [&] {
+          vart::cpu::gemm(ia.data(), ib.data(), ic.data(), M, N, K, 1, K);
+        },
+        num_of_runs);
+    cout.width(13);
+    cout << left << string(vart::cpu::get_gemm_isa_name((GemmIsa)i)) + ":"
+         << gops(f_ms) << " GFLOPS, " << gops(i_ms) << " GOPS" << endl;
+  }
+
+  // weights packed once, as WeightCache does, against packing every run
+  vart::cpu::set_gemm_isa(best);
+  auto first_ms = [&](const function<void()>& f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() -
+                                           start)
+        .count();
+  };
+  vart::cpu::GemmPackedB packed;
+  auto pack_ms = first_ms([&] {
+    packed = vart::cpu::pack_gemm_b(ib.data(), N, K, 1, K);
+  });
+  auto unpacked_ms = measure_ms(
+      [&] { vart::cpu::gemm(ia.data(), ib.data(), ic.data(), M, N, K, 1, K); },
+      num_of_runs);
+  auto packed_ms = measure_ms(
+      [&] { vart::cpu::gemm(ia.data(), packed, ic.data(), M); }, num_of_runs);
+  cout << "int32 weights packed every run: " << unpacked_ms << "ms per run"
+       << endl
+       << "int32 weights packed once:      " << pack_ms << "ms to pack, "
+       << packed_ms << "ms per run" << endl;
+  cout << "PASS" << endl;
+  return 0;
+}
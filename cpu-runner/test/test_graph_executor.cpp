@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// check that run_graph runs every node once and after its inputs, then
+// compare it with running the nodes in order, on a chain of inception
+// like blocks: four branches of 1, 2, 3 and 1 nodes with different
+// costs, joined by a concat. dedup_deps is checked on a const which is
+// in front of both branches reading it.
+//
+// usage: test_graph_executor [num_of_workers] [num_of_blocks]
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "graph_executor.hpp"
+
+using namespace std;
+
+// what an op does, cost is roughly proportional to the time
+static float work(uint64_t cost) {
+  volatile float x = 0.0f;
+  for (auto i = 0u; i < cost; ++i) {
+    x = x + std::sqrt((float)i);
+  }
+  return x;
+}
+
+static void make_inception(int num_of_blocks, vector<vector<size_t>>* deps,
+                           vector<uint64_t>* cost) {
+  auto add = [&](vector<size_t> d, uint64_t c) {
+    deps->push_back(std::move(d));
+    cost->push_back(c);
+    return deps->size() - 1u;
+  };
+  auto last = add({}, 1000u);
+  for (auto b = 0; b < num_of_blocks; ++b) {
+    auto b0 = add({last}, 40000u);
+    auto b1 = add({add({last}, 10000u)}, 60000u);
+    auto b2 = add({add({add({last}, 10000u)}, 30000u)}, 30000u);
+    auto b3 = add({last}, 5000u);
+    last = add({b0, b1, b2, b3}, 1000u);
+  }
+}
+
+// c is a const read by both branches a and b, CPURunner puts it in front
+// of each of them: x c a c b d, where x is the input of a and b, and d
+// joins them. c must run once, before a and b, and d after both.
+static int test_shared_const(size_t num_of_workers) {
+  const vector<string> order = {"x", "c", "a", "c", "b", "d"};
+  const map<string, vector<string>> inputs = {
+      {"x", {}},         {"c", {}}, {"a", {"x", "c"}},
+      {"b", {"x", "c"}}, {"d", {"a", "b"}}};
+  vector<size_t> nodes;
+  auto deps = vart::cpu::dedup_deps(
+      order, [&](const string& key) { return inputs.at(key); }, &nodes);
+  if (nodes != vector<size_t>{0u, 1u, 2u, 4u, 5u}) {
+    cout << "FAIL: const is not kept at its first copy" << endl;
+    return 1;
+  }
+  map<string, int> runs;
+  mutex mtx;
+  auto num_of_errors = 0;
+  vart::cpu::run_graph(
+      deps, vector<uint64_t>(nodes.size(), 1u),
+      [&](size_t i) {
+        lock_guard<mutex> lock(mtx);
+        const auto& key = order[nodes[i]];
+        for (const auto& input : inputs.at(key)) {
+          if (runs[input] != 1) {
+            num_of_errors++;
+          }
+        }
+        runs[key]++;
+      },
+      num_of_workers);
+  for (const auto& key : order) {
+    if (runs[key] != 1) {
+      num_of_errors++;
+    }
+  }
+  if (num_of_errors != 0) {
+    cout << "FAIL: shared const, " << num_of_errors
+         << " ops ran out of order or more than once" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  auto num_of_workers = argc >= 2 ? stoul(argv[1]) : 4u;
+  auto num_of_blocks = argc >= 3 ? stoi(argv[2]) : 20;
+
+  if (test_shared_const(num_of_workers) != 0) {
+    return 1;
+  }
+
+  vector<vector<size_t>> deps;
+  vector<uint64_t> cost;
+  make_inception(num_of_blocks, &deps, &cost);
+  auto n = deps.size();
+
+  // every node once, after all its inputs
+  vector<atomic<int>> state(n);
+  for (auto& s : state) {
+    s = 0;
+  }
+  atomic<int> num_of_errors{0};
+  vart::cpu::run_graph(
+      deps, cost,
+      [&](size_t i) {
+        for (auto d : deps[i]) {
+          if (state[d] != 2) {
+            num_of_errors++;
+          }
+        }
+        if (state[i].exchange(1) != 0) {
+          num_of_errors++;
+        }
+        work(cost[i] / 100u);
+        state[i] = 2;
+      },
+      num_of_workers);
+  for (auto& s : state) {
+    if (s != 2) {
+      num_of_errors++;
+    }
+  }
+  if (num_of_errors != 0) {
+    cout << "FAIL: " << num_of_errors << " nodes ran out of order" << endl;
+    return 1;
+  }
+
+  // an exception stops the graph and comes back to the caller
+  atomic<size_t> num_of_runs{0u};
+  try {
+    vart::cpu::run_graph(
+        deps, cost,
+        [&](size_t i) {
+          num_of_runs++;
+          if (i == n / 2u) {
+            throw std::runtime_error("node failed");
+          }
+        },
+        num_of_workers);
+    cout << "FAIL: exception is lost" << endl;
+    return 1;
+  } catch (const std::runtime_error&) {
+  }
+  if (num_of_runs == n) {
+    cout << "FAIL: graph goes on after an exception" << endl;
+    return 1;
+  }
+
+  auto measure_ms = [&](size_t workers, const vector<uint64_t>& priority) {
+    auto start = chrono::steady_clock::now();
+    vart::cpu::run_graph(
+        deps, priority, [&](size_t i) { work(cost[i]); }, workers);
+    return chrono::duration<double, milli>(chrono::steady_clock::now() -
+                                           start)
+        .count();
+  };
+  auto serial = measure_ms(1u, cost);
+  auto unweighted = measure_ms(num_of_workers, vector<uint64_t>(n, 0u));
+  auto weighted = measure_ms(num_of_workers, cost);
+  auto path = vart::cpu::critical_path(deps, cost);
+  uint64_t total = 0u;
+  for (auto c : cost) {
+    total += c;
+  }
+
+  cout << n << " nodes, " << num_of_workers << " workers, "
+       << "available parallelism " << (double)total / path[0] << endl
+       << "serial:                     " << serial << "ms" << endl
+       << "graph, by path length:      " << unweighted << "ms" << endl
+       << "graph, critical path first: " << weighted << "ms" << endl
+       << "PASS" << endl;
+  return 0;
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// check that plan_offsets never lets blocks which are alive at the same
+// time overlap, then run a chain of residual blocks, each op reading the
+// previous output, once with a buffer per tensor and once in a planned
+// arena, and compare memory and time.
+//
+// usage: test_memory_plan [num_of_blocks] [tensor_kb] [num_of_runs]
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "memory_plan.hpp"
+
+using namespace std;
+using vart::cpu::mem_block_t;
+using vart::cpu::plan_offsets;
+
+static int check(const vector<mem_block_t>& blocks,
+                 const vector<size_t>& offsets, size_t arena_size) {
+  auto num_of_errors = 0;
+  for (auto a = 0u; a < blocks.size(); ++a) {
+    if (offsets[a] + blocks[a].size > arena_size) {
+      num_of_errors++;
+    }
+    for (auto b = a + 1u; b < blocks.size(); ++b) {
+      auto alive = blocks[a].first <= blocks[b].last &&
+                   blocks[b].first <= blocks[a].last;
+      auto overlap = offsets[a] < offsets[b] + blocks[b].size &&
+                     offsets[b] < offsets[a] + blocks[a].size;
+      if (alive && overlap) {
+        num_of_errors++;
+      }
+    }
+  }
+  return num_of_errors;
+}
+
+// conv, relu, conv, add with the block input
+static vector<mem_block_t> make_residual(int num_of_blocks, size_t size) {
+  vector<mem_block_t> blocks;
+  blocks.push_back({size, 0u, 1u});
+  size_t in = 0u;
+  for (auto b = 0; b < num_of_blocks; ++b) {
+    auto i = blocks[in].first;
+    blocks[in].last = i + 4u;
+    blocks.push_back({size, i + 1u, i + 2u});
+    blocks.push_back({size, i + 2u, i + 3u});
+    blocks.push_back({size, i + 3u, i + 4u});
+    blocks.push_back({size, i + 4u, i + 5u});
+    in = blocks.size() - 1u;
+  }
+  return blocks;
+}
+
+int main(int argc, char* argv[]) {
+  auto num_of_blocks = argc >= 2 ? stoi(argv[1]) : 16;
+  auto tensor_kb = argc >= 3 ? stoul(argv[2]) : 256u;
+  auto num_of_runs = argc >= 4 ? stoi(argv[3]) : 20;
+  const size_t alignment = 4096u;
+
+  mt19937 gen(123);
+  for (auto t = 0; t < 100; ++t) {
+    vector<mem_block_t> blocks;
+    auto n = 1u + gen() % 64u;
+    for (auto i = 0u; i < n; ++i) {
+      auto first = (size_t)(gen() % 100u);
+      blocks.push_back({1u + gen() % 100000u, first, first + gen() % 20u});
+    }
+    size_t arena_size = 0u;
+    auto offsets = plan_offsets(blocks, alignment, &arena_size);
+    if (check(blocks, offsets, arena_size) != 0) {
+      cout << "FAIL: live blocks overlap" << endl;
+      return 1;
+    }
+  }
+
+  auto size = tensor_kb * 1024u;
+  auto blocks = make_residual(num_of_blocks, size);
+  size_t arena_size = 0u;
+  auto offsets = plan_offsets(blocks, alignment, &arena_size);
+  if (check(blocks, offsets, arena_size) != 0) {
+    cout << "FAIL: live blocks overlap" << endl;
+    return 1;
+  }
+
+  // op k writes the block which starts at k, from the blocks it reads
+  auto num = size / sizeof(float);
+  auto run = [&](const vector<float*>& ptrs) {
+    for (auto k = 1u; k < blocks.size(); ++k) {
+      auto* out = ptrs[k];
+      const auto* in = ptrs[k - 1u];
+      const auto* res = (k % 4u == 0u) ? ptrs[k - 4u] : nullptr;
+      for (auto i = 0u; i < num; ++i) {
+        auto v = in[i] * 0.5f + 1.0f;
+        out[i] = res != nullptr ? v + res[i] : v;
+      }
+    }
+  };
+  auto measure_ms = [&](const vector<float*>& ptrs) {
+    run(ptrs);
+    auto start = chrono::steady_clock::now();
+    for (auto r = 0; r < num_of_runs; ++r) {
+      run(ptrs);
+    }
+    return chrono::duration<double, milli>(chrono::steady_clock::now() -
+                                           start)
+               .count() /
+           num_of_runs;
+  };
+
+  vector<vector<float>> naive(blocks.size(), vector<float>(num, 1.0f));
+  vector<float*> naive_ptrs;
+  for (auto& b : naive) {
+    naive_ptrs.push_back(b.data());
+  }
+  vector<float> arena(arena_size / sizeof(float), 1.0f);
+  vector<float*> planned_ptrs;
+  for (auto o : offsets) {
+    planned_ptrs.push_back(arena.data() + o / sizeof(float));
+  }
+
+  auto naive_ms = measure_ms(naive_ptrs);
+  auto planned_ms = measure_ms(planned_ptrs);
+  cout << blocks.size() << " tensors of " << tensor_kb << "KB" << endl
+       << "naive:   " << blocks.size() * size / 1024u << "KB, " << naive_ms
+       << "ms" << endl
+       << "planned: " << arena_size / 1024u << "KB, " << planned_ms << "ms"
+       << endl
+       << "PASS" << endl;
+  return 0;
+}
@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// check max_pool() and sum_pool() against the loops of MaxPool and
+// AvgPool, and reduce_axes() against the in place reductions of
+// ReduceBase, for int32, float and double, with NaNs and zeros of both
+// signs among the floats, on every instruction set the cpu supports,
+// then compare their speed on the pooling and reduction layers of
+// detector heads.
+//
+// usage: test_pool_reduce [num_of_runs]
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "gemm.hpp"
+#include "pool.hpp"
+#include "reduce.hpp"
+
+using namespace std;
+using vart::cpu::GemmIsa;
+using vart::cpu::Pool;
+using vart::cpu::ReduceOp;
+
+// the loops of max_pool_one() and acc_pool_one()
+template <typename T>
+static void ref_pool(const Pool& p, bool is_max, const T* in, T* out) {
+  for (auto n = 0; n < p.n; n++) {
+    for (auto y = 0; y < p.oh; y++) {
+      for (auto x = 0; x < p.ow; x++) {
+        T* o = out + ((n * p.oh + y) * p.ow + x) * p.c;
+        fill_n(o, p.c, is_max ? numeric_limits<T>::lowest() : T(0));
+        for (auto h = 0; h < p.kh; h++) {
+          for (auto w = 0; w < p.kw; w++) {
+            if (y * p.sh + h >= p.ih || x * p.sw + w >= p.iw) continue;
+            const T* s =
+                in + ((n * p.ih + y * p.sh + h) * p.iw + x * p.sw + w) * p.c;
+            for (auto c = 0; c < p.c; c++) {
+              if (is_max) {
+                if (o[c] < s[c]) o[c] = s[c];
+              } else {
+                o[c] += s[c];
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// ReduceBase::run() with the calculate() of the reduce ops
+template <typename T>
+static void ref_reduce(ReduceOp op, const vector<int>& dims,
+                       const vector<int>& axes, const T* in, T* out) {
+  vector<int64_t> cod(dims.size(), 1);
+  for (auto d = (int)dims.size() - 1; d-- > 0;) {
+    cod[d] = cod[d + 1] * dims[d + 1];
+  }
+  auto num = accumulate(dims.begin(), dims.end(), int64_t(1),
+                        multiplies<int64_t>());
+  vector<T> buf(in, in + num);
+  for (auto idx : axes) {
+    for (auto i = 0; i < num / (dims[idx] * cod[idx]); i++) {
+      T* prlt = buf.data() + i * dims[idx] * cod[idx];
+      for (auto j = 1; j < dims[idx]; j++) {
+        T* pcur = prlt + j * cod[idx];
+        for (auto k = 0; k < cod[idx]; k++) {
+          if (op == ReduceOp::MAX) {
+            prlt[k] = std::max(prlt[k], pcur[k]);
+          } else if (op == ReduceOp::MIN) {
+            prlt[k] = std::min(prlt[k], pcur[k]);
+          } else if (op == ReduceOp::SUM) {
+            prlt[k] += pcur[k];
+          } else {
+            prlt[k] *= pcur[k];
+          }
+        }
+      }
+    }
+  }
+  auto out_dims = dims;
+  for (auto idx : axes) {
+    out_dims[idx] = 1;
+  }
+  auto out_num = accumulate(out_dims.begin(), out_dims.end(), int64_t(1),
+                            multiplies<int64_t>());
+  for (int64_t pos = 0; pos < out_num; pos++) {
+    int64_t src = 0, rest = pos;
+    for (auto d = (int)dims.size() - 1; d >= 0; d--) {
+      src += rest % out_dims[d] * cod[d];
+      rest /= out_dims[d];
+    }
+    out[pos] = buf[src];
+  }
+}
+
+template <typename T>
+static vector<T> random_data(mt19937& gen, size_t size, bool specials) {
+  vector<T> v(size);
+  for (auto& x : v) {
+    auto i = (int)(gen() % 256) - 128;
+    if constexpr (is_floating_point<T>::value) {
+      x = i / T(37);
+      auto u = gen() % 64;
+      if (specials && u == 0) {
+        x = numeric_limits<T>::quiet_NaN();
+      } else if (specials && u < 8) {
+        x = u % 2 ? T(0) : -T(0);
+      }
+    } else {
+      // products of small numbers, so that not all of them overflow
+      x = gen() % 2 ? i % 3 : i;
+    }
+  }
+  return v;
+}
+
+template <typename T>
+static bool same(const vector<T>& a, const vector<T>& b) {
+  return a.size() == b.size() &&
+         memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+template <typename T>
+static bool check_pool(mt19937& gen, const Pool& p) {
+  auto in = random_data<T>(gen, p.n * p.ih * p.iw * p.c, true);
+  vector<T> ref(p.n * p.oh * p.ow * p.c), out(ref.size(), T(-1));
+  ref_pool(p, true, in.data(), ref.data());
+  vart::cpu::max_pool(p, in.data(), out.data(), true);
+  auto ok = same(ref, out);
+  // sums of NaNs are NaNs of either sign, no specials for them
+  in = random_data<T>(gen, in.size(), false);
+  ref_pool(p, false, in.data(), ref.data());
+  vart::cpu::sum_pool(p, in.data(), out.data(), true);
+  return ok && same(ref, out);
+}
+
+template <typename T>
+static bool check_reduce(mt19937& gen) {
+  auto nd = 1 + gen() % 4;
+  vector<int> dims(nd), axes;
+  for (auto& d : dims) {
+    d = 1 + gen() % 9;
+  }
+  if (gen() % 4 == 0) {
+    // long enough for whole vectors of lanes
+    dims[gen() % nd] = 70 + gen() % 200;
+  }
+  for (auto d = 0; d < (int)nd; ++d) {
+    if (gen() % 2) {
+      axes.push_back(d);
+    }
+  }
+  shuffle(axes.begin(), axes.end(), gen);
+  auto num = accumulate(dims.begin(), dims.end(), 1, multiplies<int>());
+  auto ok = true;
+  for (auto op : {ReduceOp::MAX, ReduceOp::MIN, ReduceOp::SUM,
+                  ReduceOp::PROD}) {
+    auto in = random_data<T>(gen, num, op == ReduceOp::MAX ||
+                                           op == ReduceOp::MIN);
+    vector<T> ref(num), out(num, T(-1));
+    ref_reduce(op, dims, axes, in.data(), ref.data());
+    vart::cpu::reduce_axes(op, dims, axes, in.data(), out.data(), true);
+    auto out_num = num;
+    for (auto a : axes) {
+      out_num /= dims[a];
+    }
+    ok = ok && memcmp(ref.data(), out.data(), out_num * sizeof(T)) == 0;
+  }
+  return ok;
+}
+
+static double measure_ms(const function<void()>& f, int num_of_runs) {
+  f();
+  auto start = chrono::steady_clock::now();
+  for (auto r = 0; r < num_of_runs; ++r) {
+    f();
+  }
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - start)
+             .count() /
+         num_of_runs;
+}
+
+// padded as PoolBase pads a SAME pooling
+static Pool make_pool(int64_t h, int64_t w, int64_t c, int64_t k, int64_t s) {
+  auto oh = (h + s - 1) / s, ow = (w + s - 1) / s;
+  return Pool{1, (oh - 1) * s + k, (ow - 1) * s + k, c, oh, ow, k, k, s, s};
+}
+
+int main(int argc, char* argv[]) {
+  auto num_of_runs = argc >= 2 ? stoi(argv[1]) : 5;
+
+  auto best = vart::cpu::get_gemm_isa();
+  mt19937 gen(123);
+  vector<Pool> pools;
+  for (auto k : {2, 3, 5}) {
+    for (auto s : {1, 2}) {
+      for (auto c : {1, 5, 32, 45}) {
+        pools.push_back(make_pool(7, 9, c, k, s));
+      }
+    }
+  }
+  // special pad past the input, and global poolings
+  pools.push_back(Pool{2, 7, 8, 19, 4, 4, 3, 3, 2, 2});
+  pools.push_back(Pool{2, 7, 8, 3, 1, 1, 7, 8, 1, 1});
+  pools.push_back(Pool{1, 9, 9, 77, 1, 1, 9, 9, 1, 1});
+  for (auto i = 0; i <= (int)best; ++i) {
+    vart::cpu::set_gemm_isa((GemmIsa)i);
+    auto ok = true;
+    for (const auto& p : pools) {
+      ok = ok && check_pool<float>(gen, p) && check_pool<double>(gen, p) &&
+           check_pool<int32_t>(gen, p);
+    }
+    for (auto t = 0; t < 300 && ok; ++t) {
+      ok = check_reduce<float>(gen) && check_reduce<double>(gen) &&
+           check_reduce<int32_t>(gen);
+    }
+    if (!ok) {
+      cout << "FAIL: " << vart::cpu::get_gemm_isa_name((GemmIsa)i)
+           << " differs from the loops" << endl;
+      return 1;
+    }
+  }
+
+  vart::cpu::set_gemm_isa(best);
+  cout << "isa " << vart::cpu::get_gemm_isa_name(best) << endl;
+  struct PoolLayer {
+    const char* name;
+    Pool p;
+    bool is_max;
+  };
+  for (const auto& l : vector<PoolLayer>{
+           {"global avgpool 7x7x2048", Pool{1, 7, 7, 2048, 1, 1, 7, 7, 1, 1},
+            false},
+           {"maxpool 3x3 s2 112x112x64", make_pool(112, 112, 64, 3, 2), true},
+           {"spp maxpool 5x5 13x13x512", make_pool(13, 13, 512, 5, 1), true},
+           {"spp maxpool 9x9 13x13x512", make_pool(13, 13, 512, 9, 1), true},
+           {"spp maxpool 13x13 13x13x512", make_pool(13, 13, 512, 13, 1),
+            true},
+           {"avgpool 3x3 s1 35x35x192", make_pool(35, 35, 192, 3, 1),
+            false}}) {
+    const auto& p = l.p;
+    auto in = random_data<float>(gen, p.n * p.ih * p.iw * p.c, false);
+    vector<float> out(p.n * p.oh * p.ow * p.c);
+    auto ref_ms = measure_ms(
+        [&] { ref_pool(p, l.is_max, in.data(), out.data()); }, num_of_runs);
+    auto ms = measure_ms(
+        [&] {
+          if (l.is_max) {
+            vart::cpu::max_pool(p, in.data(), out.data(), true);
+          } else {
+            vart::cpu::sum_pool(p, in.data(), out.data(), true);
+          }
+        },
+        num_of_runs);
+    cout << l.name << ": loops " << ref_ms << "ms, pool " << ms << "ms"
+         << endl;
+  }
+  struct ReduceLayer {
+    const char* name;
+    ReduceOp op;
+    vector<int> dims;
+    vector<int> axes;
+  };
+  for (const auto& l : vector<ReduceLayer>{
+           {"mean over HW 20x20x256", ReduceOp::SUM, {1, 20, 20, 256}, {1, 2}},
+           {"max over C 80x80x85", ReduceOp::MAX, {1, 80, 80, 85}, {3}},
+           {"sum over C 80x80x85", ReduceOp::SUM, {1, 80, 80, 85}, {3}},
+           {"max over HW 40x40x255", ReduceOp::MAX, {1, 40, 40, 255}, {1, 2}},
+       }) {
+    auto num = accumulate(l.dims.begin(), l.dims.end(), 1, multiplies<int>());
+    auto in = random_data<float>(gen, num, false);
+    vector<float> out(num);
+    auto ref_ms = measure_ms(
+        [&] { ref_reduce(l.op, l.dims, l.axes, in.data(), out.data()); },
+        num_of_runs);
+    auto ms = measure_ms(
+        [&] {
+          vart::cpu::reduce_axes(l.op, l.dims, l.axes, in.data(), out.data(),
+                                 true);
+        },
+        num_of_runs);
+    cout << l.name << ": loops " << ref_ms << "ms, reduce " << ms << "ms"
+         << endl;
+  }
+  cout << "PASS" << endl;
+  return 0;
+}
@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// check that the int32 pipeline of qlinear-conv2d, im2col, gemm() with
+// packed weights and requantize(), gives bit exact results with the
+// per element loops of q_linear_conv2d.cpp for every instruction set the
+// cpu supports, then compare their speed on a few layer shapes.
+//
+// usage: test_qlinear_conv [num_of_runs]
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "gemm.hpp"
+#include "requantize.hpp"
+
+using namespace std;
+using vart::cpu::GemmIsa;
+
+// round_even() of q_linear_conv2d.cpp
+static int32_t ref_round_even(int64_t n, int shift, int32_t data_max,
+                              int32_t data_min) {
+  int64_t mask = 1LL << (shift - 1);
+  int32_t integer_part = static_cast<int32_t>(n >> shift);
+  if (n & mask) {
+    int64_t fractional_mask = mask - 1;
+    if (!(n & fractional_mask)) {
+      if (integer_part % 2) {
+        integer_part++;
+      }
+    } else {
+      integer_part++;
+    }
+  }
+  if (integer_part > data_max) integer_part = data_max;
+  if (integer_part < data_min) integer_part = data_min;
+  return integer_part;
+}
+
+static int32_t ref_requantize(const vart::cpu::Requantize& q, int32_t acc,
+                              int64_t c, int64_t r) {
+  int64_t tmp =
+      q.mul * acc + (q.row_add ? q.row_add[r] : 0) + q.add[c];
+  if (q.relu && tmp < 0) tmp = 0;
+  return ref_round_even(tmp + q.post, q.shift, q.hi, q.lo);
+}
+
+static bool check_requantize(mt19937& gen) {
+  auto rows = 1 + gen() % 7, channels = 1 + gen() % 70;
+  uniform_int_distribution<int32_t> i32(INT32_MIN, INT32_MAX);
+  uniform_int_distribution<int64_t> i40(-(1LL << 40), 1LL << 40);
+  vector<int32_t> acc(rows * channels), out(acc.size());
+  vector<int64_t> add(channels), row_add(rows);
+  for (auto& x : acc) {
+    // many ties and values close to the clamp bounds
+    x = gen() % 2 ? i32(gen) : (int32_t)(gen() % 512) - 256;
+  }
+  for (auto& x : add) x = gen() % 2 ? i40(gen) : (int64_t)(gen() % 64) - 32;
+  for (auto& x : row_add) x = i40(gen);
+  vart::cpu::Requantize q;
+  q.mul = gen() % 2 ? i32(gen) : (int64_t)(gen() % 5) - 2;
+  q.add = add.data();
+  q.row_add = gen() % 2 ? row_add.data() : nullptr;
+  q.relu = gen() % 2;
+  q.post = i40(gen);
+  q.shift = 1 + gen() % 40;
+  q.lo = gen() % 2 ? -128 : INT32_MIN;
+  q.hi = gen() % 2 ? 127 : INT32_MAX;
+  vart::cpu::requantize(q, acc.data(), channels, out.data(), channels, rows,
+                        channels);
+  for (auto r = 0u; r < rows; ++r) {
+    for (auto c = 0u; c < channels; ++c) {
+      if (out[r * channels + c] !=
+          ref_requantize(q, acc[r * channels + c], c, r)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+struct Layer {
+  int64_t h, w, ic, oc, k, s;
+};
+
+// padded NHWC input, [oc, k, k, ic] weights, one image
+struct Conv {
+  Layer l;
+  int64_t oh, ow;
+  vector<int32_t> in, weights;
+  int32_t zw;
+  vart::cpu::Requantize q;
+  vector<int64_t> add;
+};
+
+// the per element loops of qlinearconv2d_conv() and fix()
+static void ref_conv(const Conv& cv, int32_t* out) {
+  auto& l = cv.l;
+  vector<int64_t> row_add(cv.oh * cv.ow);
+  for (auto h = 0; h < cv.oh; ++h) {
+    for (auto w = 0; w < cv.ow; ++w) {
+      int32_t ifm = 0;
+      for (auto kh = 0; kh < l.k; ++kh) {
+        for (auto kw = 0; kw < l.k; ++kw) {
+          auto* src = &cv.in[((h * l.s + kh) * l.w + w * l.s + kw) * l.ic];
+          for (auto c = 0; c < l.ic; ++c) ifm += src[c];
+        }
+      }
+      row_add[h * cv.ow + w] = -cv.q.mul * cv.zw * ifm;
+      for (auto oc = 0; oc < l.oc; ++oc) {
+        int64_t acc = 0;
+        for (auto kh = 0; kh < l.k; ++kh) {
+          for (auto kw = 0; kw < l.k; ++kw) {
+            auto* src = &cv.in[((h * l.s + kh) * l.w + w * l.s + kw) * l.ic];
+            auto* wts = &cv.weights[((oc * l.k + kh) * l.k + kw) * l.ic];
+            for (auto c = 0; c < l.ic; ++c) acc += src[c] * wts[c];
+          }
+        }
+        auto q = cv.q;
+        q.row_add = row_add.data();
+        out[(h * cv.ow + w) * l.oc + oc] =
+            ref_requantize(q, (int32_t)acc, oc, h * cv.ow + w);
+      }
+    }
+  }
+}
+
+// what QLinearConv2d runs for int32 data without a matmul shift
+static void fast_conv(const Conv& cv, const vart::cpu::GemmPackedB& packed,
+                      vector<int32_t>& tmp, int32_t* out) {
+  auto& l = cv.l;
+  auto M = cv.oh * cv.ow, K = l.k * l.k * l.ic;
+  tmp.resize(M * K);
+  for (auto h = 0; h < cv.oh; ++h) {
+    for (auto w = 0; w < cv.ow; ++w) {
+      for (auto kh = 0; kh < l.k; ++kh) {
+        memcpy(&tmp[((h * cv.ow + w) * l.k + kh) * l.k * l.ic],
+               &cv.in[((h * l.s + kh) * l.w + w * l.s) * l.ic],
+               l.k * l.ic * sizeof(int32_t));
+      }
+    }
+  }
+  vart::cpu::gemm(tmp.data(), packed, out, M);
+  vector<int64_t> row_add;
+  auto q = cv.q;
+  if (cv.zw != 0) {
+    row_add.resize(M);
+    for (auto p = 0; p < M; ++p) {
+      int32_t sum = 0;
+      for (auto k = 0; k < K; ++k) sum += tmp[p * K + k];
+      row_add[p] = -cv.q.mul * cv.zw * sum;
+    }
+    q.row_add = row_add.data();
+  }
+  vart::cpu::requantize(q, out, l.oc, out, l.oc, M, l.oc);
+}
+
+static Conv make_conv(mt19937& gen, const Layer& l, bool relu) {
+  Conv cv;
+  cv.l = l;
+  cv.oh = (l.h - l.k) / l.s + 1;
+  cv.ow = (l.w - l.k) / l.s + 1;
+  cv.in.resize(l.h * l.w * l.ic);
+  cv.weights.resize(l.oc * l.k * l.k * l.ic);
+  for (auto& x : cv.in) x = (int32_t)(gen() % 256) - 128;
+  for (auto& x : cv.weights) x = (int32_t)(gen() % 256) - 128;
+  cv.zw = gen() % 2 ? 0 : (int32_t)(gen() % 16) - 8;
+  cv.add.resize(l.oc);
+  for (auto& x : cv.add) x = (int64_t)(gen() % (1 << 30)) - (1 << 29);
+  cv.q.mul = 1 + gen() % (1 << 20);
+  cv.q.add = cv.add.data();
+  cv.q.relu = relu;
+  cv.q.post = (int64_t)(gen() % 256 - 128) << 28;
+  cv.q.shift = 28;
+  cv.q.lo = -128;
+  cv.q.hi = 127;
+  return cv;
+}
+
+static double measure_ms(const function<void()>& f, int num_of_runs) {
+  f();
+  auto start = chrono::steady_clock::now();
+  for (auto r = 0; r < num_of_runs; ++r) {
+    f();
+  }
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - start)
+             .count() /
+         num_of_runs;
+}
+
+int main(int argc, char* argv[]) {
+  auto num_of_runs = argc >= 2 ? stoi(argv[1]) : 3;
+
+  auto best = vart::cpu::get_gemm_isa();
+  mt19937 gen(123);
+  const vector<Layer> small = {{1, 1, 1, 1, 1, 1},   {5, 7, 3, 9, 3, 1},
+                               {9, 9, 16, 17, 3, 2}, {6, 6, 33, 40, 1, 1},
+                               {8, 5, 7, 70, 2, 1},  {11, 13, 24, 8, 5, 2}};
+  for (auto i = 0; i <= (int)best; ++i) {
+    vart::cpu::set_gemm_isa((GemmIsa)i);
+    auto ok = true;
+    for (auto t = 0; t < 200 && ok; ++t) {
+      ok = check_requantize(gen);
+    }
+    for (const auto& l : small) {
+      for (auto relu : {false, true}) {
+        auto cv = make_conv(gen, l, relu);
+        auto packed = vart::cpu::pack_gemm_b(cv.weights.data(), l.oc,
+                                             l.k * l.k * l.ic, 1,
+                                             l.k * l.k * l.ic);
+        vector<int32_t> ref(cv.oh * cv.ow * l.oc), out(ref.size()), tmp;
+        ref_conv(cv, ref.data());
+        fast_conv(cv, packed, tmp, out.data());
+        ok = ok && ref == out;
+      }
+    }
+    if (!ok) {
+      cout << "FAIL: " << vart::cpu::get_gemm_isa_name((GemmIsa)i)
+           << " differs from the loops" << endl;
+      return 1;
+    }
+  }
+
+  vart::cpu::set_gemm_isa(best);
+  cout << "isa " << vart::cpu::get_gemm_isa_name(best) << endl;
+  const vector<Layer> layers = {{114, 114, 32, 64, 3, 2},
+                                {58, 58, 64, 64, 3, 1},
+                                {28, 28, 128, 256, 1, 1},
+                                {16, 16, 256, 256, 3, 1},
+                                {7, 7, 1024, 1000, 1, 1}};
+  for (const auto& l : layers) {
+    auto cv = make_conv(gen, l, true);
+    auto K = l.k * l.k * l.ic;
+    auto packed = vart::cpu::pack_gemm_b(cv.weights.data(), l.oc, K, 1, K);
+    vector<int32_t> out(cv.oh * cv.ow * l.oc), tmp;
+    auto gops = [&](double ms) {
+      return 2.0 * cv.oh * cv.ow * l.oc * K / ms / 1e6;
+    };
+    auto ref_ms = measure_ms([&] { ref_conv(cv, out.data()); }, num_of_runs);
+    auto ms = measure_ms([&] { fast_conv(cv, packed, tmp, out.data()); },
+                         num_of_runs);
+    cout << l.h << "x" << l.w << "x" << l.ic << " -> " << l.oc << ", " << l.k
+         << "x" << l.k << " s" << l.s << ": loops " << ref_ms << "ms ("
+         << gops(ref_ms) << " GOPS), gemm " << ms << "ms (" << gops(ms)
+         << " GOPS)" << endl;
+  }
+  cout << "PASS" << endl;
+  return 0;
+}
@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// check resample_nearest(), resample_bilinear() and
+// resample_bilinear_fix() against the per pixel loops of Resize and
+// ResizeBilinearFix, for up and down scales with every align_corners and
+// half_pixel_centers, int32, float and double, and each round mode, on
+// every instruction set the cpu supports, then compare their speed on the
+// upsampling layers of segmentation decoders.
+//
+// usage: test_resize [num_of_runs]
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "cpu_util.hpp"
+#include "gemm.hpp"
+#include "resample.hpp"
+
+using namespace std;
+using vart::cpu::GemmIsa;
+using vart::cpu::Resample;
+using vart::cpu::ResampleAxis;
+
+struct Shape {
+  int n, ih, iw, c, oh, ow;
+  bool align_corners;
+  bool half_pixel_centers;
+};
+
+// the coordinates of resize.cpp, in float, and resize_bilinear_fix.cpp,
+// in double
+template <typename F>
+static F cal_scale(int64_t in, int64_t out, bool align_corners) {
+  return (align_corners && out > 1) ? (in - 1) / static_cast<F>(out - 1)
+                                    : in / static_cast<F>(out);
+}
+
+template <typename F>
+static F scaler(int32_t out, F scale, bool half_pixel_centers, F bias) {
+  return half_pixel_centers ? (static_cast<F>(out) + 0.5f) * scale - bias
+                            : static_cast<F>(out) * scale;
+}
+
+static int64_t nearest_index(int i, int in_size, int out_size, bool align,
+                             bool half_pixel) {
+  auto in = scaler<float>(i, cal_scale<float>(in_size, out_size, align),
+                          half_pixel, 0.0f);
+  return min(align ? (int64_t)round(in) : (int64_t)floor(in),
+             (int64_t)in_size - 1);
+}
+
+template <typename F>
+struct Interpolation {
+  int lower;
+  int upper;
+  F lerp;
+};
+
+template <typename F>
+static Interpolation<F> linear_index(int i, int in_size, int out_size,
+                                     bool align, bool half_pixel) {
+  const F in =
+      scaler<F>(i, cal_scale<F>(in_size, out_size, align), half_pixel, 0.5);
+  return {max((int)floor(in), 0), min((int)ceil(in), in_size - 1),
+          in - floor(in)};
+}
+
+// the loops of Resize::resize()
+template <typename T>
+static void ref_nearest(const Shape& s, const T* in, T* out) {
+  for (int n = 0; n < s.n; ++n)
+    for (int h = 0; h < s.oh; ++h) {
+      auto hi = nearest_index(h, s.ih, s.oh, s.align_corners,
+                              s.half_pixel_centers);
+      for (int w = 0; w < s.ow; ++w) {
+        auto wi = nearest_index(w, s.iw, s.ow, s.align_corners,
+                                s.half_pixel_centers);
+        for (int c = 0; c < s.c; ++c) {
+          out[((n * s.oh + h) * s.ow + w) * s.c + c] =
+              in[((n * s.ih + hi) * s.iw + wi) * s.c + c];
+        }
+      }
+    }
+}
+
+template <typename T>
+static void ref_bilinear(const Shape& s, const T* in, float* out) {
+  for (int n = 0; n < s.n; ++n)
+    for (int h = 0; h < s.oh; ++h) {
+      auto y = linear_index<float>(h, s.ih, s.oh, s.align_corners,
+                                   s.half_pixel_centers);
+      for (int w = 0; w < s.ow; ++w) {
+        auto x = linear_index<float>(w, s.iw, s.ow, s.align_corners,
+                                     s.half_pixel_centers);
+        for (int c = 0; c < s.c; ++c) {
+          auto at = [&](int yi, int xi) {
+            return (float)in[((n * s.ih + yi) * s.iw + xi) * s.c + c];
+          };
+          const float top_left = at(y.lower, x.lower);
+          const float top_right = at(y.lower, x.upper);
+          const float bottom_left = at(y.upper, x.lower);
+          const float bottom_right = at(y.upper, x.upper);
+          const float top = top_left + (top_right - top_left) * x.lerp;
+          const float bottom =
+              bottom_left + (bottom_right - bottom_left) * x.lerp;
+          out[((n * s.oh + h) * s.ow + w) * s.c + c] =
+              top + (bottom - top) * y.lerp;
+        }
+      }
+    }
+}
+
+// the loops of ResizeBilinearFix::resize_bilinear_fix()
+template <typename T>
+static void ref_bilinear_fix(const Shape& s, const string& mode, int shift,
+                             const T* in, T* out) {
+  const int upshift_factor = 32768;
+  for (int n = 0; n < s.n; ++n)
+    for (int h = 0; h < s.oh; ++h) {
+      auto y = linear_index<double>(h, s.ih, s.oh, s.align_corners,
+                                    s.half_pixel_centers);
+      for (int w = 0; w < s.ow; ++w) {
+        auto x = linear_index<double>(w, s.iw, s.ow, s.align_corners,
+                                      s.half_pixel_centers);
+        for (int c = 0; c < s.c; ++c) {
+          auto at = [&](int yi, int xi) {
+            return (int)in[((n * s.ih + yi) * s.iw + xi) * s.c + c];
+          };
+          auto wgt_left = (uint16_t)std::round(
+              std::max(0.0, 1.0 - x.lerp) * upshift_factor);
+          auto wgt_right = (uint16_t)std::round(
+              std::max(0.0, 1.0 - std::abs(x.lerp - 1.0)) * upshift_factor);
+          auto wgt_top = (uint16_t)std::round(
+              std::max(0.0, 1.0 - y.lerp) * upshift_factor);
+          auto wgt_bottom = (uint16_t)std::round(
+              std::max(0.0, 1.0 - std::abs(y.lerp - 1.0)) * upshift_factor);
+          auto left = vart::cpu::round_normal<int16_t>(
+              mode, (double)(at(y.lower, x.lower) * wgt_top +
+                             at(y.upper, x.lower) * wgt_bottom) /
+                        pow(2., 8));
+          auto right = vart::cpu::round_normal<int16_t>(
+              mode, (double)(at(y.lower, x.upper) * wgt_top +
+                             at(y.upper, x.upper) * wgt_bottom) /
+                        pow(2., 8));
+          out[((n * s.oh + h) * s.ow + w) * s.c + c] =
+              vart::cpu::round_normal<T>(
+                  mode, (double)(left * wgt_left + right * wgt_right) /
+                            pow(2., 22 - shift));
+        }
+      }
+    }
+}
+
+// the tables the ops build
+static Resample make_nearest(const Shape& s) {
+  Resample r{s.n, s.ih, s.iw, s.c, s.oh, s.ow, {}, {}};
+  for (int i = 0; i < s.oh; ++i) {
+    r.ys.lower.push_back(nearest_index(i, s.ih, s.oh, s.align_corners,
+                                       s.half_pixel_centers));
+  }
+  for (int i = 0; i < s.ow; ++i) {
+    r.xs.lower.push_back(nearest_index(i, s.iw, s.ow, s.align_corners,
+                                       s.half_pixel_centers));
+  }
+  return r;
+}
+
+static Resample make_bilinear(const Shape& s, bool fix) {
+  Resample r{s.n, s.ih, s.iw, s.c, s.oh, s.ow, {}, {}};
+  auto axis = [&](int in_size, int out_size, ResampleAxis* a) {
+    for (int i = 0; i < out_size; ++i) {
+      if (fix) {
+        auto e = linear_index<double>(i, in_size, out_size, s.align_corners,
+                                      s.half_pixel_centers);
+        a->lower.push_back(e.lower);
+        a->upper.push_back(e.upper);
+        a->weight_lower.push_back(
+            (uint16_t)std::round(std::max(0.0, 1.0 - e.lerp) * 32768));
+        a->weight_upper.push_back((uint16_t)std::round(
+            std::max(0.0, 1.0 - std::abs(e.lerp - 1.0)) * 32768));
+      } else {
+        auto e = linear_index<float>(i, in_size, out_size, s.align_corners,
+                                     s.half_pixel_centers);
+        a->lower.push_back(e.lower);
+        a->upper.push_back(e.upper);
+        a->lerp.push_back(e.lerp);
+      }
+    }
+  };
+  axis(s.ih, s.oh, &r.ys);
+  axis(s.iw, s.ow, &r.xs);
+  return r;
+}
+
+template <typename T>
+static vector<T> random_data(mt19937& gen, size_t num) {
+  vector<T> data(num);
+  uniform_int_distribution<int> dist(-128, 127);
+  for (auto& d : data) {
+    if constexpr (std::is_integral<T>::value) {
+      d = (T)dist(gen);
+    } else {
+      d = (T)(dist(gen) * 0.37);
+    }
+  }
+  return data;
+}
+
+template <typename T>
+static bool check(mt19937& gen, const Shape& s) {
+  auto in = random_data<T>(gen, (size_t)s.n * s.ih * s.iw * s.c);
+  auto out_num = (size_t)s.n * s.oh * s.ow * s.c;
+  auto ok = true;
+
+  vector<T> ref(out_num), out(out_num);
+  ref_nearest(s, in.data(), ref.data());
+  vart::cpu::resample_nearest(make_nearest(s), in.data(), out.data(), true);
+  ok = ok && ref == out;
+
+  vector<float> ref_f(out_num), out_f(out_num);
+  auto bilinear = make_bilinear(s, false);
+  ref_bilinear(s, in.data(), ref_f.data());
+  vart::cpu::resample_bilinear(bilinear, in.data(), out_f.data(), true);
+  ok = ok && memcmp(ref_f.data(), out_f.data(), out_num * sizeof(float)) == 0;
+
+  auto fix = make_bilinear(s, true);
+  for (auto mode : {"STD_ROUND", "DPU_ROUND", "PY3_ROUND"}) {
+    for (auto shift : {0, -3, 5, 22, -10}) {
+      ref_bilinear_fix(s, mode, shift, in.data(), ref.data());
+      vart::cpu::resample_bilinear_fix(
+          fix,
+          vart::cpu::ResampleFix{8, 22 - shift, string(mode) != "DPU_ROUND"},
+          in.data(), out.data(), true);
+      ok = ok && memcmp(ref.data(), out.data(), out_num * sizeof(T)) == 0;
+    }
+  }
+  return ok;
+}
+
+static double measure_ms(const function<void()>& f, int num_of_runs) {
+  f();
+  auto start = chrono::steady_clock::now();
+  for (auto r = 0; r < num_of_runs; ++r) {
+    f();
+  }
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - start)
+             .count() /
+         num_of_runs;
+}
+
+int main(int argc, char* argv[]) {
+  auto num_of_runs = argc >= 2 ? stoi(argv[1]) : 5;
+
+  auto best = vart::cpu::get_gemm_isa();
+  mt19937 gen(123);
+  vector<Shape> shapes;
+  for (auto align : {false, true}) {
+    for (auto half_pixel : {false, true}) {
+      // both at once read past the input, as tf refuses them
+      if (align && half_pixel) {
+        continue;
+      }
+      for (auto c : {1, 3, 19, 40}) {
+        shapes.push_back({2, 5, 7, c, 10, 14, align, half_pixel});
+        shapes.push_back({1, 4, 4, c, 13, 11, align, half_pixel});
+        shapes.push_back({1, 9, 8, c, 4, 3, align, half_pixel});
+        shapes.push_back({2, 1, 6, c, 3, 1, align, half_pixel});
+      }
+    }
+  }
+  for (auto i = 0; i <= (int)best; ++i) {
+    vart::cpu::set_gemm_isa((GemmIsa)i);
+    auto ok = true;
+    for (const auto& s : shapes) {
+      ok = ok && check<float>(gen, s) && check<double>(gen, s) &&
+           check<int32_t>(gen, s);
+    }
+    if (!ok) {
+      cout << "FAIL: " << vart::cpu::get_gemm_isa_name((GemmIsa)i)
+           << " differs from the loops" << endl;
+      return 1;
+    }
+  }
+
+  vart::cpu::set_gemm_isa(best);
+  cout << "isa " << vart::cpu::get_gemm_isa_name(best) << endl;
+  struct Layer {
+    const char* name;
+    Shape s;
+  };
+  for (const auto& l : vector<Layer>{
+           {"deeplab x4 64x64x256", {1, 64, 64, 256, 256, 256, false, true}},
+           {"deeplab logits x4 128x128x21",
+            {1, 128, 128, 21, 512, 512, false, true}},
+           {"fpn x2 32x32x128", {1, 32, 32, 128, 64, 64, true, false}},
+           {"logits x8 64x64x19", {1, 64, 64, 19, 512, 512, false, true}}}) {
+    const auto& s = l.s;
+    auto out_num = (size_t)s.n * s.oh * s.ow * s.c;
+    auto mpix = s.n * s.oh * s.ow / 1e3;
+    auto in_f = random_data<float>(gen, (size_t)s.n * s.ih * s.iw * s.c);
+    auto in_i = random_data<int32_t>(gen, in_f.size());
+    vector<float> out_f(out_num);
+    vector<int32_t> out_i(out_num);
+    auto bilinear = make_bilinear(s, false);
+    auto fix = make_bilinear(s, true);
+    auto nearest = make_nearest(s);
+    auto ref_ms = measure_ms(
+        [&] { ref_bilinear(s, in_f.data(), out_f.data()); }, num_of_runs);
+    auto ms = measure_ms(
+        [&] {
+          vart::cpu::resample_bilinear(bilinear, in_f.data(), out_f.data(),
+                                       true);
+        },
+        num_of_runs);
+    auto ref_fix_ms = measure_ms(
+        [&] { ref_bilinear_fix(s, "DPU_ROUND", 0, in_i.data(), out_i.data()); },
+        num_of_runs);
+    auto fix_ms = measure_ms(
+        [&] {
+          vart::cpu::resample_bilinear_fix(
+              fix, vart::cpu::ResampleFix{8, 22, false}, in_i.data(),
+              out_i.data(), true);
+        },
+        num_of_runs);
+    auto ref_nearest_ms = measure_ms(
+        [&] { ref_nearest(s, in_f.data(), out_f.data()); }, num_of_runs);
+    auto nearest_ms = measure_ms(
+        [&] {
+          vart::cpu::resample_nearest(nearest, in_f.data(), out_f.data(),
+                                      true);
+        },
+        num_of_runs);
+    cout << l.name << " (Mpixel/s): bilinear loops " << mpix / ref_ms
+         << ", resample " << mpix / ms << "; fix loops " << mpix / ref_fix_ms
+         << ", resample " << mpix / fix_ms << "; nearest loops "
+         << mpix / ref_nearest_ms << ", resample " << mpix / nearest_ms
+         << endl;
+  }
+  cout << "PASS" << endl;
+  return 0;
+}
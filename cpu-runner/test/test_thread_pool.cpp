@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// check that parallel_for covers every iteration exactly once, then
+// compare it with the std::async batches which the ops used before, on
+// workloads of the size of small layers, e.g. 7x7x512 or 14x14x256.
+//
+// usage: test_thread_pool [cpu_num] [num_of_runs]
+
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "cpu_helper.hpp"
+#include "thread_pool.hpp"
+
+using namespace std;
+using vart::cpu::parallel_for;
+using vart::cpu::parallel_for_range;
+using vart::cpu::Schedule;
+
+// what a small elementwise or pooling op does per output position
+static void work(const float* in, float* out, int64_t begin, int64_t end) {
+  for (auto i = begin; i < end; ++i) {
+    out[i] = in[i] > 0.0f ? in[i] : in[i] * 0.1f;
+  }
+}
+
+template <typename F>
+static double measure_us(int num_of_runs, F f) {
+  auto start = chrono::steady_clock::now();
+  for (auto r = 0; r < num_of_runs; ++r) {
+    f();
+  }
+  return chrono::duration<double, micro>(chrono::steady_clock::now() - start)
+             .count() /
+         num_of_runs;
+}
+
+int main(int argc, char* argv[]) {
+  auto cpu_num = argc >= 2 ? stoi(argv[1]) : 4;
+  auto num_of_runs = argc >= 3 ? stoi(argv[2]) : 2000;
+  vart::cpu::set_cpu_num(cpu_num);
+  auto THREAD_NUM = (int64_t)CPU_NUM;
+  auto ok = true;
+
+  for (auto schedule : {Schedule::STATIC, Schedule::DYNAMIC}) {
+    auto n = 100003;
+    auto hits = vector<atomic<int>>(n);
+    parallel_for_range(
+        n,
+        [&hits](int64_t begin, int64_t end) {
+          for (auto i = begin; i < end; ++i) {
+            hits[i]++;
+          }
+        },
+        schedule, 100);
+    for (auto& h : hits) {
+      ok = ok && h.load() == 1;
+    }
+  }
+  auto nested = atomic<int>(0);
+  parallel_for(THREAD_NUM, [&nested, THREAD_NUM](int64_t) {
+    parallel_for(THREAD_NUM, [&nested](int64_t) { nested++; });
+  });
+  ok = ok && nested.load() == THREAD_NUM * THREAD_NUM;
+  auto thrown = false;
+  try {
+    parallel_for(THREAD_NUM, [](int64_t i) {
+      if (i == 0) {
+        throw runtime_error("test");
+      }
+    });
+  } catch (const runtime_error&) {
+    thrown = true;
+  }
+  ok = ok && thrown;
+
+  cout << "threads=" << vart::cpu::ThreadPool::instance().num_of_threads()
+       << " cpu_num=" << CPU_NUM << endl;
+  for (auto size : {7 * 7 * 512, 14 * 14 * 256, 28 * 28 * 128, 56 * 56 * 64}) {
+    auto in = vector<float>(size, -1.0f);
+    auto out = vector<float>(size);
+    auto THREAD_WORKLOAD = (size + THREAD_NUM - 1) / THREAD_NUM;
+    auto async_us = measure_us(num_of_runs, [&]() {
+      vector<future<void>> fut(THREAD_NUM);
+      for (auto i = 0; i < THREAD_NUM; i++) {
+        fut[i] = async(launch::async, [&, i]() {
+          work(in.data(), out.data(), i * THREAD_WORKLOAD,
+               min<int64_t>(size, (i + 1) * THREAD_WORKLOAD));
+        });
+      }
+      for (auto& f : fut) {
+        f.wait();
+      }
+    });
+    auto pool_us = measure_us(num_of_runs, [&]() {
+      parallel_for(THREAD_NUM, [&](int64_t i) {
+        work(in.data(), out.data(), i * THREAD_WORKLOAD,
+             min<int64_t>(size, (i + 1) * THREAD_WORKLOAD));
+      });
+    });
+    cout << fixed << setprecision(2) << "size=" << size
+         << " std::async=" << async_us << "us"
+         << " thread_pool=" << pool_us << "us"
+         << " speedup=" << async_us / pool_us << endl;
+  }
+  cout << (ok ? "PASS" : "FAIL") << endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,324 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// check transpose() against per element index arithmetic for random
+// permutes of 1, 4 and 8 byte elements and strided slices, and the
+// pixel-shuffle and reorg transposes against the loops of those ops, then
+// compare the bandwidth of NCHW <-> NHWC and pixel-shuffle with the
+// divide and modulo loop permute used to run.
+//
+// usage: test_transpose [N] [C] [H] [W] [num_of_runs]
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "transpose.hpp"
+
+using namespace std;
+
+// the loop of permute.cpp
+template <typename T>
+static void naive_permute(const vector<int>& shape, const vector<int>& order,
+                          const T* in, T* out) {
+  vector<int64_t> in_strides(shape.size(), 1), out_strides(shape.size(), 1);
+  for (auto d = (int)shape.size() - 1; d-- > 0;) {
+    in_strides[d] = in_strides[d + 1] * shape[d + 1];
+    out_strides[d] = out_strides[d + 1] * shape[order[d + 1]];
+  }
+  int64_t num = accumulate(shape.begin(), shape.end(), (int64_t)1,
+                           multiplies<int64_t>());
+  for (int64_t i = 0; i < num; ++i) {
+    int64_t out_pos = 0;
+    for (auto d = 0u; d < shape.size(); ++d) {
+      out_pos += i / in_strides[order[d]] % shape[order[d]] * out_strides[d];
+    }
+    out[out_pos] = in[i];
+  }
+}
+
+template <typename T>
+static bool check_permute(mt19937& gen) {
+  auto nd = 1 + gen() % 5;
+  vector<int> shape(nd), order(nd);
+  for (auto& d : shape) {
+    d = 1 + gen() % 13;
+  }
+  iota(order.begin(), order.end(), 0);
+  shuffle(order.begin(), order.end(), gen);
+  auto num = accumulate(shape.begin(), shape.end(), 1, multiplies<int>());
+  vector<T> in(num), ref(num), out(num), part(num);
+  for (auto i = 0; i < num; ++i) {
+    in[i] = (T)(i * 7 + 3);
+  }
+  naive_permute(shape, order, in.data(), ref.data());
+  auto t = vart::cpu::make_permute(shape, order);
+  vart::cpu::transpose(t, in.data(), out.data(), true);
+  int64_t split = gen() % (num + 1);
+  vart::cpu::transpose(t, in.data(), part.data(), 0, split);
+  vart::cpu::transpose(t, in.data(), part.data(), split, num);
+  return out == ref && part == ref;
+}
+
+// the loops of pixel_shuffle.cpp
+static void naive_pixel_shuffle(const vector<int>& is, const vector<int>& os,
+                                int s, bool upscale, const float* in,
+                                float* out) {
+  auto& shape = upscale ? os : is;
+  auto& other = upscale ? is : os;
+  int idx = 0;
+  for (auto b = 0; b < shape[0]; b++)
+    for (auto h = 0; h < shape[1]; h++)
+      for (auto w = 0; w < shape[2]; w++)
+        for (auto c = 0; c < shape[3]; c++) {
+          auto index = b * other[1] * other[2] * other[3] +
+                       h / s * other[2] * other[3] + w / s * other[3] +
+                       c * s * s + w % s + h % s * s;
+          if (upscale) {
+            out[idx++] = in[index];
+          } else {
+            out[index] = in[idx++];
+          }
+        }
+}
+
+static bool check_pixel_shuffle() {
+  auto ok = true;
+  for (auto s : {2, 3}) {
+    for (auto upscale : {true, false}) {
+      vector<int> is = {2, 3 * s, 2 * s, 5 * s * s};
+      vector<int> os = {2, 3, 2, 5 * s * s * s * s};
+      if (upscale) {
+        os = {2, is[1] * s, is[2] * s, is[3] / s / s};
+      } else {
+        os = {2, is[1] / s, is[2] / s, is[3] * s * s};
+      }
+      vector<float> in(2 * 3 * 2 * 5 * s * s * s * s), ref(in.size()),
+          out(in.size());
+      iota(in.begin(), in.end(), 0.0f);
+      naive_pixel_shuffle(is, os, s, upscale, in.data(), ref.data());
+      auto t = vart::cpu::make_pixel_shuffle(is, s, upscale);
+      vart::cpu::transpose(t, in.data(), out.data(), false);
+      ok = ok && out == ref;
+    }
+  }
+  return ok;
+}
+
+// the loops of reorg.cpp on an [1, H, W, C] input
+static void naive_reorg(int H, int W, int C, int s, bool reverse,
+                        const float* in, float* out) {
+  auto num = H * W * C;
+  vector<float> tmp(num);
+  auto row = [&](int i) {
+    auto h_unit = s * s;
+    auto rest = i % h_unit;
+    return i / h_unit * h_unit + rest % s * s + rest / s;
+  };
+  if (!reverse) {
+    for (auto i = 0; i < H; i++)
+      for (auto j = 0; j < W * C; j++) tmp[row(i) * W * C + j] = in[i * W * C + j];
+    auto oW = W / s, oC = C * s * s;
+    for (auto i = 0; i < H; i++)
+      for (auto j = 0; j < W; j++)
+        for (auto k = 0; k < C; k++)
+          out[i / s * oW * oC + j / s * oC + (i % s) * s * C + (j % s) * C +
+              k] = tmp[(i * W + j) * C + k];
+  } else {
+    auto oH = H * s, oW = W * s, oC = C / s / s;
+    for (auto i = 0; i < oH; i++)
+      for (auto j = 0; j < oW; j++)
+        for (auto k = 0; k < oC; k++)
+          tmp[(i * oW + j) * oC + k] =
+              in[(i / s * W + j / s) * C + (i % s) * s * oC + (j % s) * oC + k];
+    for (auto i = 0; i < oH; i++)
+      for (auto j = 0; j < oW * oC; j++)
+        out[row(i) * oW * oC + j] = tmp[i * oW * oC + j];
+  }
+}
+
+static bool check_reorg() {
+  auto ok = true;
+  for (auto s : {2, 3}) {
+    for (auto reverse : {false, true}) {
+      auto H = reverse ? 2 * s : 2 * s * s, W = 3 * s;
+      auto C = reverse ? 2 * s * s : 5;
+      vector<float> in(H * W * C), ref(in.size()), out(in.size());
+      iota(in.begin(), in.end(), 0.0f);
+      naive_reorg(H, W, C, s, reverse, in.data(), ref.data());
+      vart::cpu::Transpose t;
+      ok = ok && vart::cpu::make_reorg({1, H, W, C}, s, reverse, &t);
+      vart::cpu::transpose(t, in.data(), out.data(), false);
+      ok = ok && out == ref;
+    }
+  }
+  return ok;
+}
+
+// begin and end as xir::validate_strided_slice() resolves them: negative
+// ones count from the end, then both are clamped into the dim, down to -1
+// for a negative stride
+static void resolve_slice(int dim, int stride, int* begin, int* end) {
+  auto lo = stride > 0 ? 0 : -1;
+  auto hi = stride > 0 ? dim : dim - 1;
+  for (auto x : {begin, end}) {
+    *x = max(lo, min(hi, *x < 0 ? *x + dim : *x));
+  }
+}
+
+// the elements of a strided slice, one index at a time
+template <typename T>
+static vector<T> naive_strided_slice(const vector<int>& shape,
+                                     const vector<int>& begin,
+                                     const vector<int>& end,
+                                     const vector<int>& strides,
+                                     const T* in) {
+  vector<T> out;
+  function<void(size_t, int64_t)> slice = [&](size_t d, int64_t pos) {
+    if (d == shape.size()) {
+      out.push_back(in[pos]);
+      return;
+    }
+    for (auto i = begin[d]; strides[d] > 0 ? i < end[d] : i > end[d];
+         i += strides[d]) {
+      slice(d + 1, pos * shape[d] + i);
+    }
+  };
+  slice(0, 0);
+  return out;
+}
+
+// random slices with negative strides, and begin and end out of the dims,
+// which are clamped
+template <typename T>
+static bool check_strided_slice(mt19937& gen) {
+  auto nd = 1 + gen() % 4;
+  vector<int> shape(nd), begin(nd), end(nd), strides(nd);
+  for (auto d = 0u; d < nd; ++d) {
+    shape[d] = 1 + gen() % 9;
+    strides[d] = (int)(1 + gen() % 3) * (gen() % 2 ? -1 : 1);
+    begin[d] = (int)(gen() % (2 * shape[d] + 7)) - shape[d] - 3;
+    end[d] = (int)(gen() % (2 * shape[d] + 7)) - shape[d] - 3;
+    resolve_slice(shape[d], strides[d], &begin[d], &end[d]);
+  }
+  auto num = accumulate(shape.begin(), shape.end(), 1, multiplies<int>());
+  vector<T> in(num);
+  for (auto i = 0; i < num; ++i) {
+    in[i] = (T)(i * 7 + 3);
+  }
+  auto ref = naive_strided_slice(shape, begin, end, strides, in.data());
+  vector<int> out_shape;
+  auto t = vart::cpu::make_strided_slice(shape, begin, end, strides,
+                                         &out_shape);
+  if (accumulate(out_shape.begin(), out_shape.end(), (size_t)1,
+                 multiplies<size_t>()) != ref.size()) {
+    return false;
+  }
+  vector<T> out(ref.size()), part(ref.size());
+  if (!ref.empty()) {
+    vart::cpu::transpose(t, in.data(), out.data(), true);
+    int64_t split = gen() % (ref.size() + 1);
+    vart::cpu::transpose(t, in.data(), part.data(), 0, split);
+    vart::cpu::transpose(t, in.data(), part.data(), split,
+                         (int64_t)ref.size());
+  }
+  return out == ref && part == ref;
+}
+
+static double measure_ms(const function<void()>& f, int num_of_runs) {
+  f();
+  auto start = chrono::steady_clock::now();
+  for (auto r = 0; r < num_of_runs; ++r) {
+    f();
+  }
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - start)
+             .count() /
+         num_of_runs;
+}
+
+int main(int argc, char* argv[]) {
+  auto N = argc >= 2 ? stoi(argv[1]) : 1;
+  auto C = argc >= 3 ? stoi(argv[2]) : 64;
+  auto H = argc >= 4 ? stoi(argv[3]) : 112;
+  auto W = argc >= 5 ? stoi(argv[4]) : 112;
+  auto num_of_runs = argc >= 6 ? stoi(argv[5]) : 10;
+
+  mt19937 gen(123);
+  auto ok = check_pixel_shuffle() && check_reorg();
+  for (auto t = 0; t < 300 && ok; ++t) {
+    ok = check_permute<int8_t>(gen) && check_permute<float>(gen) &&
+         check_permute<double>(gen) && check_strided_slice<int8_t>(gen) &&
+         check_strided_slice<float>(gen);
+  }
+  if (!ok) {
+    cout << "FAIL: transpose differs from the op loops" << endl;
+    return 1;
+  }
+
+  vector<float> in(N * C * H * W), out(in.size());
+  iota(in.begin(), in.end(), 0.0f);
+  auto bytes = 2.0 * in.size() * sizeof(float);
+  struct Case {
+    string name;
+    vector<int> shape;
+    vector<int> order;
+  };
+  for (const auto& c : vector<Case>{{"NCHW->NHWC", {N, C, H, W}, {0, 2, 3, 1}},
+                                    {"NHWC->NCHW", {N, H, W, C}, {0, 3, 1, 2}},
+                                    {"HW swap", {N, C, H, W}, {0, 1, 3, 2}}}) {
+    auto naive_ms = measure_ms(
+        [&] { naive_permute(c.shape, c.order, in.data(), out.data()); },
+        num_of_runs);
+    auto t = vart::cpu::make_permute(c.shape, c.order);
+    auto ms = measure_ms(
+        [&] { vart::cpu::transpose(t, in.data(), out.data(), true); },
+        num_of_runs);
+    cout << c.name << ": index arithmetic " << bytes / naive_ms / 1e6
+         << " GB/s, transpose " << bytes / ms / 1e6 << " GB/s" << endl;
+  }
+  for (auto upscale : {true, false}) {
+    vector<int> is = {N, H / 2, W / 2, C};
+    vector<int> os = {N, H / 4, W / 4, C * 4};
+    if (upscale) {
+      os = {N, H, W, C / 4};
+    } else {
+      is = {N, H, W, C / 4};
+      os = {N, H / 2, W / 2, C};
+    }
+    auto size = (size_t)N * H * W * C / 4;
+    auto pixel_bytes = 2.0 * size * sizeof(float);
+    auto naive_ms = measure_ms(
+        [&] {
+          naive_pixel_shuffle(is, os, 2, upscale, in.data(), out.data());
+        },
+        num_of_runs);
+    auto t = vart::cpu::make_pixel_shuffle(is, 2, upscale);
+    auto ms = measure_ms(
+        [&] { vart::cpu::transpose(t, in.data(), out.data(), true); },
+        num_of_runs);
+    cout << "pixel-shuffle " << (upscale ? "up" : "down")
+         << ": index arithmetic " << pixel_bytes / naive_ms / 1e6
+         << " GB/s, transpose " << pixel_bytes / ms / 1e6 << " GB/s" << endl;
+  }
+  cout << "PASS" << endl;
+  return 0;
+}
@@ -189,8 +189,9 @@ void DpuControllerXrtEdge::run(size_t core_idx, const uint64_t code,
     }
   };
 #ifndef _WIN32
-  vitis::ai::trace::add_trace("dpu-controller", vitis::ai::trace::func_start,
-                              core_idx, 0);
+  static auto trace_dpu_controller =
+      vitis::ai::trace::trace_class_handle("dpu-controller");
+  trace_dpu_controller.add_trace(vitis::ai::trace::func_start, core_idx, 0);
 #endif
   xrt_cu_->run(
       core_idx, func,
@@ -209,8 +210,8 @@ void DpuControllerXrtEdge::run(size_t core_idx, const uint64_t code,
       });
   auto hwconuter = get_device_hwconuter(core_idx);
 #ifndef _WIN32
-  vitis::ai::trace::add_trace("dpu-controller", vitis::ai::trace::func_end,
-                              core_idx, hwconuter);
+  trace_dpu_controller.add_trace(vitis::ai::trace::func_end, core_idx,
+                                 hwconuter);
 #endif
 }
 size_t DpuControllerXrtEdge::get_num_of_dpus() const {
@@ -248,8 +248,9 @@ void DpuControllerXrtXv2Dpu::run(size_t core_idx, const uint64_t code,
   };
 
 #ifndef _WIN32
-  vitis::ai::trace::add_trace("dpu-controller", vitis::ai::trace::func_start,
-                              core_idx, 0);
+  static auto trace_dpu_controller =
+      vitis::ai::trace::trace_class_handle("dpu-controller");
+  trace_dpu_controller.add_trace(vitis::ai::trace::func_start, core_idx, 0);
   vitis::ai::trace::lock(core_idx);
 #endif
   xrt_cu_->run(
@@ -270,8 +271,8 @@ void DpuControllerXrtXv2Dpu::run(size_t core_idx, const uint64_t code,
   auto hwconuter = get_device_hwconuter(core_idx);
 #ifndef _WIN32
   vitis::ai::trace::unlock(core_idx);
-  vitis::ai::trace::add_trace("dpu-controller", vitis::ai::trace::func_end,
-                              core_idx, hwconuter);
+  trace_dpu_controller.add_trace(vitis::ai::trace::func_end, core_idx,
+                                 hwconuter);
 #endif
 }
 
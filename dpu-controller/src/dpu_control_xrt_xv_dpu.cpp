@@ -196,8 +196,9 @@ void DpuControllerXrtXvDpu::run(size_t core_idx, const uint64_t code,
   };
 
 #ifndef _WIN32
-  vitis::ai::trace::add_trace("dpu-controller", vitis::ai::trace::func_start,
-                              core_idx, 0);
+  static auto trace_dpu_controller =
+      vitis::ai::trace::trace_class_handle("dpu-controller");
+  trace_dpu_controller.add_trace(vitis::ai::trace::func_start, core_idx, 0);
   // vitis::ai::trace::lock(core_idx);
 #endif
   xrt_cu_->run(
@@ -218,8 +219,8 @@ void DpuControllerXrtXvDpu::run(size_t core_idx, const uint64_t code,
   auto hwconuter = get_device_hwconuter(core_idx);
 #ifndef _WIN32
   // vitis::ai::trace::unlock(core_idx);
-  vitis::ai::trace::add_trace("dpu-controller", vitis::ai::trace::func_end,
-                              core_idx, hwconuter);
+  trace_dpu_controller.add_trace(vitis::ai::trace::func_end, core_idx,
+                                 hwconuter);
 #endif
 }
 size_t DpuControllerXrtXvDpu::get_num_of_dpus() const {
@@ -197,14 +197,15 @@ void DpuControllerDnndk::run(size_t core_idx, const uint64_t code,
   t2.addr6 = size >= 7 ? gen_reg[6] : 0;
   t2.addr7 = size >= 8 ? gen_reg[7] : 0;
 #ifndef _WIN32
-  vitis::ai::trace::add_trace("dpu-controller", vitis::ai::trace::func_start,
-                              core_idx, 0);
+  static auto trace_dpu_controller =
+      vitis::ai::trace::trace_class_handle("dpu-controller");
+  trace_dpu_controller.add_trace(vitis::ai::trace::func_start, core_idx, 0);
 #endif
   auto retval = ioctl(fd_, DPUIOC_RUN, (void*)(&t2));
   auto hwcounter = get_device_hwcounter(t2);
 #ifndef _WIN32
-  vitis::ai::trace::add_trace("dpu-controller", vitis::ai::trace::func_end,
-                              core_idx, hwcounter);
+  trace_dpu_controller.add_trace(vitis::ai::trace::func_end, core_idx,
+                                 hwcounter);
 #endif
   if (ENV_PARAM(XLNX_SHOW_DPU_COUNTER)) {
     auto core_idx = t2.core_id;
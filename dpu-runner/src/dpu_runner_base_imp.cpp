@@ -64,6 +64,18 @@ DpuRunnerBaseImp::DpuRunnerBaseImp(  // TODO clear input_tensors
       output_tensors_{output_tensors},
       session_{session},
       subgraph_{NULL} {
+  auto kernel = session_->get_kernel();
+  auto labels = vitis::ai::metrics::labels_t{
+      {"subgraph", kernel ? kernel->get_subgraph()->get_name() : ""}};
+  auto& registry = vitis::ai::MetricsRegistry::instance();
+  metrics_.copy_input = registry.histogram(
+      "vart_dpu_runner_copy_input_time_microseconds",
+      "time to copy inputs to the device", labels);
+  metrics_.run = registry.histogram("vart_dpu_runner_run_time_microseconds",
+                                    "time to run the DPU", labels);
+  metrics_.copy_output = registry.histogram(
+      "vart_dpu_runner_copy_output_time_microseconds",
+      "time to copy outputs from the device", labels);
   LOG_IF(INFO, ENV_PARAM(DEBUG_DPU_RUNNER))
       << "create  dpu runner " << (void*)this                         //
       << " device_core_id " << session_->get_device_core_id() << " "  //
@@ -642,6 +654,10 @@ void DpuRunnerBaseImp::after_run_dpu() {
 }
 
 void DpuRunnerBaseImp::start_dpu2(size_t device_core_id) {
+#if !_WIN32
+  // one run is one job, its events are sampled as a whole.
+  auto trace_job = vitis::ai::trace::trace_job();
+#endif
   if (ENV_PARAM(DEBUG_DPU_RUNNER_DRY_RUN) >= 3) {
     LOG(INFO) << "DEBUG_DPU_RUNNER_DRY_RUN = "
               << ENV_PARAM(DEBUG_DPU_RUNNER_DRY_RUN) << ", ignore running dpu";
@@ -691,7 +707,9 @@ void DpuRunnerBaseImp::start_dpu2(size_t device_core_id) {
       auto batch = session_->get_num_of_engines();
       // MSVC NOTE: it is not safe to call template function across DLL.
 #if !_WIN32
-      vitis::ai::trace::add_trace("dpu-runner", name, batch, workload, depth);
+      static auto trace_dpu_runner =
+          vitis::ai::trace::trace_class_handle("dpu-runner");
+      trace_dpu_runner.add_trace(name, batch, workload, depth);
 #endif
     }
     LOG_IF(FATAL, ENV_PARAM(XLNX_ENABLE_FINGERPRINT_CHECK) &&
@@ -17,6 +17,7 @@
 #pragma once
 #include <memory>
 #include <vart/runner.hpp>
+#include <vitis/ai/metrics.hpp>
 #include <xir/device_memory.hpp>
 #include <xir/graph/graph.hpp>
 
@@ -59,6 +60,14 @@ class DpuRunnerBaseImp : public vart::Runner {
                                  vart::TensorBuffer* tb_to, float scale);
   bool check_fingerprint(size_t device_core_id);
 
+ protected:
+  // always on, see vitis/ai/metrics.hpp
+  struct {
+    vitis::ai::Histogram* copy_input;
+    vitis::ai::Histogram* run;
+    vitis::ai::Histogram* copy_output;
+  } metrics_;
+
  public:
   enum TensorType { INPUT, INTERNAL, OUTPUT };
 
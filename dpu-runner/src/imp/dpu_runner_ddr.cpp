@@ -180,15 +180,22 @@ std::pair<uint32_t, int> DpuRunnerDdr::execute_async(
     const std::vector<vart::TensorBuffer*>& input,
     const std::vector<vart::TensorBuffer*>& output) {
   __TIC__(DPU_RUNNER_COPY_INPUT);
+  auto t0 = std::chrono::steady_clock::now();
   UNI_LOG_CHECK(my_input_.empty(), VART_SIZE_MISMATCH);
   my_input_ = prepare_input(input, output);
+  auto t1 = std::chrono::steady_clock::now();
   __TOC__(DPU_RUNNER_COPY_INPUT);
   __TIC__(DPU_RUNNER)
   start_dpu2(session_->get_device_core_id());
+  auto t2 = std::chrono::steady_clock::now();
   __TOC__(DPU_RUNNER)
   __TIC__(DPU_RUNNER_COPY_OUTPUT);
   prepare_output(output);
+  auto t3 = std::chrono::steady_clock::now();
   __TOC__(DPU_RUNNER_COPY_OUTPUT);
+  metrics_.copy_input->observe(t1 - t0);
+  metrics_.run->observe(t2 - t1);
+  metrics_.copy_output->observe(t3 - t2);
   my_input_.clear();
   return std::make_pair<uint32_t, int>(1u, 0);
 }
@@ -21,6 +21,7 @@
 #include <sys/types.h>
 
 #include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <thread>
 #include <vitis/ai/env_config.hpp>
@@ -96,6 +97,9 @@ std::pair<uint32_t, int> DpuRunnerHbm::execute_async(
   auto my_output_tensor_buffers = session_->get_outputs();
   // CHECK_EQ(my_output_tensor_buffers.size(), output.size());
   CHECK(my_input_tensor_buffers.size() == input.size());
+  auto t0 = std::chrono::steady_clock::now();
+  auto t1 = t0;
+  auto t2 = t0;
   {
     // begin copy input
     auto input_size = my_input_tensor_buffers.size();
@@ -122,6 +126,7 @@ std::pair<uint32_t, int> DpuRunnerHbm::execute_async(
     chunks_ = w->get_workspaces(workspace_regs);
     //
     upload_data(my_input_tensor_buffers, chunks_, device_core_id);
+    t1 = std::chrono::steady_clock::now();
     {
       // auto lock = w->lock_core();
 
@@ -132,6 +137,7 @@ std::pair<uint32_t, int> DpuRunnerHbm::execute_async(
       /// device_scheduler_->mark_busy_time(device_core_id, -1 /*release the
       /// core*/);
     }
+    t2 = std::chrono::steady_clock::now();
     download_data(my_output_tensor_buffers, chunks_, device_core_id);
   }
   {
@@ -149,6 +155,10 @@ std::pair<uint32_t, int> DpuRunnerHbm::execute_async(
     }
     // end copy output
   }
+  // copy_input includes waiting for the workspace lock.
+  metrics_.copy_input->observe(t1 - t0);
+  metrics_.run->observe(t2 - t1);
+  metrics_.copy_output->observe(std::chrono::steady_clock::now() - t2);
   return ret;
 }
 
@@ -55,10 +55,18 @@ class DummyRunner : public vart::RunnerExt {
   std::vector<std::unique_ptr<xir::Tensor>> outputs_;
   std::vector<std::unique_ptr<vart::TensorBuffer>> input_tensor_buffers_;
   std::vector<std::unique_ptr<vart::TensorBuffer>> output_tensor_buffers_;
+  int process_time_;
 };
 
 DummyRunner::DummyRunner(const xir::Subgraph* subgraph, xir::Attrs* attrs)
-    : inputs_{}, outputs_{} {
+    : inputs_{},
+      outputs_{},
+      process_time_{ENV_PARAM(DUMMY_RUNNER_PROCESS_TIME)} {
+  // attr "dummy_runner_process_time" overrides the env, so that runners
+  // with different latencies can live in the same process.
+  if (attrs && attrs->has_attr("dummy_runner_process_time")) {
+    process_time_ = attrs->get_attr<int>("dummy_runner_process_time");
+  }
   LOG_IF(INFO, ENV_PARAM(DEBUG_DUMMY_RUNNER))
       << "@" << (void*)this << " dummy runner is created for subgraph "
       << subgraph->get_name();
@@ -107,9 +115,8 @@ std::pair<uint32_t, int> DummyRunner::execute_async(
       << "@" << (void*)this << " start to run: "
       << " inputs= " << to_string(input) << " "    //
       << " outputs= " << to_string(output) << " "  //
-      << "processing time =" << ENV_PARAM(DUMMY_RUNNER_PROCESS_TIME) << " ms";
-  std::this_thread::sleep_for(
-      std::chrono::milliseconds(ENV_PARAM(DUMMY_RUNNER_PROCESS_TIME)));
+      << "processing time =" << process_time_ << " ms";
+  std::this_thread::sleep_for(std::chrono::milliseconds(process_time_));
   return std::make_pair(0u, 0);
 }
 
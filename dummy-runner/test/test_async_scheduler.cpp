@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// several models share one process wide async runner scheduler. Each
+// model is backed by a dummy runner with its own latency and weight,
+// and is driven by a closed loop client keeping NUM_OF_INFLIGHT
+// requests in flight. The device time each model gets is reported at
+// the end, it should be proportional to the weights.
+//
+// usage:
+//   test_async_scheduler <xmodel> <process_time_ms>:<weight>[:<max_pending>]...
+// e.g.
+//   env XLNX_NUM_OF_DEVICE_SLOTS=2 test_async_scheduler a.xmodel 2:1 8:1 8:3
+
+#include <glog/logging.h>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vart/runner.hpp>
+#include <xir/graph/graph.hpp>
+
+#include "../src/runner_helper.hpp"
+#include "vitis/ai/collection_helper.hpp"
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM(NUM_OF_RUNNERS, "2")
+DEF_ENV_PARAM(NUM_OF_INFLIGHT, "16")
+DEF_ENV_PARAM(DURATION_MS, "10000")
+using namespace std;
+
+struct model_t {
+  int process_time;
+  double weight;
+  size_t max_pending;
+  unique_ptr<xir::Graph> graph;
+  unique_ptr<vart::Runner> runner;
+  uint64_t num_of_completed;
+  uint64_t num_of_rejected;
+};
+
+static void parse_model(const string& spec, model_t& model) {
+  model.process_time = 2;
+  model.weight = 1.0;
+  model.max_pending = 0u;
+  char sep;
+  istringstream str(spec);
+  str >> model.process_time >> sep >> model.weight;
+  if (str >> sep) {
+    str >> model.max_pending;
+  }
+}
+
+static void client_main(model_t* model, std::atomic<int>* stop) {
+  struct job_t {
+    uint32_t job_id;
+    vector<unique_ptr<vart::TensorBuffer>> inputs;
+    vector<unique_ptr<vart::TensorBuffer>> outputs;
+  };
+  auto runner = model->runner.get();
+  deque<job_t> jobs;
+  while (!*stop || !jobs.empty()) {
+    while (!*stop && jobs.size() < (size_t)ENV_PARAM(NUM_OF_INFLIGHT)) {
+      auto inputs =
+          vart::alloc_cpu_flat_tensor_buffers(runner->get_input_tensors());
+      auto outputs =
+          vart::alloc_cpu_flat_tensor_buffers(runner->get_output_tensors());
+      auto job =
+          runner->execute_async(vitis::ai::vector_unique_ptr_get(inputs),
+                                vitis::ai::vector_unique_ptr_get(outputs));
+      if (job.second != 0) {
+        model->num_of_rejected++;
+        break;
+      }
+      jobs.push_back(job_t{job.first, std::move(inputs), std::move(outputs)});
+    }
+    if (!jobs.empty()) {
+      runner->wait((int)jobs.front().job_id, -1);
+      jobs.pop_front();
+      model->num_of_completed++;
+    }
+  }
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    cout << "usage " << argv[0]
+         << " <xmodel> <process_time_ms>:<weight>[:<max_pending>] ..." << endl;
+    return 0;
+  }
+  auto models = vector<model_t>(argc - 2);
+  for (auto i = 0u; i < models.size(); ++i) {
+    auto& model = models[i];
+    parse_model(argv[i + 2], model);
+    // every model has its own graph, otherwise they share the same
+    // async runner.
+    model.graph = xir::Graph::deserialize(argv[1]);
+    xir::Subgraph* s = nullptr;
+    for (auto c : model.graph->get_root_subgraph()->get_children()) {
+      if (c->get_attr<std::string>("device") == "DPU") {
+        s = c;
+        break;
+      }
+    }
+    CHECK(s != nullptr) << "cannot find a DPU subgraph in " << argv[1];
+    auto attrs = xir::Attrs::create();
+    attrs->set_attr("interception", std::string("libvart-async-runner.so"));
+    attrs->set_attr("num_of_dpu_runners", (size_t)ENV_PARAM(NUM_OF_RUNNERS));
+    attrs->set_attr("lib", std::map<std::string, std::string>{
+                               {"DPU", "libvart-dummy-runner.so"}});
+    attrs->set_attr("dummy_runner_process_time", model.process_time);
+    attrs->set_attr("scheduler_weight", model.weight);
+    attrs->set_attr("max_pending_requests", model.max_pending);
+    model.runner = vart::Runner::create_runner_with_attrs(s, attrs.get());
+    model.num_of_completed = 0u;
+    model.num_of_rejected = 0u;
+  }
+  std::atomic<int> stop(0);
+  auto clients = vector<std::thread>();
+  for (auto& model : models) {
+    clients.emplace_back(client_main, &model, &stop);
+  }
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(ENV_PARAM(DURATION_MS)));
+  stop = 1;
+  for (auto& t : clients) {
+    t.join();
+  }
+  auto total_weight = 0.0;
+  auto total_device_time = 0.0;
+  for (auto& model : models) {
+    total_weight += model.weight;
+    total_device_time += (double)model.num_of_completed * model.process_time;
+  }
+  for (auto i = 0u; i < models.size(); ++i) {
+    auto& model = models[i];
+    auto device_time = (double)model.num_of_completed * model.process_time;
+    cout << "model[" << i << "] process_time=" << model.process_time << "ms"
+         << " weight=" << model.weight
+         << " max_pending=" << model.max_pending
+         << " completed=" << model.num_of_completed
+         << " rejected=" << model.num_of_rejected
+         << " fps=" << model.num_of_completed * 1000.0 / ENV_PARAM(DURATION_MS)
+         << " share=" << 100.0 * device_time / total_device_time << "%"
+         << " expected=" << 100.0 * model.weight / total_weight << "%" << endl;
+  }
+  return 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "vart/runner.hpp"
+
+namespace xir {
+class Graph;
+class Attrs;
+}  // namespace xir
+
+namespace vart {
+
+struct GraphRunnerStageMetrics {
+  std::string name;
+  std::string device;
+  uint64_t num_of_frames;
+  // time spent in execute_async/wait of the stage runner.
+  uint64_t busy_time_us;
+  // time a frame spent in the input queue of the stage.
+  uint64_t queue_time_us;
+  size_t queue_size;
+  size_t queue_capacity;
+  // busy_time_us / wall time since the graph runner is created.
+  double occupancy;
+};
+
+/**
+ * @brief A runner for a whole xmodel.
+ *
+ * The child subgraphs of the root subgraph are visited in topological
+ * order and a runner is created for each of them, according to their
+ * "device" and "runner" attributes, same as
+ * vart::Runner::create_runner_with_attrs. Subgraphs on device "USER"
+ * are skipped.
+ *
+ * Every stage runs on its own thread with a bounded input queue, so
+ * that consecutive frames are pipelined across stages, i.e. while
+ * frame N is on the DPU, frame N-1 is on the CPU. Intermediate tensors
+ * are allocated once per in-flight frame and the same buffer is
+ * passed as the output of the producer and the input of the consumer,
+ * so no copy happens between stages.
+ *
+ * Attrs:
+ *   "graph_runner_max_frames": number of in-flight frames, default 4.
+ *   "graph_runner_queue_depth": capacity of each stage queue, default 2.
+ * Other attrs, e.g. "mode" or "lib", are forwarded to the stage runners.
+ *
+ * Sample code:
+ * @code
+ *   auto graph = xir::Graph::deserialize(xmodel);
+ *   auto attrs = xir::Attrs::create();
+ *   attrs->set_attr<std::string>("mode", "ref");
+ *   auto runner = vart::GraphRunner::create_graph_runner(graph.get(),
+ *                                                        attrs.get());
+ *   auto job = runner->execute_async(inputs, outputs);
+ *   runner->wait((int)job.first, -1);
+ * @endcode
+ */
+class GraphRunner : public vart::Runner {
+ public:
+  static std::unique_ptr<GraphRunner> create_graph_runner(
+      const xir::Graph* graph, xir::Attrs* attrs);
+
+ public:
+  virtual ~GraphRunner() = default;
+  virtual std::vector<GraphRunnerStageMetrics> get_stage_metrics() = 0;
+};
+
+}  // namespace vart
@@ -0,0 +1,458 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vart/graph_runner.hpp"
+
+#include <UniLog/UniLog.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "../../runner/src/runner_helper.hpp"
+#include "vitis/ai/collection_helper.hpp"
+#include "vitis/ai/env_config.hpp"
+#include "vitis/ai/erl_msg_box.hpp"
+#include "xir/graph/graph.hpp"
+
+DEF_ENV_PARAM(DEBUG_GRAPH_RUNNER, "0");
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// all tensors of a frame are numbered, graph inputs first, then graph
+// outputs and then intermediate tensors.
+struct frame_t {
+  int job_id;
+  int ret;
+  Clock::time_point enqueue_time;
+  std::vector<vart::TensorBuffer*> buffers;
+  std::unique_ptr<std::vector<std::unique_ptr<vart::TensorBuffer>>>
+      intermediates;
+};
+
+struct stage_t {
+  const xir::Subgraph* subgraph;
+  std::unique_ptr<xir::Attrs> attrs;
+  std::unique_ptr<vart::Runner> runner;
+  std::vector<size_t> input_slots;
+  std::vector<size_t> output_slots;
+  std::unique_ptr<vitis::ai::ErlMsgBox<frame_t>> queue;
+  std::thread thread;
+  std::atomic<bool> stopped;
+  std::atomic<uint64_t> num_of_frames;
+  std::atomic<uint64_t> busy_time_us;
+  std::atomic<uint64_t> queue_time_us;
+};
+
+class GraphRunnerImpl : public vart::GraphRunner {
+ public:
+  explicit GraphRunnerImpl(const xir::Graph* graph, xir::Attrs* attrs);
+  GraphRunnerImpl(const GraphRunnerImpl& other) = delete;
+  virtual ~GraphRunnerImpl();
+
+ private:
+  virtual std::pair<uint32_t, int> execute_async(
+      const std::vector<vart::TensorBuffer*>& input,
+      const std::vector<vart::TensorBuffer*>& output) override;
+  virtual int wait(int jobid, int timeout) override;
+  virtual std::vector<const xir::Tensor*> get_input_tensors() override;
+  virtual std::vector<const xir::Tensor*> get_output_tensors() override;
+  virtual std::vector<vart::GraphRunnerStageMetrics> get_stage_metrics()
+      override;
+
+ private:
+  struct job_slot_t {
+    std::promise<int> promise;
+    // wait() may time out and be called again, get_future() only once.
+    std::shared_future<int> future;
+  };
+  struct slot_info_t {
+    std::string name;
+    // the tensor of the runner which produces the slot, or the tensor
+    // of the first runner which consumes it for graph inputs.
+    const xir::Tensor* tensor;
+    int producer;
+  };
+
+ private:
+  void build_slots();
+  size_t find_or_add_slot(const xir::Tensor* tensor, int producer);
+  std::unique_ptr<std::vector<std::unique_ptr<vart::TensorBuffer>>>
+  alloc_intermediates();
+  void bind_user_buffers(const std::vector<vart::TensorBuffer*>& from,
+                         size_t first_slot, size_t num_of_slots,
+                         std::vector<vart::TensorBuffer*>& to);
+  void stage_main(size_t stage_idx);
+  void run_stage(stage_t& stage, frame_t& frame);
+  void complete_frame(std::unique_ptr<frame_t> frame);
+  int allocate_job_id();
+  job_slot_t* find_job_slot(int job_id);
+
+ private:
+  std::vector<std::unique_ptr<stage_t>> stages_;
+  std::vector<slot_info_t> slots_;
+  std::map<std::string, size_t> slot_index_;
+  size_t num_of_inputs_;
+  size_t num_of_outputs_;
+  std::unique_ptr<vitis::ai::ErlMsgBox<
+      std::vector<std::unique_ptr<vart::TensorBuffer>>>>
+      intermediates_pool_;
+  std::map<int, std::unique_ptr<job_slot_t>> jobs_;
+  std::mutex mtx_for_jobs_;
+  Clock::time_point start_time_;
+  std::atomic<bool> running_;
+};
+
+GraphRunnerImpl::GraphRunnerImpl(const xir::Graph* graph, xir::Attrs* attrs)
+    : stages_{},
+      slots_{},
+      slot_index_{},
+      num_of_inputs_{0u},
+      num_of_outputs_{0u},
+      intermediates_pool_{},
+      jobs_{},
+      mtx_for_jobs_{},
+      start_time_{Clock::now()},
+      running_{true} {
+  auto max_frames = attrs && attrs->has_attr("graph_runner_max_frames")
+                        ? attrs->get_attr<size_t>("graph_runner_max_frames")
+                        : 4u;
+  auto queue_depth = attrs && attrs->has_attr("graph_runner_queue_depth")
+                         ? attrs->get_attr<size_t>("graph_runner_queue_depth")
+                         : 2u;
+  UNI_LOG_CHECK(max_frames > 0u && queue_depth > 0u,
+                VART_RUNNER_CONSTRUCTION_FAIL)
+      << "graph_runner_max_frames and graph_runner_queue_depth must be "
+         "positive.";
+  for (auto subgraph :
+       graph->get_root_subgraph()->children_topological_sort()) {
+    auto device = subgraph->has_attr("device")
+                      ? subgraph->get_attr<std::string>("device")
+                      : std::string("");
+    if (device == "USER") {
+      continue;
+    }
+    auto stage = std::make_unique<stage_t>();
+    stage->subgraph = subgraph;
+    // it is important not to share attrs among runners, see async runner.
+    stage->attrs = attrs ? xir::Attrs::clone(attrs) : xir::Attrs::create();
+    stage->runner = vart::Runner::create_runner_with_attrs(
+        subgraph, stage->attrs.get());
+    stage->queue =
+        std::make_unique<vitis::ai::ErlMsgBox<frame_t>>(queue_depth);
+    stage->stopped = false;
+    stage->num_of_frames = 0u;
+    stage->busy_time_us = 0u;
+    stage->queue_time_us = 0u;
+    LOG_IF(INFO, ENV_PARAM(DEBUG_GRAPH_RUNNER))
+        << "stage " << stages_.size() << " " << subgraph->get_name()
+        << " device=" << device;
+    stages_.emplace_back(std::move(stage));
+  }
+  UNI_LOG_CHECK(!stages_.empty(), VART_RUNNER_CONSTRUCTION_FAIL)
+      << "no subgraph to run in graph " << graph->get_name();
+  build_slots();
+  intermediates_pool_ = std::make_unique<vitis::ai::ErlMsgBox<
+      std::vector<std::unique_ptr<vart::TensorBuffer>>>>(max_frames);
+  for (auto i = 0u; i < max_frames; ++i) {
+    intermediates_pool_->send_ptr(alloc_intermediates());
+  }
+  for (auto i = 0u; i < stages_.size(); ++i) {
+    stages_[i]->thread = std::thread([this, i]() { stage_main(i); });
+  }
+}
+
+GraphRunnerImpl::~GraphRunnerImpl() {
+  running_ = false;
+  // stages are stopped in order, every stage drains its queue before
+  // it stops, so that no frame is lost.
+  for (auto& stage : stages_) {
+    stage->thread.join();
+  }
+  LOG_IF(INFO, ENV_PARAM(DEBUG_GRAPH_RUNNER))
+      << "graph runner is destroyed. #jobs=" << jobs_.size()
+      << " if #jobs is not zero, some jobs are not waited.";
+}
+
+// graph inputs are the tensors consumed by a stage but not produced by
+// any previous stage, graph outputs are the tensors produced by a
+// stage but not consumed by any later stage.
+void GraphRunnerImpl::build_slots() {
+  auto inputs = std::vector<const xir::Tensor*>();
+  auto produced = std::map<std::string, int>();
+  auto consumed = std::map<std::string, bool>();
+  for (auto i = 0u; i < stages_.size(); ++i) {
+    for (auto t : stages_[i]->runner->get_input_tensors()) {
+      consumed[t->get_name()] = true;
+      if (produced.find(t->get_name()) == produced.end() &&
+          std::find_if(inputs.begin(), inputs.end(), [t](auto x) {
+            return x->get_name() == t->get_name();
+          }) == inputs.end()) {
+        inputs.push_back(t);
+      }
+    }
+    for (auto t : stages_[i]->runner->get_output_tensors()) {
+      produced[t->get_name()] = (int)i;
+    }
+  }
+  for (auto t : inputs) {
+    find_or_add_slot(t, -1);
+  }
+  num_of_inputs_ = slots_.size();
+  for (auto i = 0u; i < stages_.size(); ++i) {
+    for (auto t : stages_[i]->runner->get_output_tensors()) {
+      if (!consumed[t->get_name()]) {
+        find_or_add_slot(t, (int)i);
+      }
+    }
+  }
+  num_of_outputs_ = slots_.size() - num_of_inputs_;
+  for (auto i = 0u; i < stages_.size(); ++i) {
+    auto& stage = *stages_[i];
+    for (auto t : stage.runner->get_output_tensors()) {
+      stage.output_slots.push_back(find_or_add_slot(t, (int)i));
+    }
+    for (auto t : stage.runner->get_input_tensors()) {
+      auto slot = find_or_add_slot(t, -1);
+      // the buffer is allocated by the producer, so it must be large
+      // enough for the consumer.
+      UNI_LOG_CHECK(slots_[slot].tensor->get_data_size() >=
+                        t->get_data_size(),
+                    VART_RUNNER_CONSTRUCTION_FAIL)
+          << "tensor size mismatch between stages. tensor=" << t->get_name()
+          << " produced=" << slots_[slot].tensor->get_data_size()
+          << " consumed=" << t->get_data_size();
+      stage.input_slots.push_back(slot);
+    }
+  }
+  LOG_IF(INFO, ENV_PARAM(DEBUG_GRAPH_RUNNER))
+      << "#inputs=" << num_of_inputs_ << " #outputs=" << num_of_outputs_
+      << " #intermediates=" << slots_.size() - num_of_inputs_ - num_of_outputs_;
+}
+
+size_t GraphRunnerImpl::find_or_add_slot(const xir::Tensor* tensor,
+                                         int producer) {
+  auto it = slot_index_.find(tensor->get_name());
+  if (it != slot_index_.end()) {
+    return it->second;
+  }
+  auto ret = slots_.size();
+  slots_.push_back(slot_info_t{tensor->get_name(), tensor, producer});
+  slot_index_[tensor->get_name()] = ret;
+  return ret;
+}
+
+std::unique_ptr<std::vector<std::unique_ptr<vart::TensorBuffer>>>
+GraphRunnerImpl::alloc_intermediates() {
+  auto tensors = std::vector<const xir::Tensor*>();
+  for (auto i = num_of_inputs_ + num_of_outputs_; i < slots_.size(); ++i) {
+    tensors.push_back(slots_[i].tensor);
+  }
+  return std::make_unique<std::vector<std::unique_ptr<vart::TensorBuffer>>>(
+      vart::alloc_cpu_flat_tensor_buffers(tensors));
+}
+
+std::vector<const xir::Tensor*> GraphRunnerImpl::get_input_tensors() {
+  auto ret = std::vector<const xir::Tensor*>();
+  for (auto i = 0u; i < num_of_inputs_; ++i) {
+    ret.push_back(slots_[i].tensor);
+  }
+  return ret;
+}
+
+std::vector<const xir::Tensor*> GraphRunnerImpl::get_output_tensors() {
+  auto ret = std::vector<const xir::Tensor*>();
+  for (auto i = num_of_inputs_; i < num_of_inputs_ + num_of_outputs_; ++i) {
+    ret.push_back(slots_[i].tensor);
+  }
+  return ret;
+}
+
+// buffers are matched by tensor name first, and by position otherwise.
+void GraphRunnerImpl::bind_user_buffers(
+    const std::vector<vart::TensorBuffer*>& from, size_t first_slot,
+    size_t num_of_slots, std::vector<vart::TensorBuffer*>& to) {
+  CHECK_EQ(from.size(), num_of_slots) << "number of tensor buffers mismatch.";
+  for (auto i = 0u; i < from.size(); ++i) {
+    auto it = slot_index_.find(from[i]->get_tensor()->get_name());
+    auto slot = it != slot_index_.end() && it->second >= first_slot &&
+                        it->second < first_slot + num_of_slots
+                    ? it->second
+                    : first_slot + i;
+    to[slot] = from[i];
+  }
+}
+
+std::pair<uint32_t, int> GraphRunnerImpl::execute_async(
+    const std::vector<vart::TensorBuffer*>& input,
+    const std::vector<vart::TensorBuffer*>& output) {
+  auto frame = std::make_unique<frame_t>();
+  frame->ret = 0;
+  frame->buffers.resize(slots_.size());
+  bind_user_buffers(input, 0u, num_of_inputs_, frame->buffers);
+  bind_user_buffers(output, num_of_inputs_, num_of_outputs_, frame->buffers);
+  // back pressure, wait until a frame finishes if too many frames are
+  // in flight.
+  while ((frame->intermediates = intermediates_pool_->recv(
+              std::chrono::milliseconds(1000))) == nullptr) {
+    LOG_IF(INFO, ENV_PARAM(DEBUG_GRAPH_RUNNER))
+        << "waiting for a free frame.";
+  }
+  auto base = num_of_inputs_ + num_of_outputs_;
+  for (auto i = 0u; i < frame->intermediates->size(); ++i) {
+    frame->buffers[base + i] = (*frame->intermediates)[i].get();
+  }
+  frame->job_id = allocate_job_id();
+  auto job_id = frame->job_id;
+  frame->enqueue_time = Clock::now();
+  stages_[0]->queue->send_ptr(std::move(frame));
+  return std::make_pair((uint32_t)job_id, 0);
+}
+
+int GraphRunnerImpl::wait(int jobid, int timeout) {
+  auto job = find_job_slot(jobid);
+  auto ret = -1;
+  if (job == nullptr) {
+    return ret;
+  }
+  auto future = job->future;
+  if (timeout != -1 && future.wait_for(std::chrono::milliseconds(timeout)) !=
+                           std::future_status::ready) {
+    // keep the job, the frame still refers to it.
+    return ret;
+  }
+  ret = future.get();
+  std::lock_guard<std::mutex> lock(mtx_for_jobs_);
+  jobs_.erase(jobid);
+  return ret;
+}
+
+void GraphRunnerImpl::stage_main(size_t stage_idx) {
+  auto& stage = *stages_[stage_idx];
+  auto upstream_stopped = [this, stage_idx]() {
+    return stage_idx == 0u ? !running_.load()
+                           : stages_[stage_idx - 1]->stopped.load();
+  };
+  while (!upstream_stopped() || !stage.queue->empty()) {
+    auto frame = stage.queue->recv(std::chrono::milliseconds(100));
+    if (frame == nullptr) {
+      continue;
+    }
+    auto now = Clock::now();
+    stage.queue_time_us +=
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            now - frame->enqueue_time)
+            .count();
+    run_stage(stage, *frame);
+    auto end = Clock::now();
+    stage.busy_time_us +=
+        std::chrono::duration_cast<std::chrono::microseconds>(end - now)
+            .count();
+    stage.num_of_frames++;
+    if (frame->ret != 0 || stage_idx + 1 == stages_.size()) {
+      complete_frame(std::move(frame));
+    } else {
+      frame->enqueue_time = end;
+      stages_[stage_idx + 1]->queue->send_ptr(std::move(frame));
+    }
+  }
+  stage.stopped = true;
+}
+
+void GraphRunnerImpl::run_stage(stage_t& stage, frame_t& frame) {
+  auto inputs = std::vector<vart::TensorBuffer*>();
+  auto outputs = std::vector<vart::TensorBuffer*>();
+  inputs.reserve(stage.input_slots.size());
+  outputs.reserve(stage.output_slots.size());
+  for (auto slot : stage.input_slots) {
+    inputs.push_back(frame.buffers[slot]);
+  }
+  for (auto slot : stage.output_slots) {
+    outputs.push_back(frame.buffers[slot]);
+  }
+  LOG_IF(INFO, ENV_PARAM(DEBUG_GRAPH_RUNNER) >= 2)
+      << "job " << frame.job_id << " runs " << stage.subgraph->get_name()
+      << " inputs=" << to_string(inputs) << " outputs=" << to_string(outputs);
+  auto job = stage.runner->execute_async(inputs, outputs);
+  frame.ret = job.second;
+  if (frame.ret == 0) {
+    frame.ret = stage.runner->wait((int)job.first, -1);
+  }
+  LOG_IF(WARNING, frame.ret != 0)
+      << "job " << frame.job_id << " failed at " << stage.subgraph->get_name()
+      << " ret=" << frame.ret;
+}
+
+void GraphRunnerImpl::complete_frame(std::unique_ptr<frame_t> frame) {
+  intermediates_pool_->send_ptr(std::move(frame->intermediates));
+  auto job = find_job_slot(frame->job_id);
+  if (job != nullptr) {
+    job->promise.set_value(frame->ret);
+  }
+}
+
+int GraphRunnerImpl::allocate_job_id() {
+  std::lock_guard<std::mutex> lock(mtx_for_jobs_);
+  auto job_id = jobs_.empty() ? 0 : jobs_.rbegin()->first + 1;
+  auto job = std::make_unique<job_slot_t>();
+  job->future = job->promise.get_future().share();
+  jobs_[job_id] = std::move(job);
+  return job_id;
+}
+
+GraphRunnerImpl::job_slot_t* GraphRunnerImpl::find_job_slot(int job_id) {
+  std::lock_guard<std::mutex> lock(mtx_for_jobs_);
+  auto it = jobs_.find(job_id);
+  return it == jobs_.end() ? nullptr : it->second.get();
+}
+
+std::vector<vart::GraphRunnerStageMetrics>
+GraphRunnerImpl::get_stage_metrics() {
+  auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                        Clock::now() - start_time_)
+                        .count();
+  auto ret = std::vector<vart::GraphRunnerStageMetrics>();
+  ret.reserve(stages_.size());
+  for (auto& stage : stages_) {
+    auto m = vart::GraphRunnerStageMetrics();
+    m.name = stage->subgraph->get_name();
+    m.device = stage->subgraph->has_attr("device")
+                   ? stage->subgraph->get_attr<std::string>("device")
+                   : std::string("");
+    m.num_of_frames = stage->num_of_frames;
+    m.busy_time_us = stage->busy_time_us;
+    m.queue_time_us = stage->queue_time_us;
+    m.queue_size = stage->queue->size();
+    m.queue_capacity = stage->queue->capacity();
+    m.occupancy =
+        elapsed_us == 0 ? 0.0 : (double)m.busy_time_us / (double)elapsed_us;
+    ret.emplace_back(std::move(m));
+  }
+  return ret;
+}
+}  // namespace
+
+namespace vart {
+std::unique_ptr<GraphRunner> GraphRunner::create_graph_runner(
+    const xir::Graph* graph, xir::Attrs* attrs) {
+  return std::unique_ptr<GraphRunner>(new GraphRunnerImpl(graph, attrs));
+}
+}  // namespace vart
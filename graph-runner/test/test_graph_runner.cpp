@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// run a whole xmodel with the graph runner twice, once with a single
+// frame in flight, i.e. stages run serially, and once pipelined. The
+// outputs of both runs must be identical, and the frame rate and the
+// per stage occupancy are reported. A job which times out can be waited
+// for again.
+//
+// usage: env MODE=ref test_graph_runner <xmodel>
+//   MODE=ref runs all subgraphs on the cpu runner, MODE=sim runs DPU
+//   subgraphs on the sim runner.
+
+#include <glog/logging.h>
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <xir/graph/graph.hpp>
+
+#include "../../runner/src/runner_helper.hpp"
+#include "vart/graph_runner.hpp"
+#include "vitis/ai/collection_helper.hpp"
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM(NUM_OF_FRAMES, "32");
+DEF_ENV_PARAM(MAX_FRAMES, "4");
+DEF_ENV_PARAM_2(MODE, "ref", std::string);
+using namespace std;
+
+using buffers_t = vector<unique_ptr<vart::TensorBuffer>>;
+
+static void fill_inputs(buffers_t& inputs, int frame) {
+  for (auto& b : inputs) {
+    auto size = b->get_tensor()->get_data_size();
+    auto data = (char*)b->data(vart::get_index_zeros(b->get_tensor())).first;
+    for (decltype(size) i = 0; i < size; ++i) {
+      data[i] = (char)((i * 7 + frame * 13) & 0x3f);
+    }
+  }
+}
+
+static vector<buffers_t> run(const xir::Graph* graph, size_t max_frames,
+                             const std::string& name) {
+  auto attrs = xir::Attrs::create();
+  attrs->set_attr<std::string>("mode", ENV_PARAM(MODE));
+  attrs->set_attr<size_t>("graph_runner_max_frames", max_frames);
+  auto runner = vart::GraphRunner::create_graph_runner(graph, attrs.get());
+  auto num_of_frames = (size_t)ENV_PARAM(NUM_OF_FRAMES);
+  auto inputs = vector<buffers_t>(num_of_frames);
+  auto outputs = vector<buffers_t>(num_of_frames);
+  auto jobs = vector<int>(num_of_frames);
+  for (auto i = 0u; i < num_of_frames; ++i) {
+    inputs[i] =
+        vart::alloc_cpu_flat_tensor_buffers(runner->get_input_tensors());
+    outputs[i] =
+        vart::alloc_cpu_flat_tensor_buffers(runner->get_output_tensors());
+    fill_inputs(inputs[i], (int)i);
+  }
+  auto start = chrono::steady_clock::now();
+  // keep at most max_frames jobs in flight, execute_async blocks
+  // otherwise.
+  auto next_to_wait = 0u;
+  for (auto i = 0u; i < num_of_frames; ++i) {
+    auto job =
+        runner->execute_async(vitis::ai::vector_unique_ptr_get(inputs[i]),
+                              vitis::ai::vector_unique_ptr_get(outputs[i]));
+    CHECK_EQ(job.second, 0) << "cannot submit frame " << i;
+    jobs[i] = (int)job.first;
+    if (i + 1 - next_to_wait >= max_frames) {
+      CHECK_EQ(runner->wait(jobs[next_to_wait], -1), 0);
+      next_to_wait++;
+    }
+  }
+  for (; next_to_wait < num_of_frames; ++next_to_wait) {
+    CHECK_EQ(runner->wait(jobs[next_to_wait], -1), 0);
+  }
+  auto us = chrono::duration_cast<chrono::microseconds>(
+                chrono::steady_clock::now() - start)
+                .count();
+  cout << name << ": " << num_of_frames << " frames in " << us << "us, fps="
+       << fixed << setprecision(2) << num_of_frames * 1e6 / us << endl;
+  for (auto& m : runner->get_stage_metrics()) {
+    cout << "\t" << m.name << "@" << m.device << " frames=" << m.num_of_frames
+         << " busy=" << m.busy_time_us << "us"
+         << " queued=" << m.queue_time_us << "us"
+         << " occupancy=" << setprecision(1) << m.occupancy * 100 << "%"
+         << endl;
+  }
+  return outputs;
+}
+
+static bool wait_after_timeout(const xir::Graph* graph) {
+  auto attrs = xir::Attrs::create();
+  attrs->set_attr<std::string>("mode", ENV_PARAM(MODE));
+  auto runner = vart::GraphRunner::create_graph_runner(graph, attrs.get());
+  auto inputs =
+      vart::alloc_cpu_flat_tensor_buffers(runner->get_input_tensors());
+  auto outputs =
+      vart::alloc_cpu_flat_tensor_buffers(runner->get_output_tensors());
+  fill_inputs(inputs, 0);
+  auto job = runner->execute_async(vitis::ai::vector_unique_ptr_get(inputs),
+                                   vitis::ai::vector_unique_ptr_get(outputs));
+  CHECK_EQ(job.second, 0) << "cannot submit the frame";
+  // poll with a short timeout, every wait after the first one is a wait
+  // after a timeout.
+  auto num_of_timeouts = 0;
+  auto ret = -1;
+  while ((ret = runner->wait((int)job.first, 1)) == -1 &&
+         num_of_timeouts < 10000) {
+    num_of_timeouts++;
+  }
+  cout << "wait after " << num_of_timeouts << " timeouts: ret=" << ret
+       << endl;
+  // the job is gone once it is waited for.
+  return ret == 0 && runner->wait((int)job.first, 0) == -1;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout << "usage: " << argv[0] << " <xmodel>" << endl;
+    return 1;
+  }
+  auto graph = xir::Graph::deserialize(argv[1]);
+  auto serial = run(graph.get(), 1u, "serial");
+  auto pipelined =
+      run(graph.get(), (size_t)ENV_PARAM(MAX_FRAMES), "pipelined");
+  auto ok = true;
+  for (auto i = 0u; i < serial.size(); ++i) {
+    for (auto j = 0u; j < serial[i].size(); ++j) {
+      auto size = serial[i][j]->get_tensor()->get_data_size();
+      auto a = serial[i][j]->data(vart::get_index_zeros(
+          serial[i][j]->get_tensor()));
+      auto b = pipelined[i][j]->data(vart::get_index_zeros(
+          pipelined[i][j]->get_tensor()));
+      if (memcmp((void*)a.first, (void*)b.first, size) != 0) {
+        LOG(ERROR) << "output mismatch. frame=" << i << " tensor="
+                   << serial[i][j]->get_tensor()->get_name();
+        ok = false;
+      }
+    }
+  }
+  ok = wait_after_timeout(graph.get()) && ok;
+  cout << (ok ? "PASS" : "FAIL") << endl;
+  return ok ? 0 : 1;
+}
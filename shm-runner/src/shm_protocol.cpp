@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./shm_protocol.hpp"
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <system_error>
+
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM_2(XLNX_SHM_SERVER_SOCKET, "/tmp/vart_shm_server.sock",
+                std::string);
+
+namespace vart {
+namespace shm {
+
+// every tensor in a slot starts at a cache line boundary.
+static constexpr size_t ALIGNMENT = 64u;
+
+std::string default_socket_path() { return ENV_PARAM(XLNX_SHM_SERVER_SOCKET); }
+
+static bool write_all(int fd, const char* data, size_t size) {
+  while (size > 0u) {
+    auto n = ::send(fd, data, size, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    size -= (size_t)n;
+  }
+  return true;
+}
+
+static bool read_all(int fd, char* data, size_t size) {
+  while (size > 0u) {
+    auto n = ::recv(fd, data, size, 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    size -= (size_t)n;
+  }
+  return true;
+}
+
+bool send_msg(int fd, const msg_header_t& header, const std::string& payload) {
+  auto h = header;
+  h.payload_size = (uint32_t)payload.size();
+  return write_all(fd, (const char*)&h, sizeof(h)) &&
+         write_all(fd, payload.data(), payload.size());
+}
+
+bool recv_msg(int fd, msg_header_t& header, std::string& payload) {
+  if (!read_all(fd, (char*)&header, sizeof(header))) {
+    return false;
+  }
+  payload.resize(header.payload_size);
+  return read_all(fd, &payload[0], payload.size());
+}
+
+std::string encode_kv(const std::map<std::string, std::string>& kv) {
+  std::ostringstream str;
+  for (auto& x : kv) {
+    str << x.first << "=" << x.second << "\n";
+  }
+  return str.str();
+}
+
+std::map<std::string, std::string> decode_kv(const std::string& payload) {
+  auto ret = std::map<std::string, std::string>();
+  std::istringstream str(payload);
+  std::string line;
+  while (std::getline(str, line)) {
+    auto pos = line.find('=');
+    if (pos != std::string::npos) {
+      ret[line.substr(0, pos)] = line.substr(pos + 1);
+    }
+  }
+  return ret;
+}
+
+size_t assign_offsets(std::vector<tensor_info_t>& tensors) {
+  size_t offset = 0u;
+  for (auto& t : tensors) {
+    t.offset = offset;
+    offset += (t.size + ALIGNMENT - 1u) / ALIGNMENT * ALIGNMENT;
+  }
+  return offset;
+}
+
+// line 1: <shm_name> <slot_size> <num_of_slots>
+// then one line per tensor:
+//   <i|o> <name> <data_type> <size> <offset> <has_fix_point> <fix_point>
+//   <num_of_dims> <dims>...
+std::string encode_layout(const layout_t& layout) {
+  std::ostringstream str;
+  str << layout.shm_name << " " << layout.slot_size << " "
+      << layout.num_of_slots << "\n";
+  for (auto& t : layout.tensors) {
+    str << (t.is_input ? "i" : "o") << " " << t.name << " " << t.data_type
+        << " " << t.size << " " << t.offset << " " << t.has_fix_point << " "
+        << t.fix_point << " " << t.dims.size();
+    for (auto d : t.dims) {
+      str << " " << d;
+    }
+    str << "\n";
+  }
+  return str.str();
+}
+
+layout_t decode_layout(const std::string& payload) {
+  auto ret = layout_t();
+  std::istringstream str(payload);
+  str >> ret.shm_name >> ret.slot_size >> ret.num_of_slots;
+  std::string dir;
+  while (str >> dir) {
+    auto t = tensor_info_t();
+    size_t num_of_dims = 0u;
+    t.is_input = dir == "i";
+    str >> t.name >> t.data_type >> t.size >> t.offset >> t.has_fix_point >>
+        t.fix_point >> num_of_dims;
+    t.dims.resize(num_of_dims);
+    for (auto& d : t.dims) {
+      str >> d;
+    }
+    CHECK(str) << "corrupted layout: " << payload;
+    ret.tensors.emplace_back(std::move(t));
+  }
+  return ret;
+}
+
+static std::system_error shm_error(const std::string& what,
+                                   const std::string& name) {
+  return std::system_error(errno, std::generic_category(),
+                           what + " shared memory " + name);
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::create(const std::string& name,
+                                                   size_t size) {
+  auto fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    throw shm_error("cannot create", name);
+  }
+  // do not leave a half created segment behind.
+  auto fail = [fd, &name](const std::string& what) {
+    auto e = shm_error(what, name);
+    close(fd);
+    shm_unlink(name.c_str());
+    return e;
+  };
+  if (ftruncate(fd, (off_t)size) != 0) {
+    throw fail("cannot resize");
+  }
+  auto data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    throw fail("cannot map");
+  }
+  close(fd);
+  return std::unique_ptr<SharedMemory>(
+      new SharedMemory(name, (char*)data, size, true));
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::open(const std::string& name,
+                                                 size_t size) {
+  auto fd = shm_open(name.c_str(), O_RDWR, 0600);
+  if (fd < 0) {
+    throw shm_error("cannot open", name);
+  }
+  auto data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    auto e = shm_error("cannot map", name);
+    close(fd);
+    throw e;
+  }
+  close(fd);
+  return std::unique_ptr<SharedMemory>(
+      new SharedMemory(name, (char*)data, size, false));
+}
+
+SharedMemory::SharedMemory(const std::string& name, char* data, size_t size,
+                           bool owner)
+    : name_{name}, data_{data}, size_{size}, owner_{owner} {}
+
+SharedMemory::~SharedMemory() {
+  munmap(data_, size_);
+  if (owner_) {
+    shm_unlink(name_.c_str());
+  }
+}
+
+}  // namespace shm
+}  // namespace vart
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+// Protocol between vart_shm_server and libvart-shm-runner.
+//
+// Control messages go through a Unix domain socket, one connection per
+// client runner. Every message is a fixed size header followed by
+// `payload_size` bytes of text payload.
+//
+//   client                         server
+//   CREATE {key=value lines}  -->
+//                             <--  CREATED {shm layout}  or ERROR {what}
+//   RUN {slot, job_id}        -->
+//                             <--  DONE {slot, job_id, ret}
+//
+// Tensor payloads never go through the socket. The server creates a
+// POSIX shared memory segment per connection, which is a ring of
+// `num_of_slots` slots, and every slot holds all input tensors
+// followed by all output tensors of one request. The client writes
+// inputs into a slot, sends RUN with the slot index and reads outputs
+// from the same slot after DONE.
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vart {
+namespace shm {
+
+enum msg_type_t : uint32_t {
+  MSG_CREATE = 1,
+  MSG_CREATED = 2,
+  MSG_RUN = 3,
+  MSG_DONE = 4,
+  MSG_ERROR = 5,
+};
+
+struct msg_header_t {
+  uint32_t type;
+  uint32_t slot;
+  uint32_t job_id;
+  int32_t ret;
+  uint32_t payload_size;
+};
+
+struct tensor_info_t {
+  bool is_input;
+  std::string name;
+  std::string data_type;
+  std::vector<std::int32_t> dims;
+  // in bytes
+  size_t size;
+  // offset within a slot
+  size_t offset;
+  bool has_fix_point;
+  int fix_point;
+};
+
+struct layout_t {
+  std::string shm_name;
+  size_t slot_size;
+  size_t num_of_slots;
+  std::vector<tensor_info_t> tensors;
+};
+
+std::string default_socket_path();
+
+// return false if the peer is closed or on error.
+bool send_msg(int fd, const msg_header_t& header,
+              const std::string& payload = std::string());
+bool recv_msg(int fd, msg_header_t& header, std::string& payload);
+
+// "key=value" lines
+std::string encode_kv(const std::map<std::string, std::string>& kv);
+std::map<std::string, std::string> decode_kv(const std::string& payload);
+
+// assign tensor offsets within a slot and return the slot size.
+size_t assign_offsets(std::vector<tensor_info_t>& tensors);
+std::string encode_layout(const layout_t& layout);
+layout_t decode_layout(const std::string& payload);
+
+// A mapped POSIX shared memory segment, the owner unlinks it on
+// destruction. create() and open() throw std::system_error on failure.
+class SharedMemory {
+ public:
+  static std::unique_ptr<SharedMemory> create(const std::string& name,
+                                              size_t size);
+  static std::unique_ptr<SharedMemory> open(const std::string& name,
+                                            size_t size);
+  SharedMemory(const SharedMemory& other) = delete;
+  SharedMemory& operator=(const SharedMemory& rhs) = delete;
+  ~SharedMemory();
+
+ public:
+  char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  SharedMemory(const std::string& name, char* data, size_t size, bool owner);
+
+ private:
+  std::string name_;
+  char* data_;
+  size_t size_;
+  bool owner_;
+};
+
+}  // namespace shm
+}  // namespace vart
@@ -0,0 +1,371 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// client side of vart_shm_server, it is a runner plugin, e.g.
+//
+//   attrs->set_attr("lib", std::map<std::string, std::string>{
+//                              {"DPU", "libvart-shm-runner.so"}});
+//
+// attrs:
+//   "shm_runner_xmodel": path of the xmodel, the server loads the model
+//       from it. If absent, the graph is serialized into a temporary
+//       file.
+//   "shm_runner_lib": the runner library used by the server, e.g.
+//       libvart-dummy-runner.so, default is the one in the subgraph.
+//   "shm_runner_num_of_slots": number of requests in flight, default 8.
+//
+// Buffers returned by get_inputs()/get_outputs() live in slot 0 of the
+// shared memory, running with them copies nothing. They are one set of
+// buffers, so only one zero copy request is in flight at a time, and
+// execute_async() with them waits until the previous one is done. Other
+// buffers are copied into a free slot of the shared memory ring, any
+// number of them can be in flight.
+
+#include <glog/logging.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <xir/graph/graph.hpp>
+
+#include "../../runner/src/runner_helper.hpp"
+#include "./shm_protocol.hpp"
+#include "vart/runner_ext.hpp"
+#include "vitis/ai/collection_helper.hpp"
+#include "vitis/ai/env_config.hpp"
+#include "vitis/ai/erl_msg_box.hpp"
+#include "vitis/ai/plugin.hpp"
+
+DEF_ENV_PARAM(DEBUG_SHM_RUNNER, "0");
+
+using namespace vart::shm;
+
+namespace {
+class ShmRunner : public vart::RunnerExt {
+ public:
+  explicit ShmRunner(const xir::Subgraph* subgraph, xir::Attrs* attrs);
+  ShmRunner(const ShmRunner& other) = delete;
+  virtual ~ShmRunner();
+
+ public:
+  virtual std::pair<uint32_t, int> execute_async(
+      const std::vector<vart::TensorBuffer*>& input,
+      const std::vector<vart::TensorBuffer*>& output) override;
+  virtual int wait(int jobid, int timeout) override;
+  virtual std::vector<const xir::Tensor*> get_input_tensors() override;
+  virtual std::vector<const xir::Tensor*> get_output_tensors() override;
+  virtual std::vector<vart::TensorBuffer*> get_inputs() override;
+  virtual std::vector<vart::TensorBuffer*> get_outputs() override;
+  virtual int set_run_attrs(std::unique_ptr<xir::Attrs>&) override {
+    return 0;
+  }
+
+ private:
+  struct job_t {
+    std::promise<int> promise;
+    std::shared_future<int> future;
+    uint32_t slot;
+    // user buffers to copy the outputs back to, empty if zero copy.
+    std::vector<vart::TensorBuffer*> outputs;
+  };
+
+ private:
+  void connect_to_server(const std::string& path);
+  int find_slot(const std::vector<vart::TensorBuffer*>& input,
+                const std::vector<vart::TensorBuffer*>& output);
+  uint32_t acquire_slot(vitis::ai::ErlMsgBox<uint32_t>& slots);
+  void release_slot(const job_t& job);
+  void receiver_main();
+
+ private:
+  int fd_;
+  layout_t layout_;
+  std::unique_ptr<SharedMemory> shm_;
+  std::vector<std::unique_ptr<xir::Tensor>> inputs_;
+  std::vector<std::unique_ptr<xir::Tensor>> outputs_;
+  std::vector<std::vector<std::unique_ptr<vart::TensorBuffer>>> slot_inputs_;
+  std::vector<std::vector<std::unique_ptr<vart::TensorBuffer>>> slot_outputs_;
+  // slot 0 is reserved for get_inputs() and get_outputs(), it is in
+  // zero_copy_slot_ while no zero copy request is in flight.
+  vitis::ai::ErlMsgBox<uint32_t> free_slots_;
+  vitis::ai::ErlMsgBox<uint32_t> zero_copy_slot_;
+  std::map<int, std::unique_ptr<job_t>> jobs_;
+  int next_job_id_;
+  std::mutex mtx_for_jobs_;
+  std::mutex mtx_for_send_;
+  std::thread receiver_;
+};
+
+static void copy_tensor_buffer(vart::TensorBuffer* from,
+                               vart::TensorBuffer* to) {
+  auto from_data = from->data(vart::get_index_zeros(from->get_tensor()));
+  auto to_data = to->data(vart::get_index_zeros(to->get_tensor()));
+  memcpy((void*)to_data.first, (const void*)from_data.first,
+         std::min(from_data.second, to_data.second));
+}
+
+ShmRunner::ShmRunner(const xir::Subgraph* subgraph, xir::Attrs* attrs)
+    : fd_{-1}, next_job_id_{0} {
+  auto kv = std::map<std::string, std::string>();
+  auto tmp_xmodel = std::string();
+  if (attrs && attrs->has_attr("shm_runner_xmodel")) {
+    kv["xmodel"] = attrs->get_attr<std::string>("shm_runner_xmodel");
+  } else {
+    // the file is removed once the server has loaded it. The server
+    // caches models by "model_key", which is named after the contents:
+    // all processes running the same graph agree on it and their
+    // requests are batched together, different graphs never share it
+    // even if their names are the same.
+    auto graph = subgraph->get_graph();
+    tmp_xmodel = "/tmp/vart_shm_runner_" + std::to_string(getpid()) + "_" +
+                 std::to_string((uintptr_t)this) + ".xmodel";
+    graph->serialize(tmp_xmodel);
+    std::ostringstream contents;
+    contents << std::ifstream(tmp_xmodel, std::ios::binary).rdbuf();
+    kv["xmodel"] = tmp_xmodel;
+    kv["model_key"] =
+        std::to_string(std::hash<std::string>()(contents.str())) + "_" +
+        std::to_string(contents.str().size());
+  }
+  kv["subgraph"] = subgraph->get_name();
+  if (attrs && attrs->has_attr("shm_runner_lib")) {
+    kv["lib"] = attrs->get_attr<std::string>("shm_runner_lib");
+  }
+  kv["num_of_slots"] = std::to_string(
+      attrs && attrs->has_attr("shm_runner_num_of_slots")
+          ? attrs->get_attr<size_t>("shm_runner_num_of_slots")
+          : 8u);
+  connect_to_server(default_socket_path());
+  auto header = msg_header_t{MSG_CREATE, 0u, 0u, 0, 0u};
+  auto payload = encode_kv(kv);
+  auto ok = send_msg(fd_, header, payload) && recv_msg(fd_, header, payload);
+  if (!tmp_xmodel.empty()) {
+    unlink(tmp_xmodel.c_str());
+  }
+  CHECK(ok) << "cannot talk to the server";
+  CHECK_EQ(header.type, MSG_CREATED) << "server error: " << payload;
+  layout_ = decode_layout(payload);
+  CHECK_GE(layout_.num_of_slots, 2u) << "at least 2 slots are required";
+  shm_ = SharedMemory::open(layout_.shm_name,
+                            layout_.slot_size * layout_.num_of_slots);
+  for (auto& t : layout_.tensors) {
+    auto x = xir::Tensor::create(t.name, t.dims, xir::DataType(t.data_type));
+    if (t.has_fix_point) {
+      x->set_attr<int>("fix_point", t.fix_point);
+    }
+    (t.is_input ? inputs_ : outputs_).emplace_back(std::move(x));
+  }
+  slot_inputs_.resize(layout_.num_of_slots);
+  slot_outputs_.resize(layout_.num_of_slots);
+  for (auto slot = 0u; slot < layout_.num_of_slots; ++slot) {
+    auto base = shm_->data() + slot * layout_.slot_size;
+    for (auto& t : layout_.tensors) {
+      auto& buffers = t.is_input ? slot_inputs_[slot] : slot_outputs_[slot];
+      auto tensor = t.is_input ? inputs_[buffers.size()].get()
+                               : outputs_[buffers.size()].get();
+      buffers.emplace_back(
+          std::make_unique<vart::CpuFlatTensorBuffer>(base + t.offset, tensor));
+    }
+    (slot == 0u ? zero_copy_slot_ : free_slots_).emplace_send(slot);
+  }
+  receiver_ = std::thread([this]() { receiver_main(); });
+  LOG_IF(INFO, ENV_PARAM(DEBUG_SHM_RUNNER))
+      << "@" << (void*)this << " shm runner is created for subgraph "
+      << subgraph->get_name() << " shm=" << layout_.shm_name;
+}
+
+ShmRunner::~ShmRunner() {
+  // the server closes the session and the receiver thread exits.
+  shutdown(fd_, SHUT_RDWR);
+  receiver_.join();
+  close(fd_);
+}
+
+void ShmRunner::connect_to_server(const std::string& path) {
+  fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+  PCHECK(fd_ >= 0) << "cannot create socket";
+  auto addr = sockaddr_un();
+  addr.sun_family = AF_UNIX;
+  CHECK_LT(path.size(), sizeof(addr.sun_path)) << "path is too long " << path;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  PCHECK(connect(fd_, (sockaddr*)&addr, sizeof(addr)) == 0)
+      << "cannot connect to vart_shm_server at " << path
+      << ", please start it first.";
+}
+
+// return the slot if all buffers are already in the same slot of the
+// shared memory, -1 otherwise.
+int ShmRunner::find_slot(const std::vector<vart::TensorBuffer*>& input,
+                         const std::vector<vart::TensorBuffer*>& output) {
+  auto slot = -1;
+  for (auto& buffers : {input, output}) {
+    for (auto b : buffers) {
+      auto p = (char*)b->data(vart::get_index_zeros(b->get_tensor())).first;
+      if (p < shm_->data() || p >= shm_->data() + shm_->size()) {
+        return -1;
+      }
+      auto s = (int)((size_t)(p - shm_->data()) / layout_.slot_size);
+      if (slot != -1 && slot != s) {
+        return -1;
+      }
+      slot = s;
+    }
+  }
+  return slot;
+}
+
+std::pair<uint32_t, int> ShmRunner::execute_async(
+    const std::vector<vart::TensorBuffer*>& input,
+    const std::vector<vart::TensorBuffer*>& output) {
+  CHECK_EQ(input.size(), inputs_.size());
+  CHECK_EQ(output.size(), outputs_.size());
+  auto job = std::make_unique<job_t>();
+  job->future = job->promise.get_future().share();
+  auto slot = find_slot(input, output);
+  if (slot == 0) {
+    job->slot = acquire_slot(zero_copy_slot_);
+  } else {
+    // buffers of the shared memory outside slot 0 are not ours to run in
+    // place, copy them like any other buffers.
+    job->slot = acquire_slot(free_slots_);
+    for (auto i = 0u; i < input.size(); ++i) {
+      copy_tensor_buffer(input[i], slot_inputs_[job->slot][i].get());
+    }
+    job->outputs = output;
+  }
+  auto msg = msg_header_t{MSG_RUN, job->slot, 0u, 0, 0u};
+  {
+    std::lock_guard<std::mutex> lock(mtx_for_jobs_);
+    msg.job_id = (uint32_t)next_job_id_++;
+    jobs_[(int)msg.job_id] = std::move(job);
+  }
+  {
+    std::lock_guard<std::mutex> lock(mtx_for_send_);
+    if (!send_msg(fd_, msg)) {
+      LOG(WARNING) << "cannot talk to the server";
+      // no DONE will come, drop the job and give its slot back unless the
+      // receiver thread has already failed it.
+      std::lock_guard<std::mutex> lock_for_jobs(mtx_for_jobs_);
+      auto it = jobs_.find((int)msg.job_id);
+      try {
+        it->second->promise.set_value(-1);
+        release_slot(*it->second);
+      } catch (std::future_error&) {
+        // already completed
+      }
+      jobs_.erase(it);
+      return std::make_pair(msg.job_id, -1);
+    }
+  }
+  return std::make_pair(msg.job_id, 0);
+}
+
+uint32_t ShmRunner::acquire_slot(vitis::ai::ErlMsgBox<uint32_t>& slots) {
+  std::unique_ptr<uint32_t> slot;
+  while ((slot = slots.recv(std::chrono::milliseconds(1000))) == nullptr) {
+    LOG_IF(INFO, ENV_PARAM(DEBUG_SHM_RUNNER)) << "waiting for a free slot";
+  }
+  return *slot;
+}
+
+void ShmRunner::release_slot(const job_t& job) {
+  (job.slot == 0u ? zero_copy_slot_ : free_slots_).emplace_send(job.slot);
+}
+
+void ShmRunner::receiver_main() {
+  auto header = msg_header_t();
+  auto payload = std::string();
+  while (recv_msg(fd_, header, payload)) {
+    CHECK_EQ(header.type, MSG_DONE) << "unexpected message from the server";
+    job_t* job = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mtx_for_jobs_);
+      auto it = jobs_.find((int)header.job_id);
+      CHECK(it != jobs_.end()) << "unknown job " << header.job_id;
+      job = it->second.get();
+    }
+    for (auto i = 0u; i < job->outputs.size(); ++i) {
+      copy_tensor_buffer(slot_outputs_[job->slot][i].get(), job->outputs[i]);
+    }
+    release_slot(*job);
+    job->promise.set_value(header.ret);
+  }
+  // the server is gone, fail all pending jobs and give their slots back.
+  std::lock_guard<std::mutex> lock(mtx_for_jobs_);
+  for (auto& job : jobs_) {
+    try {
+      job.second->promise.set_value(-1);
+      release_slot(*job.second);
+    } catch (std::future_error&) {
+      // already completed
+    }
+  }
+}
+
+int ShmRunner::wait(int jobid, int timeout) {
+  job_t* job = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mtx_for_jobs_);
+    auto it = jobs_.find(jobid);
+    if (it == jobs_.end()) {
+      return -1;
+    }
+    job = it->second.get();
+  }
+  auto future = job->future;
+  if (timeout != -1 && future.wait_for(std::chrono::milliseconds(timeout)) !=
+                           std::future_status::ready) {
+    // keep the job, the receiver thread still refers to it.
+    return -1;
+  }
+  auto ret = future.get();
+  std::lock_guard<std::mutex> lock(mtx_for_jobs_);
+  jobs_.erase(jobid);
+  return ret;
+}
+
+std::vector<const xir::Tensor*> ShmRunner::get_input_tensors() {
+  return vitis::ai::vector_unique_ptr_get_const(inputs_);
+}
+
+std::vector<const xir::Tensor*> ShmRunner::get_output_tensors() {
+  return vitis::ai::vector_unique_ptr_get_const(outputs_);
+}
+
+std::vector<vart::TensorBuffer*> ShmRunner::get_inputs() {
+  return vitis::ai::vector_unique_ptr_get(slot_inputs_[0]);
+}
+
+std::vector<vart::TensorBuffer*> ShmRunner::get_outputs() {
+  return vitis::ai::vector_unique_ptr_get(slot_outputs_[0]);
+}
+
+}  // namespace
+
+extern "C" vart::Runner* create_runner_with_attrs(const xir::Subgraph* subgraph,
+                                                  xir::Attrs* attrs) {
+  return new ShmRunner(subgraph, attrs);
+}
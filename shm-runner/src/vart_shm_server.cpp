@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// A local inference daemon. It hosts one runner per (xmodel, subgraph,
+// backend lib) and serves any number of libvart-shm-runner clients on
+// the same host. All clients of the same model share the same runner,
+// which is wrapped by the async runner, so requests from different
+// processes are batched together.
+//
+// usage: vart_shm_server [socket_path]
+
+#include <glog/logging.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <xir/graph/graph.hpp>
+
+#include "../../runner/src/runner_helper.hpp"
+#include "./shm_protocol.hpp"
+#include "vitis/ai/collection_helper.hpp"
+#include "vitis/ai/env_config.hpp"
+#include "vitis/ai/erl_msg_box.hpp"
+
+DEF_ENV_PARAM(DEBUG_SHM_SERVER, "0");
+DEF_ENV_PARAM(XLNX_SHM_SERVER_ASYNC, "1");
+DEF_ENV_PARAM_2(XLNX_SHM_SERVER_NUM_OF_RUNNERS, "4", size_t);
+DEF_ENV_PARAM_2(XLNX_SHM_SERVER_MAX_NUM_OF_SLOTS, "64", size_t);
+// upper bound of the shared memory of a session, in bytes.
+DEF_ENV_PARAM_2(XLNX_SHM_SERVER_MAX_SHM_SIZE, "1073741824", size_t);
+
+using namespace vart::shm;
+
+namespace {
+struct hosted_model_t {
+  std::unique_ptr<xir::Graph> graph;
+  std::unique_ptr<xir::Attrs> attrs;
+  std::unique_ptr<vart::Runner> runner;
+};
+
+struct request_t {
+  uint32_t slot;
+  uint32_t job_id;
+  std::pair<uint32_t, int> job;
+};
+
+std::mutex g_mtx_for_models;
+std::map<std::string, std::shared_ptr<hosted_model_t>> g_models;
+std::atomic<int> g_num_of_sessions(0);
+
+const xir::Subgraph* find_subgraph(const xir::Graph* graph,
+                                   const std::string& name) {
+  for (auto s : graph->get_root_subgraph()->children_topological_sort()) {
+    if (name.empty() ? (s->has_attr("device") &&
+                        s->get_attr<std::string>("device") == "DPU")
+                     : s->get_name() == name) {
+      return s;
+    }
+  }
+  return nullptr;
+}
+
+std::shared_ptr<hosted_model_t> get_model(
+    const std::map<std::string, std::string>& kv) {
+  auto get = [&kv](const std::string& k) {
+    auto it = kv.find(k);
+    return it == kv.end() ? std::string() : it->second;
+  };
+  auto xmodel = get("xmodel");
+  auto subgraph_name = get("subgraph");
+  auto lib = get("lib");
+  // clients which serialize the graph into a temporary file name the
+  // model by its contents, others by the path.
+  auto model_key = get("model_key");
+  auto key = (model_key.empty() ? xmodel : model_key) + "|" + subgraph_name +
+             "|" + lib;
+  std::lock_guard<std::mutex> lock(g_mtx_for_models);
+  auto it = g_models.find(key);
+  if (it != g_models.end()) {
+    return it->second;
+  }
+  auto model = std::make_shared<hosted_model_t>();
+  model->graph = xir::Graph::deserialize(xmodel);
+  auto subgraph = find_subgraph(model->graph.get(), subgraph_name);
+  // a bad request fails its own session only, not the whole server.
+  if (subgraph == nullptr) {
+    throw std::runtime_error("cannot find subgraph '" + subgraph_name +
+                             "' in " + xmodel);
+  }
+  model->attrs = xir::Attrs::create();
+  if (ENV_PARAM(XLNX_SHM_SERVER_ASYNC)) {
+    model->attrs->set_attr<std::string>("interception",
+                                        "libvart-async-runner.so");
+    model->attrs->set_attr<size_t>("num_of_dpu_runners",
+                                   ENV_PARAM(XLNX_SHM_SERVER_NUM_OF_RUNNERS));
+  }
+  if (!lib.empty()) {
+    model->attrs->set_attr("lib",
+                           std::map<std::string, std::string>{
+                               {subgraph->get_attr<std::string>("device"),
+                                lib}});
+  }
+  model->runner =
+      vart::Runner::create_runner_with_attrs(subgraph, model->attrs.get());
+  LOG_IF(INFO, ENV_PARAM(DEBUG_SHM_SERVER))
+      << "model is loaded. key=" << key;
+  g_models[key] = model;
+  return model;
+}
+
+std::vector<tensor_info_t> get_tensor_infos(vart::Runner* runner) {
+  auto ret = std::vector<tensor_info_t>();
+  for (auto is_input : {true, false}) {
+    for (auto t : is_input ? runner->get_input_tensors()
+                           : runner->get_output_tensors()) {
+      auto info = tensor_info_t();
+      info.is_input = is_input;
+      info.name = t->get_name();
+      info.data_type = t->get_data_type().to_string();
+      info.dims = t->get_shape();
+      info.size = (size_t)t->get_data_size();
+      info.has_fix_point = t->has_attr("fix_point");
+      info.fix_point = info.has_fix_point ? t->get_attr<int>("fix_point") : 0;
+      ret.emplace_back(std::move(info));
+    }
+  }
+  return ret;
+}
+
+// "num_of_slots" from the client, at least 2: one is reserved for zero
+// copy requests.
+size_t get_num_of_slots(const std::map<std::string, std::string>& kv) {
+  auto it = kv.find("num_of_slots");
+  if (it == kv.end()) {
+    return 8u;
+  }
+  auto& value = it->second;
+  auto max_num_of_slots = ENV_PARAM(XLNX_SHM_SERVER_MAX_NUM_OF_SLOTS);
+  auto num_of_slots = std::numeric_limits<size_t>::max();
+  if (!value.empty() && value.size() <= 9u &&
+      value.find_first_not_of("0123456789") == std::string::npos) {
+    num_of_slots = (size_t)std::stoul(value);
+  }
+  if (num_of_slots < 2u || num_of_slots > max_num_of_slots) {
+    throw std::invalid_argument("num_of_slots=" + value +
+                                " is out of range [2, " +
+                                std::to_string(max_num_of_slots) + "]");
+  }
+  return num_of_slots;
+}
+
+// send DONE for every request in submission order. It is the only
+// thread which writes to the socket after CREATED.
+void completion_main(int fd, vart::Runner* runner,
+                     vitis::ai::ErlMsgBox<request_t>* queue) {
+  while (true) {
+    auto req = queue->recv(std::chrono::milliseconds(1000));
+    if (req == nullptr) {
+      continue;
+    }
+    if (req->job_id == (uint32_t)-1) {
+      break;
+    }
+    auto ret = req->job.second == 0
+                   ? runner->wait((int)req->job.first, -1)
+                   : req->job.second;
+    auto done = msg_header_t{MSG_DONE, req->slot, req->job_id, ret, 0u};
+    if (!send_msg(fd, done)) {
+      LOG_IF(INFO, ENV_PARAM(DEBUG_SHM_SERVER)) << "client is gone.";
+    }
+  }
+}
+
+void session_main(int fd) {
+  auto session_id = g_num_of_sessions++;
+  auto header = msg_header_t();
+  auto payload = std::string();
+  if (!recv_msg(fd, header, payload) || header.type != MSG_CREATE) {
+    LOG(WARNING) << "session " << session_id << ": protocol error";
+    close(fd);
+    return;
+  }
+  auto kv = decode_kv(payload);
+  std::shared_ptr<hosted_model_t> model;
+  auto layout = layout_t();
+  std::unique_ptr<SharedMemory> shm;
+  try {
+    model = get_model(kv);
+    layout.shm_name = "/vart_shm_" + std::to_string(getpid()) + "_" +
+                      std::to_string(session_id);
+    layout.num_of_slots = get_num_of_slots(kv);
+    layout.tensors = get_tensor_infos(model->runner.get());
+    layout.slot_size = assign_offsets(layout.tensors);
+    auto max_shm_size = ENV_PARAM(XLNX_SHM_SERVER_MAX_SHM_SIZE);
+    if (layout.slot_size == 0u ||
+        layout.slot_size > max_shm_size / layout.num_of_slots) {
+      throw std::invalid_argument(
+          "slot_size=" + std::to_string(layout.slot_size) +
+          " num_of_slots=" + std::to_string(layout.num_of_slots) +
+          " do not fit in XLNX_SHM_SERVER_MAX_SHM_SIZE=" +
+          std::to_string(max_shm_size));
+    }
+    shm = SharedMemory::create(layout.shm_name,
+                               layout.slot_size * layout.num_of_slots);
+  } catch (std::exception& e) {
+    LOG(WARNING) << "session " << session_id << ": " << e.what();
+    send_msg(fd, msg_header_t{MSG_ERROR, 0u, 0u, -1, 0u}, e.what());
+    close(fd);
+    return;
+  }
+  auto runner = model->runner.get();
+  // tensor buffers are views of the shared memory, nothing is copied.
+  auto input_tensors = runner->get_input_tensors();
+  auto output_tensors = runner->get_output_tensors();
+  auto inputs = std::vector<std::vector<std::unique_ptr<vart::TensorBuffer>>>(
+      layout.num_of_slots);
+  auto outputs = std::vector<std::vector<std::unique_ptr<vart::TensorBuffer>>>(
+      layout.num_of_slots);
+  for (auto slot = 0u; slot < layout.num_of_slots; ++slot) {
+    auto base = shm->data() + slot * layout.slot_size;
+    for (auto& t : layout.tensors) {
+      auto& buffers = t.is_input ? inputs[slot] : outputs[slot];
+      auto tensor = t.is_input ? input_tensors[buffers.size()]
+                               : output_tensors[buffers.size()];
+      buffers.emplace_back(
+          std::make_unique<vart::CpuFlatTensorBuffer>(base + t.offset, tensor));
+    }
+  }
+  if (!send_msg(fd, msg_header_t{MSG_CREATED, 0u, 0u, 0, 0u},
+                encode_layout(layout))) {
+    close(fd);
+    return;
+  }
+  LOG_IF(INFO, ENV_PARAM(DEBUG_SHM_SERVER))
+      << "session " << session_id << " created. shm=" << layout.shm_name
+      << " slot_size=" << layout.slot_size
+      << " num_of_slots=" << layout.num_of_slots;
+  auto queue = vitis::ai::ErlMsgBox<request_t>(layout.num_of_slots + 1u);
+  auto completion = std::thread(completion_main, fd, runner, &queue);
+  while (recv_msg(fd, header, payload)) {
+    if (header.type != MSG_RUN || header.slot >= layout.num_of_slots) {
+      LOG(WARNING) << "session " << session_id << ": bad request. type="
+                   << header.type << " slot=" << header.slot;
+      break;
+    }
+    auto job = runner->execute_async(
+        vitis::ai::vector_unique_ptr_get(inputs[header.slot]),
+        vitis::ai::vector_unique_ptr_get(outputs[header.slot]));
+    queue.emplace_send(request_t{header.slot, header.job_id, job});
+  }
+  queue.emplace_send(request_t{0u, (uint32_t)-1, {0u, 0}});
+  completion.join();
+  close(fd);
+  LOG_IF(INFO, ENV_PARAM(DEBUG_SHM_SERVER))
+      << "session " << session_id << " closed.";
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  auto path = argc >= 2 ? std::string(argv[1]) : default_socket_path();
+  signal(SIGPIPE, SIG_IGN);
+  auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  PCHECK(fd >= 0) << "cannot create socket";
+  auto addr = sockaddr_un();
+  addr.sun_family = AF_UNIX;
+  CHECK_LT(path.size(), sizeof(addr.sun_path)) << "path is too long " << path;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  unlink(path.c_str());
+  PCHECK(bind(fd, (sockaddr*)&addr, sizeof(addr)) == 0)
+      << "cannot bind " << path;
+  PCHECK(listen(fd, 64) == 0) << "cannot listen " << path;
+  LOG(INFO) << "vart_shm_server is listening on " << path;
+  while (true) {
+    auto client = accept(fd, nullptr, nullptr);
+    if (client < 0) {
+      PLOG(WARNING) << "accept failed";
+      continue;
+    }
+    std::thread(session_main, client).detach();
+  }
+  return 0;
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// several client processes share one vart_shm_server. Every process
+// runs NUM_OF_REQUESTS requests with NUM_OF_INFLIGHT requests in
+// flight (1 with ZERO_COPY) and reports its own frame rate, the parent
+// reports the aggregated one.
+//
+// usage:
+//   vart_shm_server &
+//   env NUM_OF_PROCESSES=4 test_shm_runner <xmodel> [backend_lib]
+//
+// backend_lib is the runner which the server loads for the DPU
+// subgraph, e.g. libvart-dummy-runner.so. The default is the backend
+// selected by the server itself.
+
+#include <glog/logging.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <xir/graph/graph.hpp>
+
+#include "../../runner/src/runner_helper.hpp"
+#include "vart/runner.hpp"
+#include "vart/runner_ext.hpp"
+#include "vitis/ai/collection_helper.hpp"
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM(NUM_OF_PROCESSES, "2");
+DEF_ENV_PARAM(NUM_OF_REQUESTS, "1000");
+DEF_ENV_PARAM(NUM_OF_INFLIGHT, "4");
+DEF_ENV_PARAM(ZERO_COPY, "1");
+using namespace std;
+
+using buffers_t = vector<unique_ptr<vart::TensorBuffer>>;
+
+static const xir::Subgraph* find_dpu_subgraph(const xir::Graph* graph) {
+  for (auto s : graph->get_root_subgraph()->children_topological_sort()) {
+    if (s->has_attr("device") && s->get_attr<std::string>("device") == "DPU") {
+      return s;
+    }
+  }
+  return nullptr;
+}
+
+static int client_main(const std::string& xmodel, const std::string& lib,
+                       int id) {
+  auto graph = xir::Graph::deserialize(xmodel);
+  auto subgraph = find_dpu_subgraph(graph.get());
+  CHECK(subgraph != nullptr) << "no DPU subgraph in " << xmodel;
+  auto attrs = xir::Attrs::create();
+  attrs->set_attr("lib", std::map<std::string, std::string>{
+                             {"DPU", "libvart-shm-runner.so"}});
+  attrs->set_attr<std::string>("shm_runner_xmodel", xmodel);
+  if (!lib.empty()) {
+    attrs->set_attr<std::string>("shm_runner_lib", lib);
+  }
+  auto runner = vart::Runner::create_runner_with_attrs(subgraph, attrs.get());
+  auto r = dynamic_cast<vart::RunnerExt*>(runner.get());
+  auto zero_copy = ENV_PARAM(ZERO_COPY) && r != nullptr;
+  // get_inputs()/get_outputs() are one set of buffers, one request at a
+  // time can run with them.
+  auto num_of_inflight = zero_copy ? 1u : (size_t)ENV_PARAM(NUM_OF_INFLIGHT);
+  auto num_of_requests = (size_t)ENV_PARAM(NUM_OF_REQUESTS);
+  auto inputs = vector<buffers_t>(num_of_inflight);
+  auto outputs = vector<buffers_t>(num_of_inflight);
+  for (auto i = 0u; i < num_of_inflight && !zero_copy; ++i) {
+    inputs[i] =
+        vart::alloc_cpu_flat_tensor_buffers(runner->get_input_tensors());
+    outputs[i] =
+        vart::alloc_cpu_flat_tensor_buffers(runner->get_output_tensors());
+  }
+  auto jobs = vector<int>(num_of_inflight, -1);
+  auto start = chrono::steady_clock::now();
+  for (auto i = 0u; i < num_of_requests + num_of_inflight; ++i) {
+    auto k = i % num_of_inflight;
+    if (jobs[k] >= 0) {
+      CHECK_EQ(runner->wait(jobs[k], -1), 0);
+      jobs[k] = -1;
+    }
+    if (i >= num_of_requests) {
+      continue;
+    }
+    auto job =
+        zero_copy ? runner->execute_async(r->get_inputs(), r->get_outputs())
+                  : runner->execute_async(
+                        vitis::ai::vector_unique_ptr_get(inputs[k]),
+                        vitis::ai::vector_unique_ptr_get(outputs[k]));
+    CHECK_EQ(job.second, 0) << "cannot submit request " << i;
+    jobs[k] = (int)job.first;
+  }
+  auto us = chrono::duration_cast<chrono::microseconds>(
+                chrono::steady_clock::now() - start)
+                .count();
+  cout << "process " << id << ": " << num_of_requests << " requests in " << us
+       << "us, fps=" << fixed << setprecision(2)
+       << num_of_requests * 1e6 / us << (zero_copy ? " (zero copy)" : "")
+       << endl;
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout << "usage: " << argv[0] << " <xmodel> [backend_lib]" << endl;
+    return 1;
+  }
+  auto xmodel = std::string(argv[1]);
+  auto lib = argc >= 3 ? std::string(argv[2]) : std::string();
+  auto num_of_processes = ENV_PARAM(NUM_OF_PROCESSES);
+  auto start = chrono::steady_clock::now();
+  for (auto i = 0; i < num_of_processes; ++i) {
+    auto pid = fork();
+    PCHECK(pid >= 0) << "cannot fork";
+    if (pid == 0) {
+      exit(client_main(xmodel, lib, i));
+    }
+  }
+  auto ok = true;
+  for (auto i = 0; i < num_of_processes; ++i) {
+    int status = 0;
+    wait(&status);
+    ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  }
+  auto us = chrono::duration_cast<chrono::microseconds>(
+                chrono::steady_clock::now() - start)
+                .count();
+  auto total = (size_t)num_of_processes * ENV_PARAM(NUM_OF_REQUESTS);
+  cout << "total: " << total << " requests in " << us << "us, fps=" << fixed
+       << setprecision(2) << total * 1e6 / us << endl;
+  cout << (ok ? "PASS" : "FAIL") << endl;
+  return ok ? 0 : 1;
+}
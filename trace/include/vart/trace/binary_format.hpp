@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+// The binary trace file written by the trace flusher, see
+// VAI_TRACE_STREAM. All integers are in the byte order of the host.
+//
+//   file   := header chunk*
+//   header := "VAITRACE" u32:version u32:pid u32:sizeof(trace_record_t)
+//   chunk  := u8:type u32:size payload[size]
+//
+//   STRINGS := (u32:id u32:len bytes[len])*
+//   CLASS   := u32:class_id u32:n u32:column_name_id[n]
+//   EVENTS  := trace_record_t*
+//   INFO    := u32:n (u32:len key[len] u32:len value[len])[n]
+//   LOST    := u64:number of events overwritten before being flushed
+//
+// A string or a class is always written before the first event which
+// refers to it.
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "event.hpp"
+
+namespace vitis::ai::trace {
+namespace binary {
+constexpr char MAGIC[8] = {'V', 'A', 'I', 'T', 'R', 'A', 'C', 'E'};
+constexpr uint32_t VERSION = 1u;
+
+enum chunk_type_t : uint8_t {
+  CHUNK_STRINGS = 1,
+  CHUNK_CLASS = 2,
+  CHUNK_EVENTS = 3,
+  CHUNK_INFO = 4,
+  CHUNK_LOST = 5,
+};
+
+struct class_def_t {
+  std::string name;
+  std::vector<std::string> column_names;
+};
+
+struct trace_file_t {
+  uint32_t pid = 0u;
+  std::map<uint32_t, std::string> strings;
+  std::map<uint32_t, class_def_t> classes;
+  std::vector<trace_record_t> records;
+  std::vector<std::map<std::string, std::string>> infos;
+  uint64_t lost = 0u;
+};
+
+// read a whole trace file. A truncated last chunk, e.g. the process is
+// killed while flushing, is ignored.
+inline bool read_trace_file(const std::string& path, trace_file_t& out,
+                            std::string* error = nullptr) {
+  auto fail = [error](const std::string& msg) {
+    if (error != nullptr) {
+      *error = msg;
+    }
+    return false;
+  };
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return fail("cannot open " + path);
+  }
+  char magic[sizeof(MAGIC)];
+  uint32_t version = 0u;
+  uint32_t record_size = 0u;
+  in.read(magic, sizeof(magic));
+  in.read((char*)&version, sizeof(version));
+  in.read((char*)&out.pid, sizeof(out.pid));
+  in.read((char*)&record_size, sizeof(record_size));
+  if (!in || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+    return fail("not a vaitrace binary file");
+  }
+  if (version != VERSION || record_size != sizeof(trace_record_t)) {
+    return fail("unsupported version " + std::to_string(version));
+  }
+  while (true) {
+    uint8_t type = 0u;
+    uint32_t size = 0u;
+    in.read((char*)&type, sizeof(type));
+    in.read((char*)&size, sizeof(size));
+    auto payload = std::string(in ? size : 0u, '\0');
+    in.read(&payload[0], size);
+    if (!in) {
+      break;
+    }
+    auto p = payload.data();
+    auto end = p + payload.size();
+    auto u32 = [&p, end]() {
+      uint32_t v = 0u;
+      if (p + sizeof(v) <= end) {
+        memcpy(&v, p, sizeof(v));
+      }
+      p += sizeof(v);
+      return v;
+    };
+    auto str = [&p, end, &u32]() {
+      auto len = u32();
+      auto ret = std::string(p, std::min<size_t>(len, end - std::min(p, end)));
+      p += len;
+      return ret;
+    };
+    switch (type) {
+      case CHUNK_STRINGS:
+        while (p < end) {
+          auto id = u32();
+          out.strings[id] = str();
+        }
+        break;
+      case CHUNK_CLASS: {
+        auto id = u32();
+        auto& c = out.classes[id];
+        c.name = out.strings[id];
+        for (auto n = u32(); n > 0u && p < end; --n) {
+          c.column_names.push_back(out.strings[u32()]);
+        }
+        break;
+      }
+      case CHUNK_EVENTS: {
+        auto n = payload.size() / sizeof(trace_record_t);
+        auto old_size = out.records.size();
+        out.records.resize(old_size + n);
+        memcpy((void*)&out.records[old_size], payload.data(),
+               n * sizeof(trace_record_t));
+        break;
+      }
+      case CHUNK_INFO: {
+        auto info = std::map<std::string, std::string>();
+        for (auto n = u32(); n > 0u && p < end; --n) {
+          auto k = str();
+          info[k] = str();
+        }
+        out.infos.emplace_back(std::move(info));
+        break;
+      }
+      case CHUNK_LOST: {
+        uint64_t lost = 0u;
+        memcpy(&lost, p, std::min<size_t>(sizeof(lost), payload.size()));
+        out.lost += lost;
+        break;
+      }
+      default:
+        // unknown chunks are skipped, for forward compatibility.
+        break;
+    }
+  }
+  return true;
+}
+}  // namespace binary
+}  // namespace vitis::ai::trace
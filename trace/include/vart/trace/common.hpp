@@ -18,6 +18,8 @@
 #ifndef __COMMON_H_
 #define __COMMON_H_
 
+#include <atomic>
+
 #include "event.hpp"
 #include "payload.hpp"
 #include "ringbuf.hpp"
@@ -31,10 +33,11 @@ namespace vitis::ai::trace {
 // using namespace std;
 using std::map;
 using vai_trace_header_t = traceEventBase;
-using vai_trace_q_t = RingBuf<vai_trace_header_t>;
+using vai_trace_q_t = RingBuf<trace_record_t>;
 using vai_trace_opt_t = std::pair<string, string>;
 using vai_trace_options_t = map<string, string>;
 
+class trace_stream;
 class trace_controller {
  public:
   trace_controller(map<string,string> options);
@@ -44,11 +47,20 @@ class trace_controller {
   string get_logger_file_path(void);
   string get_logger_dir_path(void);
   void push_info(trace_entry_t i);
+  // info entries from the `from`-th one
+  vector<trace_entry_t> get_info(size_t from);
   vai_trace_q_t* p_rbuf=nullptr;
-  vector<trace_entry_t> infobase;
+  // not null if events are streamed to a binary file
+  trace_stream* stream = nullptr;
 
  private:
-  std::mutex infobase_lock;
+  // info entries are pushed without lock to the front of a list which
+  // is never popped, nodes are immutable once linked.
+  struct info_node_t {
+    trace_entry_t entry;
+    info_node_t* next;
+  };
+  std::atomic<info_node_t*> infobase{nullptr};
   string logger_dir_path;
   string logger_file_path;
   bool enabled;
@@ -60,10 +72,6 @@ inline trace_controller &get_trace_controller_inst() {
     return tc_inst;
 }
 
-inline vector<trace_entry_t>* get_infobase() {
-  return &get_trace_controller_inst().infobase;
-}
-
 inline vai_trace_q_t* get_rbuf() {
     return get_trace_controller_inst().p_rbuf;
 }
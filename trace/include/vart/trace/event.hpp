@@ -17,6 +17,8 @@
 
 #pragma once
 #include <stdlib.h>
+
+#include <cstdint>
 #include <iostream>
 #include <map>
 #include <sstream>
@@ -74,4 +76,40 @@ class traceEventBase {
   double ts;
 };
 #pragma pack(pop)
+
+enum trace_field_type_t : uint8_t {
+  TRACE_FIELD_NONE = 0,
+  TRACE_FIELD_INT,
+  TRACE_FIELD_UINT,
+  TRACE_FIELD_DOUBLE,
+  // the value is the id of an interned string
+  TRACE_FIELD_STRING,
+};
+
+// A fixed-size, trivially copyable trace event. It is what the per
+// thread rings hold, and what the binary trace file is made of.
+struct trace_record_t {
+  static constexpr size_t MAX_FIELDS = 8u;
+  double ts;
+  uint32_t pid;
+  // the interned class name
+  uint32_t class_id;
+  uint8_t cpu_id;
+  uint8_t num_of_fields;
+  uint8_t types[MAX_FIELDS];
+  uint64_t fields[MAX_FIELDS];
+};
+
+// intern `s` into the process wide string pool and return its id, the
+// same string always gets the same id. Cheap for strings which the
+// calling thread has seen before.
+uint32_t intern_str(const char* s, size_t len);
+inline uint32_t intern_str(const std::string& s) {
+  return intern_str(s.data(), s.size());
+}
+std::string lookup_str(uint32_t id);
+
+// fill ts, pid and cpu_id.
+void init_record(trace_record_t& r, uint32_t class_id);
+std::string field_to_string(const trace_record_t& r, size_t idx);
 }  // namespace vitis::ai::trace
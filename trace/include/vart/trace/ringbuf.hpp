@@ -16,18 +16,35 @@
  */
 
 #pragma once
+// Per-thread trace ring buffers.
+//
+// Every thread which emits events gets its own fixed-size ring of
+// records on its first event. Only the owner thread writes to a ring,
+// so writing an event takes no lock: the record is filled in place in
+// the next slot, overwriting the oldest one when the ring is full. A
+// per-slot sequence number lets readers copy records out while the
+// owner keeps writing, torn or overwritten records are detected and
+// dropped. Rings of exited threads are kept and handed to the next new
+// thread, so short lived threads do not allocate new rings.
+
+#include <glog/logging.h>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <cstring>
-#include <exception>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "event.hpp"
 #include "vaitrace_dbg.hpp"
@@ -46,61 +63,168 @@ using std::endl;
 using std::vector;
 using std::string;
 template <typename T>
-class RingBuf : public list<T*> {
+class RingBuf {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "records are copied out while being overwritten");
+
  public:
-  RingBuf(size_t size_mb = 1, size_t substitution_rate = 20)
-      : cur_size_(0), substitution_rate(substitution_rate), m_lock{} {
+  // `size_mb` is the size of the ring of each thread.
+  explicit RingBuf(size_t size_mb = 1) : mtx_{}, rings_{}, free_rings_{} {
     CHECK(size_mb > 0 && size_mb <= 32);
-    max_size_ = size_mb * 1024 * 1024;
+    num_of_slots_ = size_mb * 1024 * 1024 / sizeof(slot_t);
   }
+  RingBuf(const RingBuf& other) = delete;
+  RingBuf& operator=(const RingBuf& rhs) = delete;
 
-  ~RingBuf() {}
+ public:
+  // fill the next record of the calling thread in place, lock free.
+  template <typename F>
+  void write(F fill) {
+    auto ring = local_ring();
+    auto head = ring->head.load(std::memory_order_relaxed);
+    auto& slot = ring->slots[head % ring->size];
+    auto seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq + 1u, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    fill(slot.value);
+    slot.seq.store(seq + 2u, std::memory_order_release);
+    ring->head.store(head + 1u, std::memory_order_release);
+  }
 
-  void push(T* data) {
-    lock_guard<mutex> lock(m_lock);
-    // m_lock.lock();
-    this->push_back(data);
-    cur_size_ += data->get_size();
-    // m_lock.unlock();
+  void push(const T& value) {
+    write([&value](T& r) { r = value; });
+  }
 
-    // This step can be asynchronous
-    maintain();
+  // append records which are not drained yet to `out`, return the
+  // number of records which are overwritten before being drained.
+  uint64_t drain(std::vector<T>& out) {
+    auto lost = (uint64_t)0u;
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (auto& ring : rings_) {
+      auto head = ring->head.load(std::memory_order_acquire);
+      auto tail = std::max<uint64_t>(ring->tail, head - std::min<uint64_t>(
+                                                           head, ring->size));
+      lost += tail - ring->tail;
+      for (auto i = tail; i < head; ++i) {
+        out.emplace_back();
+        if (!read(*ring, i, out.back())) {
+          out.pop_back();
+          lost++;
+        }
+      }
+      ring->tail = head;
+    }
+    return lost;
   }
 
-  void lock(void) {
-      m_lock.lock();
+  // visit a copy of all records in the rings, drained or not, in
+  // timestamp order.
+  template <typename F>
+  void for_each(F f) {
+    auto records = std::vector<T>();
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      for (auto& ring : rings_) {
+        auto head = ring->head.load(std::memory_order_acquire);
+        auto n = std::min<uint64_t>(head, ring->size);
+        for (auto i = head - n; i < head; ++i) {
+          records.emplace_back();
+          if (!read(*ring, i, records.back())) {
+            records.pop_back();
+          }
+        }
+      }
+    }
+    std::stable_sort(records.begin(), records.end(),
+                     [](const T& a, const T& b) { return a.ts < b.ts; });
+    for (auto& r : records) {
+      f(r);
+    }
   }
 
-  void unlock(void) {
-      m_lock.unlock();
+  size_t num_of_rings() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return rings_.size();
   }
 
  private:
-  size_t max_size_;
-  size_t cur_size_;
-  size_t substitution_rate;
-  std::mutex m_lock;
-  bool overflowed(void) { return (cur_size_ > max_size_); }
-
-  void put_slots(void) {
-    size_t put_bytes = int(max_size_ * substitution_rate / 100);
-
-    CHECK(put_bytes <= cur_size_);
-
-    for (size_t i = 0; i < put_bytes;) {
-      auto entry = this->front();
-      auto entry_size = entry->get_size();
-      cur_size_ -= entry_size;
-      i += entry_size;
-      delete entry;
-      this->pop_front();
+  struct slot_t {
+    // odd while the slot is being written, 2 * N after N writes.
+    std::atomic<uint32_t> seq{0u};
+    T value;
+  };
+
+  struct thread_ring_t {
+    explicit thread_ring_t(size_t n)
+        : slots{std::make_unique<slot_t[]>(n)}, size{n}, head{0u}, tail{0u} {}
+    std::unique_ptr<slot_t[]> slots;
+    const size_t size;
+    // only written by the owner thread.
+    std::atomic<uint64_t> head;
+    // only used by drain, under mtx_.
+    uint64_t tail;
+  };
+
+  // the ring of the calling thread, it goes back to the free list when
+  // the thread exits.
+  struct local_ring_t {
+    ~local_ring_t() {
+      if (owner != nullptr) {
+        owner->release_ring(ring);
+      }
+    }
+    RingBuf* owner = nullptr;
+    thread_ring_t* ring = nullptr;
+  };
+
+  thread_ring_t* local_ring() {
+    thread_local local_ring_t local;
+    if (local.owner != this) {
+      if (local.owner != nullptr) {
+        local.owner->release_ring(local.ring);
+      }
+      local.ring = acquire_ring();
+      local.owner = this;
+    }
+    return local.ring;
+  }
+
+  thread_ring_t* acquire_ring() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!free_rings_.empty()) {
+      auto ret = free_rings_.back();
+      free_rings_.pop_back();
+      return ret;
     }
+    rings_.emplace_back(std::make_unique<thread_ring_t>(num_of_slots_));
+    VAITRACE_DBG << "new trace ring for thread " << std::this_thread::get_id()
+                 << ", " << rings_.size() << " rings in total";
+    return rings_.back().get();
+  }
+
+  void release_ring(thread_ring_t* ring) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    free_rings_.push_back(ring);
   }
 
-  void maintain(void) {
-    if (overflowed()) {
-      put_slots();
+  // copy the `idx`-th record ever written to the ring, fail if it is
+  // being written or is already overwritten.
+  static bool read(thread_ring_t& ring, uint64_t idx, T& out) {
+    auto& slot = ring.slots[idx % ring.size];
+    auto expected = (uint32_t)(2u * (idx / ring.size + 1u));
+    auto seq = slot.seq.load(std::memory_order_acquire);
+    if (seq != expected) {
+      return false;
     }
+    std::memcpy((void*)&out, (const void*)&slot.value, sizeof(T));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.seq.load(std::memory_order_relaxed) == seq;
   }
+
+ private:
+  size_t num_of_slots_;
+  std::mutex mtx_;
+  std::vector<std::unique_ptr<thread_ring_t>> rings_;
+  std::vector<thread_ring_t*> free_rings_;
 };
 }  // namespace vitis::ai::trace
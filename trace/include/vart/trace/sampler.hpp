@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+// Trace sampling, so that tracing can stay on in production.
+//
+//   VAI_TRACE_SAMPLE_RATE=N      keep 1 in N jobs, default 1, i.e. all
+//   VAI_TRACE_RATE_LIMIT=c:n,... keep at most n events per second of
+//                                class c, e.g. dpu-controller:1000
+//   VAI_TRACE_OVERHEAD_BUDGET=p  adjust N automatically, so that tracing
+//                                costs less than p percent of the cpu
+//                                time, e.g. 1.0
+//
+// A job is everything that a thread emits while a trace_job is alive,
+// e.g. dpu-runner and dpu-controller events of one DPU run. Events of a
+// sampled job are all kept, events of other jobs are all dropped, so
+// that begin/end pairs stay intact. Events outside of any job are only
+// subject to the rate limits. Every class counts the events offered
+// and kept, and the sampling report in the trace info scales the kept
+// events and spans up to estimate the whole population.
+#include <cstdint>
+#include <vector>
+
+#include "event.hpp"
+
+namespace vitis::ai::trace {
+class traceClass;
+struct class_sampling_t;
+class_sampling_t* new_class_sampling(traceClass* tc);
+
+// RAII, the events of the calling thread belong to a new job until it
+// is destroyed. Jobs do not nest, an inner job is part of the outer one.
+class trace_job {
+ public:
+  trace_job();
+  ~trace_job();
+  trace_job(const trace_job& other) = delete;
+  trace_job& operator=(const trace_job& rhs) = delete;
+
+ private:
+  bool owner_;
+};
+
+// start the auto mode if VAI_TRACE_OVERHEAD_BUDGET is set.
+void start_sampler();
+// false if the event is dropped, called before it is recorded.
+bool sample_event(traceClass* tc);
+// called after the event is recorded.
+void on_record(traceClass* tc, const trace_record_t& r);
+
+// per class counters and estimates, as info entries.
+std::vector<trace_entry_t> sampling_report();
+}  // namespace vitis::ai::trace
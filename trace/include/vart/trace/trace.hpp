@@ -18,6 +18,7 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <atomic>
 #include <chrono>
 #include <cstring>
 #include <fstream>
@@ -79,6 +80,36 @@ void unlock(void);
 void unlock(size_t &core_idx);
 void unlock(std::mutex &mutex);
 
+// A trace class resolved on its first event, so that later events skip
+// the lookup by name, e.g.
+//
+//   static auto tc = vitis::ai::trace::trace_class_handle("dpu-runner");
+//   tc.add_trace(name, batch, workload, depth);
+class trace_class_handle {
+ public:
+  explicit trace_class_handle(const char* name) : name_{name}, tc_{nullptr} {}
+
+  template <typename... Ts>
+  inline void add_trace(Ts... args) {
+    if (!is_enabled()) return;
+    auto tc = get();
+    if (tc != nullptr) tc->add_trace(args...);
+  }
+
+  traceClass* get() {
+    auto ret = tc_.load(std::memory_order_acquire);
+    if (ret == nullptr) {
+      ret = find_traceclass(name_);
+      tc_.store(ret, std::memory_order_release);
+    }
+    return ret;
+  }
+
+ private:
+  const char* name_;
+  std::atomic<traceClass*> tc_;
+};
+
 // Two helper functions
 template <typename... Ts>
 inline void add_trace(const char* name, Ts... args) {
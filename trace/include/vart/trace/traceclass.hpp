@@ -20,6 +20,7 @@
 #include <stdlib.h>
 #include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <fstream>
 #include <functional>
 #include <iomanip>
@@ -28,11 +29,13 @@
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "common.hpp"
 #include "ringbuf.hpp"
+#include "sampler.hpp"
 #include "vaitrace_dbg.hpp"
 
 namespace vitis::ai::trace {
@@ -42,59 +45,43 @@ namespace vitis::ai::trace {
 //
 // using namespace std;
 extern bool is_enabled(void);
-#if _WIN32
-template <typename T>
-#else
-template <typename TrFun, typename T>
-#endif
-class tevent : public traceEventBase {
- public:
-#if _WIN32
-   tevent(T& pl, std::vector<std::string> column_names_input,
-        std::string class_name_input, uint32_t column_num_input)
-    : traceEventBase(sizeof(pl)), payload(pl), column_names(column_names_input),
-      class_name(class_name_input), column_num(column_num_input)  {}
-#else 
-  tevent(TrFun& tf, T& pl)
-      : traceEventBase(sizeof(pl)), translate_f(tf), payload(pl) {}
-#endif
-  ~tevent() {}
-
-  trace_entry_t get() {
-    auto trace_entry = traceEventBase::get();
-
-    vector<string> payload_buf;
-    payload.to_vector(payload_buf);
 
-    auto payload_map = translate_f(payload_buf);
+inline void encode_field(trace_record_t& r, size_t idx, const char* v) {
+  r.types[idx] = TRACE_FIELD_STRING;
+  r.fields[idx] = intern_str(v, v == nullptr ? 0u : strlen(v));
+}
 
-    trace_entry.insert(payload_map.begin(), payload_map.end());
+inline void encode_field(trace_record_t& r, size_t idx, const string& v) {
+  r.types[idx] = TRACE_FIELD_STRING;
+  r.fields[idx] = intern_str(v);
+}
 
-    return trace_entry;
-  }
-#if _WIN32
-trace_entry_t translate_f(std::vector<std::string> data ) {
-   trace_entry_t ret;
-
-   ret.insert(std::make_pair("classname", this->class_name));
-   uint32_t data_size = (uint32_t)data.size();
-   auto col_num = std::min<uint32_t>(data_size, column_num);
-   for (size_t i = 0; i < col_num; i++) {
-     ret.insert(make_pair(column_names[i], data[i]));
-    }
-   return ret;
+template <typename T>
+inline void encode_field(trace_record_t& r, size_t idx, T v) {
+  static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                "trace fields are numbers or strings");
+  if constexpr (std::is_floating_point<T>::value) {
+    auto d = (double)v;
+    r.types[idx] = TRACE_FIELD_DOUBLE;
+    memcpy(&r.fields[idx], &d, sizeof(d));
+  } else if constexpr (std::is_enum<T>::value ||
+                       std::is_signed<T>::value) {
+    r.types[idx] = TRACE_FIELD_INT;
+    r.fields[idx] = (uint64_t)(int64_t)v;
+  } else {
+    r.types[idx] = TRACE_FIELD_UINT;
+    r.fields[idx] = (uint64_t)v;
   }
-#endif
- private:
-#if _WIN32
-  std::vector<std::string> column_names;
-  std::string class_name;
-  uint32_t column_num;
-#else
-  TrFun& translate_f;
-#endif
-  T payload;
-};
+}
+
+template <typename... Ts>
+inline void encode_fields(trace_record_t& r, const Ts&... args) {
+  static_assert(sizeof...(Ts) <= trace_record_t::MAX_FIELDS,
+                "too many trace fields");
+  size_t idx = 0u;
+  (encode_field(r, idx++, args), ...);
+  r.num_of_fields = (uint8_t)sizeof...(Ts);
+}
 
 void push_info(trace_entry_t i);
 class traceClass {
@@ -105,14 +92,13 @@ class traceClass {
   template <typename... Ts>
   inline void add_trace(Ts... args) {
     if (!is_enabled()) return;
-    auto payload = vitis::ai::trace::trace_payload<Ts...>(args...);
-#if _WIN32
-    auto e = new tevent<decltype(payload)> (payload, this->column_names, this->classname, this->column_num);
-#else
-    auto e = new tevent<decltype(this->translate_f), decltype(payload)>(
-        this->translate_f, payload);
-#endif
-    get_rbuf()->push(e);
+    if (!sample_event(this)) return;
+    auto self = this;
+    get_rbuf()->write([self, &args...](trace_record_t& r) {
+      init_record(r, self->class_id);
+      encode_fields(r, args...);
+      on_record(self, r);
+    });
   };
 
   template <typename... Ts>
@@ -135,27 +121,18 @@ class traceClass {
       auto pos = 2 * i;
       ret.insert(make_pair(buf[pos], buf[pos + 1]));
     }
-    // get_infobase()->push_back(ret);
     push_info(ret);
   };
-#ifndef _WIN32
-  std::function<trace_entry_t(std::vector<std::string>)> translate_f =
-      [this](std::vector<std::string> data) {
-        trace_entry_t ret;
-
-        ret.insert(std::make_pair("classname", this->classname));
-        uint32_t data_size = (uint32_t)data.size();
-        // MSVC NOTE: must use std::min<uint32_t> instead of std::min, otherwise
-        // strange compilation error illegal token.
-        auto col_num = std::min<uint32_t>(data_size, column_num);
-
-        for (size_t i = 0; i < col_num; i++) {
-          ret.insert(make_pair(this->column_names[i], data[i]));
-        }
-        return ret;
-      };
-#endif
+
+  // the text form of a record of this class.
+  trace_entry_t translate(const trace_record_t& r);
+  const vector<string>& get_column_names() const { return column_names; }
+
   string classname;
+  // the interned class name
+  uint32_t class_id;
+  // counters and rate limit, see sampler.hpp
+  class_sampling_t* sampling;
 
  private:
   uint32_t column_num;
@@ -164,5 +141,7 @@ class traceClass {
 
 traceClass* new_traceclass(const char* name_, vector<string> items);
 traceClass* find_traceclass(const char* classname);
+traceClass* find_traceclass(uint32_t class_id);
+std::vector<traceClass*> get_traceclasses();
 
 }  // namespace vitis::ai::trace
@@ -57,7 +57,9 @@ traceEventBase::traceEventBase(size_t payload_size) {
 #if _WIN32
   pid = GetCurrentProcessId();
 #else
-  pid = gettid();
+  // a syscall, do it once per thread.
+  thread_local auto tid = (pid_t)gettid();
+  pid = tid;
 #endif
 
 #if _WIN32
@@ -78,4 +80,38 @@ trace_entry_t traceEventBase::get() {
   return ret;
 };
 
+void init_record(trace_record_t& r, uint32_t class_id) {
+#if _WIN32
+  r.pid = GetCurrentProcessId();
+  r.cpu_id = 0;
+#else
+  thread_local auto tid = (uint32_t)gettid();
+  r.pid = tid;
+  r.cpu_id = (uint8_t)sched_getcpu();
+#endif
+  r.ts = get_xrt_ts();
+  r.class_id = class_id;
+  r.num_of_fields = 0u;
+}
+
+// the same text as to_string() of the original value.
+std::string field_to_string(const trace_record_t& r, size_t idx) {
+  auto v = r.fields[idx];
+  switch (r.types[idx]) {
+    case TRACE_FIELD_INT:
+      return std::to_string((int64_t)v);
+    case TRACE_FIELD_UINT:
+      return std::to_string(v);
+    case TRACE_FIELD_DOUBLE: {
+      auto d = 0.0;
+      memcpy(&d, &v, sizeof(d));
+      return to_string(d);
+    }
+    case TRACE_FIELD_STRING:
+      return lookup_str((uint32_t)v);
+    default:
+      return std::string();
+  }
+}
+
 }  // namespace vitis::ai::trace
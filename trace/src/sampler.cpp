@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <vart/trace/sampler.hpp>
+
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vart/trace/traceclass.hpp>
+#include <vitis/ai/metrics.hpp>
+#include <vitis/ai/tsc_clock.hpp>
+
+#include "internal.hpp"
+
+namespace vitis::ai::trace {
+
+struct class_sampling_t {
+  Counter* recorded;
+  Counter* dropped_by_job;
+  Counter* dropped_by_rate;
+  Counter* spans;
+  Counter* span_ns;
+  // the column of begin (1) / end (0), -1 if the class has no spans.
+  int event_state_idx;
+  // events per second, 0 is unlimited.
+  int64_t rate_limit;
+  std::atomic<int64_t> tokens;
+  std::atomic<int64_t> last_refill_ns;
+};
+
+namespace {
+// the cost of 1 in COST_SAMPLE events is measured.
+constexpr uint32_t COST_SAMPLE = 64u;
+constexpr uint64_t MAX_SAMPLE_RATE = 1u << 20;
+
+int64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             TscClock::now().time_since_epoch())
+      .count();
+}
+
+int64_t process_cpu_ns() {
+#if _WIN32
+  return now_ns() * std::thread::hardware_concurrency();
+#else
+  timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+// e.g. "dpu-controller:1000,py:100"
+std::map<std::string, int64_t> parse_rate_limits(const std::string& s) {
+  auto ret = std::map<std::string, int64_t>();
+  std::istringstream str(s);
+  std::string item;
+  while (std::getline(str, item, ',')) {
+    auto pos = item.rfind(':');
+    if (pos == std::string::npos) {
+      LOG(WARNING) << "ignore VAI_TRACE_RATE_LIMIT item: " << item;
+      continue;
+    }
+    ret[item.substr(0, pos)] = std::stoll(item.substr(pos + 1));
+  }
+  return ret;
+}
+
+struct sampler_t {
+  sampler_t()
+      : sample_rate{std::max<uint64_t>(
+            1u, std::stoull(my_getenv_s("VAI_TRACE_SAMPLE_RATE", "1")))},
+        overhead_budget{
+            std::stod(my_getenv_s("VAI_TRACE_OVERHEAD_BUDGET", "0"))},
+        overhead{0.0},
+        rate_limits{
+            parse_rate_limits(my_getenv_s("VAI_TRACE_RATE_LIMIT", ""))},
+        next_job{0u} {
+    auto& r = MetricsRegistry::instance();
+    jobs =
+        r.counter("vart_trace_jobs_total", "trace jobs", {{"result", "all"}});
+    sampled_jobs = r.counter("vart_trace_jobs_total", "trace jobs",
+                             {{"result", "sampled"}});
+    cost_ns = r.counter("vart_trace_cost_nanoseconds_total",
+                        "estimated cpu time spent in recording events");
+  }
+
+  bool next_job_sampled() {
+    jobs->inc();
+    auto n = sample_rate.load(std::memory_order_relaxed);
+    if (n > 1u && next_job.fetch_add(1u, std::memory_order_relaxed) % n != 0u) {
+      return false;
+    }
+    sampled_jobs->inc();
+    return true;
+  }
+
+  // keep the cost of tracing under the budget, by halving or doubling
+  // the sampling rate every second.
+  void adjust_main() {
+    auto last_cost = cost_ns->value();
+    auto last_cpu = process_cpu_ns();
+    while (true) {
+      std::this_thread::sleep_for(std::chrono::seconds(1));
+      auto cost = cost_ns->value();
+      auto cpu = process_cpu_ns();
+      if (cpu <= last_cpu) {
+        continue;
+      }
+      auto percent = 100.0 * (double)(cost - last_cost) / (cpu - last_cpu);
+      overhead.store(percent, std::memory_order_relaxed);
+      auto n = sample_rate.load(std::memory_order_relaxed);
+      auto new_n = n;
+      if (percent > overhead_budget) {
+        new_n = std::min(n * 2u, MAX_SAMPLE_RATE);
+      } else if (percent < overhead_budget / 4.0) {
+        new_n = std::max<uint64_t>(n / 2u, 1u);
+      }
+      if (new_n != n) {
+        VAITRACE_DBG << "trace overhead " << percent << "%, sample 1 in "
+                     << new_n << " jobs";
+        sample_rate.store(new_n, std::memory_order_relaxed);
+      }
+      last_cost = cost;
+      last_cpu = cpu;
+    }
+  }
+
+  std::atomic<uint64_t> sample_rate;
+  const double overhead_budget;
+  std::atomic<double> overhead;
+  const std::map<std::string, int64_t> rate_limits;
+  std::atomic<uint64_t> next_job;
+  Counter* jobs;
+  Counter* sampled_jobs;
+  Counter* cost_ns;
+};
+
+sampler_t& sampler() {
+  // never destroyed, events are emitted while the process exits.
+  static sampler_t* the_sampler = new sampler_t();
+  return *the_sampler;
+}
+
+// -1: not in a job, 0: the job is dropped, 1: the job is sampled.
+thread_local int tl_job = -1;
+thread_local uint32_t tl_num_of_events = 0u;
+thread_local int64_t tl_cost_start = 0;
+
+bool take_token(class_sampling_t* s) {
+  auto now = now_ns();
+  auto last = s->last_refill_ns.load(std::memory_order_relaxed);
+  if (now - last >= 1000000 &&
+      s->last_refill_ns.compare_exchange_strong(last, now,
+                                                std::memory_order_relaxed)) {
+    // one second of burst at most.
+    auto refill = (int64_t)((double)s->rate_limit * (now - last) / 1e9);
+    auto tokens = std::max<int64_t>(s->tokens.load(std::memory_order_relaxed),
+                                    0);
+    s->tokens.store(std::min(tokens + refill, s->rate_limit),
+                    std::memory_order_relaxed);
+  }
+  return s->tokens.fetch_sub(1, std::memory_order_relaxed) > 0;
+}
+}  // namespace
+
+class_sampling_t* new_class_sampling(traceClass* tc) {
+  auto& r = MetricsRegistry::instance();
+  auto& name = tc->classname;
+  auto ret = new class_sampling_t();
+  auto events = [&r, &name](const char* result) {
+    return r.counter("vart_trace_events_total", "trace events",
+                     {{"class", name}, {"result", result}});
+  };
+  ret->recorded = events("recorded");
+  ret->dropped_by_job = events("dropped_by_job");
+  ret->dropped_by_rate = events("dropped_by_rate");
+  ret->spans = r.counter("vart_trace_spans_total", "recorded trace spans",
+                         {{"class", name}});
+  ret->span_ns = r.counter("vart_trace_span_nanoseconds_total",
+                           "total time of recorded trace spans",
+                           {{"class", name}});
+  auto& cols = tc->get_column_names();
+  auto it = std::find(cols.begin(), cols.end(), "event_state");
+  ret->event_state_idx = it == cols.end() ? -1 : (int)(it - cols.begin());
+  auto& limits = sampler().rate_limits;
+  auto limit = limits.find(name);
+  ret->rate_limit = limit == limits.end() ? 0 : limit->second;
+  ret->tokens = ret->rate_limit;
+  ret->last_refill_ns = now_ns();
+  return ret;
+}
+
+void start_sampler() {
+  auto& s = sampler();
+  VAITRACE_DBG << "sample 1 in " << s.sample_rate << " jobs, overhead budget "
+               << s.overhead_budget << "%";
+  if (s.overhead_budget > 0.0) {
+    std::thread([&s]() { s.adjust_main(); }).detach();
+  }
+}
+
+trace_job::trace_job() : owner_{is_enabled() && tl_job < 0} {
+  if (owner_) {
+    tl_job = sampler().next_job_sampled() ? 1 : 0;
+  }
+}
+
+trace_job::~trace_job() {
+  if (owner_) {
+    tl_job = -1;
+  }
+}
+
+bool sample_event(traceClass* tc) {
+  auto s = tc->sampling;
+  if (tl_job == 0) {
+    s->dropped_by_job->inc();
+    return false;
+  }
+  if (s->rate_limit > 0 && !take_token(s)) {
+    s->dropped_by_rate->inc();
+    return false;
+  }
+  if (++tl_num_of_events % COST_SAMPLE == 0u) {
+    tl_cost_start = now_ns();
+  }
+  return true;
+}
+
+void on_record(traceClass* tc, const trace_record_t& r) {
+  auto s = tc->sampling;
+  s->recorded->inc();
+  if (s->event_state_idx >= 0 && s->event_state_idx < r.num_of_fields) {
+    // begin timestamps of open spans, per thread and class.
+    thread_local std::unordered_map<traceClass*, std::vector<double>> open;
+    auto& stack = open[tc];
+    if (r.fields[s->event_state_idx] != 0u) {
+      // an unmatched begin, e.g. the end is dropped by a rate limit,
+      // must not grow the stack forever.
+      if (stack.size() < 64u) {
+        stack.push_back(r.ts);
+      }
+    } else if (!stack.empty()) {
+      s->spans->inc();
+      s->span_ns->inc((uint64_t)std::max(0.0, (r.ts - stack.back()) * 1e9));
+      stack.pop_back();
+    }
+  }
+  if (tl_cost_start != 0) {
+    sampler().cost_ns->inc((uint64_t)(now_ns() - tl_cost_start) * COST_SAMPLE);
+    tl_cost_start = 0;
+  }
+}
+
+std::vector<trace_entry_t> sampling_report() {
+  auto& sampler_ = sampler();
+  auto ret = std::vector<trace_entry_t>();
+  auto summary = trace_entry_t();
+  summary["classname"] = "trace_sampling";
+  summary["sample_rate"] = std::to_string(sampler_.sample_rate.load());
+  summary["jobs"] = std::to_string(sampler_.jobs->value());
+  summary["sampled_jobs"] = std::to_string(sampler_.sampled_jobs->value());
+  summary["overhead_budget_percent"] = to_string(sampler_.overhead_budget);
+  summary["overhead_percent"] = to_string(sampler_.overhead.load());
+  ret.push_back(summary);
+  for (auto tc : get_traceclasses()) {
+    auto s = tc->sampling;
+    auto recorded = s->recorded->value();
+    auto offered =
+        recorded + s->dropped_by_job->value() + s->dropped_by_rate->value();
+    if (offered == 0u) {
+      continue;
+    }
+    // every kept event stands for `scale` events of the population.
+    auto scale = recorded == 0u ? 0.0 : (double)offered / recorded;
+    auto spans = s->spans->value();
+    auto span_s = (double)s->span_ns->value() / 1e9;
+    auto e = trace_entry_t();
+    e["classname"] = "trace_sampling";
+    e["class"] = tc->classname;
+    e["offered"] = std::to_string(offered);
+    e["recorded"] = std::to_string(recorded);
+    e["dropped_by_job"] = std::to_string(s->dropped_by_job->value());
+    e["dropped_by_rate"] = std::to_string(s->dropped_by_rate->value());
+    e["scale"] = to_string(scale);
+    if (s->event_state_idx >= 0) {
+      e["spans"] = std::to_string(spans);
+      e["span_mean_s"] = to_string(spans == 0u ? 0.0 : span_s / spans);
+      e["estimated_spans"] = to_string(spans * scale);
+      e["estimated_span_total_s"] = to_string(span_s * scale);
+    }
+    ret.push_back(e);
+  }
+  return ret;
+}
+}  // namespace vitis::ai::trace
@@ -17,6 +17,8 @@
 
 #include "str.hpp"
 
+#include <vart/trace/event.hpp>
+
 namespace vitis::ai::trace {
 
 // MSVC NOTE: must not using namespace std; it trigger an error, 'byte':
@@ -25,32 +27,72 @@ namespace vitis::ai::trace {
 //
 // using namespace std;
 
-str_pool g_pool_;
+str_pool& pool_instance() {
+  // never destroyed, threads may emit events while the process exits.
+  static str_pool* the_pool = new str_pool();
+  return *the_pool;
+}
 
 size_t str_pool_size(void) { return pool_instance().size(); }
 
-str_pool::str_pool() : index(0), pool{} {};
+str_pool::str_pool() : mtx{}, index(0), strs{}, pool{} {};
 str_pool::~str_pool(){};
 
 str_id str_pool::add_str(const char* str_) {
-  if (pool[str_]) {
-    return pool[str_];
-  } else {
-    pool[str_] = new_idx();
-    return pool[str_];
+  return add_str(str_, str_ == nullptr ? 0u : strlen(str_));
+};
+
+str_id str_pool::add_str(const char* str_, size_t len) {
+  auto key = std::string_view(str_ == nullptr ? "" : str_, len);
+  std::lock_guard<std::mutex> lock(mtx);
+  auto it = pool.find(key);
+  if (it != pool.end()) {
+    return it->second;
   }
+  strs.emplace_back(key);
+  auto ret = new_idx();
+  pool.emplace(std::string_view(strs.back()), ret);
+  return ret;
 };
 
 const char* str_pool::idx_to_str(str_id id) {
-  for (const auto& [str, idx] : pool) {
-    if (idx == id) {
-      return str;
-    }
+  std::lock_guard<std::mutex> lock(mtx);
+  if (id == 0u || id > strs.size()) {
+    return NULL;
   }
-  return NULL;
+  return strs[id - 1u].c_str();
 };
 
-size_t str_pool::size() { return pool.size(); };
+size_t str_pool::size() {
+  std::lock_guard<std::mutex> lock(mtx);
+  return strs.size();
+};
+
+std::vector<std::string> str_pool::get_strs(size_t from) {
+  std::lock_guard<std::mutex> lock(mtx);
+  return std::vector<std::string>(strs.begin() + std::min(from, strs.size()),
+                                  strs.end());
+};
+
+uint32_t intern_str(const char* s, size_t len) {
+  // most strings are class names, column names and subgraph names, a
+  // small per thread cache avoids the lock of the pool.
+  thread_local std::unordered_map<std::string_view, str_id> cache;
+  auto key = std::string_view(s == nullptr ? "" : s, len);
+  auto it = cache.find(key);
+  if (it != cache.end()) {
+    return it->second;
+  }
+  auto ret = pool_instance().add_str(key.data(), key.size());
+  // the key must view the pooled copy, `s` may be gone after return.
+  cache.emplace(std::string_view(pool_instance().idx_to_str(ret), len), ret);
+  return ret;
+};
+
+std::string lookup_str(uint32_t id) {
+  auto ret = pool_instance().idx_to_str(id);
+  return ret == NULL ? std::string() : std::string(ret);
+};
 
 str::str(const char* str_) { idx_ = pool_instance().add_str(str_); };
 
@@ -30,32 +30,44 @@
 #include <utility>
 #include <vector>
 
-using str_id = uint16_t;
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+
+using str_id = uint32_t;
 
 namespace vitis {
 namespace ai {
 namespace trace {
 
+// interned strings, ids start from 1 and are never reused. It is
+// thread safe, strings are compared by content.
 class str_pool {
  public:
   str_pool();
   ~str_pool();
   str_id add_str(const char* str_);
+  str_id add_str(const char* str_, size_t len);
   const char* idx_to_str(str_id id);
   size_t size();
+  // strings with id in (from, size()]
+  std::vector<std::string> get_strs(size_t from);
 
  private:
   str_id new_idx() {
     index++;
     return index;
   }
+  std::mutex mtx;
   str_id index;
-  std::map<const char*, str_id> pool;
+  // deque, so that views of the strings are never invalidated.
+  std::deque<std::string> strs;
+  std::unordered_map<std::string_view, str_id> pool;
 };
 
-extern str_pool g_pool_;
-
-inline str_pool& pool_instance() { return g_pool_; };
+// trace classes are static objects which intern their names, the pool
+// must be ready before any of them.
+str_pool& pool_instance();
 
 class str {
  public:
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "stream.hpp"
+
+#if _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#include <chrono>
+#include <vart/trace/binary_format.hpp>
+#include <vart/trace/traceclass.hpp>
+
+#include "str.hpp"
+
+namespace vitis::ai::trace {
+
+static void put_u32(std::string& buf, uint32_t v) {
+  buf.append((const char*)&v, sizeof(v));
+}
+
+static void put_str(std::string& buf, const std::string& s) {
+  put_u32(buf, (uint32_t)s.size());
+  buf.append(s);
+}
+
+trace_stream::trace_stream(trace_controller* controller,
+                           const std::string& path, size_t interval_ms)
+    : controller_{controller},
+      path_{path},
+      interval_ms_{interval_ms},
+      out_{path, std::ios::binary | std::ios::trunc},
+      mtx_{},
+      flush_mtx_{},
+      cv_{},
+      stopped_{false},
+      num_of_strs_{0u},
+      num_of_infos_{0u},
+      classes_{},
+      records_{},
+      thread_{} {
+  CHECK(out_.is_open()) << "cannot open " << path;
+  uint32_t pid = getpid();
+  uint32_t record_size = sizeof(trace_record_t);
+  out_.write(binary::MAGIC, sizeof(binary::MAGIC));
+  out_.write((const char*)&binary::VERSION, sizeof(binary::VERSION));
+  out_.write((const char*)&pid, sizeof(pid));
+  out_.write((const char*)&record_size, sizeof(record_size));
+  thread_ = std::thread([this]() { run(); });
+  VAITRACE_DBG << "streaming to " << path << " every " << interval_ms
+               << "ms";
+}
+
+trace_stream::~trace_stream() { stop(); }
+
+void trace_stream::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id()) {
+    thread_.join();
+  }
+  flush();
+}
+
+void trace_stream::run() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  while (!stopped_) {
+    cv_.wait_for(lock, std::chrono::milliseconds(interval_ms_));
+    if (stopped_) {
+      break;
+    }
+    lock.unlock();
+    flush();
+    lock.lock();
+  }
+}
+
+void trace_stream::write_chunk(uint8_t type, const std::string& payload) {
+  auto size = (uint32_t)payload.size();
+  out_.write((const char*)&type, sizeof(type));
+  out_.write((const char*)&size, sizeof(size));
+  out_.write(payload.data(), payload.size());
+}
+
+void trace_stream::flush() {
+  // flush is called by the flusher thread and by stop().
+  std::lock_guard<std::mutex> lock(flush_mtx_);
+  records_.clear();
+  auto lost = controller_->p_rbuf->drain(records_);
+  // events are drained first, so that every string and class they refer
+  // to is already known.
+  auto new_classes = std::vector<traceClass*>();
+  for (auto c : get_traceclasses()) {
+    if (classes_.insert(c->class_id).second) {
+      for (auto& col : c->get_column_names()) {
+        intern_str(col);
+      }
+      new_classes.push_back(c);
+    }
+  }
+  auto strs = pool_instance().get_strs(num_of_strs_);
+  if (!strs.empty()) {
+    auto buf = std::string();
+    for (auto& s : strs) {
+      put_u32(buf, (uint32_t)++num_of_strs_);
+      put_str(buf, s);
+    }
+    write_chunk(binary::CHUNK_STRINGS, buf);
+  }
+  for (auto c : new_classes) {
+    auto buf = std::string();
+    auto& cols = c->get_column_names();
+    put_u32(buf, c->class_id);
+    put_u32(buf, (uint32_t)cols.size());
+    for (auto& col : cols) {
+      put_u32(buf, intern_str(col));
+    }
+    write_chunk(binary::CHUNK_CLASS, buf);
+  }
+  if (!records_.empty()) {
+    write_chunk(binary::CHUNK_EVENTS,
+                std::string((const char*)records_.data(),
+                            records_.size() * sizeof(trace_record_t)));
+  }
+  for (auto& info : controller_->get_info(num_of_infos_)) {
+    auto buf = std::string();
+    put_u32(buf, (uint32_t)info.size());
+    for (auto& kv : info) {
+      put_str(buf, kv.first);
+      put_str(buf, kv.second);
+    }
+    write_chunk(binary::CHUNK_INFO, buf);
+    num_of_infos_++;
+  }
+  if (lost > 0u) {
+    write_chunk(binary::CHUNK_LOST,
+                std::string((const char*)&lost, sizeof(lost)));
+    LOG_FIRST_N(WARNING, 1)
+        << lost << " trace events are overwritten before being flushed, "
+        << "consider a larger VAI_TRACE_RBUF_MB or a smaller "
+        << "VAI_TRACE_FLUSH_MS";
+  }
+  out_.flush();
+}
+
+}  // namespace vitis::ai::trace
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vart/trace/common.hpp>
+#include <vector>
+
+namespace vitis::ai::trace {
+
+// A background flusher, it drains the trace rings every `interval_ms`
+// and appends the events to a binary trace file, see binary_format.hpp.
+// Memory is bounded by the rings, however long the capture is.
+class trace_stream {
+ public:
+  trace_stream(trace_controller* controller, const std::string& path,
+               size_t interval_ms);
+  ~trace_stream();
+  trace_stream(const trace_stream& other) = delete;
+  trace_stream& operator=(const trace_stream& rhs) = delete;
+
+  // stop the flusher thread and do the last flush.
+  void stop();
+  void flush();
+
+ private:
+  void run();
+  void write_chunk(uint8_t type, const std::string& payload);
+
+ private:
+  trace_controller* controller_;
+  const std::string path_;
+  const size_t interval_ms_;
+  std::ofstream out_;
+  std::mutex mtx_;
+  std::mutex flush_mtx_;
+  std::condition_variable cv_;
+  bool stopped_;
+  size_t num_of_strs_;
+  size_t num_of_infos_;
+  std::set<uint32_t> classes_;
+  std::vector<trace_record_t> records_;
+  std::thread thread_;
+};
+
+}  // namespace vitis::ai::trace
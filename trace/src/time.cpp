@@ -17,20 +17,14 @@
 
 #include "time.hpp"
 
-namespace vitis::ai::trace {
+#include <vitis/ai/tsc_clock.hpp>
 
-inline uint64_t get_tsc(void) {
-#if defined(__i386__) or defined(__x86_64__)
-  unsigned long long high, low;
-  asm volatile("rdtsc" : "=a"(low), "=d"(high));
-  return (low + (high << 32));
-#else
-  return 0;
-#endif
-};
+namespace vitis::ai::trace {
 
 double get_ts(void) {
-  auto tp = std::chrono::steady_clock::now().time_since_epoch();
+  // read once or twice per event, the TSC is much cheaper than
+  // clock_gettime and shares the epoch of steady_clock.
+  auto tp = vitis::ai::TscClock::now().time_since_epoch();
   auto ts = std::chrono::duration_cast<
                 std::chrono::duration<double, std::ratio<1, 1>>>(tp)
                 .count();
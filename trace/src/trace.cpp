@@ -22,6 +22,7 @@
 #include <vart/trace/trace.hpp>
 
 #include "internal.hpp"
+#include "stream.hpp"
 #if _WIN32
 #  include <windows.h>
 #else
@@ -73,27 +74,52 @@ trace_controller::trace_controller(vai_trace_options_t options)
 
   signal(SIGINT, handler);
   signal(SIGTERM, handler);
+
+  start_sampler();
+
+  if (options["stream"] == "1") {
+    stream = new trace_stream(this, logger_file_path + ".bin",
+                              stoi(options["flush_ms"], nullptr));
+  }
 };
 
 trace_controller::~trace_controller() {
   dump();
-  free(p_rbuf);
+  // p_rbuf and stream are not freed, threads which exit later still
+  // return their rings to p_rbuf.
 };
 
 string trace_controller::get_logger_file_path() { return logger_file_path; };
 string trace_controller::get_logger_dir_path() { return logger_dir_path; };
 
 void trace_controller::push_info(trace_entry_t i) {
-  std::lock_guard<std::mutex> lock(infobase_lock);
-  infobase.push_back(i);
+  auto node = new info_node_t{std::move(i), nullptr};
+  node->next = infobase.load(std::memory_order_relaxed);
+  while (!infobase.compare_exchange_weak(node->next, node,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+  }
+}
+
+vector<trace_entry_t> trace_controller::get_info(size_t from) {
+  auto nodes = vector<info_node_t*>();
+  for (auto n = infobase.load(std::memory_order_acquire); n != nullptr;
+       n = n->next) {
+    nodes.push_back(n);
+  }
+  // nodes are newest first, entry k in push order is nodes[size - 1 - k].
+  auto ret = vector<trace_entry_t>();
+  for (auto i = from; i < nodes.size(); ++i) {
+    ret.push_back(nodes[nodes.size() - 1 - i]->entry);
+  }
+  return ret;
 }
 
 mutex global_lock;
 mutex core_lock[CORE_N_MAX];
 
 void trace_time_sync(const char* tag) {
-  auto tp = steady_clock::now().time_since_epoch();
-  auto ts = duration_cast<duration<double>>(tp).count();
+  auto ts = get_ts();
 
   auto xrt_ts = get_xrt_ts();
   add_info("trace_timesync", "xrt_ts", xrt_ts, "steady_clock", ts, "unit", "s");
@@ -123,6 +149,11 @@ bool check_env(vai_trace_options_t& options) {
   string logger_file_path = trace_log_dir + "vaitrace_" + to_string(pid);
   options["logger_file_path"] = logger_file_path;
 
+  // stream events to <logger_file_path>.bin instead of dumping them as
+  // text at exit, see binary_format.hpp.
+  options["stream"] = my_getenv_s("VAI_TRACE_STREAM", "0");
+  options["flush_ms"] = my_getenv_s("VAI_TRACE_FLUSH_MS", "100");
+
   return enable;
 }
 
@@ -176,34 +207,45 @@ void push_info(trace_entry_t i) { get_trace_controller_inst().push_info(i); };
 void dump() {
   if (!is_enabled()) return;
 
+  // add_info is a no-op once tracing is disabled.
+  trace_time_sync("vart_tracer");
+
   disable_trace();
   VAITRACE_DBG << "Dumping...";
 
+  // both the streaming and the text dump write these as info.
+  for (auto& i : sampling_report()) {
+    push_info(i);
+  }
+
+  auto stream = get_trace_controller_inst().stream;
+  if (stream != nullptr) {
+    stream->stop();
+    return;
+  }
+
   vector<trace_entry_t> o_data;
 
   trace_entry_t section_flag;
 
   section_flag.insert(std::make_pair("#SECTION", "INFO"));
 
-  // Add timesync
-  trace_time_sync("vart_tracer");
-
   // Get Info
   o_data.push_back(section_flag);
-  auto infobase = get_infobase();
-  for_each(infobase->begin(), infobase->end(),
-           [&o_data](auto n) { o_data.push_back(n); });
+  for (auto& i : get_trace_controller_inst().get_info(0u)) {
+    o_data.push_back(i);
+  }
 
   // Get Trace
   section_flag.erase("#SECTION");
   section_flag.insert(std::make_pair("#SECTION", "TRACE"));
   o_data.push_back(section_flag);
-  get_rbuf()->lock();
-
-  for_each(get_rbuf()->begin(), get_rbuf()->end(),
-           [&o_data](auto n) { o_data.push_back(n->get()); });
-
-  get_rbuf()->unlock();
+  get_rbuf()->for_each([&o_data](const trace_record_t& r) {
+    auto tc = find_traceclass(r.class_id);
+    if (tc != nullptr) {
+      o_data.push_back(tc->translate(r));
+    }
+  });
 
   auto o_file = get_trace_controller_inst().get_logger_file_path();
   VAITRACE_DBG << "Dumping to:" << o_file;
@@ -26,10 +26,8 @@ static traceClass* py_traceclass =
 
 extern "C" {
 void tracepoint_py_func(bool start, const char* func_name) {
-  if (start)
-    add_trace("py", 1, std::string(func_name));
-  else
-    add_trace("py", 0, std::string(func_name));
+  if (py_traceclass == nullptr) return;
+  py_traceclass->add_trace(start ? 1 : 0, func_name);
 }
 }
 }  // namespace vitis::ai::trace
@@ -16,6 +16,8 @@
  */
 
 #include <mutex>
+#include <string_view>
+#include <unordered_map>
 #include <vart/trace/payload.hpp>
 #include <vart/trace/ringbuf.hpp>
 #include <vart/trace/traceclass.hpp>
@@ -26,6 +28,10 @@ extern bool is_enabled(void);
 
 std::mutex table_lock;
 vector<traceClass*> traceclass_table;
+// class name => class, the key views traceClass::classname.
+std::unordered_map<std::string_view, traceClass*> traceclass_by_name;
+// interned class name => class
+std::unordered_map<uint32_t, traceClass*> traceclass_by_id;
 
 static traceClass time_sync("trace_timesync", {});
 static traceClass dpu_controller("dpu-controller",
@@ -38,11 +44,15 @@ static traceClass user_task("user-task", {"event_state", "event_name", "info"});
 
 traceClass::traceClass(const char* name_, vector<string> items) {
   classname = std::string(name_);
+  class_id = intern_str(classname);
   column_names = items;
   column_num = items.size();
+  sampling = new_class_sampling(this);
 
   table_lock.lock();
   traceclass_table.push_back(this);
+  traceclass_by_name[std::string_view(classname)] = this;
+  traceclass_by_id[class_id] = this;
   table_lock.unlock();
 };
 
@@ -63,12 +73,46 @@ traceClass* find_traceclass(const char* name) {
     return nullptr;
   }
 
-  // Only lock table for write
-  for (const auto t : traceclass_table) {
-    if (strcmp(t->classname.c_str(), name) == 0) return t;
+  // classes are never unregistered, so a per thread cache needs no lock
+  // and no invalidation. Misses are not cached, the class might be
+  // registered later.
+  thread_local std::unordered_map<std::string_view, traceClass*> cache;
+  auto key = std::string_view(name);
+  auto it = cache.find(key);
+  if (it != cache.end()) {
+    return it->second;
   }
+  std::lock_guard<std::mutex> lock(table_lock);
+  auto found = traceclass_by_name.find(key);
+  if (found == traceclass_by_name.end()) {
+    return nullptr;
+  }
+  cache.emplace(found->first, found->second);
+  return found->second;
+};
+
+traceClass* find_traceclass(uint32_t class_id) {
+  std::lock_guard<std::mutex> lock(table_lock);
+  auto it = traceclass_by_id.find(class_id);
+  return it == traceclass_by_id.end() ? nullptr : it->second;
+};
+
+std::vector<traceClass*> get_traceclasses() {
+  std::lock_guard<std::mutex> lock(table_lock);
+  return traceclass_table;
+};
 
-  return nullptr;
+trace_entry_t traceClass::translate(const trace_record_t& r) {
+  trace_entry_t ret;
+  ret.insert(std::make_pair("pid", to_string(r.pid)));
+  ret.insert(std::make_pair("cpu_id", to_string(r.cpu_id)));
+  ret.insert(std::make_pair("ts", to_string(r.ts)));
+  ret.insert(std::make_pair("classname", classname));
+  auto col_num = std::min<uint32_t>(r.num_of_fields, column_num);
+  for (size_t i = 0; i < col_num; i++) {
+    ret.insert(std::make_pair(column_names[i], field_to_string(r, i)));
+  }
+  return ret;
 };
 
 }  // namespace vitis::ai::trace
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Convert a binary trace file, see VAI_TRACE_STREAM, to the Chrome trace
+// event JSON format, which chrome://tracing and ui.perfetto.dev open.
+//
+// Classes with an `event_state` column, e.g. dpu-controller, cpu-task,
+// user-task and py, become duration events, 1 begins and 0 ends one.
+// Other classes, e.g. dpu-runner, become instant events. Info entries
+// are kept in the metadata.
+//
+// usage: vaitrace_to_json <vaitrace_PID.bin> [output.json]
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vart/trace/binary_format.hpp>
+
+using namespace vitis::ai::trace;
+
+static std::string escape(const std::string& s) {
+  std::ostringstream str;
+  for (auto c : s) {
+    if (c == '"' || c == '\\') {
+      str << '\\' << c;
+    } else if ((unsigned char)c < 0x20) {
+      str << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c
+          << std::dec;
+    } else {
+      str << c;
+    }
+  }
+  return str.str();
+}
+
+static std::string field_to_json(const binary::trace_file_t& file,
+                                 const trace_record_t& r, size_t idx) {
+  auto v = r.fields[idx];
+  switch (r.types[idx]) {
+    case TRACE_FIELD_INT:
+      return std::to_string((int64_t)v);
+    case TRACE_FIELD_UINT:
+      return std::to_string(v);
+    case TRACE_FIELD_DOUBLE: {
+      auto d = 0.0;
+      memcpy(&d, &v, sizeof(d));
+      std::ostringstream str;
+      str << std::setprecision(17) << d;
+      return str.str();
+    }
+    case TRACE_FIELD_STRING: {
+      auto it = file.strings.find((uint32_t)v);
+      return "\"" + escape(it == file.strings.end() ? "" : it->second) + "\"";
+    }
+    default:
+      return "null";
+  }
+}
+
+static void write_event(std::ostream& out, const binary::trace_file_t& file,
+                        const trace_record_t& r) {
+  auto it = file.classes.find(r.class_id);
+  if (it == file.classes.end()) {
+    return;
+  }
+  auto& c = it->second;
+  auto phase = "i";
+  auto name = c.name;
+  std::ostringstream args;
+  auto num_of_fields =
+      std::min<size_t>(r.num_of_fields, c.column_names.size());
+  for (auto i = 0u; i < num_of_fields; ++i) {
+    auto& col = c.column_names[i];
+    if (col == "event_state") {
+      phase = (int64_t)r.fields[i] == 0 ? "E" : "B";
+    } else if (r.types[i] == TRACE_FIELD_STRING && name == c.name) {
+      // the first string field names the event, e.g. the subgraph.
+      name = file.strings.count((uint32_t)r.fields[i])
+                 ? file.strings.at((uint32_t)r.fields[i])
+                 : name;
+    }
+    args << ",\"" << escape(col)
+         << "\":" << field_to_json(file, r, i);
+  }
+  out << "{\"name\":\"" << escape(name) << "\",\"cat\":\"" << escape(c.name)
+      << "\",\"ph\":\"" << phase << "\",\"ts\":" << std::fixed
+      << std::setprecision(3) << r.ts * 1e6 << std::defaultfloat
+      << ",\"pid\":" << file.pid << ",\"tid\":" << r.pid;
+  if (phase[0] == 'i') {
+    out << ",\"s\":\"t\"";
+  }
+  out << ",\"args\":{\"cpu_id\":" << (int)r.cpu_id << args.str() << "}}";
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " <vaitrace_PID.bin> [output.json]"
+              << std::endl;
+    return 1;
+  }
+  auto file = binary::trace_file_t();
+  auto error = std::string();
+  if (!binary::read_trace_file(argv[1], file, &error)) {
+    std::cerr << error << std::endl;
+    return 1;
+  }
+  std::stable_sort(
+      file.records.begin(), file.records.end(),
+      [](const trace_record_t& a, const trace_record_t& b) {
+        return a.ts < b.ts;
+      });
+  std::ofstream out_file;
+  if (argc >= 3) {
+    out_file.open(argv[2]);
+    if (!out_file) {
+      std::cerr << "cannot open " << argv[2] << std::endl;
+      return 1;
+    }
+  }
+  std::ostream& out = argc >= 3 ? out_file : std::cout;
+  out << "{\"traceEvents\":[\n";
+  auto first = true;
+  for (auto& r : file.records) {
+    if (file.classes.count(r.class_id) == 0u) {
+      continue;
+    }
+    out << (first ? "" : ",\n");
+    write_event(out, file, r);
+    first = false;
+  }
+  out << "\n],\"displayTimeUnit\":\"ms\",\"metadata\":{\"lost_events\":"
+      << file.lost << ",\"info\":[";
+  for (auto i = 0u; i < file.infos.size(); ++i) {
+    out << (i == 0u ? "" : ",") << "{";
+    auto sep = "";
+    for (auto& kv : file.infos[i]) {
+      out << sep << "\"" << escape(kv.first) << "\":\"" << escape(kv.second)
+          << "\"";
+      sep = ",";
+    }
+    out << "}";
+  }
+  out << "]}}\n";
+  std::cerr << "converted " << file.records.size() << " events, "
+            << file.lost << " events were lost." << std::endl;
+  return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// measure the per-event cost of resolving a trace class: a linear strcmp
+// scan of the class table, as find_traceclass did before, the lookup by
+// name and a trace_class_handle.
+//
+// usage: env NUM_OF_EVENTS=1000000 NUM_OF_CLASSES=32 test_trace_dispatch
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vart/trace/trace.hpp>
+#include <vector>
+
+#include "vitis/ai/env_config.hpp"
+DEF_ENV_PARAM(NUM_OF_EVENTS, "1000000");
+DEF_ENV_PARAM(NUM_OF_CLASSES, "32");
+using namespace std;
+namespace trace = vitis::ai::trace;
+
+template <typename F>
+static double run(F f) {
+  auto num_of_events = ENV_PARAM(NUM_OF_EVENTS);
+  auto start = chrono::steady_clock::now();
+  for (auto i = 0; i < num_of_events; ++i) {
+    f(i);
+  }
+  auto ns = chrono::duration_cast<chrono::nanoseconds>(
+                chrono::steady_clock::now() - start)
+                .count();
+  return (double)ns / num_of_events;
+}
+
+int main(int argc, char* argv[]) {
+  // the trace controller is created when libvart-trace is loaded, so
+  // the environment must be set before that, run again with it.
+  if (getenv("VAI_TRACE_ENABLE") == nullptr) {
+    setenv("VAI_TRACE_ENABLE", "true", 1);
+    setenv("VAI_TRACE_DIR", "/tmp/", 1);
+    execv("/proc/self/exe", argv);
+    PLOG(FATAL) << "cannot run " << argv[0] << " again";
+  }
+  if (!trace::is_enabled()) {
+    cout << "FAIL: tracing is not enabled" << endl;
+    return 1;
+  }
+  auto ok = true;
+  auto names = vector<string>();
+  for (auto i = 0; i < ENV_PARAM(NUM_OF_CLASSES); ++i) {
+    names.emplace_back("bench-class-" + std::to_string(i));
+    trace::new_traceclass(names.back().c_str(),
+                          {"event_state", "event_name", "info"});
+  }
+  // the last registered class is the worst case of a linear scan.
+  auto name = names.back().c_str();
+  auto table = trace::get_traceclasses();
+  auto linear_ns = run([&table, name](int i) {
+    for (auto tc : table) {
+      if (strcmp(tc->classname.c_str(), name) == 0) {
+        tc->add_trace(1, "bench", i);
+        break;
+      }
+    }
+  });
+  auto by_name_ns =
+      run([name](int i) { trace::add_trace(name, 1, "bench", i); });
+  auto handle = trace::trace_class_handle(name);
+  auto handle_ns = run([&handle](int i) { handle.add_trace(1, "bench", i); });
+  ok = ok && handle.get() == trace::find_traceclass(name) &&
+       handle.get() != nullptr;
+
+  auto num_of_events = 0u;
+  trace::get_rbuf()->for_each([&](const trace::trace_record_t& r) {
+    ok = ok && r.class_id == handle.get()->class_id && r.num_of_fields == 3u;
+    num_of_events++;
+  });
+  ok = ok && num_of_events > 0u;
+  cout << fixed << setprecision(2)                               //
+       << "classes=" << table.size()                             //
+       << " linear scan (before)=" << linear_ns << "ns"          //
+       << " by name=" << by_name_ns << "ns"                      //
+       << " handle=" << handle_ns << "ns" << endl;
+  // do not dump at exit.
+  trace::get_trace_controller_inst().disable();
+  cout << (ok ? "PASS" : "FAIL") << endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// measure the per-event cost of add_trace with 1, 2, 4 and 8 threads,
+// compared with a mutex protected list of heap allocated events, which
+// is how events were buffered before per-thread rings.
+//
+// usage: env NUM_OF_EVENTS=1000000 test_trace_overhead
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vart/trace/trace.hpp>
+#include <vector>
+
+#include "vitis/ai/env_config.hpp"
+DEF_ENV_PARAM(NUM_OF_EVENTS, "1000000");
+using namespace std;
+namespace trace = vitis::ai::trace;
+
+template <typename F>
+static double run_threads(int num_of_threads, F f) {
+  auto num_of_events = ENV_PARAM(NUM_OF_EVENTS);
+  auto threads = vector<thread>();
+  auto start = chrono::steady_clock::now();
+  for (auto t = 0; t < num_of_threads; ++t) {
+    threads.emplace_back([f, num_of_events]() {
+      for (auto i = 0; i < num_of_events; ++i) {
+        f(i);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  auto ns = chrono::duration_cast<chrono::nanoseconds>(
+                chrono::steady_clock::now() - start)
+                .count();
+  // wall time per event of one thread.
+  return (double)ns / num_of_events;
+}
+
+namespace {
+struct bench_event_t : public trace::traceEventBase {
+  bench_event_t(int i) : trace::traceEventBase(sizeof(i)), value(i) {}
+  int value;
+};
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  // the trace controller is created when libvart-trace is loaded, so
+  // the environment must be set before that, run again with it.
+  if (getenv("VAI_TRACE_ENABLE") == nullptr) {
+    setenv("VAI_TRACE_ENABLE", "true", 1);
+    setenv("VAI_TRACE_DIR", "/tmp/", 1);
+    execv("/proc/self/exe", argv);
+    PLOG(FATAL) << "cannot run " << argv[0] << " again";
+  }
+  if (!trace::is_enabled()) {
+    cout << "FAIL: tracing is not enabled" << endl;
+    return 1;
+  }
+  auto ok = true;
+  cout << fixed << setprecision(2);
+  for (auto num_of_threads : {1, 2, 4, 8}) {
+    auto ring_ns = run_threads(num_of_threads, [](int i) {
+      trace::add_trace("user-task", 1, "test_trace_overhead", i);
+    });
+    auto mtx = std::mutex();
+    auto events = list<trace::traceEventBase*>();
+    auto list_ns = run_threads(num_of_threads, [&mtx, &events](int i) {
+      auto e = new bench_event_t(i);
+      std::lock_guard<std::mutex> lock(mtx);
+      events.push_back(e);
+    });
+    for (auto e : events) {
+      delete e;
+    }
+    cout << "threads=" << num_of_threads << " ring=" << ring_ns << "ns"
+         << " locked list (baseline)=" << list_ns << "ns" << endl;
+  }
+
+  // rings of exited threads are reused, and the merged events are in
+  // timestamp order.
+  auto rbuf = trace::get_rbuf();
+  ok = ok && rbuf->num_of_rings() <= 8u;
+  auto num_of_events = 0u;
+  auto last_ts = 0.0;
+  auto ordered = true;
+  rbuf->for_each([&](const trace::trace_record_t& r) {
+    ordered = ordered && r.ts >= last_ts;
+    last_ts = r.ts;
+    num_of_events++;
+  });
+  ok = ok && ordered && num_of_events > 0u;
+  cout << "rings=" << rbuf->num_of_rings() << " events=" << num_of_events
+       << endl;
+  // do not dump at exit.
+  trace::get_trace_controller_inst().disable();
+  cout << (ok ? "PASS" : "FAIL") << endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// sample 1 in 10 jobs and rate limit another class, then check that
+// the kept events and the estimates in the sampling report add up, and
+// that the report and the timesync are streamed to the binary file.
+//
+// usage: env NUM_OF_THREADS=4 NUM_OF_JOBS=1000 test_trace_sampling
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vart/trace/binary_format.hpp>
+#include <vart/trace/trace.hpp>
+#include <vector>
+
+#include "../src/util.hpp"
+#include "vitis/ai/env_config.hpp"
+DEF_ENV_PARAM(NUM_OF_THREADS, "4");
+DEF_ENV_PARAM(NUM_OF_JOBS, "1000");
+DEF_ENV_PARAM(NUM_OF_EVENTS, "100000");
+using namespace std;
+namespace trace = vitis::ai::trace;
+
+static void spin_us(int us) {
+  auto end = chrono::steady_clock::now() + chrono::microseconds(us);
+  while (chrono::steady_clock::now() < end) {
+  }
+}
+
+static const trace::trace_entry_t* find_report(
+    const vector<trace::trace_entry_t>& report, const string& classname) {
+  for (auto& e : report) {
+    auto it = e.find("class");
+    if (it != e.end() && it->second == classname) {
+      return &e;
+    }
+  }
+  return nullptr;
+}
+
+int main(int argc, char* argv[]) {
+  // the trace controller is created when libvart-trace is loaded, so
+  // the environment must be set before that, run again with it.
+  if (getenv("VAI_TRACE_ENABLE") == nullptr) {
+    setenv("VAI_TRACE_ENABLE", "true", 1);
+    setenv("VAI_TRACE_DIR", "/tmp/", 1);
+    setenv("VAI_TRACE_SAMPLE_RATE", "10", 1);
+    setenv("VAI_TRACE_RATE_LIMIT", "rated:1000", 1);
+    setenv("VAI_TRACE_STREAM", "1", 1);
+    setenv("VAI_TRACE_FLUSH_MS", "10", 1);
+    execv("/proc/self/exe", argv);
+    PLOG(FATAL) << "cannot run " << argv[0] << " again";
+  }
+  if (!trace::is_enabled()) {
+    cout << "FAIL: tracing is not enabled" << endl;
+    return 1;
+  }
+  auto sampled = trace::new_traceclass("sampled", {"event_state", "id"});
+  auto rated = trace::new_traceclass("rated", {"id"});
+  auto num_of_threads = ENV_PARAM(NUM_OF_THREADS);
+  auto num_of_jobs = ENV_PARAM(NUM_OF_JOBS);
+  auto num_of_events = ENV_PARAM(NUM_OF_EVENTS);
+  auto threads = vector<thread>();
+  auto start = chrono::steady_clock::now();
+  for (auto t = 0; t < num_of_threads; ++t) {
+    threads.emplace_back([=]() {
+      for (auto i = 0; i < num_of_jobs; ++i) {
+        auto job = trace::trace_job();
+        sampled->add_trace(1, i);
+        spin_us(10);
+        sampled->add_trace(0, i);
+      }
+      // not in a job, only the rate limit applies.
+      for (auto i = 0; i < num_of_events; ++i) {
+        rated->add_trace(i);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  auto seconds = chrono::duration<double>(chrono::steady_clock::now() - start)
+                     .count();
+  auto report = trace::sampling_report();
+  auto ok = true;
+  auto total_jobs = num_of_threads * num_of_jobs;
+  auto s = find_report(report, "sampled");
+  ok = ok && s != nullptr &&
+       stoll(s->at("offered")) == 2ll * total_jobs &&
+       stoll(s->at("recorded")) == 2ll * (total_jobs / 10) &&
+       stoll(s->at("spans")) == total_jobs / 10 &&
+       fabs(stod(s->at("estimated_spans")) - total_jobs) < 1e-6 * total_jobs &&
+       stod(s->at("span_mean_s")) >= 10e-6;
+  auto r = find_report(report, "rated");
+  auto max_rated = 1000.0 * (1.0 + seconds) + num_of_threads;
+  ok = ok && r != nullptr &&
+       stoll(r->at("offered")) == (long long)num_of_threads * num_of_events &&
+       stoll(r->at("recorded")) <= (long long)max_rated &&
+       stoll(r->at("recorded")) >= 1000ll &&
+       stoll(r->at("dropped_by_rate")) + stoll(r->at("recorded")) ==
+           stoll(r->at("offered"));
+  for (auto& e : report) {
+    for (auto& kv : e) {
+      cout << kv.first << "=" << kv.second << " ";
+    }
+    cout << endl;
+  }
+
+  // dump pushes the report and the timesync as info, then stops the
+  // stream, which flushes them.
+  auto path = trace::get_trace_controller_inst().get_logger_file_path() + ".bin";
+  trace::dump();
+  auto file = trace::binary::trace_file_t();
+  auto error = string();
+  ok = trace::binary::read_trace_file(path, file, &error) && ok;
+  ok = ok && file.records.size() + file.lost ==
+                 (uint64_t)stoll(s->at("recorded")) +
+                     (uint64_t)stoll(r->at("recorded"));
+  auto num_of_timesyncs = 0;
+  for (auto& info : file.infos) {
+    num_of_timesyncs += info["classname"] == "trace_timesync";
+  }
+  auto streamed_s = find_report(file.infos, "sampled");
+  auto streamed_r = find_report(file.infos, "rated");
+  ok = ok && num_of_timesyncs == 1 && streamed_s != nullptr &&
+       streamed_s->at("offered") == s->at("offered") &&
+       streamed_r != nullptr &&
+       streamed_r->at("offered") == r->at("offered");
+  cout << path << ": " << error << " infos=" << file.infos.size()
+       << " timesyncs=" << num_of_timesyncs << endl;
+  cout << (ok ? "PASS" : "FAIL") << endl;
+  return ok ? 0 : 1;
+}
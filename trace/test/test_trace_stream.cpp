@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// stream events of a few threads to a binary trace file and read it
+// back. Every event is either in the file or counted as lost, and every
+// info entry is in it once, also those added after the first flush.
+//
+// usage: env NUM_OF_THREADS=4 NUM_OF_EVENTS=100000 test_trace_stream
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vart/trace/binary_format.hpp>
+#include <vart/trace/trace.hpp>
+#include <vector>
+
+#include "../src/stream.hpp"
+#include "vitis/ai/env_config.hpp"
+DEF_ENV_PARAM(NUM_OF_THREADS, "4");
+DEF_ENV_PARAM(NUM_OF_EVENTS, "100000");
+using namespace std;
+namespace trace = vitis::ai::trace;
+
+int main(int argc, char* argv[]) {
+  // the trace controller is created when libvart-trace is loaded, so
+  // the environment must be set before that, run again with it.
+  if (getenv("VAI_TRACE_ENABLE") == nullptr) {
+    setenv("VAI_TRACE_ENABLE", "true", 1);
+    setenv("VAI_TRACE_DIR", "/tmp/", 1);
+    setenv("VAI_TRACE_STREAM", "1", 1);
+    setenv("VAI_TRACE_FLUSH_MS", "10", 1);
+    setenv("VAI_TRACE_RBUF_MB", "1", 1);
+    execv("/proc/self/exe", argv);
+    PLOG(FATAL) << "cannot run " << argv[0] << " again";
+  }
+  if (!trace::is_enabled()) {
+    cout << "FAIL: tracing is not enabled" << endl;
+    return 1;
+  }
+  auto& controller = trace::get_trace_controller_inst();
+  auto ok = controller.stream != nullptr;
+  if (!ok) {
+    cout << "FAIL: streaming is not enabled" << endl;
+    return 1;
+  }
+  trace::add_info("user-task", "test", "test_trace_stream");
+  auto num_of_threads = ENV_PARAM(NUM_OF_THREADS);
+  auto num_of_events = ENV_PARAM(NUM_OF_EVENTS);
+  auto threads = vector<thread>();
+  for (auto t = 0; t < num_of_threads; ++t) {
+    threads.emplace_back([num_of_events]() {
+      for (auto i = 0; i < num_of_events; ++i) {
+        trace::add_trace("user-task", i % 2,
+                         "event_" + std::to_string(i % 10), i);
+      }
+    });
+  }
+  // a few flushes go by between the info entries.
+  auto num_of_infos = 3;
+  for (auto i = 1; i < num_of_infos; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    trace::add_info("user-task", "test", "info_" + std::to_string(i));
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  controller.stream->stop();
+  controller.disable();
+
+  auto file = trace::binary::trace_file_t();
+  auto error = string();
+  auto path = controller.get_logger_file_path() + ".bin";
+  ok = trace::binary::read_trace_file(path, file, &error);
+  auto total = (uint64_t)num_of_threads * num_of_events;
+  ok = ok && file.records.size() + file.lost == total;
+  for (auto& r : file.records) {
+    auto c = file.classes.find(r.class_id);
+    ok = ok && c != file.classes.end() && c->second.name == "user-task" &&
+         c->second.column_names.size() == 3u && r.num_of_fields == 3u &&
+         r.types[1] == trace::TRACE_FIELD_STRING &&
+         file.strings[(uint32_t)r.fields[1]] ==
+             "event_" + std::to_string(r.fields[2] % 10);
+  }
+  ok = ok && !file.infos.empty() &&
+       file.infos[0]["test"] == "test_trace_stream";
+  for (auto i = 1; i < num_of_infos; ++i) {
+    auto n = 0;
+    for (auto& info : file.infos) {
+      n += info["test"] == "info_" + std::to_string(i);
+    }
+    if (n != 1) {
+      cout << "info_" << i << " is in the file " << n << " times" << endl;
+      ok = false;
+    }
+  }
+  cout << path << ": " << error << " events=" << file.records.size()
+       << " lost=" << file.lost << " strings=" << file.strings.size()
+       << endl;
+  cout << (ok ? "PASS" : "FAIL") << endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+// A lightweight, always-on metrics registry.
+//
+// Metrics are created once, usually in a constructor, and updated on
+// the hot path without any lock: counters and histograms are sharded
+// per thread, every shard sits in its own cache line and is updated
+// with relaxed atomics. Readers sum up all shards.
+//
+//   static auto requests = vitis::ai::MetricsRegistry::instance().counter(
+//       "vart_requests_total", "number of requests");
+//   requests->inc();
+//
+// The registry is dumped in the Prometheus text format, periodically to
+// a file if env XLNX_METRICS_FILE is set, or on every connection to a
+// Unix domain socket if env XLNX_METRICS_SOCKET is set, e.g.
+//
+//   curl --unix-socket /tmp/vart_metrics.sock http://localhost/metrics
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "./tsc_clock.hpp"
+
+namespace vitis {
+namespace ai {
+namespace metrics {
+using labels_t = std::vector<std::pair<std::string, std::string>>;
+
+constexpr size_t NUM_OF_SHARDS = 16u;
+
+// a small per thread index, threads are assigned to shards round robin.
+size_t shard_index();
+
+// 10us ... 1s
+const std::vector<double>& default_latency_buckets_us();
+
+inline void atomic_add(std::atomic<double>& x, double v) {
+  auto old = x.load(std::memory_order_relaxed);
+  while (!x.compare_exchange_weak(old, old + v, std::memory_order_relaxed)) {
+  }
+}
+}  // namespace metrics
+
+class Counter {
+ public:
+  void inc(uint64_t n = 1u) {
+    shards_[metrics::shard_index()].value.fetch_add(n,
+                                                    std::memory_order_relaxed);
+  }
+  uint64_t value() const {
+    auto ret = (uint64_t)0u;
+    for (auto& s : shards_) {
+      ret += s.value.load(std::memory_order_relaxed);
+    }
+    return ret;
+  }
+
+ private:
+  struct alignas(64) shard_t {
+    std::atomic<uint64_t> value{0u};
+  };
+  std::array<shard_t, metrics::NUM_OF_SHARDS> shards_;
+};
+
+// a gauge is a single value, it cannot be sharded because of `set`.
+class Gauge {
+ public:
+  void set(double v) { value_.store(v, std::memory_order_relaxed); }
+  void inc(double v = 1.0) { metrics::atomic_add(value_, v); }
+  void dec(double v = 1.0) { metrics::atomic_add(value_, -v); }
+  double value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<double> value_{0.0};
+};
+
+class Histogram {
+ public:
+  // `bounds` are the inclusive upper bounds of the buckets, in
+  // increasing order, the +Inf bucket is implicit.
+  explicit Histogram(const std::vector<double>& bounds);
+  Histogram(const Histogram& other) = delete;
+  Histogram& operator=(const Histogram& rhs) = delete;
+
+ public:
+  void observe(double v) {
+    auto& s = shards_[metrics::shard_index()];
+    auto idx = 0u;
+    // bounds are few, a linear search is faster than a binary search.
+    while (idx < bounds_.size() && v > bounds_[idx]) {
+      ++idx;
+    }
+    s.buckets[idx].fetch_add(1u, std::memory_order_relaxed);
+    metrics::atomic_add(s.sum, v);
+  }
+  template <typename Rep, typename Period>
+  void observe(std::chrono::duration<Rep, Period> d) {
+    observe((double)std::chrono::duration_cast<std::chrono::microseconds>(d)
+                .count());
+  }
+
+  struct snapshot_t {
+    // not cumulative, the last one is the +Inf bucket.
+    std::vector<uint64_t> buckets;
+    uint64_t count;
+    double sum;
+  };
+  snapshot_t snapshot() const;
+  const std::vector<double>& bounds() const { return bounds_; }
+
+ private:
+  struct alignas(64) shard_t {
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets;
+    std::atomic<double> sum{0.0};
+  };
+  const std::vector<double> bounds_;
+  std::array<shard_t, metrics::NUM_OF_SHARDS> shards_;
+};
+
+// observe the elapsed time in microseconds on destruction.
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(Histogram* h) : h_{h}, start_{TscClock::now()} {}
+  ~ScopedTimer() { h_->observe(TscClock::now() - start_); }
+  ScopedTimer(const ScopedTimer& other) = delete;
+  ScopedTimer& operator=(const ScopedTimer& rhs) = delete;
+
+ private:
+  Histogram* h_;
+  TscClock::time_point start_;
+};
+
+class MetricsRegistry {
+ public:
+  static MetricsRegistry& instance();
+  MetricsRegistry(const MetricsRegistry& other) = delete;
+  MetricsRegistry& operator=(const MetricsRegistry& rhs) = delete;
+
+ public:
+  // the same (name, labels) always returns the same metric. Metrics
+  // live as long as the process, the returned pointers never dangle.
+  Counter* counter(const std::string& name, const std::string& help,
+                   const metrics::labels_t& labels = {});
+  Gauge* gauge(const std::string& name, const std::string& help,
+               const metrics::labels_t& labels = {});
+  Histogram* histogram(const std::string& name, const std::string& help,
+                       const metrics::labels_t& labels = {},
+                       const std::vector<double>& bounds =
+                           metrics::default_latency_buckets_us());
+
+  // Prometheus text exposition format, version 0.0.4
+  std::string dump() const;
+  // write dump() to `path` atomically, i.e. via a temporary file.
+  bool dump_to_file(const std::string& path) const;
+
+ private:
+  MetricsRegistry();
+  void start_exporters();
+
+ private:
+  struct family_t {
+    std::string type;
+    std::string help;
+    // key is the rendered label set, e.g. {subgraph="a"}
+    std::map<std::string, std::unique_ptr<Counter>> counters;
+    std::map<std::string, std::unique_ptr<Gauge>> gauges;
+    std::map<std::string, std::unique_ptr<Histogram>> histograms;
+  };
+  family_t& get_family(const std::string& name, const std::string& type,
+                       const std::string& help);
+  mutable std::mutex mtx_;
+  std::map<std::string, family_t> families_;
+};
+
+}  // namespace ai
+}  // namespace vitis
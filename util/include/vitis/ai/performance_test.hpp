@@ -25,6 +25,7 @@
 #include <mutex>
 #include <vector>
 #include <vitis/ai/env_config.hpp>
+#include <vitis/ai/tsc_clock.hpp>
 DEF_ENV_PARAM(SLEEP_MS, "60000");
 namespace vitis {
 namespace ai {
@@ -44,7 +45,7 @@ class PerformanceTestRunner {
 
 class PerformanceTest {
  public:
-  using Clock = std::chrono::steady_clock;
+  using Clock = vitis::ai::TscClock;
   std::mutex mtx_;
   static std::unique_ptr<PerformanceTestRunner> thread_main(
       PerformanceTest* me, std::unique_ptr<PerformanceTestRunner>&& runner,
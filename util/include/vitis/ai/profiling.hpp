@@ -19,6 +19,7 @@
 #include <glog/logging.h>
 #include <chrono>
 #include "./env_config.hpp"
+#include "./tsc_clock.hpp"
 DEF_ENV_PARAM(DEEPHI_PROFILING, "0");
 
 namespace vitis {
@@ -44,13 +45,15 @@ void dump();
 
 } // profiling
 
-using Clock = std::chrono::steady_clock;
+// short ops are timed, the clock must be cheap to read. Its time points
+// are steady_clock time points.
+using Clock = TscClock;
 
 #define __TIC__(tag)                                                           \
   auto __##tag##_start_time =                                                  \
       ENV_PARAM(DEEPHI_PROFILING)                                              \
           ? vitis::ai::Clock::now()                                            \
-          : std::chrono::time_point<vitis::ai::Clock>();
+          : vitis::ai::Clock::time_point();
 
 #define __TOC__(tag)                                                           \
   do {                                                                         \
@@ -79,7 +82,7 @@ using Clock = std::chrono::steady_clock;
   auto __##tag##_start_time =                                                  \
       ENV_PARAM(DEEPHI_PROFILING)                                              \
           ? vitis::ai::Clock::now()                                            \
-          : std::chrono::time_point<vitis::ai::Clock>();
+          : vitis::ai::Clock::time_point();
 
 #define __TOC_SUM__(tag)                                                       \
   do {                                                                         \
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+// A cheap monotonic clock for timing short operations.
+//
+// On x86-64 with an invariant TSC, and on aarch64 with its generic
+// timer, now() reads the CPU counter and scales it to nanoseconds. The
+// scale is calibrated against CLOCK_MONOTONIC at first use and corrected
+// for drift about once per second, so TscClock stays within a few
+// microseconds of std::chrono::steady_clock and shares its epoch; its
+// time points are steady_clock time points. Corrections never move it
+// back: it is stepped forward only, and slowed down if it is ahead. When
+// the counter cannot be trusted, e.g. no invariant TSC or the counters
+// of different cores are not in sync, or env XLNX_TSC_CLOCK=0, it falls
+// back to steady_clock.
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace vitis {
+namespace ai {
+
+class TscClock {
+ public:
+  using duration = std::chrono::nanoseconds;
+  using rep = duration::rep;
+  using period = duration::period;
+  using time_point = std::chrono::steady_clock::time_point;
+  static constexpr bool is_steady = true;
+
+  static time_point now() noexcept;
+
+  // false if it falls back to steady_clock.
+  static bool is_tsc();
+  // e.g. "tsc 2995.2 MHz" or "steady_clock (no invariant tsc)"
+  static std::string description();
+};
+
+}  // namespace ai
+}  // namespace vitis
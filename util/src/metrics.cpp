@@ -0,0 +1,317 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "vitis/ai/metrics.hpp"
+
+#include <glog/logging.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM(DEBUG_METRICS, "0");
+DEF_ENV_PARAM_2(XLNX_METRICS_FILE, "", std::string);
+DEF_ENV_PARAM_2(XLNX_METRICS_SOCKET, "", std::string);
+DEF_ENV_PARAM(XLNX_METRICS_INTERVAL_MS, "1000");
+
+namespace vitis {
+namespace ai {
+namespace metrics {
+
+size_t shard_index() {
+  static std::atomic<size_t> next_index{0u};
+  thread_local size_t index = next_index++ % NUM_OF_SHARDS;
+  return index;
+}
+
+const std::vector<double>& default_latency_buckets_us() {
+  static const std::vector<double> buckets = {
+      10,    20,    50,     100,    200,    500,    1000,   2000,
+      5000,  10000, 20000,  50000,  100000, 200000, 500000, 1000000};
+  return buckets;
+}
+
+static std::string escape(const std::string& s) {
+  std::string ret;
+  for (auto c : s) {
+    if (c == '\\' || c == '"') {
+      ret += '\\';
+      ret += c;
+    } else if (c == '\n') {
+      ret += "\\n";
+    } else {
+      ret += c;
+    }
+  }
+  return ret;
+}
+
+static std::string render_labels(const labels_t& labels) {
+  if (labels.empty()) {
+    return "";
+  }
+  std::ostringstream str;
+  str << "{";
+  for (auto i = 0u; i < labels.size(); ++i) {
+    str << (i == 0u ? "" : ",") << labels[i].first << "=\""
+        << escape(labels[i].second) << "\"";
+  }
+  str << "}";
+  return str.str();
+}
+
+// {a="1"} + le="10" => {a="1",le="10"}
+static std::string add_label(const std::string& labels,
+                             const std::string& label) {
+  if (labels.empty()) {
+    return "{" + label + "}";
+  }
+  return labels.substr(0, labels.size() - 1u) + "," + label + "}";
+}
+}  // namespace metrics
+
+Histogram::Histogram(const std::vector<double>& bounds) : bounds_{bounds} {
+  for (auto& s : shards_) {
+    s.buckets = std::make_unique<std::atomic<uint64_t>[]>(bounds_.size() + 1u);
+    for (auto i = 0u; i < bounds_.size() + 1u; ++i) {
+      s.buckets[i] = 0u;
+    }
+  }
+}
+
+Histogram::snapshot_t Histogram::snapshot() const {
+  auto ret = snapshot_t{std::vector<uint64_t>(bounds_.size() + 1u, 0u), 0u,
+                        0.0};
+  for (auto& s : shards_) {
+    for (auto i = 0u; i < ret.buckets.size(); ++i) {
+      auto n = s.buckets[i].load(std::memory_order_relaxed);
+      ret.buckets[i] += n;
+      ret.count += n;
+    }
+    ret.sum += s.sum.load(std::memory_order_relaxed);
+  }
+  return ret;
+}
+
+MetricsRegistry& MetricsRegistry::instance() {
+  // never destroyed, so that metrics can be updated and dumped while
+  // the process is exiting.
+  static MetricsRegistry* the_instance = []() {
+    auto ret = new MetricsRegistry();
+    ret->start_exporters();
+    return ret;
+  }();
+  return *the_instance;
+}
+
+MetricsRegistry::MetricsRegistry() : mtx_{}, families_{} {}
+
+MetricsRegistry::family_t& MetricsRegistry::get_family(
+    const std::string& name, const std::string& type,
+    const std::string& help) {
+  auto& ret = families_[name];
+  if (ret.type.empty()) {
+    ret.type = type;
+    ret.help = help;
+  }
+  CHECK_EQ(ret.type, type) << "metric " << name << " is registered as "
+                           << ret.type;
+  return ret;
+}
+
+Counter* MetricsRegistry::counter(const std::string& name,
+                                  const std::string& help,
+                                  const metrics::labels_t& labels) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto& m = get_family(name, "counter", help)
+                .counters[metrics::render_labels(labels)];
+  if (m == nullptr) {
+    m = std::make_unique<Counter>();
+  }
+  return m.get();
+}
+
+Gauge* MetricsRegistry::gauge(const std::string& name, const std::string& help,
+                              const metrics::labels_t& labels) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto& m =
+      get_family(name, "gauge", help).gauges[metrics::render_labels(labels)];
+  if (m == nullptr) {
+    m = std::make_unique<Gauge>();
+  }
+  return m.get();
+}
+
+Histogram* MetricsRegistry::histogram(const std::string& name,
+                                      const std::string& help,
+                                      const metrics::labels_t& labels,
+                                      const std::vector<double>& bounds) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto& m = get_family(name, "histogram", help)
+                .histograms[metrics::render_labels(labels)];
+  if (m == nullptr) {
+    m = std::make_unique<Histogram>(bounds);
+  }
+  return m.get();
+}
+
+std::string MetricsRegistry::dump() const {
+  std::ostringstream str;
+  str.precision(15);
+  std::lock_guard<std::mutex> lock(mtx_);
+  for (auto& f : families_) {
+    auto& name = f.first;
+    auto& family = f.second;
+    str << "# HELP " << name << " " << family.help << "\n"
+        << "# TYPE " << name << " " << family.type << "\n";
+    for (auto& c : family.counters) {
+      str << name << c.first << " " << c.second->value() << "\n";
+    }
+    for (auto& g : family.gauges) {
+      str << name << g.first << " " << g.second->value() << "\n";
+    }
+    for (auto& h : family.histograms) {
+      auto s = h.second->snapshot();
+      auto& bounds = h.second->bounds();
+      auto cumulative = (uint64_t)0u;
+      for (auto i = 0u; i < s.buckets.size(); ++i) {
+        cumulative += s.buckets[i];
+        std::ostringstream le;
+        le.precision(15);
+        le << "le=\"";
+        if (i < bounds.size()) {
+          le << bounds[i];
+        } else {
+          le << "+Inf";
+        }
+        le << "\"";
+        str << name << "_bucket" << metrics::add_label(h.first, le.str())
+            << " " << cumulative << "\n";
+      }
+      str << name << "_sum" << h.first << " " << s.sum << "\n"
+          << name << "_count" << h.first << " " << s.count << "\n";
+    }
+  }
+  return str.str();
+}
+
+bool MetricsRegistry::dump_to_file(const std::string& path) const {
+  auto tmp = path + ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      return false;
+    }
+    out << dump();
+    if (!out) {
+      return false;
+    }
+  }
+#ifdef _WIN32
+  std::remove(path.c_str());
+#endif
+  return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+static void file_exporter_main(MetricsRegistry* self, std::string path) {
+  while (true) {
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(ENV_PARAM(XLNX_METRICS_INTERVAL_MS)));
+    LOG_IF(WARNING, !self->dump_to_file(path) && ENV_PARAM(DEBUG_METRICS))
+        << "cannot write metrics to " << path;
+  }
+}
+
+#ifndef _WIN32
+// every connection gets one dump, framed as an HTTP response so that
+// both `nc -U` and `curl --unix-socket` work.
+static void socket_exporter_main(MetricsRegistry* self, std::string path) {
+  auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    LOG(WARNING) << "cannot create metrics socket";
+    return;
+  }
+  auto addr = sockaddr_un();
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  unlink(path.c_str());
+  if (bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 8) != 0) {
+    LOG(WARNING) << "cannot listen on metrics socket " << path;
+    close(fd);
+    return;
+  }
+  while (true) {
+    auto client = accept(fd, nullptr, nullptr);
+    if (client < 0) {
+      continue;
+    }
+    // drain the request if any, but do not wait for it.
+    auto timeout = timeval{0, 100000};
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    char buf[1024];
+    (void)recv(client, buf, sizeof(buf), 0);
+    auto body = self->dump();
+    auto response = std::string(
+                        "HTTP/1.0 200 OK\r\n"
+                        "Content-Type: text/plain; version=0.0.4\r\n"
+                        "Content-Length: ") +
+                    std::to_string(body.size()) + "\r\n\r\n" + body;
+    auto p = response.data();
+    auto size = response.size();
+    while (size > 0u) {
+      auto n = send(client, p, size, MSG_NOSIGNAL);
+      if (n <= 0) {
+        break;
+      }
+      p += n;
+      size -= (size_t)n;
+    }
+    close(client);
+  }
+}
+#endif
+
+void MetricsRegistry::start_exporters() {
+  auto file = ENV_PARAM(XLNX_METRICS_FILE);
+  if (!file.empty()) {
+    LOG_IF(INFO, ENV_PARAM(DEBUG_METRICS)) << "dump metrics to " << file;
+    std::thread(file_exporter_main, this, file).detach();
+    // the last dump, short lived processes would not have any.
+    static std::string the_file = file;
+    atexit([]() { MetricsRegistry::instance().dump_to_file(the_file); });
+  }
+#ifndef _WIN32
+  auto socket_path = ENV_PARAM(XLNX_METRICS_SOCKET);
+  if (!socket_path.empty()) {
+    LOG_IF(INFO, ENV_PARAM(DEBUG_METRICS))
+        << "serve metrics on " << socket_path;
+    std::thread(socket_exporter_main, this, socket_path).detach();
+  }
+#endif
+}
+
+}  // namespace ai
+}  // namespace vitis
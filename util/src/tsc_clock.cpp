@@ -0,0 +1,312 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "vitis/ai/tsc_clock.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM(DEBUG_TSC_CLOCK, "0");
+DEF_ENV_PARAM(XLNX_TSC_CLOCK, "1");
+
+namespace vitis {
+namespace ai {
+
+namespace {
+// the scale is a 32.32 fixed point number of nanoseconds per tick.
+constexpr int SHIFT = 32;
+constexpr int64_t RECALIBRATE_NS = 1000000000;
+constexpr int64_t CALIBRATE_NS = 10000000;
+// a drift correction changes the scale by at most 500ppm.
+constexpr double MAX_SLEW = 500e-6;
+// beyond this, e.g. after a suspend, the clock steps forward instead of
+// slewing.
+constexpr int64_t MAX_SLEW_ERROR_NS = 1000000;
+// the counters of all cores must agree within this.
+constexpr int64_t MAX_CORE_OFFSET_NS = 10000;
+
+inline uint64_t read_ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t ret;
+  asm volatile("isb; mrs %0, cntvct_el0" : "=r"(ret)::"memory");
+  return ret;
+#else
+  return 0u;
+#endif
+}
+
+inline int64_t monotonic_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+struct sample_t {
+  uint64_t ticks;
+  int64_t ns;
+};
+
+// the counter read closest to a CLOCK_MONOTONIC read, i.e. the tightest
+// of a few brackets.
+sample_t take_sample() {
+  auto ret = sample_t{0u, 0};
+  auto best = ~(uint64_t)0u;
+  for (auto i = 0; i < 16; ++i) {
+    auto t0 = read_ticks();
+    auto ns = monotonic_ns();
+    auto t1 = read_ticks();
+    if (t1 >= t0 && t1 - t0 < best) {
+      best = t1 - t0;
+      ret = sample_t{t0 + (t1 - t0) / 2u, ns};
+    }
+  }
+  return ret;
+}
+
+bool has_invariant_counter(std::string& reason) {
+#if defined(__x86_64__) || defined(__i386__)
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (!__get_cpuid(0x80000000u, &eax, &ebx, &ecx, &edx) ||
+      eax < 0x80000007u) {
+    reason = "no invariant tsc";
+    return false;
+  }
+  __get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx);
+  if ((edx & (1u << 8)) == 0u) {
+    reason = "no invariant tsc";
+    return false;
+  }
+  return true;
+#elif defined(__aarch64__)
+  // the generic timer runs at a constant rate by definition.
+  return true;
+#else
+  reason = "no cpu counter";
+  return false;
+#endif
+}
+
+class clock_state_t {
+ public:
+  clock_state_t() { init(); }
+
+  int64_t now_ns() {
+    if (!enabled_) {
+      return monotonic_ns();
+    }
+    auto ticks = read_ticks();
+    auto ret = to_ns(ticks);
+    if ((int64_t)(ticks - base_ticks_.load(std::memory_order_relaxed)) >
+        (int64_t)recalibrate_ticks_) {
+      recalibrate();
+    }
+    return ret;
+  }
+
+  bool enabled() const { return enabled_; }
+  const std::string& description() const { return description_; }
+
+ private:
+  int64_t to_ns(uint64_t ticks) const {
+    uint32_t seq;
+    uint64_t base_ticks;
+    int64_t base_ns;
+    uint64_t mult;
+    do {
+      seq = seq_.load(std::memory_order_acquire);
+      base_ticks = base_ticks_.load(std::memory_order_relaxed);
+      base_ns = base_ns_.load(std::memory_order_relaxed);
+      mult = mult_.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((seq & 1u) != 0u || seq != seq_.load(std::memory_order_relaxed));
+    // another core might be a few ticks behind the base.
+    auto delta = (int64_t)(ticks - base_ticks);
+    if (delta <= 0) {
+      return base_ns;
+    }
+#ifdef __SIZEOF_INT128__
+    return base_ns + (int64_t)(((unsigned __int128)delta * mult) >> SHIFT);
+#else
+    return base_ns + (int64_t)std::ldexp((double)delta * (double)mult, -SHIFT);
+#endif
+  }
+
+  void set_params(uint64_t base_ticks, int64_t base_ns, double ns_per_tick) {
+    auto seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1u, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    base_ticks_.store(base_ticks, std::memory_order_relaxed);
+    base_ns_.store(base_ns, std::memory_order_relaxed);
+    mult_.store((uint64_t)std::llround(std::ldexp(ns_per_tick, SHIFT)),
+                std::memory_order_relaxed);
+    seq_.store(seq + 2u, std::memory_order_release);
+    ns_per_tick_ = ns_per_tick;
+  }
+
+  void init() {
+    auto reason = std::string();
+    if (!ENV_PARAM(XLNX_TSC_CLOCK)) {
+      reason = "disabled by XLNX_TSC_CLOCK=0";
+    } else if (has_invariant_counter(reason)) {
+      auto s0 = take_sample();
+      std::this_thread::sleep_for(std::chrono::nanoseconds(CALIBRATE_NS));
+      auto s1 = take_sample();
+      if (s1.ticks <= s0.ticks || s1.ns <= s0.ns) {
+        reason = "the counter does not advance";
+      } else {
+        set_params(s1.ticks, s1.ns,
+                   (double)(s1.ns - s0.ns) / (double)(s1.ticks - s0.ticks));
+        last_ = s1;
+        recalibrate_ticks_ = (uint64_t)(RECALIBRATE_NS / ns_per_tick_);
+        enabled_ = check_cores(reason);
+      }
+    }
+    std::ostringstream str;
+    if (enabled_) {
+#if defined(__aarch64__)
+      str << "cntvct ";
+#else
+      str << "tsc ";
+#endif
+      str << std::fixed << std::setprecision(1) << 1000.0 / ns_per_tick_
+          << " MHz";
+    } else {
+      str << "steady_clock (" << reason << ")";
+    }
+    description_ = str.str();
+    LOG_IF(INFO, ENV_PARAM(DEBUG_TSC_CLOCK)) << "clock: " << description_;
+  }
+
+  // on every core, the calibrated counter must agree with
+  // CLOCK_MONOTONIC, otherwise the counters are not in sync.
+  bool check_cores(std::string& reason) {
+#ifdef __linux__
+    auto num_of_cpus = std::min(std::thread::hardware_concurrency(), 1024u);
+    auto offsets = std::vector<int64_t>(num_of_cpus, 0);
+    auto threads = std::vector<std::thread>();
+    for (auto cpu = 0u; cpu < num_of_cpus; ++cpu) {
+      threads.emplace_back([this, cpu, &offsets]() {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+          // not allowed to run there, it is not used by us either.
+          return;
+        }
+        auto s = take_sample();
+        offsets[cpu] = to_ns(s.ticks) - s.ns;
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    for (auto cpu = 0u; cpu < num_of_cpus; ++cpu) {
+      LOG_IF(INFO, ENV_PARAM(DEBUG_TSC_CLOCK))
+          << "cpu " << cpu << " offset " << offsets[cpu] << "ns";
+      if (std::abs(offsets[cpu]) > MAX_CORE_OFFSET_NS) {
+        reason = "the counter of cpu " + std::to_string(cpu) + " is off by " +
+                 std::to_string(offsets[cpu]) + "ns";
+        return false;
+      }
+    }
+#endif
+    return true;
+  }
+
+  // continue from where the current scale is, and slew the scale so
+  // that the error against CLOCK_MONOTONIC is gone by the next one. A
+  // larger error is stepped if the clock is behind, but never back, the
+  // clock is steady: ahead, it keeps running at the slowest slew until
+  // CLOCK_MONOTONIC catches up.
+  void recalibrate() {
+    if (updating_.exchange(true, std::memory_order_acquire)) {
+      return;
+    }
+    auto s = take_sample();
+    auto current = to_ns(s.ticks);
+    auto error = s.ns - current;
+    auto valid = s.ticks > last_.ticks && s.ns > last_.ns;
+    auto measured =
+        valid ? (double)(s.ns - last_.ns) / (double)(s.ticks - last_.ticks)
+              : ns_per_tick_;
+    if (valid && std::abs(error) < MAX_SLEW_ERROR_NS) {
+      auto slew = std::max(-MAX_SLEW,
+                           std::min(MAX_SLEW, (double)error / RECALIBRATE_NS));
+      set_params(s.ticks, current, measured * (1.0 + slew));
+    } else if (error > 0) {
+      LOG_IF(INFO, ENV_PARAM(DEBUG_TSC_CLOCK))
+          << "clock steps by " << error << "ns";
+      set_params(s.ticks, s.ns, measured);
+    } else {
+      LOG_IF(INFO, ENV_PARAM(DEBUG_TSC_CLOCK))
+          << "clock is ahead by " << -error << "ns, slowing down";
+      set_params(s.ticks, current, measured * (1.0 - MAX_SLEW));
+    }
+    last_ = s;
+    updating_.store(false, std::memory_order_release);
+  }
+
+ private:
+  bool enabled_ = false;
+  std::string description_;
+  std::atomic<uint32_t> seq_{0u};
+  std::atomic<uint64_t> base_ticks_{0u};
+  std::atomic<int64_t> base_ns_{0};
+  std::atomic<uint64_t> mult_{0u};
+  // only touched by init and by the thread which recalibrates.
+  double ns_per_tick_ = 1.0;
+  sample_t last_{0u, 0};
+  uint64_t recalibrate_ticks_ = 0u;
+  std::atomic<bool> updating_{false};
+};
+
+clock_state_t& state() {
+  // never destroyed, clocks are read while the process exits.
+  static clock_state_t* the_state = new clock_state_t();
+  return *the_state;
+}
+}  // namespace
+
+TscClock::time_point TscClock::now() noexcept {
+  return time_point(std::chrono::nanoseconds(state().now_ns()));
+}
+
+bool TscClock::is_tsc() { return state().enabled(); }
+
+std::string TscClock::description() { return state().description(); }
+
+}  // namespace ai
+}  // namespace vitis
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// check that sharded updates from many threads add up, then measure
+// the cost of one update, compared with a plain atomic shared by all
+// threads.
+//
+// usage: env NUM_OF_THREADS=8 test_metrics
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "vitis/ai/env_config.hpp"
+#include "vitis/ai/metrics.hpp"
+DEF_ENV_PARAM(NUM_OF_THREADS, "4")
+DEF_ENV_PARAM(NUM_OF_UPDATES, "10000000")
+using namespace std;
+
+template <typename F>
+static double run_threads(F f) {
+  auto num_of_threads = ENV_PARAM(NUM_OF_THREADS);
+  auto num_of_updates = ENV_PARAM(NUM_OF_UPDATES);
+  auto threads = vector<thread>();
+  auto start = chrono::steady_clock::now();
+  for (auto t = 0; t < num_of_threads; ++t) {
+    threads.emplace_back([f, num_of_updates]() {
+      for (auto i = 0; i < num_of_updates; ++i) {
+        f(i);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  auto ns = chrono::duration_cast<chrono::nanoseconds>(
+                chrono::steady_clock::now() - start)
+                .count();
+  // wall time per update of one thread.
+  return (double)ns / num_of_updates;
+}
+
+int main(int argc, char* argv[]) {
+  auto& r = vitis::ai::MetricsRegistry::instance();
+  auto counter = r.counter("test_counter_total", "a counter");
+  auto gauge = r.gauge("test_gauge", "a gauge", {{"kind", "test"}});
+  auto histogram =
+      r.histogram("test_latency_microseconds", "a histogram", {}, {1, 10, 100});
+  auto total = (uint64_t)ENV_PARAM(NUM_OF_THREADS) * ENV_PARAM(NUM_OF_UPDATES);
+  auto ok = true;
+
+  auto counter_ns = run_threads([counter](int) { counter->inc(); });
+  ok = ok && counter->value() == total;
+  auto histogram_ns = run_threads(
+      [histogram](int i) { histogram->observe((double)(i % 200)); });
+  auto s = histogram->snapshot();
+  ok = ok && s.count == total && s.buckets.size() == 4u;
+  auto gauge_ns = run_threads([gauge](int) { gauge->inc(); });
+  ok = ok && (uint64_t)gauge->value() == total;
+  ok = ok && r.counter("test_counter_total", "a counter") == counter;
+
+  std::atomic<uint64_t> shared{0u};
+  auto shared_ns = run_threads(
+      [&shared](int) { shared.fetch_add(1u, std::memory_order_relaxed); });
+
+  cout << r.dump();
+  cout << fixed << setprecision(2)                                    //
+       << "threads=" << ENV_PARAM(NUM_OF_THREADS)                     //
+       << " counter=" << counter_ns << "ns"                           //
+       << " histogram=" << histogram_ns << "ns"                       //
+       << " gauge=" << gauge_ns << "ns"                               //
+       << " shared atomic counter (baseline)=" << shared_ns << "ns"  //
+       << endl;
+  cout << (ok ? "PASS" : "FAIL") << endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// compare the cost of TscClock::now() with steady_clock and
+// clock_gettime, then check that it keeps track of steady_clock.
+//
+// usage: env NUM_OF_CALLS=10000000 DURATION_MS=3000 test_tsc_clock
+
+#include <time.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "vitis/ai/env_config.hpp"
+#include "vitis/ai/tsc_clock.hpp"
+DEF_ENV_PARAM(NUM_OF_CALLS, "10000000");
+DEF_ENV_PARAM(DURATION_MS, "3000");
+using namespace std;
+
+template <typename F>
+static double ns_per_call(F f) {
+  auto num_of_calls = ENV_PARAM(NUM_OF_CALLS);
+  auto sum = (int64_t)0;
+  auto start = chrono::steady_clock::now();
+  for (auto i = 0; i < num_of_calls; ++i) {
+    sum += f();
+  }
+  auto ns = chrono::duration_cast<chrono::nanoseconds>(
+                chrono::steady_clock::now() - start)
+                .count();
+  // keep `sum`, so that calls are not optimized away.
+  return sum == 42 ? 0.0 : (double)ns / num_of_calls;
+}
+
+static int64_t error_ns() {
+  auto a = chrono::steady_clock::now();
+  auto b = vitis::ai::TscClock::now();
+  auto c = chrono::steady_clock::now();
+  return chrono::duration_cast<chrono::nanoseconds>(b - (a + (c - a) / 2))
+      .count();
+}
+
+int main(int argc, char* argv[]) {
+  auto ok = true;
+  cout << "clock: " << vitis::ai::TscClock::description() << endl;
+  auto tsc_ns = ns_per_call([]() {
+    return vitis::ai::TscClock::now().time_since_epoch().count();
+  });
+  auto steady_ns = ns_per_call([]() {
+    return chrono::steady_clock::now().time_since_epoch().count();
+  });
+  auto gettime_ns = ns_per_call([]() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_nsec;
+  });
+  cout << fixed << setprecision(2)                        //
+       << "TscClock::now=" << tsc_ns << "ns"              //
+       << " steady_clock::now=" << steady_ns << "ns"      //
+       << " clock_gettime=" << gettime_ns << "ns" << endl;
+
+  // monotonic, and within 50us of steady_clock over a few drift
+  // corrections.
+  auto max_error = (int64_t)0;
+  auto last = vitis::ai::TscClock::now();
+  auto end = chrono::steady_clock::now() +
+             chrono::milliseconds(ENV_PARAM(DURATION_MS));
+  while (chrono::steady_clock::now() < end) {
+    for (auto i = 0; i < 1000; ++i) {
+      auto now = vitis::ai::TscClock::now();
+      ok = ok && now >= last;
+      last = now;
+    }
+    max_error = std::max(max_error, std::abs(error_ns()));
+    this_thread::sleep_for(chrono::milliseconds(10));
+  }
+  ok = ok && max_error < 50000;
+  cout << "max error=" << max_error << "ns" << endl;
+  cout << (ok ? "PASS" : "FAIL") << endl;
+  return ok ? 0 : 1;
+}